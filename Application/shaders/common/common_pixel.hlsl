@@ -66,34 +66,37 @@ cbuffer TextureMetaCB : register(b1)
     float4 DetailN_Meta;   // x=IsAttached y=Strength z=UvX w=UvY
 
     // Singular
-    float4 Singular0; // x=IsOccAttached y=IsRoughAttached z=IsMetalAttached w=pad
+    float4 Singular0; // x=IsOccAttached y=IsRoughAttached z=IsMetalAttached w=IsORMPacked
     float4 Singular1; // x=OccStrength y=RoughValue z=MetalValue w=pad
     float4 Singular2; // x=OccUvX y=OccUvY z=RoughUvX w=RoughUvY
     float4 Singular3; // x=MetalUvX y=MetalUvY z=pad w=pad
 
     // Forced mip
     float4 ForcedMip; // x=ForcedMipLevel y=UseForcedMip z=pad w=pad
+
+    // Array slice per texture slot, four slots per float4 in slot order
+    float4 ArraySlices[4];
 };
 
-Texture2D gBaseColorTex     : register(t0);  // BaseColor
-Texture2D gNormalTex        : register(t1);  // Normal
-Texture2D gORMTex           : register(t2);  // ORM
-Texture2D gEmissiveTex      : register(t3);  // Emissive
+Texture2DArray gBaseColorTex    : register(t0);  // BaseColor
+Texture2DArray gNormalTex       : register(t1);  // Normal
+Texture2DArray gORMTex          : register(t2);  // ORM
+Texture2DArray gEmissiveTex     : register(t3);  // Emissive
 
-Texture2D gRoughnessTex     : register(t4);  // Roughness
-Texture2D gMetallicTex      : register(t5);  // Metallic
-Texture2D gOcclusionTex     : register(t6);  // Occlusion
+Texture2DArray gRoughnessTex    : register(t4);  // Roughness
+Texture2DArray gMetallicTex     : register(t5);  // Metallic
+Texture2DArray gOcclusionTex    : register(t6);  // Occlusion
 
-Texture2D gOpacityTex       : register(t7);  // Opacity
+Texture2DArray gOpacityTex      : register(t7);  // Opacity
 
-Texture2D gHeightTex        : register(t8);  // Height
-Texture2D gDisplacementTex  : register(t9);  // Displacement
+Texture2DArray gHeightTex       : register(t8);  // Height
+Texture2DArray gDisplacementTex : register(t9);  // Displacement
 
-Texture2D gSpecularTex      : register(t10); // Specular
-Texture2D gGlossinessTex    : register(t11); // Glossiness
+Texture2DArray gSpecularTex     : register(t10); // Specular
+Texture2DArray gGlossinessTex   : register(t11); // Glossiness
 
-Texture2D gDetailNormalTex  : register(t12); // DetailNormal
-Texture2D gShadowMapTex     : register(t13); // ShadowMap
+Texture2DArray gDetailNormalTex : register(t12); // DetailNormal
+Texture2D      gShadowMapTex    : register(t13); // ShadowMap
 
 SamplerState gSamp0 : register(s0);
 SamplerComparisonState gShadowCmp : register(s1);
@@ -128,21 +131,50 @@ StructuredBuffer<KFE_LightData> gLights : register(t15);
 
 float HasTex(float flag) { return step(0.5f, flag); }
 
+//~ Texture slots, same order as EModelTextureSlot
+#define SLOT_BASE_COLOR     0
+#define SLOT_NORMAL         1
+#define SLOT_ORM            2
+#define SLOT_EMISSIVE       3
+#define SLOT_ROUGHNESS      4
+#define SLOT_METALLIC       5
+#define SLOT_OCCLUSION      6
+#define SLOT_OPACITY        7
+#define SLOT_HEIGHT         8
+#define SLOT_DISPLACEMENT   9
+#define SLOT_SPECULAR       10
+#define SLOT_GLOSSINESS     11
+#define SLOT_DETAIL_NORMAL  12
+
+//~ Small textures share arrays, every material texture is a Texture2DArray
+float3 SliceUV(float2 uv, uint slot)
+{
+    return float3(uv, ArraySlices[slot >> 2][slot & 3]);
+}
+
 float UseForcedMip() { return step(0.5f, ForcedMip.y); }
 
+//~ Tangent space normal from XY, Z rebuilt. Cooked BC5 maps carry no Z,
+//~ uncompressed maps decode to the same unit normal.
+float3 UnpackNormalTS(float3 s)
+{
+    const float2 xy = s.xy * 2.0f - 1.0f;
+    return float3(xy, sqrt(saturate(1.0f - dot(xy, xy))));
+}
+
 //~ Sample 2D with optional forced mip
-float SampleTex1(Texture2D tex, float2 uv)
+float SampleTex1(Texture2DArray tex, float2 uv, uint slot)
 {
-    const float s0 = tex.Sample(gSamp0, uv).r;
-    const float sF = tex.SampleLevel(gSamp0, uv, ForcedMip.x).r;
+    const float s0 = tex.Sample(gSamp0, SliceUV(uv, slot)).r;
+    const float sF = tex.SampleLevel(gSamp0, SliceUV(uv, slot), ForcedMip.x).r;
     return lerp(s0, sF, UseForcedMip());
 }
 
 //~ Sample 2D with forced mip in rgb
-float3 SampleTex3(Texture2D tex, float2 uv)
+float3 SampleTex3(Texture2DArray tex, float2 uv, uint slot)
 {
-    const float3 s0 = tex.Sample(gSamp0, uv).rgb;
-    const float3 sF = tex.SampleLevel(gSamp0, uv, ForcedMip.x).rgb;
+    const float3 s0 = tex.Sample(gSamp0, SliceUV(uv, slot)).rgb;
+    const float3 sF = tex.SampleLevel(gSamp0, SliceUV(uv, slot), ForcedMip.x).rgb;
     return lerp(s0, sF, UseForcedMip());
 }
 
@@ -156,11 +188,11 @@ float3 ApplyBaseColorTex(float2 uv0, float3 fallbackColor)
 
     // Normal sampling
     const float3 texSample =
-        gBaseColorTex.Sample(gSamp0, uv).rgb;
+        gBaseColorTex.Sample(gSamp0, SliceUV(uv, SLOT_BASE_COLOR)).rgb;
 
     // Forced mip
     const float3 texForced =
-        gBaseColorTex.SampleLevel(gSamp0, uv, ForcedMip.x).rgb;
+        gBaseColorTex.SampleLevel(gSamp0, SliceUV(uv, SLOT_BASE_COLOR), ForcedMip.x).rgb;
 
     const float useForced = step(0.5f, ForcedMip.y);
     const float3 tex =
@@ -189,14 +221,14 @@ float3 ApplyNormalTex(
     const float2 uv = uv0 * Normal_Meta.zw;
 
     // Sample normal map
-    const float3 s0 = gNormalTex.Sample(gSamp0, uv).xyz;
-    const float3 sF = gNormalTex.SampleLevel(gSamp0, uv, ForcedMip.x).xyz;
+    const float3 s0 = gNormalTex.Sample(gSamp0, SliceUV(uv, SLOT_NORMAL)).xyz;
+    const float3 sF = gNormalTex.SampleLevel(gSamp0, SliceUV(uv, SLOT_NORMAL), ForcedMip.x).xyz;
 
     const float useForced = step(0.5f, ForcedMip.y);
     const float3 sample01 = lerp(s0, sF, useForced);
 
     // Unpack
-    float3 nTS = sample01 * 2.0f - 1.0f;
+    float3 nTS = UnpackNormalTS(sample01);
     nTS = normalize(nTS);
 
     // Build TBN
@@ -222,11 +254,11 @@ float ApplyOcclusionTex(float2 uv0)
 
     // Sample AO
     const float aoSample =
-        gOcclusionTex.Sample(gSamp0, uv).r;
+        gOcclusionTex.Sample(gSamp0, SliceUV(uv, SLOT_OCCLUSION)).r;
 
     // Forced mip
     const float aoForced =
-        gOcclusionTex.SampleLevel(gSamp0, uv, ForcedMip.x).r;
+        gOcclusionTex.SampleLevel(gSamp0, SliceUV(uv, SLOT_OCCLUSION), ForcedMip.x).r;
 
     const float useForced = step(0.5f, ForcedMip.y);
     const float aoTex = lerp(aoSample, aoForced, useForced);
@@ -246,8 +278,8 @@ float2 ApplyDisplacementUV(float2 uv0, float3 worldPos)
 
     const float2 uvD = uv0 * Displace_Meta.zw;
 
-    const float h0 = gDisplacementTex.Sample(gSamp0, uvD).r;
-    const float hF = gDisplacementTex.SampleLevel(gSamp0, uvD, ForcedMip.x).r;
+    const float h0 = gDisplacementTex.Sample(gSamp0, SliceUV(uvD, SLOT_DISPLACEMENT)).r;
+    const float hF = gDisplacementTex.SampleLevel(gSamp0, SliceUV(uvD, SLOT_DISPLACEMENT), ForcedMip.x).r;
 
     const float useForced = step(0.5f, ForcedMip.y);
     const float h = lerp(h0, hF, useForced);
@@ -272,8 +304,8 @@ float SampleGloss(float2 uv0)
 
     const float2 uv = uv0 * Gloss_Meta.zw;
 
-    const float g0 = gGlossinessTex.Sample(gSamp0, uv).r;
-    const float gF = gGlossinessTex.SampleLevel(gSamp0, uv, ForcedMip.x).r;
+    const float g0 = gGlossinessTex.Sample(gSamp0, SliceUV(uv, SLOT_GLOSSINESS)).r;
+    const float gF = gGlossinessTex.SampleLevel(gSamp0, SliceUV(uv, SLOT_GLOSSINESS), ForcedMip.x).r;
 
     const float useForced = step(0.5f, ForcedMip.y);
     float gloss = lerp(g0, gF, useForced);
@@ -287,8 +319,8 @@ void ApplyOpacityCutout(float2 uv0)
     const float has = HasTex(Opacity_Meta.x);
     if (has < 0.5f) return;
 
-    const float a0 = gOpacityTex.Sample(gSamp0, uv0).r;
-    const float aF = gOpacityTex.SampleLevel(gSamp0, uv0, ForcedMip.x).r;
+    const float a0 = gOpacityTex.Sample(gSamp0, SliceUV(uv0, SLOT_OPACITY)).r;
+    const float aF = gOpacityTex.SampleLevel(gSamp0, SliceUV(uv0, SLOT_OPACITY), ForcedMip.x).r;
 
     const float useForced = step(0.5f, ForcedMip.y);
     float a = lerp(a0, aF, useForced);
@@ -552,7 +584,7 @@ float3 ApplyEmissiveTex(float2 uv0)
     const float2 uv = uv0 * Emissive_Meta.zw;
 
     //~ RGB emissive color
-    const float3 e = SampleTex3(gEmissiveTex, uv);
+    const float3 e = SampleTex3(gEmissiveTex, uv, SLOT_EMISSIVE);
 
     //~ Intensity is like a multiplier
     const float intensity = max(Emissive_Meta.y, 0.0f);
@@ -567,7 +599,7 @@ float3 SampleORM(float2 uv0)
 
     // ORM sample
     const float2 uvOrm  = uv0 * ORM_Meta.zw;
-    const float3 ormTex = SampleTex3(gORMTex, uvOrm);
+    const float3 ormTex = SampleTex3(gORMTex, uvOrm, SLOT_ORM);
 
     const float aoTex    = ormTex.r;
     const float roughTex = ormTex.g;
@@ -584,9 +616,9 @@ float3 SampleORM(float2 uv0)
     const float2 uvMetal = uv0 * Singular3.xy;
 
     // Singular samples
-    const float aoSingTex    = SampleTex1(gOcclusionTex, uvAO);
-    const float roughSingTex = SampleTex1(gRoughnessTex, uvRough);
-    const float metalSingTex = SampleTex1(gMetallicTex, uvMetal);
+    const float aoSingTex    = SampleTex1(gOcclusionTex, uvAO, SLOT_OCCLUSION);
+    const float roughSingTex = SampleTex1(gRoughnessTex, uvRough, SLOT_ROUGHNESS);
+    const float metalSingTex = SampleTex1(gMetallicTex, uvMetal, SLOT_METALLIC);
 
     // Singular constants
     const float aoConst    = 1.0f;
@@ -617,7 +649,7 @@ float SampleRoughness(float2 uv0)
     const float2 uv = uv0 * Singular2.zw;
 
     //~ Texture or constant
-    const float rTex = SampleTex1(gRoughnessTex, uv);
+    const float rTex = SampleTex1(gRoughnessTex, uv, SLOT_ROUGHNESS);
     const float rVal = saturate(Singular1.y);
 
     return lerp(rVal, rTex, enable);
@@ -631,7 +663,7 @@ float SampleMetallic(float2 uv0)
     const float2 uv = uv0 * Singular3.xy;
 
     //~ Texture or constant
-    const float mTex = SampleTex1(gMetallicTex, uv);
+    const float mTex = SampleTex1(gMetallicTex, uv, SLOT_METALLIC);
     const float mVal = saturate(Singular1.z);
 
     return lerp(mVal, mTex, enable);
@@ -645,7 +677,7 @@ float3 SampleSpecularColor(float2 uv0, float3 fallbackSpec)
     const float2 uv = uv0 * Specular_Meta.zw;
 
     //~ RGB spec color
-    const float3 s = SampleTex3(gSpecularTex, uv);
+    const float3 s = SampleTex3(gSpecularTex, uv, SLOT_SPECULAR);
 
     //~ Strength mixes toward fallback
     const float strength = saturate(Specular_Meta.y);
@@ -662,11 +694,11 @@ float3 ApplyDetailNormalTex(float2 uv0, float3 baseN, float3 worldT, float3 worl
     const float2 uv = uv0 * DetailN_Meta.zw;
 
     //~ Detail normal in TS
-    const float3 s0 = gDetailNormalTex.Sample(gSamp0, uv).xyz;
-    const float3 sF = gDetailNormalTex.SampleLevel(gSamp0, uv, ForcedMip.x).xyz;
+    const float3 s0 = gDetailNormalTex.Sample(gSamp0, SliceUV(uv, SLOT_DETAIL_NORMAL)).xyz;
+    const float3 sF = gDetailNormalTex.SampleLevel(gSamp0, SliceUV(uv, SLOT_DETAIL_NORMAL), ForcedMip.x).xyz;
     const float3 s  = lerp(s0, sF, UseForcedMip());
 
-    float3 nTS = normalize(s * 2.0f - 1.0f);
+    float3 nTS = normalize(UnpackNormalTS(s));
 
     //~ TBN
     const float3 N = normalize(baseN);
@@ -690,8 +722,8 @@ float2 ApplyHeightParallaxUV(float2 uv0, float3 worldPos)
     const float scale = Height_Meta.y;
 
     //~ Sample height
-    const float h0 = gHeightTex.Sample(gSamp0, uv0).r;
-    const float hF = gHeightTex.SampleLevel(gSamp0, uv0, ForcedMip.x).r;
+    const float h0 = gHeightTex.Sample(gSamp0, SliceUV(uv0, SLOT_HEIGHT)).r;
+    const float hF = gHeightTex.SampleLevel(gSamp0, SliceUV(uv0, SLOT_HEIGHT), ForcedMip.x).r;
     const float h  = lerp(h0, hF, UseForcedMip());
 
     //~ Center height at 0
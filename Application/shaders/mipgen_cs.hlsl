@@ -15,12 +15,14 @@ void main(uint3 dispatchThreadID : SV_DispatchThreadID)
     if (dstCoord.x >= gDstSize.x || dstCoord.y >= gDstSize.y)
         return;
 
-    uint2 srcCoord = dstCoord * 2;
+    // Clamped so 1 texel wide levels do not average in out of bounds zeros
+    uint2 srcCoord0 = min(dstCoord * 2,     gSrcSize - 1);
+    uint2 srcCoord1 = min(dstCoord * 2 + 1, gSrcSize - 1);
 
-    float4 c0 = gSrcMip[srcCoord + uint2(0, 0)];
-    float4 c1 = gSrcMip[srcCoord + uint2(1, 0)];
-    float4 c2 = gSrcMip[srcCoord + uint2(0, 1)];
-    float4 c3 = gSrcMip[srcCoord + uint2(1, 1)];
+    float4 c0 = gSrcMip[uint2(srcCoord0.x, srcCoord0.y)];
+    float4 c1 = gSrcMip[uint2(srcCoord1.x, srcCoord0.y)];
+    float4 c2 = gSrcMip[uint2(srcCoord0.x, srcCoord1.y)];
+    float4 c3 = gSrcMip[uint2(srcCoord1.x, srcCoord1.y)];
 
     gDstMip[dstCoord] = (c0 + c1 + c2 + c3) * 0.25f;
 }
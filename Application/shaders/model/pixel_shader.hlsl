@@ -36,24 +36,38 @@ float4 main(PSInput input) : SV_TARGET
     );
     N = ApplyDetailNormalTex(uv, N, input.WorldTangent, input.WorldBitan);
 
-    // Individuals
-    const float aoInd    = ApplyOcclusionTex(uv);
-    const float roughInd = SampleRoughness(uv);
-    const float metalInd = SampleMetallic(uv);
-
-    // ORM values
-    const float3 orm = SampleORM(uv);
-    const float  aoOrm    = orm.x;
-    const float  roughOrm = orm.y;
-    const float  metalOrm = orm.z;
-
     // Flags
     const float hasOrm = step(0.5f, ORM_Meta.x);
     const float mixed  = step(0.5f, ORM_Meta.y); 
 
-    const float ao    = lerp(aoInd,    lerp(aoOrm,    aoInd,    mixed), hasOrm);
-    const float rough = lerp(roughInd, lerp(roughOrm, roughInd, mixed), hasOrm);
-    const float metal = lerp(metalInd, lerp(metalOrm, metalInd, mixed), hasOrm);
+    float ao, rough, metal;
+
+    //~ Unmixed ORM (authored or packed at load) is one fetch, uniform across the draw
+    [branch]
+    if (hasOrm > 0.5f && mixed < 0.5f)
+    {
+        const float3 orm = SampleTex3(gORMTex, uv * ORM_Meta.zw, SLOT_ORM);
+
+        //~ Packed from a separate occlusion map, which honours its strength. Authored ORM does not.
+        const float packed = step(0.5f, Singular0.w);
+        ao    = lerp(orm.x, lerp(1.0f, orm.x, saturate(Singular1.x)), packed);
+        rough = orm.y;
+        metal = orm.z;
+    }
+    else
+    {
+        // Individuals
+        const float aoInd    = ApplyOcclusionTex(uv);
+        const float roughInd = SampleRoughness(uv);
+        const float metalInd = SampleMetallic(uv);
+
+        // ORM values
+        const float3 orm = SampleORM(uv);
+
+        ao    = lerp(aoInd,    lerp(orm.x, aoInd,    mixed), hasOrm);
+        rough = lerp(roughInd, lerp(orm.y, roughInd, mixed), hasOrm);
+        metal = lerp(metalInd, lerp(orm.z, metalInd, mixed), hasOrm);
+    }
 
     const float gloss = saturate(1.0f - rough);
 
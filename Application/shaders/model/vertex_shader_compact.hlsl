@@ -0,0 +1,101 @@
+cbuffer CommonCB : register(b0)
+{
+    float4x4 gWorldT;
+    float4x4 gWorldInvTransposeT;
+
+    float4x4 gViewT;
+    float4x4 gProjT;
+    float4x4 gViewProjT;
+    float4x4 gOrthoT;
+
+    float3 gCameraPosWS;
+    float  gCameraNear;
+
+    float3 gCameraForwardWS;
+    float  gCameraFar;
+
+    float3 gCameraRightWS;
+    float  _PadCamRight;
+
+    float3 gCameraUpWS;
+    float  _PadCamUp;
+
+    float3 gObjectPosWS;
+    float  _PadObjPos;
+
+    float3 gPlayerPosWS;
+    float  _PadPlayerPos;
+
+    float2 gResolution;
+    float2 gInvResolution;
+
+    float2 gMousePosPixels;
+    float2 gMousePosNDC;
+
+    float  gTime;
+    float  gDeltaTime;
+    float  _PadTime0;
+    float  _PadTime1;
+
+    uint   gNumTotalLights;
+    uint   gRenderFlags;
+    uint   _PadFlags0;
+    uint   _PadFlags1;
+};
+
+//~ Matches KFEMeshGeometry::GetInputLayout(EMeshVertexFormat::Compact).
+//~ Position arrives as UNORM against the mesh AABB; the dequantize
+//~ scale/offset is already folded into gWorldT on the CPU.
+struct VSInput
+{
+    float4 Position  : POSITION;  // xyz = unorm position, w = bitangent sign (0 => -1, 1 => +1)
+    float2 Normal    : NORMAL;    // octahedral
+    float2 Tangent   : TANGENT;   // octahedral
+    float2 TexCoord0 : TEXCOORD0;
+    float2 TexCoord1 : TEXCOORD1;
+};
+
+struct VSOutput
+{
+    float4 PositionCS   : SV_POSITION;
+
+    float3 WorldPos     : TEXCOORD0;
+    float3 WorldNormal  : TEXCOORD1;
+    float3 WorldTangent : TEXCOORD2;
+    float3 WorldBitan   : TEXCOORD3;
+
+    float2 TexCoord0    : TEXCOORD4;
+    float2 TexCoord1    : TEXCOORD5;
+};
+
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    float  t = saturate(-n.z);
+    n.xy += (n.xy >= 0.0f) ? -t : t;
+    return normalize(n);
+}
+
+VSOutput main(VSInput v)
+{
+    VSOutput o;
+
+    float4 worldPos = mul(float4(v.Position.xyz, 1.0f), gWorldT);
+    float4 viewPos  = mul(worldPos, gViewT);
+    o.PositionCS    = mul(viewPos, gProjT);
+
+    o.WorldPos = worldPos.xyz;
+
+    const float3 normal  = DecodeOctahedral(v.Normal);
+    const float3 tangent = DecodeOctahedral(v.Tangent);
+    const float  sign    = v.Position.w * 2.0f - 1.0f;
+
+    o.WorldNormal  = normal;
+    o.WorldTangent = tangent;
+    o.WorldBitan   = normalize(cross(normal, tangent) * sign);
+
+    o.TexCoord0 = v.TexCoord0;
+    o.TexCoord1 = v.TexCoord1;
+
+    return o;
+}
@@ -32,6 +32,7 @@ namespace kfe
         KFEBuffer*    ResourceBuffer = nullptr;
         DXGI_FORMAT   Format         = static_cast<DXGI_FORMAT>(0);
         std::uint64_t OffsetInBytes  = 0u;
+        std::uint64_t SizeInBytes    = 0u; //~ 0 = up to the end of the buffer
     } KFE_INDEX_BUFFER_CREATE_DESC;
 
     /// <summary>
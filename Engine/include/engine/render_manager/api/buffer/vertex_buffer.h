@@ -33,6 +33,7 @@ namespace kfe
 
         std::uint32_t StrideInBytes = 0u;
         std::uint64_t OffsetInBytes = 0u;
+        std::uint64_t SizeInBytes   = 0u; //~ 0 = up to the end of the buffer
         std::string   DebugName{};
     } KFE_VERTEX_BUFFER_CREATE_DESC;
 
@@ -7,6 +7,7 @@
 #include "engine/render_manager/api/buffer/constant_buffer.h"
 #include "engine/render_manager/api/components/device.h"
 #include "engine/render_manager/api/heap/heap_cbv_srv_uav.h"
+#include "engine/render_manager/api/pool/residency_manager.h"
 
 #include <cstdint>
 #include <memory>
@@ -79,6 +80,7 @@ namespace kfe
         std::uint32_t      m_frameIndex{ 0u };
         std::uint32_t      m_sizeBytes{ 0u };
         bool               m_initialized{ false };
+        KFEResidencyHandle m_residency{};
     };
 
 } // namespace kfe
@@ -0,0 +1,135 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : geometry_arena.h
+ *  Purpose   : Shared default heap vertex/index pages that static meshes are
+ *              suballocated from, plus linear upload pages recycled by fence.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+#include "EngineAPI.h"
+
+#include "engine/core.h"
+#include "engine/system/interface/interface_singleton.h"
+#include "offset_allocator.h"
+
+#include <cstdint>
+#include <memory>
+
+struct ID3D12Fence;
+struct ID3D12GraphicsCommandList;
+
+namespace kfe
+{
+	class KFEDevice;
+	class KFEBuffer;
+
+	enum class EGeometryArenaBuffer : std::uint8_t
+	{
+		Vertex,
+		Index,
+	};
+
+	typedef struct _KFE_GEOMETRY_ARENA_CREATE_DESC
+	{
+		KFEDevice*    Device          = nullptr;
+		std::uint64_t VertexPageBytes = 64ull << 20;
+		std::uint64_t IndexPageBytes  = 32ull << 20;
+		std::uint64_t UploadPageBytes = 16ull << 20;
+	} KFE_GEOMETRY_ARENA_CREATE_DESC;
+
+	typedef struct _KFE_GEOMETRY_ALLOCATION
+	{
+		EGeometryArenaBuffer  Type  = EGeometryArenaBuffer::Vertex;
+		std::uint32_t         Page  = ~0u;
+		KFE_OFFSET_ALLOCATION Range{};
+
+		bool IsValid() const noexcept { return Page != ~0u && Range.IsValid(); }
+	} KFE_GEOMETRY_ALLOCATION;
+
+	typedef struct _KFE_GEOMETRY_UPLOAD_DESC
+	{
+		ID3D12GraphicsCommandList* CommandList = nullptr;
+		const void*                Data        = nullptr;
+		std::uint64_t              SizeInBytes = 0u;
+
+		//~ Signalled once CommandList has executed. Without it the upload is assumed
+		//~ to run on the frame set by SetFrameFence, and is rejected if there is none.
+		ID3D12Fence*               Fence       = nullptr;
+		std::uint64_t              FenceValue  = 0u;
+	} KFE_GEOMETRY_UPLOAD_DESC;
+
+	typedef struct _KFE_GEOMETRY_ARENA_STATS
+	{
+		std::uint32_t              VertexPages   = 0u;
+		std::uint32_t              IndexPages    = 0u;
+		KFE_OFFSET_ALLOCATOR_STATS Vertex{};      //~ summed over pages
+		KFE_OFFSET_ALLOCATOR_STATS Index{};
+		std::uint32_t              UploadPages   = 0u;
+		std::uint64_t              UploadBytes   = 0u; //~ upload heap currently held
+		std::uint32_t              PendingFrees  = 0u; //~ waiting on a fence
+	} KFE_GEOMETRY_ARENA_STATS;
+
+	/// <summary>
+	/// Static geometry lives in a few large default heap buffers instead of one
+	/// committed resource per mesh. Each page is split with a KFEOffsetAllocator.
+	/// Pages rest in VERTEX_AND_CONSTANT_BUFFER / INDEX_BUFFER, uploads move them
+	/// through COPY_DEST on the recording list.
+	/// </summary>
+	class KFE_API KFEGeometryArena final : public ISingleton<KFEGeometryArena>
+	{
+		friend class ISingleton<KFEGeometryArena>;
+	public:
+		 KFEGeometryArena() noexcept;
+		~KFEGeometryArena() noexcept;
+
+		KFEGeometryArena(const KFEGeometryArena&) = delete;
+		KFEGeometryArena(KFEGeometryArena&&) noexcept = delete;
+
+		KFEGeometryArena& operator=(const KFEGeometryArena&) = delete;
+		KFEGeometryArena& operator=(KFEGeometryArena&&) noexcept = delete;
+
+		//~ Pages are created lazily. KFEGpuMesh initializes the arena with default
+		//~ page sizes on first use, call this before loading to pick other sizes.
+		NODISCARD bool Initialize(_In_ const KFE_GEOMETRY_ARENA_CREATE_DESC& desc);
+		NODISCARD bool IsReady   () const noexcept;
+
+		//~ alignment 0 = 16 bytes. Adds a page when no existing one has room.
+		NODISCARD KFE_GEOMETRY_ALLOCATION Allocate(EGeometryArenaBuffer type,
+			std::uint64_t sizeInBytes,
+			std::uint64_t alignment = 0u) noexcept;
+
+		//~ Copies through an upload page. Pages stay in COMMON and rely on implicit
+		//~ promotion, so no barrier is recorded and no live page is ever transitioned.
+		NODISCARD bool Upload(_In_ const KFE_GEOMETRY_ALLOCATION& allocation,
+			_In_ const KFE_GEOMETRY_UPLOAD_DESC& desc) noexcept;
+
+		//~ Graphics fence value the current frame signals when it retires. Called once
+		//~ per frame before recording, frees wait for it as well as for the uploads.
+		void SetFrameFence(_In_opt_ ID3D12Fence* fence, std::uint64_t fenceValue) noexcept;
+
+		//~ The range is reused once the last upload fence seen by the arena and the
+		//~ current frame fence complete, so no frame in flight still draws from it.
+		void Free(_In_ const KFE_GEOMETRY_ALLOCATION& allocation) noexcept;
+
+		//~ Returns completed frees to their pages and recycles completed upload pages
+		void Collect() noexcept;
+
+		//~ Releases empty pages except the first of each kind
+		void Trim() noexcept;
+
+		//~ Drops every page, only safe once the GPU is idle
+		void Destroy() noexcept;
+
+		NODISCARD _Ret_maybenull_ KFEBuffer* GetBuffer(_In_ const KFE_GEOMETRY_ALLOCATION& allocation) const noexcept;
+
+		NODISCARD KFE_GEOMETRY_ARENA_STATS GetStats() const noexcept;
+
+	private:
+		class Impl;
+		std::unique_ptr<Impl> m_impl;
+	};
+} // namespace kfe
@@ -0,0 +1,114 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : offset_allocator.h
+ *  Purpose   : CPU only range allocator used to suballocate large GPU buffers.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+#include "EngineAPI.h"
+
+#include "engine/core.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace kfe
+{
+	inline constexpr std::uint64_t KFE_INVALID_OFFSET = ~0ull;
+
+	typedef struct _KFE_OFFSET_ALLOCATOR_CREATE_DESC
+	{
+		std::uint64_t Capacity     = 0u;
+		std::uint64_t MinAlignment = 16u; //~ power of two, every size is rounded up to it
+	} KFE_OFFSET_ALLOCATOR_CREATE_DESC;
+
+	typedef struct _KFE_OFFSET_ALLOCATION
+	{
+		std::uint64_t Offset = KFE_INVALID_OFFSET;
+		std::uint64_t Size   = 0u; //~ requested size
+
+		bool IsValid() const noexcept { return Offset != KFE_INVALID_OFFSET; }
+	} KFE_OFFSET_ALLOCATION;
+
+	typedef struct _KFE_OFFSET_ALLOCATOR_STATS
+	{
+		std::uint64_t Capacity         = 0u;
+		std::uint64_t UsedBytes        = 0u; //~ including alignment rounding
+		std::uint64_t FreeBytes        = 0u;
+		std::uint64_t LargestFreeBlock = 0u;
+		std::uint32_t FreeBlockCount   = 0u;
+		std::uint32_t AllocationCount  = 0u;
+		float         Fragmentation    = 0.0f; //~ 1 - LargestFreeBlock / FreeBytes
+	} KFE_OFFSET_ALLOCATOR_STATS;
+
+	typedef struct _KFE_OFFSET_ALLOCATOR_BENCH_DESC
+	{
+		std::uint64_t Capacity    = 256ull << 20;
+		std::uint32_t Operations  = 200000u;
+		std::uint64_t MinSize     = 256u;
+		std::uint64_t MaxSize     = 1ull << 20;
+		std::uint64_t Alignment   = 16u;
+		float         FreeChance  = 0.45f; //~ chance that an operation frees instead of allocates
+		std::uint32_t Seed        = 1337u;
+	} KFE_OFFSET_ALLOCATOR_BENCH_DESC;
+
+	typedef struct _KFE_OFFSET_ALLOCATOR_BENCH_RESULT
+	{
+		std::uint32_t Allocations       = 0u;
+		std::uint32_t Frees             = 0u;
+		std::uint32_t FailedAllocations = 0u;
+		double        AllocateNs        = 0.0; //~ average per call
+		double        FreeNs            = 0.0;
+		std::uint64_t PeakUsedBytes     = 0u;
+		float         PeakFragmentation = 0.0f;
+		bool          bConsistent       = false; //~ Validate() after every phase
+	} KFE_OFFSET_ALLOCATOR_BENCH_RESULT;
+
+	/// <summary>
+	/// Best fit free list over [0, Capacity). Neighbouring free blocks are merged
+	/// on Free, so a full free returns to a single block. No GPU state at all.
+	/// </summary>
+	class KFE_API KFEOffsetAllocator
+	{
+	public:
+		 KFEOffsetAllocator() noexcept;
+		~KFEOffsetAllocator() noexcept;
+
+		KFEOffsetAllocator(const KFEOffsetAllocator&) = delete;
+		KFEOffsetAllocator(KFEOffsetAllocator&&) noexcept;
+
+		KFEOffsetAllocator& operator=(const KFEOffsetAllocator&) = delete;
+		KFEOffsetAllocator& operator=(KFEOffsetAllocator&&) noexcept;
+
+		NODISCARD bool Initialize(_In_ const KFE_OFFSET_ALLOCATOR_CREATE_DESC& desc);
+
+		//~ alignment 0 uses MinAlignment, otherwise it has to be a power of two.
+		//~ Returns an invalid allocation when no free block fits.
+		NODISCARD KFE_OFFSET_ALLOCATION Allocate(std::uint64_t size, std::uint64_t alignment = 0u) noexcept;
+		NODISCARD bool                  Free    (_In_ const KFE_OFFSET_ALLOCATION& allocation) noexcept;
+
+		//~ Drops every allocation
+		void Reset() noexcept;
+
+		NODISCARD KFE_OFFSET_ALLOCATOR_STATS GetStats     () const noexcept;
+		NODISCARD std::uint64_t              GetCapacity  () const noexcept;
+		NODISCARD bool                       IsInitialized() const noexcept;
+		NODISCARD bool                       IsEmpty      () const noexcept;
+
+		//~ Checks the free lists against the live allocations: no overlaps, no
+		//~ unmerged neighbours, byte counts add up to the capacity.
+		NODISCARD bool Validate() const noexcept;
+
+		//~ Random allocate/free mix on a private allocator, timing both calls
+		static KFE_OFFSET_ALLOCATOR_BENCH_RESULT RunBenchmark(
+			_In_ const KFE_OFFSET_ALLOCATOR_BENCH_DESC& desc = {}) noexcept;
+
+	private:
+		class Impl;
+		std::unique_ptr<Impl> m_impl;
+	};
+} // namespace kfe
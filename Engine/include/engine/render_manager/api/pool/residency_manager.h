@@ -0,0 +1,206 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : residency_manager.h
+ *  Purpose   : One place that knows how much GPU memory the engine holds, per
+ *              category, and evicts the least recently used resources that can
+ *              shrink when the total goes over the budget.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+#include "EngineAPI.h"
+
+#include "engine/core.h"
+#include "engine/system/common_types.h"
+#include "engine/system/interface/interface_singleton.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+struct ID3D12Resource;
+struct IDXGIAdapter3;
+
+namespace kfe
+{
+	class KFEDevice;
+	class KFEResidencyManager;
+
+	enum class EResidencyCategory : std::uint8_t
+	{
+		Texture,
+		Mesh,
+		RenderTarget,
+		ConstantBuffer, //~ upload heap, counted but not held against the local budget
+		Count
+	};
+
+	typedef struct _KFE_RESIDENCY_DESC
+	{
+		std::uint64_t BudgetBytes          = 0u;   //~ 0 = BudgetFraction of what the budget source reports
+		float         BudgetFraction       = 0.9f; //~ room for what never registers (swap chain, PSOs, heaps)
+		std::uint32_t MinIdleFrames        = 3u;   //~ frames in flight, younger resources are never evicted
+		std::uint32_t MaxEvictionsPerFrame = 16u;
+	} KFE_RESIDENCY_DESC;
+
+	typedef struct _KFE_RESIDENCY_REGISTER_DESC
+	{
+		std::string        Name{};
+		EResidencyCategory Category    = EResidencyCategory::Texture;
+		std::uint64_t      SizeInBytes = 0u;
+
+		//~ Null pins the resource. Otherwise it drops what it can and returns the bytes
+		//~ that will go, the owner reports the real size with Resize once they have.
+		std::function<std::uint64_t()> Evict{};
+	} KFE_RESIDENCY_REGISTER_DESC;
+
+	typedef struct _KFE_RESIDENCY_CATEGORY_STATS
+	{
+		std::uint32_t Resources      = 0u;
+		std::uint64_t Bytes          = 0u;
+		std::uint64_t EvictableBytes = 0u; //~ held by resources with an Evict callback
+		std::uint64_t Evictions      = 0u;
+		std::uint64_t EvictedBytes   = 0u; //~ what the callbacks promised
+	} KFE_RESIDENCY_CATEGORY_STATS;
+
+	typedef struct _KFE_RESIDENCY_STATS
+	{
+		std::uint64_t Frame            = 0u;
+		std::uint64_t BudgetBytes      = 0u; //~ 0 = no budget, counters only
+		std::uint64_t LocalBytes       = 0u; //~ what counts against the budget
+		std::uint64_t PeakLocalBytes   = 0u;
+		std::uint64_t OverBudgetFrames = 0u; //~ still over after evicting
+		std::array<KFE_RESIDENCY_CATEGORY_STATS, static_cast<std::size_t>(EResidencyCategory::Count)> Categories{};
+	} KFE_RESIDENCY_STATS;
+
+	/// <summary>
+	/// Where the budget comes from. Queried once per frame.
+	/// </summary>
+	class KFE_API IKFEResidencyBudgetSource
+	{
+	public:
+		virtual ~IKFEResidencyBudgetSource() = default;
+		NODISCARD virtual std::uint64_t QueryBudgetBytes() noexcept = 0;
+	};
+
+	//~ A set number, for tests and for forcing a small budget
+	class KFE_API KFEFixedBudgetSource final : public IKFEResidencyBudgetSource
+	{
+	public:
+		explicit KFEFixedBudgetSource(std::uint64_t budgetBytes) noexcept : m_budgetBytes(budgetBytes) {}
+
+		void SetBudgetBytes(std::uint64_t budgetBytes) noexcept { m_budgetBytes = budgetBytes; }
+		NODISCARD std::uint64_t QueryBudgetBytes() noexcept override { return m_budgetBytes; }
+
+	private:
+		std::uint64_t m_budgetBytes;
+	};
+
+	//~ Local segment budget the OS gives the process, 0 when the query fails
+	class KFE_API KFEAdapterBudgetSource final : public IKFEResidencyBudgetSource
+	{
+	public:
+		explicit KFEAdapterBudgetSource(_In_ IDXGIAdapter3* adapter) noexcept : m_pAdapter(adapter) {}
+
+		NODISCARD std::uint64_t QueryBudgetBytes() noexcept override;
+
+	private:
+		IDXGIAdapter3* m_pAdapter;
+	};
+
+	/// <summary>
+	/// One registration, unregistered on destruction or Reset. Movable, so owners
+	/// keep their default moves.
+	/// </summary>
+	class KFE_API KFEResidencyHandle
+	{
+	public:
+		 KFEResidencyHandle() noexcept = default;
+		 KFEResidencyHandle(_In_ KFEResidencyManager* owner, std::uint32_t id) noexcept : m_pOwner(owner), m_id(id) {}
+		~KFEResidencyHandle() noexcept { Reset(); }
+
+		KFEResidencyHandle(const KFEResidencyHandle&) = delete;
+		KFEResidencyHandle& operator=(const KFEResidencyHandle&) = delete;
+
+		KFEResidencyHandle(KFEResidencyHandle&& other) noexcept
+			: m_pOwner(std::exchange(other.m_pOwner, nullptr))
+			, m_id(std::exchange(other.m_id, KFE_INVALID_INDEX))
+		{}
+
+		KFEResidencyHandle& operator=(KFEResidencyHandle&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				m_pOwner = std::exchange(other.m_pOwner, nullptr);
+				m_id     = std::exchange(other.m_id, KFE_INVALID_INDEX);
+			}
+			return *this;
+		}
+
+		void Reset () noexcept;
+		void Touch () const noexcept;
+		void Resize(std::uint64_t sizeInBytes) const noexcept;
+
+		NODISCARD bool          IsValid() const noexcept { return m_pOwner && m_id != KFE_INVALID_INDEX; }
+		NODISCARD std::uint32_t GetId  () const noexcept { return m_id; }
+
+	private:
+		KFEResidencyManager* m_pOwner{ nullptr };
+		std::uint32_t        m_id    { KFE_INVALID_INDEX };
+	};
+
+	/// <summary>
+	/// Every committed resource the engine creates registers its size and category.
+	/// Once per frame BeginFrame refreshes the budget, and while the local total is
+	/// over it, evicts the least recently used evictable resources that have been
+	/// idle for MinIdleFrames. Thread safe. Leaked on exit, handles in other
+	/// singletons may outlive it otherwise.
+	/// </summary>
+	class KFE_API KFEResidencyManager final : public ISingleton<KFEResidencyManager, true>
+	{
+		friend class ISingleton<KFEResidencyManager, true>;
+	public:
+		 KFEResidencyManager() noexcept;
+		~KFEResidencyManager() noexcept;
+
+		KFEResidencyManager(const KFEResidencyManager&) = delete;
+		KFEResidencyManager(KFEResidencyManager&&) noexcept = delete;
+
+		KFEResidencyManager& operator=(const KFEResidencyManager&) = delete;
+		KFEResidencyManager& operator=(KFEResidencyManager&&) noexcept = delete;
+
+		//~ Null and no BudgetBytes in the desc means no budget, only counters
+		void SetBudgetSource(std::unique_ptr<IKFEResidencyBudgetSource> source) noexcept;
+		void SetDesc(_In_ const KFE_RESIDENCY_DESC& desc) noexcept;
+
+		NODISCARD KFEResidencyHandle Register(_In_ KFE_RESIDENCY_REGISTER_DESC desc);
+
+		void Unregister(std::uint32_t id) noexcept;
+		void Resize    (std::uint32_t id, std::uint64_t sizeInBytes) noexcept;
+		void Touch     (std::uint32_t id) noexcept; //~ used in the current frame
+
+		//~ Once per frame before recording. Returns the bytes the evictions promised.
+		std::uint64_t BeginFrame() noexcept;
+
+		//~ What category may hold with everything else as it is, UINT64_MAX without a budget
+		NODISCARD std::uint64_t GetBudgetFor(EResidencyCategory category) const noexcept;
+		NODISCARD KFE_RESIDENCY_STATS GetStats() const noexcept;
+
+		//~ Size a committed resource really takes, placement alignment included
+		NODISCARD static std::uint64_t QueryAllocationBytes(_In_ KFEDevice* device, _In_ ID3D12Resource* resource) noexcept;
+
+		//~ Runs the eviction policy on a private manager with a fixed budget source, logs failures
+		NODISCARD static bool RunSelfTest() noexcept;
+
+	private:
+		class Impl;
+		std::unique_ptr<Impl> m_impl;
+	};
+} // namespace kfe
@@ -37,11 +37,18 @@ namespace kfe
         std::uint32_t MipLevels = 1u;
         std::uint32_t ArraySize = 1u;
 
+        //~ Leading subresources the upload buffer has room for, 0 = all of them
+        std::uint32_t UploadSubresources = 1u;
+
+        //~ Needed by GPU mip generation, block compressed formats must turn it off
+        bool AllowUnorderedAccess = true;
+
     } KFE_STAGING_TEXTURE_CREATE_DESC;
 
     /// <summary>
     /// Staging texture: owns an UPLOAD buffer
-    /// DEFAULT KFETexture and records CopyTextureRegion.
+    /// DEFAULT KFETexture and records CopyTextureRegion
+    /// for every subresource that was written.
     /// </summary>
     class KFE_API KFEStagingTexture final : public IKFEObject
     {
@@ -77,9 +84,24 @@ namespace kfe
             _In_ const void* data,
             std::uint32_t    srcRowPitchBytes) noexcept;
 
+        //~ Rows are texel rows, or block rows for block compressed formats
+        NODISCARD bool WriteSubresource(
+            std::uint32_t    subresource,
+            _In_ const void* data,
+            std::uint32_t    srcRowPitchBytes) noexcept;
+
         NODISCARD bool RecordUploadToTexture(
             _In_ ID3D12GraphicsCommandList* cmdList) const noexcept;
 
+        //~ Copies subresources [first, first + count) only, for textures filled a piece
+        //~ at a time. Barriers touch just that range, the rest may be in use.
+        //~ bResident: an earlier copy left the range in PIXEL_SHADER_RESOURCE.
+        NODISCARD bool RecordUploadRange(
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            std::uint32_t firstSubresource,
+            std::uint32_t count,
+            bool          bResident) const noexcept;
+
     private:
         class Impl;
         std::unique_ptr<Impl> m_impl;
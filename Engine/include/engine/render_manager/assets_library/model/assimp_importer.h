@@ -25,12 +25,14 @@ namespace kfe::import
     using Float3 = DirectX::XMFLOAT3;   //~ Positions, normals, tangents
     using Float4x4 = DirectX::XMFLOAT4X4; //~ Node transforms
 
+    //~ Missing attributes keep the engine defaults, so KFEMeshVertex can be copied
+    //~ straight from it (same layout)
     struct ImportedVertex
     {
         Float3 Position{};
-        Float3 Normal{};
-        Float3 Tangent{};
-        Float3 Bitangent{};
+        Float3 Normal{ 0.0f, 1.0f, 0.0f };
+        Float3 Tangent{ 1.0f, 0.0f, 0.0f };
+        Float3 Bitangent{ 0.0f, 0.0f, 1.0f };
 
         Float2 UV[KFE_MAX_UV_CHANNELS]{};
 
@@ -44,6 +46,7 @@ namespace kfe::import
         std::string                 Name;
         std::vector<ImportedVertex> Vertices;
         std::vector<std::uint32_t>  Indices;
+        std::uint32_t               MaterialIndex = 0u; //~ source file material, ~0u when none
 
         Float3 AABBMin{ 1e30f,  1e30f,  1e30f };
         Float3 AABBMax{ -1e30f, -1e30f, -1e30f };
@@ -77,6 +80,13 @@ namespace kfe::import
         }
     };
 
+    //~ Who fills in missing normals and tangents
+    enum class EImportTangentSpace : std::uint8_t
+    {
+        Engine = 0, //~ KFETangentSpace after conversion, multithreaded and deterministic
+        Assimp,     //~ aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace
+    };
+
     class KFE_API AssimpImporter
     {
     public:
@@ -90,6 +100,16 @@ namespace kfe::import
 
         bool LoadFromFile(const std::string& filePath,
             ImportedScene& outScene,
-            std::string& outErrorMessage) noexcept;
+            std::string& outErrorMessage) const noexcept;
+
+        void                SetTangentSpace(EImportTangentSpace mode) noexcept { m_tangentSpace = mode; }
+        EImportTangentSpace GetTangentSpace() const noexcept { return m_tangentSpace; }
+
+        //~ Post process flags used by LoadFromFile, cooked data is keyed on them.
+        //~ Engine mode drops Assimp's normal and tangent steps, so the keys differ.
+        std::uint32_t GetPostProcessFlags() const noexcept;
+
+    private:
+        EImportTangentSpace m_tangentSpace{ EImportTangentSpace::Engine };
     };
 } // namespace kfe::import
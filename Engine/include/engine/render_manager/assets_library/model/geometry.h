@@ -12,8 +12,12 @@
 
 #include "EngineAPI.h"
 #include "assimp_importer.h"
+#include "meshlet.h"
+#include "mesh_lod.h"
 
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -21,6 +25,9 @@
 
 namespace kfe
 {
+    struct KFE_MESH_OPTIMIZE_DESC;
+    struct KFE_MESH_OPTIMIZE_STATS;
+
     //~ Final CPU-side vertex layout for the renderer.
 	//~ For every mesh to be added to the engine.
     struct KFEMeshVertex
@@ -48,6 +55,25 @@ namespace kfe
         DirectX::XMFLOAT2 UV1{};
     };
 
+    enum class EMeshVertexFormat : std::uint8_t
+    {
+        Full = 0,   //~ KFEMeshVertex as is
+        Compact     //~ KFEMeshVertexCompact, needs shaders/model/vertex_shader_compact.hlsl
+    };
+
+    //~ Opt-in 24 byte GPU vertex (KFEMeshVertex is 68).
+    //~ Position is quantized against the mesh AABB, the renderer folds the
+    //~ dequantize scale/offset into the world matrix.
+    struct KFEMeshVertexCompact
+    {
+        std::uint16_t Position[4]{}; //~ R16G16B16A16_UNORM, w = bitangent sign (0 => -1, 1 => +1)
+        std::int16_t  Normal[2]{};   //~ R16G16_SNORM, octahedral
+        std::int16_t  Tangent[2]{};  //~ R16G16_SNORM, octahedral
+        std::uint16_t UV0[2]{};      //~ R16G16_FLOAT
+        std::uint16_t UV1[2]{};      //~ R16G16_FLOAT
+    };
+    static_assert(sizeof(KFEMeshVertexCompact) == 24u, "KFEMeshVertexCompact must stay 24 bytes");
+
     class KFE_API KFEMeshGeometry
     {
     public:
@@ -61,25 +87,72 @@ namespace kfe
 
         bool BuildFromImportedMesh(const kfe::import::ImportedMesh& src) noexcept;
 
+        //~ Zero copy build, vertices and indices stay in the backing memory (e.g. a mapped .kfmesh)
+        bool BuildFromView(const std::string&                 name,
+                           std::span<const KFEMeshVertex>     vertices,
+                           std::span<const std::uint32_t>     indices,
+                           const DirectX::XMFLOAT3&           aabbMin,
+                           const DirectX::XMFLOAT3&           aabbMax,
+                           std::shared_ptr<const void>        backing,
+                           std::span<const KFE_MESHLET>       meshlets = {},
+                           std::span<const KFE_MESH_LOD>      lods = {}) noexcept;
+
+        //~ Reorders triangles/vertices for cache, overdraw and fetch (see mesh_optimizer.h).
+        //~ External geometry is copied into owned storage first.
+        bool Optimize(const KFE_MESH_OPTIMIZE_DESC& desc,
+                      KFE_MESH_OPTIMIZE_STATS*      outStats = nullptr) noexcept;
+
+        //~ Partitions the mesh into meshlets (see meshlet.h). Reorders triangles,
+        //~ so run it after Optimize. Optimize drops existing meshlets.
+        bool BuildMeshlets(const KFE_MESHLET_BUILD_DESC& desc,
+                           KFE_MESHLET_BUILD_STATS*      outStats = nullptr) noexcept;
+
+        //~ Appends simplified index ranges behind LOD0 (see mesh_lod.h), the vertex
+        //~ buffer is shared by every level. Run it last, Optimize and BuildMeshlets
+        //~ drop existing LODs.
+        bool BuildLods(const KFE_MESH_LOD_DESC& desc) noexcept;
+
         void Clear() noexcept;
 
         // Accessors
         const std::string& GetName()          const noexcept;
 
-        const std::vector<KFEMeshVertex>& GetVertices() const noexcept;
-        const std::vector<std::uint32_t>& GetIndices()  const noexcept;
+        std::span<const KFEMeshVertex> GetVertices() const noexcept;
+        std::span<const std::uint32_t> GetIndices()  const noexcept;
+        std::span<const KFE_MESHLET>   GetMeshlets() const noexcept;
+
+        //~ Empty when no chain was built, the whole index buffer is LOD0 then
+        std::span<const KFE_MESH_LOD>  GetLods() const noexcept;
 
         const DirectX::XMFLOAT3& GetAABBMin() const noexcept;
         const DirectX::XMFLOAT3& GetAABBMax() const noexcept;
 
-        bool IsValid() const noexcept;
-        static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout() noexcept;
+        bool IsValid   () const noexcept;
+        bool IsExternal() const noexcept;
+
+        //~ True when every vertex fits a 16 bit index (0xFFFF stays free as the strip cut value)
+        bool CanUseIndex16() const noexcept;
+        static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout(EMeshVertexFormat format = EMeshVertexFormat::Full) noexcept;
+        static std::uint32_t                         GetVertexStride(EMeshVertexFormat format) noexcept;
+
+    private:
+        //~ Copies mapped data into the owned vectors and drops generated LODs
+        void MakeOwnedLod0();
 
     private:
         std::string                m_name;
         std::uint32_t              m_materialIndex = 0u;
         std::vector<KFEMeshVertex> m_vertices;
         std::vector<std::uint32_t> m_indices;
+        std::vector<KFE_MESHLET>   m_meshlets;
+        std::vector<KFE_MESH_LOD>  m_lods;
+
+        //~ Views used by the renderer, point either into the vectors above or into m_pBacking
+        std::span<const KFEMeshVertex> m_vertexView;
+        std::span<const std::uint32_t> m_indexView;
+        std::span<const KFE_MESHLET>   m_meshletView;
+        std::span<const KFE_MESH_LOD>  m_lodView;
+        std::shared_ptr<const void>    m_pBacking;
 
         DirectX::XMFLOAT3          m_aabbMin;
         DirectX::XMFLOAT3          m_aabbMax;
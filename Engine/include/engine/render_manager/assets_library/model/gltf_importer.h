@@ -0,0 +1,51 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : gltf_importer.h
+ *  Purpose   : Native glTF 2.0 / GLB importer. Accessors are read straight out
+ *              of memory mapped buffers into ImportedScene, Assimp is skipped.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "assimp_importer.h"
+
+#include <cstdint>
+#include <string>
+
+namespace kfe::import
+{
+    /// <summary>
+    /// Produces the same ImportedScene the Assimp path does for a glTF file
+    /// (left handed, flipped winding, unit box vertices) without Assimp's
+    /// post processing. Normals and tangents are only generated for primitives
+    /// that do not ship them. Files using features it does not read (sparse or
+    /// quantized accessors, required compression extensions) fail, so the
+    /// caller can fall back to AssimpImporter.
+    /// </summary>
+    class KFE_API GltfImporter
+    {
+    public:
+        GltfImporter();
+        ~GltfImporter();
+
+        GltfImporter(const GltfImporter&) = delete;
+        GltfImporter& operator=(const GltfImporter&) = delete;
+        GltfImporter(GltfImporter&&) noexcept = delete;
+        GltfImporter& operator=(GltfImporter&&) noexcept = delete;
+
+        //~ .gltf or .glb extension
+        static bool CanLoad(const std::string& filePath) noexcept;
+
+        bool LoadFromFile(const std::string& filePath,
+            ImportedScene& outScene,
+            std::string& outErrorMessage) const noexcept;
+
+        //~ Stored in cooked files in place of the Assimp post process flags
+        static std::uint32_t GetImportFlags() noexcept;
+    };
+} // namespace kfe::import
@@ -14,17 +14,19 @@
 #include "engine/core.h"
 
 #include "geometry.h"
+#include "engine/render_manager/api/pool/geometry_arena.h"
 
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 #include <d3d12.h>
 
 namespace kfe
 {
     class KFEDevice;
     class KFEGraphicsCommandList;
-    class KFEStagingBuffer;
     class KFEVertexBuffer;
     class KFEIndexBuffer;
     class KFEBuffer;
@@ -35,6 +37,12 @@ namespace kfe
         ID3D12GraphicsCommandList* CommandList = nullptr;
         const KFEMeshGeometry* Geometry = nullptr;
         const char* DebugName = nullptr;
+        EMeshVertexFormat VertexFormat = EMeshVertexFormat::Full;
+        bool AllowIndex16 = true; //~ R16_UINT whenever every vertex is addressable with 16 bits
+
+        //~ Signalled once CommandList has executed, lets KFEGeometryArena recycle the upload memory
+        ID3D12Fence*  Fence      = nullptr;
+        std::uint64_t FenceValue = 0u;
     };
 
     class KFE_API KFEGpuMesh
@@ -56,18 +64,48 @@ namespace kfe
         std::uint32_t      GetVertexCount   () const noexcept;
         std::uint32_t      GetIndexCount    () const noexcept;
 
+        DXGI_FORMAT        GetIndexFormat   () const noexcept;
+        std::uint32_t      GetIndexBufferBytes() const noexcept;
+        std::uint32_t      GetVertexBufferBytes() const noexcept;
+
         const KFEVertexBuffer* GetVertexBufferView() const noexcept;
         const KFEIndexBuffer*  GetIndexBufferView () const noexcept;
 
+        EMeshVertexFormat GetVertexFormat() const noexcept;
+
+        //~ Object space transform that turns quantized positions back into mesh space,
+        //~ identity for EMeshVertexFormat::Full. Multiply it in front of the world matrix.
+        DirectX::XMMATRIX GetPositionDequantize() const noexcept;
+
+        //~ Mesh space meshlet bounds, kept on the CPU for KFEClusterCuller. Empty when
+        //~ the geometry had none, draw the whole index buffer then.
+        std::span<const KFE_MESHLET> GetMeshlets() const noexcept;
+
+        //~ Index ranges per level of detail, a single full range when no chain was built.
+        //~ Meshlets only cover LOD0.
+        std::span<const KFE_MESH_LOD> GetLods() const noexcept;
+
+        const DirectX::XMFLOAT3& GetAABBMin() const noexcept;
+        const DirectX::XMFLOAT3& GetAABBMax() const noexcept;
+
         bool IsValid() const noexcept;
 
     private:
         std::string   m_name{ "No Name" };
         std::uint32_t m_vertexCount   = 0u;
         std::uint32_t m_indexCount    = 0u;
+        bool          m_bIndex16      = false;
+
+        EMeshVertexFormat m_vertexFormat{ EMeshVertexFormat::Full };
+        DirectX::XMFLOAT3 m_aabbMin{ 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 m_aabbMax{ 1.0f, 1.0f, 1.0f };
+
+        std::vector<KFE_MESHLET>  m_meshlets;
+        std::vector<KFE_MESH_LOD> m_lods;
 
-        std::unique_ptr<KFEStagingBuffer> m_pVBStaging;
-        std::unique_ptr<KFEStagingBuffer> m_pIBStaging;
+        //~ Ranges inside the shared KFEGeometryArena pages
+        KFE_GEOMETRY_ALLOCATION           m_vbAllocation{};
+        KFE_GEOMETRY_ALLOCATION           m_ibAllocation{};
         std::unique_ptr<KFEVertexBuffer>  m_pVertexView;
         std::unique_ptr<KFEIndexBuffer>   m_pIndexView;
     };
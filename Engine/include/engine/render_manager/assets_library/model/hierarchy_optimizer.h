@@ -0,0 +1,53 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : hierarchy_optimizer.h
+ *  Purpose   : Import time node collapse and same material submesh merging,
+ *              fewer nodes to walk and fewer draws per model.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "assimp_importer.h"
+
+#include <cstdint>
+
+namespace kfe
+{
+    struct KFE_HIERARCHY_OPTIMIZE_DESC
+    {
+        bool          bCollapseNodes    = true;    //~ fold meshless nodes into their children
+        bool          bMergeSubmeshes   = true;    //~ one mesh per material, transforms baked in
+        std::uint32_t MaxMergedVertices = 65535u;  //~ per merged mesh, keeps 16 bit indices possible
+    };
+
+    struct KFE_HIERARCHY_OPTIMIZE_STATS
+    {
+        std::uint32_t NodesBefore  = 0u;
+        std::uint32_t NodesAfter   = 0u;
+        std::uint32_t MeshesBefore = 0u;
+        std::uint32_t MeshesAfter  = 0u;
+        std::uint32_t MergedMeshes = 0u;  //~ source meshes folded into a merged one
+        std::uint32_t MergeBatches = 0u;  //~ merged meshes created
+    };
+
+    /// <summary>
+    /// Imported nodes never animate, so meshless nodes only carry a transform for
+    /// their children. Collapsing pushes that transform down and drops the node.
+    /// Merging bakes each single-use mesh into root space and concatenates the
+    /// ones with the same source material (and vertex attributes) into one mesh
+    /// on the root node. Meshes referenced by more than one node stay instanced.
+    /// </summary>
+    class KFE_API KFEHierarchyOptimizer
+    {
+    public:
+        //~ Returns true when the scene changed
+        static bool Optimize(import::ImportedScene& scene,
+                             const KFE_HIERARCHY_OPTIMIZE_DESC& desc = {},
+                             KFE_HIERARCHY_OPTIMIZE_STATS* outStats = nullptr) noexcept;
+    };
+}
@@ -13,15 +13,26 @@
 #include "geometry.h"
 #include "gpu_mesh.h"
 #include "assimp_importer.h"
+#include "gltf_importer.h"
+#include "mesh_cooker.h"
+#include "hierarchy_optimizer.h"
+#include "mesh_optimizer.h"
 #include "engine/system/common_types.h"
 #include "engine/system/interface/interface_singleton.h"
 
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <d3d12.h>
+#include <wrl/client.h>
 namespace kfe
 {
     class KFEDevice;
@@ -30,10 +41,27 @@ namespace kfe
 
     struct KFE_MESH_CACHE_ENTRY;
 
+    //~ What a cache entry keeps on the CPU once its GPU upload has completed
+    enum class EMeshCPURetention : std::uint8_t
+    {
+        All = 0,    //~ imported scene and geometry stay, for tools that re-read them
+        Hierarchy,  //~ node tree, mesh names and AABBs only
+        Collision,  //~ Hierarchy plus a LOD0 position/index copy per mesh
+    };
+
+    //~ Mesh space positions and triangle list, nothing else
+    struct KFE_MESH_COLLISION_DATA
+    {
+        std::vector<DirectX::XMFLOAT3> Positions;
+        std::vector<std::uint32_t>     Indices;
+    };
+
     struct KFE_MESH_CACHE_SHARE
     {
         KFE_MESH_CACHE_ENTRY* Entry = nullptr;
         std::uint32_t         MeshCount = 0u;
+        std::uint32_t         RefCount = 0u;  //~ live KFEMeshCacheHandle copies
+        std::uint64_t         LastUsed = 0u;  //~ cache tick of the last acquire/release, orders the LRU
 
         bool IsValid() const noexcept
         {
@@ -44,8 +72,18 @@ namespace kfe
     struct KFE_MESH_CACHE_ENTRY
     {
         std::unique_ptr<import::ImportedScene>        SceneCPU;
-        std::vector<std::unique_ptr<KFEMeshGeometry>> MeshesCPU;
-        std::vector<std::unique_ptr<KFEGpuMesh>>      MeshesGPU;
+        //~ Shared, identical meshes of other entries (or of this one) point at the same objects
+        std::vector<std::shared_ptr<KFEMeshGeometry>> MeshesCPU;
+        std::vector<std::shared_ptr<KFEGpuMesh>>      MeshesGPU;
+        std::vector<std::uint64_t>                    MeshHashes;     //~ content hash per mesh, from the CPU build
+        std::vector<std::uint64_t>                    MeshDigests;    //~ second, independent hash of the same bytes
+        EMeshVertexFormat                             VertexFormat{ EMeshVertexFormat::Full };
+        std::uint32_t                                 SharedMeshes = 0u;  //~ reused instead of uploaded
+        std::uint64_t                                 CPUBytes = 0u;  //~ imported scene + geometry, shared meshes included
+        std::uint64_t                                 GPUBytes = 0u;  //~ vertex + index buffer ranges, shared meshes included
+        std::vector<KFE_MESH_COLLISION_DATA>          CollisionCPU;   //~ per mesh, EMeshCPURetention::Collision only
+        EMeshCPURetention                             Retention{ EMeshCPURetention::All };
+        bool                                          bCPUTrimmed = false;  //~ bulk arrays already released
 
         bool IsValid() const noexcept
         {
@@ -62,8 +100,84 @@ namespace kfe
         }
     };
 
+    struct KFE_MESH_CACHE_STATS
+    {
+        std::uint32_t Models          = 0u;
+        std::uint32_t Meshes          = 0u;
+        std::uint32_t Index16Meshes   = 0u;  //~ uploaded as R16_UINT
+        std::uint32_t Index32Meshes   = 0u;
+        std::uint64_t IndexBytes      = 0u;
+        std::uint64_t IndexBytesSaved = 0u;  //~ compared to uploading every mesh as R32_UINT
+        std::uint32_t Unreferenced    = 0u;  //~ models on the LRU list, evictable
+        std::uint64_t CPUBytes        = 0u;
+        std::uint64_t GPUBytes        = 0u;
+        std::uint64_t CPUBudget       = 0u;
+        std::uint64_t GPUBudget       = 0u;
+        std::uint32_t Evictions       = 0u;  //~ since startup
+        std::uint32_t SharedMeshes    = 0u;  //~ mesh slots resolved to an identical mesh
+        std::uint64_t DedupCPUBytesSaved = 0u;
+        std::uint64_t DedupGPUBytesSaved = 0u;
+        std::uint32_t TrimmedModels      = 0u;  //~ cached models whose CPU copies were released
+        std::uint32_t PendingTrims       = 0u;  //~ waiting on their upload fence
+        std::uint64_t TrimmedCPUBytes    = 0u;  //~ released since startup, the resident set saving
+    };
+
+    //~ One row per cached model, for the editor/monitoring
+    struct KFE_MESH_CACHE_ENTRY_INFO
+    {
+        std::string   Key;
+        std::uint32_t MeshCount = 0u;
+        std::uint32_t SharedMeshes = 0u;
+        std::uint32_t RefCount  = 0u;
+        std::uint64_t CPUBytes  = 0u;
+        std::uint64_t GPUBytes  = 0u;
+        EMeshCPURetention Retention{ EMeshCPURetention::All };
+        bool          bCPUTrimmed = false;
+    };
+
+    //~ Zero means unlimited. Unreferenced models are kept until either total is exceeded.
+    struct KFE_MESH_CACHE_BUDGET
+    {
+        std::uint64_t CPUBytes = 512ull << 20;
+        std::uint64_t GPUBytes = 512ull << 20;
+    };
+
+    /// <summary>
+    /// Counted reference to a cached model. Copies add a reference, destruction or
+    /// Reset drops it. When the last one goes the model moves to the LRU list and
+    /// is unloaded once the cache is over budget.
+    /// </summary>
+    class KFE_API KFEMeshCacheHandle
+    {
+        friend class KFEMeshCache;
+    public:
+         KFEMeshCacheHandle() noexcept = default;
+        ~KFEMeshCacheHandle() noexcept;
+
+        KFEMeshCacheHandle(const KFEMeshCacheHandle& other) noexcept;
+        KFEMeshCacheHandle(KFEMeshCacheHandle&& other) noexcept;
+
+        KFEMeshCacheHandle& operator=(const KFEMeshCacheHandle& other) noexcept;
+        KFEMeshCacheHandle& operator=(KFEMeshCacheHandle&& other) noexcept;
+
+        void Reset() noexcept;
+
+        NODISCARD const KFE_MESH_CACHE_SHARE* Get() const noexcept { return m_pShare; }
+        NODISCARD bool IsValid() const noexcept { return m_pShare && m_pShare->IsValid(); }
+
+        const KFE_MESH_CACHE_SHARE* operator->() const noexcept { return m_pShare; }
+        explicit operator bool() const noexcept { return IsValid(); }
+
+    private:
+        explicit KFEMeshCacheHandle(KFE_MESH_CACHE_SHARE* share) noexcept;
+
+    private:
+        KFE_MESH_CACHE_SHARE* m_pShare = nullptr;
+    };
+
     class KFE_API KFEMeshCache final : public ISingleton<KFEMeshCache>
     {
+        friend class KFEMeshCacheHandle;
     public:
         KFEMeshCache();
         ~KFEMeshCache();
@@ -79,24 +193,201 @@ namespace kfe
             KFEDevice* device,
             ID3D12GraphicsCommandList* cmdList,
             KFEResourceHeap* resourceHeap,
-            KFE_MESH_CACHE_SHARE*& outShare) noexcept;
+            KFEMeshCacheHandle& outHandle,
+            EMeshVertexFormat vertexFormat = EMeshVertexFormat::Full,
+            ID3D12Fence* fence = nullptr,
+            std::uint64_t fenceValue = 0u) noexcept;
+
+        //~ Imports and builds CPU geometry for every path on a worker pool and blocks
+        //~ until all of them are done. Duplicate paths, paths already cached in vertexFormat
+        //~ and paths already being prefetched are skipped. GetOrCreate then only does the GPU upload.
+        //~ Returns the number of paths that were prepared successfully.
+        std::uint32_t PrefetchCPU(const std::vector<std::string>& paths,
+            EMeshVertexFormat vertexFormat = EMeshVertexFormat::Full) noexcept;
+
+        //~ Same as PrefetchCPU but queues the imports on the streaming workers and
+        //~ returns right away. Poll RequestCPU to know when a path is done.
+        void PrefetchCPUAsync(const std::vector<std::string>& paths) noexcept;
+
+        //~ True once GetOrCreate for this path will not import on the calling thread:
+        //~ the model is cached or its background import finished. A failed import is
+        //~ remembered, GetOrCreate then returns false without importing again until the
+        //~ path is prefetched explicitly. Otherwise queues the import and returns false.
+        NODISCARD bool RequestCPU(const std::string& path,
+            EMeshVertexFormat vertexFormat = EMeshVertexFormat::Full) noexcept;
+
+        //~ Triangle/vertex reordering applied after an Assimp import, before cooking.
+        //~ Set it before loading; cooked files built with other settings are rebuilt.
+        void SetImportOptimization(bool enabled, const KFE_MESH_OPTIMIZE_DESC& desc = {}) noexcept;
+
+        //~ Meshlets (see meshlet.h) built after optimization and stored in the cook.
+        //~ The renderer uses them for CPU cluster culling.
+        void SetImportMeshlets(bool enabled, const KFE_MESHLET_BUILD_DESC& desc = {}) noexcept;
 
+        //~ Simplified LOD index ranges built last and stored in the cook
+        void SetImportLods(bool enabled, const KFE_MESH_LOD_DESC& desc = {}) noexcept;
+
+        //~ Node collapse and same material submesh merging right after import.
+        //~ Off by default: merging renumbers submeshes, which saved scenes key on.
+        void SetImportHierarchyOptimization(bool enabled, const KFE_HIERARCHY_OPTIMIZE_DESC& desc = {}) noexcept;
+
+        //~ Meshes with byte-identical vertices and indices share one geometry and one
+        //~ GPU mesh, across models too. Only affects models loaded afterwards.
+        void SetGeometryDedup(bool enabled) noexcept;
+
+        //~ Engine (default) or Assimp normal/tangent generation, set before loading
+        void SetTangentSpace(import::EImportTangentSpace mode) noexcept;
+
+        //~ Policy for models loaded afterwards, Hierarchy by default. The bulk CPU
+        //~ arrays are released once the upload fence passed to GetOrCreate completes.
+        void SetCPURetention(EMeshCPURetention retention) noexcept;
+        NODISCARD EMeshCPURetention GetCPURetention() const noexcept;
+
+        //~ Per model override. Tightens an already cached model right away; a model
+        //~ that was trimmed cannot get its data back without being reloaded.
+        void SetCPURetention(const std::string& path,
+            EMeshCPURetention retention,
+            EMeshVertexFormat vertexFormat = EMeshVertexFormat::Full) noexcept;
+
+        //~ Releases CPU copies of models whose upload fence has completed.
+        //~ GetOrCreate calls it too. Returns the number of models trimmed.
+        std::uint32_t TrimUploadedCPU() noexcept;
+
+        //~ Evicts unreferenced models right away if the new budget is already exceeded
+        void SetBudget(const KFE_MESH_CACHE_BUDGET& budget) noexcept;
+        NODISCARD const KFE_MESH_CACHE_BUDGET& GetBudget() const noexcept;
+
+        NODISCARD KFE_MESH_CACHE_STATS GetStats() const noexcept;
+        NODISCARD std::vector<KFE_MESH_CACHE_ENTRY_INFO> GetEntryInfo() const noexcept;
+
+        //~ Unloads unreferenced models oldest first until both totals fit the budget.
+        //~ Returns the number of models unloaded.
+        std::uint32_t EvictUnused() noexcept;
+
+        //~ Drops every unreferenced model and pending prefetch. Models still held
+        //~ by a handle stay, their handles would dangle otherwise.
         void Clear() noexcept;
 
     private:
+        void AddRef (KFE_MESH_CACHE_SHARE* share) noexcept;
+        void Release(KFE_MESH_CACHE_SHARE* share) noexcept;
+
+        void EraseEntry(const std::string& key) noexcept;
+
+        //~ Totals count every shared mesh once, also drops dead dedup slots
+        void RecountBytes() noexcept;
+
+        static std::uint64_t ComputeCPUBytes(const KFE_MESH_CACHE_ENTRY& entry) noexcept;
+
+        //~ Applies entry.Retention, returns the bytes released
+        static std::uint64_t TrimEntryCPU(KFE_MESH_CACHE_ENTRY& entry) noexcept;
+        static std::uint64_t ComputeGPUBytes(const KFE_MESH_CACHE_ENTRY& entry) noexcept;
+
+        //~ Fills entry.MeshHashes and entry.MeshDigests, thread safe
+        static void HashMeshes(KFE_MESH_CACHE_ENTRY& entry) noexcept;
+
+        //~ Live mesh with the same content and vertex format, or an empty slot
+        struct DedupSlot
+        {
+            std::weak_ptr<KFEMeshGeometry> Geometry;
+            std::weak_ptr<KFEGpuMesh>      Mesh;
+            EMeshVertexFormat              VertexFormat{ EMeshVertexFormat::Full };
+            std::uint64_t                  Digest{ 0u }; //~ compared instead of the bytes once Geometry is gone
+        };
+
+        NODISCARD DedupSlot* FindDuplicate(std::uint64_t hash,
+            std::uint64_t digest,
+            const KFEMeshGeometry& geometry,
+            EMeshVertexFormat vertexFormat) noexcept;
+
+        //~ The same model can be cached once per vertex format
+        static std::string MakeCacheKey(const std::string& path, EMeshVertexFormat vertexFormat);
+
+        //~ Parameters of the enabled build passes, a cooked file built with others is stale
+        NODISCARD std::uint64_t GetBuildHash() const noexcept;
+
         //~ Build helpers
+        //~ Thread safe, only touches the stateless importer and cooker
         bool BuildEntryCPU(const std::string& path,
+            KFE_MESH_CACHE_ENTRY& entry) const noexcept;
+
+        enum class EPrefetchResult : std::uint8_t
+        {
+            None,   //~ never prefetched, import on the calling thread
+            Ready,
+            Failed  //~ the background import failed, do not import again here
+        };
+
+        //~ Moves a prefetched CPU entry out, waiting on it if still in flight
+        EPrefetchResult TakePrefetchedCPU(const std::string& path,
             KFE_MESH_CACHE_ENTRY& entry) noexcept;
 
         bool BuildEntryGPU(KFEDevice* device,
             ID3D12GraphicsCommandList* cmdList,
             KFEResourceHeap* resourceHeap,
             const std::string& path,
+            EMeshVertexFormat vertexFormat,
+            ID3D12Fence* fence,
+            std::uint64_t fenceValue,
             KFE_MESH_CACHE_ENTRY& entry) noexcept;
 
     private:
         std::unordered_map<std::string, KFE_MESH_CACHE_ENTRY> m_cache;
         std::unordered_map<std::string, KFE_MESH_CACHE_SHARE> m_shares;
         import::AssimpImporter                                m_importer;
+        import::GltfImporter                                  m_gltfImporter;
+        KFEMeshCooker                                         m_cooker;
+        KFE_MESH_OPTIMIZE_DESC                                m_optimizeDesc{};
+        bool                                                  m_bOptimizeOnImport{ true };
+        KFE_MESHLET_BUILD_DESC                                m_meshletDesc{};
+        bool                                                  m_bBuildMeshlets{ true };
+        KFE_MESH_LOD_DESC                                     m_lodDesc{};
+        bool                                                  m_bBuildLods{ true };
+        KFE_HIERARCHY_OPTIMIZE_DESC                           m_hierarchyDesc{};
+        bool                                                  m_bOptimizeHierarchy{ false };
+        KFE_MESH_CACHE_BUDGET                                 m_budget{};
+        std::uint64_t                                         m_cpuBytes{ 0u };
+        std::uint64_t                                         m_gpuBytes{ 0u };
+        std::uint64_t                                         m_dedupCPUBytesSaved{ 0u };
+        std::uint64_t                                         m_dedupGPUBytesSaved{ 0u };
+        bool                                                  m_bDedupGeometry{ true };
+        std::unordered_multimap<std::uint64_t, DedupSlot>     m_dedup;
+        std::uint64_t                                         m_tick{ 0u };
+        std::uint32_t                                         m_evictions{ 0u };
+
+        struct PendingTrim
+        {
+            std::string                         Key;
+            Microsoft::WRL::ComPtr<ID3D12Fence> Fence;
+            std::uint64_t                       FenceValue = 0u;
+        };
+
+        EMeshCPURetention                                     m_retention{ EMeshCPURetention::Hierarchy };
+        std::unordered_map<std::string, EMeshCPURetention>    m_retentionOverrides;
+        std::vector<PendingTrim>                              m_pendingTrims;
+        std::uint64_t                                         m_trimmedCPUBytes{ 0u };
+
+        //~ Prefetched CPU entries, nullptr when the import failed
+        using PrefetchFuture = std::shared_future<std::shared_ptr<KFE_MESH_CACHE_ENTRY>>;
+
+        std::mutex                                      m_prefetchMutex;
+        std::unordered_map<std::string, PrefetchFuture> m_prefetched;
+        std::unordered_set<std::string>                 m_failedImports;  //~ cleared by PrefetchCPU(Async) and Clear
+
+        //~ Background imports for PrefetchCPUAsync/RequestCPU
+        struct StreamJob
+        {
+            std::string                                         Path;
+            std::promise<std::shared_ptr<KFE_MESH_CACHE_ENTRY>> Promise;
+        };
+
+        //~ Registers paths in m_prefetched and hands them to the workers
+        void QueueStreamJobs(const std::vector<std::string>& paths) noexcept;
+        void StreamWorker(std::stop_token stop) noexcept;
+
+        std::mutex                  m_streamMutex;
+        std::condition_variable_any m_streamCv;
+        std::deque<StreamJob>       m_streamJobs;
+        std::vector<std::jthread>   m_streamWorkers;  //~ last member, joined first
     };
 }
@@ -0,0 +1,130 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mesh_cooker.h
+ *  Purpose   : Versioned, memory mappable .kfmesh format so imported models
+ *              skip Assimp on every launch.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "engine/core.h"
+#include "assimp_importer.h"
+#include "geometry.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kfe
+{
+    inline constexpr std::uint32_t KFE_KFMESH_MAGIC     = 0x48534D4Bu; //~ "KMSH"
+    inline constexpr std::uint32_t KFE_KFMESH_VERSION   = 6u;
+    inline constexpr const char*   KFE_KFMESH_EXTENSION = ".kfmesh";
+
+    //~ Engine side processing baked into the payload, part of the cache key
+    inline constexpr std::uint32_t KFE_KFMESH_BUILD_OPTIMIZED = 1u << 0;
+    inline constexpr std::uint32_t KFE_KFMESH_BUILD_MESHLETS  = 1u << 1;
+    inline constexpr std::uint32_t KFE_KFMESH_BUILD_LODS      = 1u << 2;
+    inline constexpr std::uint32_t KFE_KFMESH_BUILD_COLLAPSED = 1u << 3;
+
+    //~ On disk layout:
+    //~ [Header][Mesh records][Node records][Node mesh indices][String table][Vertex/Index/Meshlet/LOD payloads]
+    //~ Every payload is 16 byte aligned so it can be viewed straight from the mapping.
+    struct KFE_KFMESH_HEADER
+    {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t ImportFlags;
+        std::uint32_t VertexStride;
+
+        std::int64_t  SourceWriteTime;
+        std::uint64_t SourceSize;
+
+        std::uint32_t MeshCount;
+        std::uint32_t NodeCount;
+        std::uint32_t NodeMeshIndexCount;
+        std::uint32_t BuildFlags;
+
+        std::uint64_t MeshTableOffset;
+        std::uint64_t NodeTableOffset;
+        std::uint64_t NodeMeshIndexOffset;
+        std::uint64_t StringTableOffset;
+        std::uint64_t StringTableSize;
+        std::uint64_t FileSize;
+
+        std::uint64_t BuildHash; //~ parameters of the passes in BuildFlags
+    };
+
+    struct KFE_KFMESH_MESH_RECORD
+    {
+        std::uint32_t NameOffset;
+        std::uint32_t NameLength;
+        std::uint32_t VertexCount;
+        std::uint32_t IndexCount;
+
+        std::uint64_t VertexOffset;
+        std::uint64_t IndexOffset;
+        std::uint64_t MeshletOffset;
+        std::uint64_t LodOffset;
+
+        std::uint32_t MeshletCount;
+        std::uint32_t LodCount;
+        float AABBMin[3];
+        float AABBMax[3];
+
+        std::uint32_t MaterialIndex;
+        std::uint32_t _Pad0;
+    };
+
+    //~ Nodes are stored breadth first, children of a node are contiguous
+    struct KFE_KFMESH_NODE_RECORD
+    {
+        std::uint32_t NameOffset;
+        std::uint32_t NameLength;
+
+        float LocalTransform[16];
+
+        std::uint32_t FirstMeshIndex;
+        std::uint32_t MeshIndexCount;
+        std::uint32_t FirstChild;
+        std::uint32_t ChildCount;
+    };
+
+    class KFE_API KFEMeshCooker
+    {
+    public:
+        KFEMeshCooker();
+        ~KFEMeshCooker();
+
+        KFEMeshCooker(const KFEMeshCooker&) = delete;
+        KFEMeshCooker& operator=(const KFEMeshCooker&) = delete;
+        KFEMeshCooker(KFEMeshCooker&&) noexcept = delete;
+        KFEMeshCooker& operator=(KFEMeshCooker&&) noexcept = delete;
+
+        static std::string GetCookedPath(const std::string& sourcePath);
+
+        //~ Maps the cooked file if it matches the source timestamp/size, import and build flags
+        //~ and the hash of the build parameters.
+        //~ outScene receives names, AABBs and the node hierarchy only; vertex data stays
+        //~ in the mapping and is referenced by outMeshes.
+        NODISCARD bool LoadCooked(const std::string& sourcePath,
+            std::uint32_t importFlags,
+            std::uint32_t buildFlags,
+            std::uint64_t buildHash,
+            import::ImportedScene& outScene,
+            std::vector<std::shared_ptr<KFEMeshGeometry>>& outMeshes) const noexcept;
+
+        NODISCARD bool SaveCooked(const std::string& sourcePath,
+            std::uint32_t importFlags,
+            std::uint32_t buildFlags,
+            std::uint64_t buildHash,
+            const import::ImportedScene& scene,
+            const std::vector<std::shared_ptr<KFEMeshGeometry>>& meshes) const noexcept;
+    };
+}
@@ -0,0 +1,82 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mesh_lod.h
+ *  Purpose   : Quadric error metric simplifier that builds index-only LOD
+ *              chains over a shared vertex buffer, plus screen space LOD
+ *              selection.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace kfe
+{
+    struct KFEMeshVertex;
+
+    //~ One level of detail, a range of the mesh index buffer.
+    //~ Stored as is in .kfmesh files, keep it POD.
+    struct KFE_MESH_LOD
+    {
+        std::uint32_t IndexOffset;
+        std::uint32_t IndexCount;
+        float         Error;  //~ geometric error relative to the mesh AABB diagonal, 0 for LOD0
+        std::uint32_t _Pad0;
+    };
+
+    struct KFE_MESH_LOD_DESC
+    {
+        std::uint32_t LodCount     = 4u;     //~ including LOD0
+        float         Reduction    = 0.5f;   //~ target triangle ratio between consecutive levels
+        float         MaxError     = 0.05f;  //~ relative, levels above it are not generated
+        std::uint32_t MinTriangles = 64u;    //~ no level below this
+        std::uint32_t CacheSize    = 16u;    //~ vertex cache order for every generated level
+    };
+
+    struct KFE_MESH_LOD_SELECT_DESC
+    {
+        DirectX::XMFLOAT3 CameraPosition{ 0.0f, 0.0f, 0.0f }; //~ world space
+        float             FovY          = DirectX::XM_PIDIV4;
+        float             ViewportHeight = 1080.0f;
+        float             MaxPixelError = 1.0f;
+    };
+
+    class KFE_API KFEMeshSimplifier
+    {
+    public:
+        //~ Edge collapse towards existing vertices, so the result indexes the same vertex
+        //~ buffer. Border and UV/normal seam vertices never move. Stops at targetIndexCount
+        //~ or when the next collapse would exceed targetError (relative to the AABB diagonal).
+        static bool Simplify(std::span<const KFEMeshVertex> vertices,
+                             std::span<const std::uint32_t> indices,
+                             std::uint32_t                  targetIndexCount,
+                             float                          targetError,
+                             std::vector<std::uint32_t>&    outIndices,
+                             float*                         outError = nullptr) noexcept;
+
+        //~ indices holds LOD0 on input; generated levels are appended behind it.
+        //~ outLods[0] always describes LOD0.
+        static bool BuildLodChain(std::span<const KFEMeshVertex> vertices,
+                                  std::vector<std::uint32_t>&    indices,
+                                  const KFE_MESH_LOD_DESC&       desc,
+                                  std::vector<KFE_MESH_LOD>&     outLods) noexcept;
+
+        //~ Coarsest level whose error, projected with the AABB bounding sphere, stays
+        //~ under MaxPixelError. world is row vector (DirectXMath convention).
+        static std::uint32_t SelectLod(std::span<const KFE_MESH_LOD>   lods,
+                                       const DirectX::XMFLOAT3&        aabbMin,
+                                       const DirectX::XMFLOAT3&        aabbMax,
+                                       const DirectX::XMMATRIX&        world,
+                                       const KFE_MESH_LOD_SELECT_DESC& desc) noexcept;
+    };
+}
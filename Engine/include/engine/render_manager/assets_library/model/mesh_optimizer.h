@@ -0,0 +1,81 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mesh_optimizer.h
+ *  Purpose   : Triangle/vertex reordering for post-transform cache reuse,
+ *              overdraw and vertex fetch locality.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "geometry.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace kfe
+{
+    struct KFE_MESH_OPTIMIZE_DESC
+    {
+        std::uint32_t CacheSize         = 16u;   //~ simulated FIFO post-transform cache
+        bool          OptimizeOverdraw  = true;
+        float         OverdrawThreshold = 1.05f; //~ max ACMR growth accepted for overdraw order
+        bool          OptimizeFetch     = true;
+    };
+
+    struct KFE_MESH_OPTIMIZE_STATS
+    {
+        float ACMRBefore = 0.0f; //~ transformed vertices per triangle, lower is better (0.5 ideal)
+        float ACMRAfter  = 0.0f;
+        float ATVRBefore = 0.0f; //~ transformed vertices per unique vertex, 1.0 ideal
+        float ATVRAfter  = 0.0f;
+
+        std::uint32_t ClusterCount        = 0u;
+        std::uint32_t UnreferencedRemoved = 0u;
+        bool          OverdrawApplied     = false;
+    };
+
+    class KFE_API KFEMeshOptimizer
+    {
+    public:
+        //~ FIFO cache simulation
+        static float ComputeACMR(std::span<const std::uint32_t> indices,
+                                 std::uint32_t                  vertexCount,
+                                 std::uint32_t                  cacheSize) noexcept;
+
+        static float ComputeATVR(std::span<const std::uint32_t> indices,
+                                 std::uint32_t                  vertexCount,
+                                 std::uint32_t                  cacheSize) noexcept;
+
+        //~ Tipsify (Sander et al. 2007). outClusters receives the first triangle of every
+        //~ cluster, a new cluster starts whenever the fan hits a dead end.
+        static void OptimizeVertexCache(std::span<std::uint32_t>    indices,
+                                        std::uint32_t               vertexCount,
+                                        std::uint32_t               cacheSize,
+                                        std::vector<std::uint32_t>* outClusters = nullptr);
+
+        //~ Sorts clusters so outward facing ones draw first. Keeps the input order when
+        //~ the result would push ACMR above threshold * current ACMR.
+        static bool OptimizeOverdraw(std::span<std::uint32_t>       indices,
+                                     std::span<const KFEMeshVertex> vertices,
+                                     std::span<const std::uint32_t> clusters,
+                                     std::uint32_t                  cacheSize,
+                                     float                          threshold);
+
+        //~ Renumbers vertices in first use order and drops unreferenced ones.
+        //~ Returns the number of vertices removed.
+        static std::uint32_t OptimizeVertexFetch(std::vector<KFEMeshVertex>& vertices,
+                                                 std::span<std::uint32_t>    indices);
+
+        //~ Full pass: vertex cache, then overdraw, then fetch
+        static bool Optimize(std::vector<KFEMeshVertex>&  vertices,
+                             std::vector<std::uint32_t>&  indices,
+                             const KFE_MESH_OPTIMIZE_DESC& desc,
+                             KFE_MESH_OPTIMIZE_STATS*      outStats = nullptr) noexcept;
+    };
+}
@@ -0,0 +1,106 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : meshlet.h
+ *  Purpose   : Meshlet (cluster) partitioning with bounding spheres and
+ *              normal cones, plus a CPU cluster culler that emits index
+ *              ranges for DrawIndexedInstanced.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace kfe
+{
+    struct KFEMeshVertex;
+
+    //~ Triangles of a meshlet are contiguous in the mesh index buffer.
+    //~ Stored as is in .kfmesh files, keep it POD.
+    struct KFE_MESHLET
+    {
+        DirectX::XMFLOAT3 Center;        //~ bounding sphere, mesh space
+        float             Radius;
+
+        DirectX::XMFLOAT3 ConeApex;      //~ backface cone, cull when
+        float             ConeCutoff;    //~ dot(normalize(apex - eye), axis) >= cutoff
+        DirectX::XMFLOAT3 ConeAxis;      //~ cutoff 1 => cone disabled
+
+        std::uint32_t     IndexOffset;
+        std::uint32_t     TriangleCount;
+        std::uint32_t     VertexCount;
+    };
+
+    struct KFE_MESHLET_BUILD_DESC
+    {
+        std::uint32_t MaxVertices  = 64u;
+        std::uint32_t MaxTriangles = 124u;
+        float         ConeWeight   = 0.5f; //~ 0 = only vertex reuse, higher = tighter normal cones
+    };
+
+    struct KFE_MESHLET_BUILD_STATS
+    {
+        std::uint32_t MeshletCount      = 0u;
+        float         AverageVertices   = 0.0f;
+        float         AverageTriangles  = 0.0f;
+        std::uint32_t ConesDisabled     = 0u;
+        double        BuildMilliseconds = 0.0;
+    };
+
+    //~ One contiguous DrawIndexedInstanced
+    struct KFE_DRAW_RANGE
+    {
+        std::uint32_t IndexOffset = 0u;
+        std::uint32_t IndexCount  = 0u;
+    };
+
+    struct KFE_CLUSTER_CULL_DESC
+    {
+        //~ Mesh space to clip space (row vector, DirectXMath convention)
+        DirectX::XMFLOAT4X4 MeshToClip{};
+        DirectX::XMFLOAT3   CameraPosition{ 0.0f, 0.0f, 0.0f }; //~ mesh space
+        bool                FrustumCull  = true;
+        bool                BackfaceCull = true;  //~ only valid for rigid / uniform scale transforms
+    };
+
+    struct KFE_CLUSTER_CULL_STATS
+    {
+        std::uint32_t Tested           = 0u;
+        std::uint32_t FrustumCulled    = 0u;
+        std::uint32_t BackfaceCulled   = 0u;
+        std::uint32_t DrawRanges       = 0u;
+        std::uint32_t VisibleTriangles = 0u;
+        double        CullMicroseconds = 0.0;
+    };
+
+    class KFE_API KFEMeshletBuilder
+    {
+    public:
+        //~ Greedy growth over shared vertices, seeded in the current index order.
+        //~ Rewrites indices so every meshlet is a contiguous range.
+        static bool Build(std::span<const KFEMeshVertex> vertices,
+                          std::vector<std::uint32_t>&    indices,
+                          const KFE_MESHLET_BUILD_DESC&  desc,
+                          std::vector<KFE_MESHLET>&      outMeshlets,
+                          KFE_MESHLET_BUILD_STATS*       outStats = nullptr) noexcept;
+    };
+
+    class KFE_API KFEClusterCuller
+    {
+    public:
+        //~ Visible meshlets that are neighbours in the index buffer are merged into one range
+        static void Cull(std::span<const KFE_MESHLET>   meshlets,
+                         const KFE_CLUSTER_CULL_DESC&   desc,
+                         std::vector<KFE_DRAW_RANGE>&   outRanges,
+                         KFE_CLUSTER_CULL_STATS*        outStats = nullptr) noexcept;
+    };
+}
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <d3d12.h>
 
 #include "engine/render_manager/api/buffer/buffer.h"
@@ -242,6 +243,34 @@ namespace kfe
         Count
     };
 
+    //~ Cooked block format family per slot, the shaders read single channel slots as .r
+    inline ETextureUsage GetTextureUsage(EModelTextureSlot slot) noexcept
+    {
+        switch (slot)
+        {
+        case EModelTextureSlot::Normal:
+        case EModelTextureSlot::DetailNormal:
+            return ETextureUsage::Normal;
+
+        case EModelTextureSlot::Roughness:
+        case EModelTextureSlot::Metallic:
+        case EModelTextureSlot::Occlusion:
+        case EModelTextureSlot::Opacity:
+        case EModelTextureSlot::Height:
+        case EModelTextureSlot::Displacement:
+        case EModelTextureSlot::Glossiness:
+            return ETextureUsage::Single;
+
+        //~ Linear data, only albedo and emissive take the sRGB path
+        case EModelTextureSlot::ORM:
+        case EModelTextureSlot::Specular:
+            return ETextureUsage::Data;
+
+        default:
+            return ETextureUsage::Color;
+        }
+    }
+
     struct ModelTextureMetaInformation
     {
         struct BaseColorTexture
@@ -329,7 +358,7 @@ namespace kfe
             float IsOcclusionAttached{ 0.0f };
             float IsRoughnessAttached{ 0.0f };
             float IsMetallicAttached{ 0.0f };
-            float _Pad0{ 0.0f };
+            float IsORMPacked{ 0.0f };  //~ written at bind time, the ORM map holds the three above
 
             float OcclusionStrength{ 1.0f };
             float RoughnessValue{ 1.0f };
@@ -351,8 +380,14 @@ namespace kfe
         float UseForcedMip{ 0.0f };
         float _Pad0{ 0.0f };
         float _Pad1{ 0.0f };
+
+        //~ Texture2DArray slice per EModelTextureSlot, written at bind time
+        float ArraySlice[16]{};
     };
 
+    static_assert(static_cast<std::size_t>(EModelTextureSlot::Count) <= 16u,
+        "ModelTextureMetaInformation::ArraySlice holds 16 slots");
+
     struct KFEModelSubmesh
     {
         std::string   Name{};
@@ -370,6 +405,8 @@ namespace kfe
             KFETextureSRV* TextureSrv{ nullptr };
             std::uint32_t  ResourceHandle{ KFE_INVALID_INDEX };
             std::uint32_t  ReservedSlot{ KFE_INVALID_INDEX };
+            std::uint32_t  StreamHandle{ KFE_INVALID_INDEX };
+            std::uint32_t  ArraySlice{ 0u };
             bool           Dirty{ false };
 
             void Reset() noexcept
@@ -378,13 +415,41 @@ namespace kfe
                 TextureSrv = nullptr;
                 ResourceHandle = KFE_INVALID_INDEX;
                 ReservedSlot = KFE_INVALID_INDEX;
+                StreamHandle = KFE_INVALID_INDEX;
+                ArraySlice = 0u;
                 Dirty = false;
             }
         };
 
         std::array<SrvData, static_cast<std::size_t>(EModelTextureSlot::Count)> m_srvs;
         std::uint32_t m_baseSrvIndex{ KFE_INVALID_INDEX };
+        bool          m_bTableBound{ false };  //~ the current table was written, frames may read it
+
+        //~ Replaced SRV tables, freed once the frame that last bound them retires
+        struct RetiredTable
+        {
+            std::uint32_t Base{ KFE_INVALID_INDEX };
+            ID3D12Fence*  Fence{ nullptr };
+            std::uint64_t FenceValue{ 0u };
+        };
+        std::vector<RetiredTable> m_retiredTables;
         bool          m_bTextureDirty{ true };
+        std::uint64_t m_textureGeneration{ 0u };
+
+        //~ Separate occlusion/roughness/metallic maps bound as one ORM texture. The slots
+        //~ keep the user's paths, only what gets bound and the meta CB copy change.
+        struct ORMPackMeta
+        {
+            float Attached[3]{};
+            float Tiling[6]{};
+
+            bool operator==(const ORMPackMeta&) const = default;
+        };
+
+        std::string     m_packedORMPath{};
+        KFE_ORM_SOURCES m_packedORMSources{};  //~ last triplet requested from the pool
+        ORMPackMeta     m_packedORMMeta{};     //~ meta CanPackORM saw last time
+        bool            m_bORMPending{ false };
 
         KFEModelSubmesh() noexcept
         {
@@ -408,6 +473,7 @@ namespace kfe
                 return false;
 
             m_baseSrvIndex = base;
+            m_bTableBound = false;
 
             for (std::size_t i = 0; i < count; ++i)
             {
@@ -420,11 +486,61 @@ namespace kfe
             return true;
         }
 
+        static void FreeTable(KFEResourceHeap* heap, std::uint32_t base) noexcept
+        {
+            for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(EModelTextureSlot::Count); ++i)
+                (void)heap->Free(base + i);
+        }
+
+        void FreeRetiredTables(KFEResourceHeap* heap, bool bAll) noexcept
+        {
+            std::erase_if(m_retiredTables, [heap, bAll](const RetiredTable& t) noexcept
+                {
+                    if (!bAll && t.Fence && t.Fence->GetCompletedValue() < t.FenceValue)
+                        return false;
+
+                    FreeTable(heap, t.Base);
+                    return true;
+                });
+        }
+
+        //~ Descriptors a frame in flight reads are never rewritten. A rebind after the
+        //~ table was used writes a fresh copy and retires the old one on the frame fence.
+        void RotateTable(KFEDevice* device, KFEResourceHeap* heap, ID3D12Fence* fence, std::uint64_t fenceValue) noexcept
+        {
+            const std::uint32_t count = static_cast<std::uint32_t>(EModelTextureSlot::Count);
+
+            const std::uint32_t base = heap->Allocate(count);
+            if (base == KFE_INVALID_INDEX)
+            {
+                LOG_WARNING("ModelSubmesh: No room for a new SRV table, rewriting the one in use");
+                return;
+            }
+
+            //~ Clean slots keep their descriptor, the dirty ones are written after this
+            device->GetNative()->CopyDescriptorsSimple(
+                count,
+                heap->GetHandle(base),
+                heap->GetHandle(m_baseSrvIndex),
+                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+            m_retiredTables.push_back(RetiredTable{ m_baseSrvIndex, fence, fenceValue });
+
+            m_baseSrvIndex = base;
+            for (std::uint32_t i = 0; i < count; ++i)
+                m_srvs[i].ReservedSlot = base + i;
+
+            m_bTableBound = false;
+        }
+
         void FreeReserveSlot(KFEResourceHeap* heap) noexcept
         {
             if (!heap)
                 return;
 
+            //~ Same rule as the current table, the caller makes sure the GPU is done
+            FreeRetiredTables(heap, true);
+
             for (auto& d : m_srvs)
             {
                 if (d.ReservedSlot != KFE_INVALID_INDEX)
@@ -435,25 +551,90 @@ namespace kfe
 
                 d.TextureSrv = nullptr;
                 d.ResourceHandle = KFE_INVALID_INDEX;
+                d.StreamHandle = KFE_INVALID_INDEX;
                 d.Dirty = false;
             }
 
             m_baseSrvIndex = KFE_INVALID_INDEX;
+            m_bTableBound = false;
             m_bTextureDirty = false;
         }
 
+        //~ Dirty slots BindTextureFromPath is about to load, for KFEImagePool::Prefetch
+        void CollectTextureRequests(std::vector<KFE_IMAGE_REQUEST>& outRequests) const
+        {
+            if (!m_bTextureDirty)
+                return;
+
+            const std::size_t count = static_cast<std::size_t>(EModelTextureSlot::Count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto& data = m_srvs[i];
+                const std::string& path = GetBindPath(i);
+                if (!data.Dirty || data.ReservedSlot == KFE_INVALID_INDEX || path.empty())
+                    continue;
+
+                if (!kfe_helpers::IsFile(path))
+                    continue;
+
+                outRequests.push_back({ path, GetTextureUsage(static_cast<EModelTextureSlot>(i)) });
+            }
+        }
+
+        //~ Projected size of the submesh this frame, drives mip streaming of its textures
+        void ReportTextureUse(float screenPixels) const noexcept
+        {
+            auto& pool = KFEImagePool::Instance();
+            for (const auto& d : m_srvs)
+            {
+                if (d.StreamHandle != KFE_INVALID_INDEX)
+                    pool.ReportTextureUse(d.StreamHandle, screenPixels);
+            }
+        }
+
+        //~ fence/fenceValue retire the frame being recorded, replaced tables wait for it
         bool BindTextureFromPath(
             ID3D12GraphicsCommandList* cmdList,
             KFEDevice* device,
-            KFEResourceHeap* heap) noexcept
+            KFEResourceHeap* heap,
+            ID3D12Fence* fence,
+            std::uint64_t fenceValue) noexcept
         {
+            auto& pool = KFEImagePool::Instance();
+
+            if (heap && !m_retiredTables.empty())
+                FreeRetiredTables(heap, false);
+
+            //~ Streamed textures get a new SRV whenever their resident mips change
+            if (m_textureGeneration != pool.GetResidencyGeneration())
+            {
+                m_textureGeneration = pool.GetResidencyGeneration();
+
+                const bool bStreamed = std::any_of(m_srvs.begin(), m_srvs.end(),
+                    [](const SrvData& d) { return d.StreamHandle != KFE_INVALID_INDEX; });
+
+                if (bStreamed)
+                {
+                    for (auto& d : m_srvs)
+                    {
+                        if (d.ReservedSlot != KFE_INVALID_INDEX)
+                        {
+                            d.ResourceHandle = KFE_INVALID_INDEX;
+                            d.Dirty = true;
+                        }
+                    }
+                    m_bTextureDirty = true;
+                }
+            }
+
             if (!m_bTextureDirty)
                 return true;
 
             if (!cmdList || !device || !heap)
                 return false;
 
-            auto& pool = KFEImagePool::Instance();
+            if (m_bTableBound && m_baseSrvIndex != KFE_INVALID_INDEX)
+                RotateTable(device, heap, fence, fenceValue);
 
             const std::size_t count = static_cast<std::size_t>(EModelTextureSlot::Count);
 
@@ -467,6 +648,8 @@ namespace kfe
                 if (!data.Dirty)
                     continue;
 
+                data.StreamHandle = KFE_INVALID_INDEX;
+
                 if (data.ReservedSlot == KFE_INVALID_INDEX)
                 {
                     LOG_ERROR("ModelSubmesh SRV slot {} has no ReservedSlot allocated!", i);
@@ -474,7 +657,8 @@ namespace kfe
                     continue;
                 }
 
-                if (data.TexturePath.empty())
+                const std::string& path = GetBindPath(i);
+                if (path.empty())
                 {
                     data.TextureSrv = nullptr;
                     data.ResourceHandle = KFE_INVALID_INDEX;
@@ -482,19 +666,20 @@ namespace kfe
                     continue;
                 }
 
-                if (!kfe_helpers::IsFile(data.TexturePath))
+                if (!kfe_helpers::IsFile(path))
                 {
-                    LOG_ERROR("Texture '{}' does not exist!", data.TexturePath);
+                    LOG_ERROR("Texture '{}' does not exist!", path);
                     data.TextureSrv = nullptr;
                     data.ResourceHandle = KFE_INVALID_INDEX;
                     data.Dirty = false;
                     continue;
                 }
 
-                KFETextureSRV* srv = pool.GetImageSrv(data.TexturePath, cmdList);
+                KFETextureSRV* srv = pool.GetImageSrv(path, cmdList,
+                    GetTextureUsage(static_cast<EModelTextureSlot>(i)));
                 if (!srv)
                 {
-                    LOG_ERROR("Failed to load SRV for '{}'", data.TexturePath);
+                    LOG_ERROR("Failed to load SRV for '{}'", path);
                     data.TextureSrv = nullptr;
                     data.ResourceHandle = KFE_INVALID_INDEX;
                     data.Dirty = false;
@@ -503,6 +688,10 @@ namespace kfe
 
                 data.TextureSrv = srv;
                 data.ResourceHandle = srv->GetDescriptorIndex();
+                data.StreamHandle = pool.GetStreamHandle(path,
+                    GetTextureUsage(static_cast<EModelTextureSlot>(i)));
+                data.ArraySlice = pool.GetArraySlice(path,
+                    GetTextureUsage(static_cast<EModelTextureSlot>(i)));
 
                 const D3D12_CPU_DESCRIPTOR_HANDLE src = heap->GetHandle(data.ResourceHandle);
                 const D3D12_CPU_DESCRIPTOR_HANDLE dst = heap->GetHandle(data.ReservedSlot);
@@ -546,13 +735,136 @@ namespace kfe
 
                     data.ResourceHandle = firstValidResource;
                     data.TextureSrv = m_srvs[firstValidIndex].TextureSrv;
+                    data.ArraySlice = m_srvs[firstValidIndex].ArraySlice;
                 }
             }
 
             m_bTextureDirty = false;
+            m_bTableBound = true;
             return true;
         }
 
+        //~ Bound slices into the meta CB copy, the user meta has no say in them
+        void WriteArraySlices(ModelTextureMetaInformation& meta) const noexcept
+        {
+            for (std::size_t i = 0; i < m_srvs.size(); ++i)
+                meta.ArraySlice[i] = static_cast<float>(m_srvs[i].ArraySlice);
+        }
+
+        //~ Path the slot binds, the packed ORM stands in for the three maps it holds
+        const std::string& GetBindPath(std::size_t slot) const noexcept
+        {
+            static const std::string kNone{};
+
+            if (!m_packedORMPath.empty())
+            {
+                switch (static_cast<EModelTextureSlot>(slot))
+                {
+                case EModelTextureSlot::ORM:       return m_packedORMPath;
+                case EModelTextureSlot::Occlusion:
+                case EModelTextureSlot::Roughness:
+                case EModelTextureSlot::Metallic:  return kNone;
+                default:                           break;
+                }
+            }
+            return m_srvs[slot].TexturePath;
+        }
+
+        //~ All three separate maps on, sampled with the same tiling, and no ORM map of its own
+        bool CanPackORM() const noexcept
+        {
+            const auto& s = m_textureMetaInformation.Singular;
+
+            return !HasTexture(EModelTextureSlot::ORM) &&
+                HasTexture(EModelTextureSlot::Occlusion) &&
+                HasTexture(EModelTextureSlot::Roughness) &&
+                HasTexture(EModelTextureSlot::Metallic) &&
+                s.IsOcclusionAttached >= 0.5f && s.IsRoughnessAttached >= 0.5f && s.IsMetallicAttached >= 0.5f &&
+                s.OcclusionTilingX == s.RoughnessTilingX && s.OcclusionTilingX == s.MetallicTilingX &&
+                s.OcclusionTilingY == s.RoughnessTilingY && s.OcclusionTilingY == s.MetallicTilingY;
+        }
+
+        ORMPackMeta GetORMPackMeta() const noexcept
+        {
+            const auto& s = m_textureMetaInformation.Singular;
+
+            ORMPackMeta meta{};
+            meta.Attached[0] = s.IsOcclusionAttached;
+            meta.Attached[1] = s.IsRoughnessAttached;
+            meta.Attached[2] = s.IsMetallicAttached;
+            meta.Tiling[0]   = s.OcclusionTilingX;
+            meta.Tiling[1]   = s.OcclusionTilingY;
+            meta.Tiling[2]   = s.RoughnessTilingX;
+            meta.Tiling[3]   = s.RoughnessTilingY;
+            meta.Tiling[4]   = s.MetallicTilingX;
+            meta.Tiling[5]   = s.MetallicTilingY;
+            return meta;
+        }
+
+        //~ Once per frame before CollectTextureRequests. Does nothing unless a texture
+        //~ path or the ORM related meta changed or a pack is in flight. Packing runs on
+        //~ the image pool's cook worker, the separate maps stay bound until it is done.
+        void ResolveORMPacking() noexcept
+        {
+            const ORMPackMeta meta = GetORMPackMeta();
+            if (!m_bTextureDirty && !m_bORMPending && meta == m_packedORMMeta)
+                return;
+
+            m_packedORMMeta = meta;
+            m_bORMPending = false;
+
+            std::string packed{};
+
+            if (CanPackORM())
+            {
+                if (m_packedORMSources.Occlusion != GetOcclusionPath() ||
+                    m_packedORMSources.Roughness != GetRoughnessPath() ||
+                    m_packedORMSources.Metallic  != GetMetallicPath())
+                {
+                    m_packedORMSources.Occlusion = GetOcclusionPath();
+                    m_packedORMSources.Roughness = GetRoughnessPath();
+                    m_packedORMSources.Metallic  = GetMetallicPath();
+                }
+
+                const EPackedORMState state = KFEImagePool::Instance().RequestPackedORM(m_packedORMSources, packed);
+                m_bORMPending = state == EPackedORMState::Pending;
+            }
+
+            if (packed == m_packedORMPath)
+                return;
+
+            m_packedORMPath = std::move(packed);
+
+            for (const EModelTextureSlot slot : { EModelTextureSlot::ORM, EModelTextureSlot::Occlusion,
+                                                  EModelTextureSlot::Roughness, EModelTextureSlot::Metallic })
+            {
+                auto& d = m_srvs[static_cast<std::size_t>(slot)];
+                d.TextureSrv = nullptr;
+                d.ResourceHandle = KFE_INVALID_INDEX;
+                d.Dirty = true;
+            }
+
+            m_bTextureDirty = true;
+            m_bMetaDirty = true;
+        }
+
+        //~ Meta CB copy sees an unmixed, packed ORM map in place of the separate ones
+        void WritePackedORM(ModelTextureMetaInformation& meta) const noexcept
+        {
+            if (m_packedORMPath.empty())
+                return;
+
+            meta.ORM.IsTextureAttached = 1.0f;
+            meta.ORM.IsMixed = 0.0f;
+            meta.ORM.UvTilingX = meta.Singular.OcclusionTilingX;
+            meta.ORM.UvTilingY = meta.Singular.OcclusionTilingY;
+
+            meta.Singular.IsOcclusionAttached = 0.0f;
+            meta.Singular.IsRoughnessAttached = 0.0f;
+            meta.Singular.IsMetallicAttached = 0.0f;
+            meta.Singular.IsORMPacked = 1.0f;
+        }
+
         const std::string& GetTexturePath(EModelTextureSlot tex) const noexcept
         {
             return m_srvs[static_cast<std::size_t>(tex)].TexturePath;
@@ -662,7 +974,10 @@ namespace kfe
         bool Initialize(const std::string&      path,
                         KFEDevice*              device,
                         ID3D12GraphicsCommandList* cmdList,
-                        KFEResourceHeap* heap) noexcept;
+                        KFEResourceHeap* heap,
+                        EMeshVertexFormat vertexFormat = EMeshVertexFormat::Full,
+                        ID3D12Fence* fence = nullptr,
+                        std::uint64_t fenceValue = 0u) noexcept;
 
         void Reset  ()       noexcept;
         bool IsValid() const noexcept;
@@ -681,7 +996,7 @@ namespace kfe
                                 KFEModelNode& dst) noexcept;
 
     private:
-        KFE_MESH_CACHE_SHARE* m_pShare = nullptr;
+        KFEMeshCacheHandle m_share{};
 
         std::vector<KFEModelSubmesh>  m_submeshes;
         std::unique_ptr<KFEModelNode> m_root;
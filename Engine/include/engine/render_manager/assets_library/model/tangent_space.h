@@ -0,0 +1,78 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : tangent_space.h
+ *  Purpose   : Multithreaded smooth normal and MikkTSpace style tangent
+ *              generation on ImportedMesh, replacing Assimp's post steps.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "assimp_importer.h"
+
+#include <cstdint>
+
+namespace kfe
+{
+    struct KFE_TANGENT_SPACE_DESC
+    {
+        std::uint32_t ThreadCount       = 0u;      //~ 0 = hardware concurrency
+        std::uint32_t TrianglesPerChunk = 16384u;  //~ work unit, meshes below one chunk stay on the caller
+        bool          bGenerateNormals  = true;    //~ only for meshes without normals
+        bool          bGenerateTangents = true;    //~ only for meshes with UV0 and without tangents
+    };
+
+    struct KFE_TANGENT_SPACE_STATS
+    {
+        std::uint32_t MeshesWithNormals   = 0u; //~ meshes that got generated normals
+        std::uint32_t MeshesWithTangents  = 0u; //~ meshes that got generated tangents
+        std::uint64_t NormalsGenerated    = 0u; //~ vertices
+        std::uint64_t TangentsGenerated   = 0u; //~ vertices
+        std::uint64_t MixedHandedness     = 0u; //~ vertices whose faces disagreed on UV winding
+        std::uint32_t ThreadsUsed         = 0u;
+        double        Milliseconds        = 0.0;
+    };
+
+    struct KFE_TANGENT_SPACE_BENCH_RESULT
+    {
+        std::uint32_t TriangleCount    = 0u;
+        std::uint32_t ThreadCount      = 0u;
+        double        SingleThreadMs   = 0.0;
+        double        MultiThreadMs    = 0.0;
+        double        Speedup          = 0.0;
+        bool          bDeterministic   = false; //~ both runs bitwise identical
+    };
+
+    /// <summary>
+    /// Normals are area weighted and smoothed over vertices sharing a position.
+    /// Tangents follow MikkTSpace: per face UV gradients projected onto the vertex
+    /// normal, angle weighted, with the bitangent rebuilt as sign * cross(N, T).
+    /// Work is split over triangle and vertex chunks but every vertex sums its
+    /// faces in triangle order, so the result does not depend on thread count.
+    /// </summary>
+    class KFE_API KFETangentSpace
+    {
+    public:
+        //~ Returns false when the mesh already had normals or has no triangles
+        static bool GenerateNormals(import::ImportedMesh& mesh,
+                                    const KFE_TANGENT_SPACE_DESC& desc = {}) noexcept;
+
+        //~ Needs normals and UV0, returns false when there is nothing to do
+        static bool GenerateTangents(import::ImportedMesh& mesh,
+                                     const KFE_TANGENT_SPACE_DESC& desc = {},
+                                     std::uint64_t* outMixedHandedness = nullptr) noexcept;
+
+        //~ Normals then tangents for every mesh that lacks them
+        static void ProcessScene(import::ImportedScene& scene,
+                                 const KFE_TANGENT_SPACE_DESC& desc = {},
+                                 KFE_TANGENT_SPACE_STATS* outStats = nullptr) noexcept;
+
+        //~ Dense synthetic grid, one thread against threadCount (0 = hardware)
+        static KFE_TANGENT_SPACE_BENCH_RESULT RunBenchmark(std::uint32_t gridSize = 1024u,
+                                                           std::uint32_t threadCount = 0u) noexcept;
+    };
+}
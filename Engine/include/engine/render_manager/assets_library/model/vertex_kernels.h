@@ -0,0 +1,69 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : vertex_kernels.h
+ *  Purpose   : Batch SSE/AVX2 kernels for the import path: position bounds and
+ *              a fused stream to ImportedVertex conversion with normalization.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "assimp_importer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kfe
+{
+    //~ Separate source streams, 3 floats per element (aiVector3D layout).
+    //~ nullptr streams get the ImportedVertex defaults.
+    struct KFE_VERTEX_SOURCE_STREAMS
+    {
+        const float* Positions  = nullptr;
+        const float* Normals    = nullptr;
+        const float* Tangents   = nullptr;
+        const float* Bitangents = nullptr;
+        const float* UV[import::KFE_MAX_UV_CHANNELS]{};
+        std::size_t  VertexCount = 0u;
+    };
+
+    struct KFE_VERTEX_KERNEL_BENCH_RESULT
+    {
+        std::uint32_t VertexCount    = 0u;
+        double        ScalarMs       = 0.0; //~ convert, normalize and engine copy as three scalar passes
+        double        FusedMs        = 0.0; //~ bounds kernel, fused convert, engine copy
+        double        Speedup        = 0.0;
+        bool          bMatches       = false;
+        const char*   InstructionSet = "";
+    };
+
+    class KFE_API KFEVertexKernels
+    {
+    public:
+        //~ "AVX2", "SSE2" or "Scalar", picked once from the running CPU
+        static const char* GetInstructionSet() noexcept;
+
+        //~ Grows min/max by count positions, 3 floats each
+        static void ReduceAABB(const float*    positions,
+                               std::size_t     count,
+                               import::Float3& inOutMin,
+                               import::Float3& inOutMax) noexcept;
+
+        //~ out[i].Position = (p - center) * scale, other streams copied or defaulted,
+        //~ flags filled from which streams exist. Writes the bounds of the output positions.
+        static void ConvertVertices(const KFE_VERTEX_SOURCE_STREAMS& src,
+                                    const import::Float3&            center,
+                                    float                            scale,
+                                    import::ImportedVertex*          out,
+                                    import::Float3&                  outMin,
+                                    import::Float3&                  outMax) noexcept;
+
+        //~ Synthetic mesh with normals, tangents and one UV set, run through the old
+        //~ scalar three pass path and through the kernels. Results are compared.
+        static KFE_VERTEX_KERNEL_BENCH_RESULT RunBenchmark(std::uint32_t vertexCount = 4000000u) noexcept;
+    };
+}
@@ -0,0 +1,64 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : vertex_quantizer.h
+ *  Purpose   : Encode/decode between KFEMeshVertex and KFEMeshVertexCompact.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "geometry.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace kfe
+{
+    //~ Worst case round trip error over a vertex set
+    struct KFE_VERTEX_QUANTIZATION_ERROR
+    {
+        float MaxPositionError     = 0.0f; //~ object space units, per axis
+        float MaxNormalDegrees     = 0.0f;
+        float MaxTangentDegrees    = 0.0f;
+        float MaxUVError           = 0.0f;
+        bool  BitangentSignMatches = true;
+
+        //~ True when every error is inside the analytic bound of the format
+        bool  WithinBounds         = true;
+    };
+
+    class KFE_API KFEVertexQuantizer
+    {
+    public:
+        //~ 16 bit octahedral normal error is ~0.0025 degrees, bound leaves float headroom
+        static constexpr float kMaxDirectionErrorDegrees = 0.01f;
+
+        static void              EncodeOctahedral(const DirectX::XMFLOAT3& dir, std::int16_t out[2]) noexcept;
+        static DirectX::XMFLOAT3 DecodeOctahedral(const std::int16_t in[2])                           noexcept;
+
+        static KFEMeshVertexCompact Encode(const KFEMeshVertex&     v,
+                                           const DirectX::XMFLOAT3& aabbMin,
+                                           const DirectX::XMFLOAT3& aabbMax) noexcept;
+
+        static KFEMeshVertex        Decode(const KFEMeshVertexCompact& v,
+                                           const DirectX::XMFLOAT3&    aabbMin,
+                                           const DirectX::XMFLOAT3&    aabbMax) noexcept;
+
+        static void EncodeAll(std::span<const KFEMeshVertex>     src,
+                              const DirectX::XMFLOAT3&           aabbMin,
+                              const DirectX::XMFLOAT3&           aabbMax,
+                              std::vector<KFEMeshVertexCompact>& out);
+
+        //~ Encodes and decodes every vertex and reports the largest error seen
+        static KFE_VERTEX_QUANTIZATION_ERROR MeasureRoundTrip(std::span<const KFEMeshVertex> src,
+                                                              const DirectX::XMFLOAT3&       aabbMin,
+                                                              const DirectX::XMFLOAT3&       aabbMax) noexcept;
+    };
+}
@@ -0,0 +1,48 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : block_compression.h
+ *  Purpose   : CPU BC1/BC3/BC4/BC5/BC7 block encoders for the texture cooker.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "engine/core.h"
+
+#include <cstdint>
+#include <dxgiformat.h>
+
+namespace kfe
+{
+    /// <summary>
+    /// Every encoder takes one 4x4 block of RGBA8 texels, row major (64 bytes).
+    /// BC1 and BC3 colour use the principal axis with one least squares refit,
+    /// BC4/BC5 the channel range, BC7 mode 6 only (one subset, RGBA endpoints
+    /// with p-bits, 4 bit indices), which is what most colour content ends up in.
+    /// </summary>
+    class KFE_API KFEBlockCompression
+    {
+    public:
+        static void EncodeBC1(const std::uint8_t* rgba, std::uint8_t* out8)  noexcept;
+        static void EncodeBC3(const std::uint8_t* rgba, std::uint8_t* out16) noexcept;
+        static void EncodeBC4(const std::uint8_t* rgba, std::uint32_t channel, std::uint8_t* out8) noexcept;
+        static void EncodeBC5(const std::uint8_t* rgba, std::uint8_t* out16) noexcept; //~ R and G
+        static void EncodeBC7(const std::uint8_t* rgba, std::uint8_t* out16) noexcept;
+
+        //~ 8 or 16 for the BC formats above, 0 for anything else
+        NODISCARD static std::uint32_t GetBlockBytes(DXGI_FORMAT format) noexcept;
+
+        //~ Whole image, edge texels repeat into partial blocks. out holds
+        //~ ceil(w/4) * ceil(h/4) blocks, rows of blocks are tightly packed.
+        NODISCARD static bool CompressImage(DXGI_FORMAT format,
+                                            const std::uint8_t* rgba,
+                                            std::uint32_t width,
+                                            std::uint32_t height,
+                                            std::uint8_t* out,
+                                            std::uint32_t threadCount = 1u) noexcept;
+    };
+}
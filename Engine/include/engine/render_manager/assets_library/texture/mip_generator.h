@@ -0,0 +1,90 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mip_generator.h
+ *  Purpose   : CPU mip chains for RGBA8 images: the GPU box filter bit for bit,
+ *              windowed sinc filters and gamma correct averaging for cooking.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "engine/core.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace kfe
+{
+    enum class EMipFilter : std::uint32_t
+    {
+        Box = 0, //~ 2x2 average, what mipgen_cs.hlsl does
+        Kaiser,  //~ Kaiser windowed sinc, radius 3, alpha 4
+        Lanczos  //~ Lanczos 3
+    };
+
+    struct KFE_MIP_GEN_DESC
+    {
+        EMipFilter    Filter      = EMipFilter::Box;
+        bool          bSRGB       = false; //~ RGB averaged in linear light, alpha stays linear
+        bool          bNormalMap  = false; //~ XYZ filtered as signed vectors and renormalized
+        std::uint32_t ThreadCount = 1u;    //~ 0 = every hardware thread
+    };
+
+    struct KFE_MIP_LEVEL
+    {
+        std::uint32_t             Width  = 0u;
+        std::uint32_t             Height = 0u;
+        std::vector<std::uint8_t> Pixels; //~ RGBA8, tightly packed rows
+    };
+
+    struct KFE_MIP_GEN_BENCH_RESULT
+    {
+        std::uint32_t Size           = 0u;
+        std::uint32_t ThreadCount    = 0u;
+        double        ScalarBoxMs    = 0.0; //~ shader box emulation, one thread
+        double        BoxMs          = 0.0;
+        double        Speedup        = 0.0;
+        double        SRGBBoxMs      = 0.0;
+        double        KaiserMs       = 0.0;
+        double        LanczosMs      = 0.0;
+        bool          bMatchesShader = false;
+        const char*   InstructionSet = "";
+    };
+
+    /// <summary>
+    /// Each level is filtered from the one above it, like the GPU path. The plain
+    /// box filter (no sRGB, no normals) follows the shader's arithmetic exactly:
+    /// UNORM loads, ((c0 + c1) + c2) + c3, * 0.25, saturate and round to nearest
+    /// even on the store, reads clamped to the level. Everything else goes through
+    /// a separable float filter over bands of rows.
+    /// </summary>
+    class KFE_API KFEMipGenerator
+    {
+    public:
+        //~ "AVX2", "SSE2" or "Scalar", picked once from the running CPU
+        static const char* GetInstructionSet() noexcept;
+
+        //~ outLevels[i] is mip i + 1, the base level is not copied
+        NODISCARD static bool GenerateChain(const std::uint8_t* rgba,
+                                            std::uint32_t width,
+                                            std::uint32_t height,
+                                            const KFE_MIP_GEN_DESC& desc,
+                                            std::vector<KFE_MIP_LEVEL>& outLevels) noexcept;
+
+        //~ One level from its parent; dst is max(1, w >> 1) x max(1, h >> 1)
+        NODISCARD static bool GenerateLevel(const std::uint8_t* src,
+                                            std::uint32_t srcWidth,
+                                            std::uint32_t srcHeight,
+                                            std::uint8_t* dst,
+                                            const KFE_MIP_GEN_DESC& desc) noexcept;
+
+        //~ Random image through a scalar emulation of the shader and the kernels,
+        //~ the box chains are compared byte for byte
+        static KFE_MIP_GEN_BENCH_RESULT RunBenchmark(std::uint32_t size = 2048u,
+                                                     std::uint32_t threadCount = 0u) noexcept;
+    };
+}
@@ -0,0 +1,167 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : texture_cooker.h
+ *  Purpose   : Cooked .kftex textures: full mip chain, block compressed per
+ *              usage, memory mapped at load and uploaded as is.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "engine/core.h"
+#include "engine/render_manager/assets_library/texture/mip_generator.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dxgiformat.h>
+
+namespace kfe
+{
+    inline constexpr std::uint32_t KFE_KFTEX_MAGIC     = 0x5845544Bu; //~ "KTEX"
+    inline constexpr std::uint32_t KFE_KFTEX_VERSION   = 2u;
+    inline constexpr const char*   KFE_KFTEX_EXTENSION = ".kftex";
+
+    //~ Cook settings that change the payload, part of the cache key
+    inline constexpr std::uint32_t KFE_KFTEX_COOK_COLOR_BC7        = 1u << 0;
+    inline constexpr std::uint32_t KFE_KFTEX_COOK_SRGB_MIPS        = 1u << 1;
+    inline constexpr std::uint32_t KFE_KFTEX_COOK_MIP_FILTER_SHIFT = 8u;   //~ EMipFilter
+
+    //~ What a texture feeds, picks its block format
+    enum class ETextureUsage : std::uint32_t
+    {
+        Color = 0, //~ BC7, or BC1 (opaque) / BC3 (alpha) with BC7 off
+        Normal,    //~ BC5, XY only, shaders rebuild Z
+        Single,    //~ BC4 from the red channel
+        Data       //~ packed linear channels (ORM, specular), formats as Color but never sRGB
+    };
+
+    struct KFE_TEXTURE_COOK_DESC
+    {
+        bool          bColorBC7   = true;  //~ false trades colour quality for encode time
+        EMipFilter    MipFilter   = EMipFilter::Kaiser;
+        bool          bSRGBMips   = true;  //~ colour maps are authored in sRGB, average them in linear
+        std::uint32_t ThreadCount = 0u;    //~ encoder threads, 0 = half the hardware threads
+    };
+
+    //~ Separate occlusion, roughness and metallic maps of one material
+    struct KFE_ORM_SOURCES
+    {
+        std::string Occlusion;
+        std::string Roughness;
+        std::string Metallic;
+
+        NODISCARD bool operator==(const KFE_ORM_SOURCES&) const = default;
+    };
+
+    //~ On disk layout:
+    //~ [Header][Mip records][Mip payloads]
+    //~ Payloads are 16 byte aligned rows of blocks (texels when uncompressed),
+    //~ tightly packed, so each one feeds a placed footprint copy directly.
+    struct KFE_KFTEX_HEADER
+    {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t Usage;
+        std::uint32_t Format;       //~ DXGI_FORMAT
+
+        std::int64_t  SourceWriteTime;
+        std::uint64_t SourceSize;
+
+        std::uint32_t Width;
+        std::uint32_t Height;
+        std::uint32_t MipCount;
+        std::uint32_t CookFlags;
+
+        std::uint64_t MipTableOffset;
+        std::uint64_t FileSize;
+    };
+
+    struct KFE_KFTEX_MIP_RECORD
+    {
+        std::uint32_t Width;
+        std::uint32_t Height;
+        std::uint32_t RowPitch;     //~ bytes per row of blocks or texels
+        std::uint32_t RowCount;
+
+        std::uint64_t Offset;
+        std::uint64_t Size;
+    };
+
+    struct KFE_COOKED_MIP
+    {
+        std::uint32_t       Width    = 0u;
+        std::uint32_t       Height   = 0u;
+        std::uint32_t       RowPitch = 0u;
+        std::uint32_t       RowCount = 0u;
+        const std::uint8_t* Data     = nullptr;
+    };
+
+    //~ Mips view either the file mapping or memory owned by Backing
+    struct KFE_COOKED_TEXTURE
+    {
+        DXGI_FORMAT                 Format = DXGI_FORMAT_UNKNOWN;
+        ETextureUsage               Usage  = ETextureUsage::Color;
+        std::uint32_t               Width  = 0u;
+        std::uint32_t               Height = 0u;
+        std::vector<KFE_COOKED_MIP> Mips;
+        std::shared_ptr<const void> Backing;
+
+        NODISCARD bool IsValid() const noexcept { return !Mips.empty() && Backing != nullptr; }
+    };
+
+    /// <summary>
+    /// Cooks decoded RGBA8 images into a mip chain in their GPU format.
+    /// BC formats need a top level that is a multiple of 4 in both axes,
+    /// other sizes keep the mips but stay RGBA8. Cooked files sit next to the
+    /// source, named per usage, and are rebuilt when the source stamp or the
+    /// cook settings change.
+    /// </summary>
+    class KFE_API KFETextureCooker
+    {
+    public:
+        static std::string GetCookedPath(const std::string& sourcePath, ETextureUsage usage);
+
+        NODISCARD static DXGI_FORMAT SelectFormat(ETextureUsage usage,
+                                                  bool bHasAlpha,
+                                                  std::uint32_t width,
+                                                  std::uint32_t height,
+                                                  const KFE_TEXTURE_COOK_DESC& desc) noexcept;
+
+        //~ Maps the cooked file when it matches the source and the settings
+        NODISCARD static bool LoadCooked(const std::string& sourcePath,
+                                         ETextureUsage usage,
+                                         const KFE_TEXTURE_COOK_DESC& desc,
+                                         KFE_COOKED_TEXTURE& outTexture) noexcept;
+
+        //~ In memory, nothing touches the disk
+        NODISCARD static bool CookPixels(const std::uint8_t* rgba,
+                                         std::uint32_t width,
+                                         std::uint32_t height,
+                                         ETextureUsage usage,
+                                         const KFE_TEXTURE_COOK_DESC& desc,
+                                         KFE_COOKED_TEXTURE& outTexture) noexcept;
+
+        NODISCARD static bool SaveCooked(const std::string& sourcePath,
+                                         const KFE_TEXTURE_COOK_DESC& desc,
+                                         const KFE_COOKED_TEXTURE& texture) noexcept;
+
+        //~ Decode, cook and save; for offline tools and the image pool's background cook
+        NODISCARD static bool CookFile(const std::string& sourcePath,
+                                       ETextureUsage usage,
+                                       const KFE_TEXTURE_COOK_DESC& desc = {}) noexcept;
+
+        //~ Next to the occlusion map, named after the common stem of the three
+        static std::string GetPackedORMPath(const KFE_ORM_SOURCES& sources);
+
+        //~ Red channel of each map into R = occlusion, G = roughness, B = metallic, saved as
+        //~ an uncompressed TGA that the image pool loads and cooks like any other source.
+        //~ Reused while newer than all three. False when one is missing or the sizes differ.
+        NODISCARD static bool PackORM(const KFE_ORM_SOURCES& sources, std::string& outPath) noexcept;
+    };
+}
@@ -0,0 +1,117 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : texture_streaming.h
+ *  Purpose   : CPU side of mip streaming: which mip a texture needs for its
+ *              on screen size, and which textures get their finer mips when
+ *              everything does not fit the memory budget.
+ *  -----------------------------------------------------------------------------
+ */
+#pragma once
+
+#include "EngineAPI.h"
+#include "engine/core.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace kfe
+{
+    struct KFE_TEXTURE_STREAMING_DESC
+    {
+        bool          bEnabled               = true;
+        std::uint32_t InitialMaxSize         = 256u;          //~ largest top level loaded up front, texels
+        std::uint64_t BudgetBytes            = 512ull << 20;  //~ every texture in the pool, streamed or not
+        float         TexelsPerPixel         = 1.0f;          //~ > 1 keeps sharper mips than the screen needs
+        std::uint32_t MaxUpdatesPerFrame     = 2u;            //~ resources rebuilt per frame
+        std::uint64_t MaxUploadBytesPerFrame = 32ull << 20;
+        std::uint32_t LingerFrames           = 120u;          //~ frames a finer mip stays wanted after its last use
+    };
+
+    struct KFE_TEXTURE_STREAMING_STATS
+    {
+        std::uint64_t BudgetBytes      = 0u;
+        std::uint64_t ResidentBytes    = 0u;  //~ whole pool, what the arbiter last saw
+        std::uint64_t WantedBytes      = 0u;  //~ what the pool would take without a budget
+        std::uint32_t StreamedTextures = 0u;
+        std::uint32_t PendingUpdates   = 0u;  //~ targets not reached yet
+        std::uint64_t Upgrades         = 0u;
+        std::uint64_t Downgrades       = 0u;
+    };
+
+    struct KFE_TEXTURE_STREAMING_VIEW
+    {
+        DirectX::XMFLOAT3 CameraPosition{ 0.0f, 0.0f, 0.0f }; //~ world space
+        float             FovY           = DirectX::XM_PIDIV4;
+        float             ViewportHeight = 1080.0f;
+    };
+
+    //~ One streamed texture as the arbiter sees it
+    struct KFE_STREAMING_CANDIDATE
+    {
+        std::span<const std::uint64_t> MipBytes;           //~ bytes per level of the full chain
+        std::uint32_t                  InitialMip   = 0u;  //~ coarsest top level, always resident
+        std::uint32_t                  WantedMip    = 0u;  //~ from ComputeWantedMip, finer than InitialMip or equal
+        std::uint32_t                  TopSize      = 1u;  //~ max(width, height) of mip 0
+        float                          ScreenPixels = 0.0f;
+
+        //~ Levels a block compressed texture cannot start from are skipped
+        std::uint32_t                  Width            = 0u;
+        std::uint32_t                  Height           = 0u;
+        bool                           bBlockCompressed = false;
+    };
+
+    class KFE_API KFETextureStreaming
+    {
+    public:
+        //~ Projected diameter of the AABB bounding sphere in pixels, like the mesh LOD
+        //~ selection. FLT_MAX when the camera is inside the sphere. world is row vector.
+        static float ComputeScreenPixels(const DirectX::XMFLOAT3&          aabbMin,
+                                         const DirectX::XMFLOAT3&          aabbMax,
+                                         const DirectX::XMMATRIX&          world,
+                                         const KFE_TEXTURE_STREAMING_VIEW& view) noexcept;
+
+        //~ Coarsest mip with at least texelsPerPixel texels per screen pixel across the
+        //~ object, assuming the texture spans it once. 0 pixels gives the last mip.
+        static std::uint32_t ComputeWantedMip(std::uint32_t topSize,
+                                              std::uint32_t mipCount,
+                                              float         screenPixels,
+                                              float         texelsPerPixel = 1.0f) noexcept;
+
+        //~ A block compressed texture can only start from a level in whole 4x4 blocks
+        static bool IsLoadableMip(std::uint32_t width,
+                                  std::uint32_t height,
+                                  std::uint32_t mip,
+                                  bool          bBlockCompressed) noexcept;
+
+        //~ First mip no larger than maxSize. Block compressed tops stay multiples of 4,
+        //~ so a texture may start finer than maxSize.
+        static std::uint32_t ComputeInitialMip(std::uint32_t width,
+                                               std::uint32_t height,
+                                               std::uint32_t mipCount,
+                                               std::uint32_t maxSize,
+                                               bool          bBlockCompressed) noexcept;
+
+        //~ Bytes of mips [firstMip, end)
+        static std::uint64_t SumMipBytes(std::span<const std::uint64_t> mipBytes,
+                                         std::uint32_t firstMip) noexcept;
+
+        //~ Every candidate starts at its initial mip, then the one with the fewest texels
+        //~ per screen pixel gets its next finer loadable level, until each has its wanted
+        //~ mip or the next level would not fit. fixedBytes is what is resident outside the
+        //~ candidates. Returns the total bytes of the result.
+        static std::uint64_t Arbitrate(std::span<const KFE_STREAMING_CANDIDATE> candidates,
+                                       std::uint64_t                            budgetBytes,
+                                       std::uint64_t                            fixedBytes,
+                                       std::vector<std::uint32_t>&              outTargetMips) noexcept;
+
+        //~ Checks the heuristic and the arbiter against hand worked cases, logs failures
+        NODISCARD static bool RunSelfTest() noexcept;
+    };
+}
@@ -15,18 +15,29 @@
 #include <string>
 #include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 
 #include "engine/system/interface/interface_singleton.h"
+#include "engine/system/common_types.h"
 #include "engine/render_manager/api/heap/heap_sampler.h"
 #include "engine/render_manager/api/heap/heap_cbv_srv_uav.h"
 #include "engine/render_manager/api/texture/texture.h"
 #include "engine/render_manager/api/texture/texture_srv.h"
 #include "engine/render_manager/api/texture/staging_texture.h"
+#include "engine/render_manager/api/pool/residency_manager.h"
+#include "engine/render_manager/assets_library/texture/texture_cooker.h"
+#include "engine/render_manager/assets_library/texture/texture_streaming.h"
 
 struct ID3D12RootSignature;
 struct ID3D12PipelineState;
 struct ID3D12GraphicsCommandList;
+struct ID3D12Fence;
 
 namespace kfe
 {
@@ -40,6 +51,41 @@ namespace kfe
         KFESamplerHeap* SamplerHeap{ nullptr };
     } KFE_INIT_IMAGE_POOL;
 
+    typedef struct _KFE_TEXTURE_PACKING_DESC
+    {
+        bool          bEnabled       = true;
+        std::uint32_t MaxSize        = 256u; //~ textures up to this on both axes share arrays
+        std::uint32_t SlicesPerArray = 8u;   //~ fixed at creation, unused slices still cost memory
+    } KFE_TEXTURE_PACKING_DESC;
+
+    typedef struct _KFE_TEXTURE_PACKING_STATS
+    {
+        std::uint32_t ArrayCount     = 0u;
+        std::uint32_t PackedTextures = 0u;
+        std::uint32_t FreeSlices     = 0u;
+    } KFE_TEXTURE_PACKING_STATS;
+
+    typedef struct _KFE_TEXTURE_DEDUP_STATS
+    {
+        std::uint32_t UniqueTextures  = 0u;  //~ entries holding a resource
+        std::uint32_t DuplicatePaths  = 0u;  //~ paths sharing another path's texture by content
+        std::uint64_t DuplicateHits   = 0u;  //~ GetImageSrv calls served through such a path
+        std::uint64_t BytesSaved      = 0u;  //~ resident bytes the duplicates would have taken
+    } KFE_TEXTURE_DEDUP_STATS;
+
+    enum class EPackedORMState : std::uint8_t
+    {
+        Pending, //~ queued on the cook worker, keep the separate maps bound
+        Ready,
+        Failed
+    };
+
+    typedef struct _KFE_IMAGE_REQUEST
+    {
+        std::string   Path;
+        ETextureUsage Usage{ ETextureUsage::Color };
+    } KFE_IMAGE_REQUEST;
+
     class KFE_API KFEImagePool final : public ISingleton<KFEImagePool>
     {
         struct TextureData
@@ -51,6 +97,26 @@ namespace kfe
             std::uint32_t Width = 0u;
             std::uint32_t Height = 0u;
             std::uint32_t Mips = 1u;
+
+            ETextureUsage Usage = ETextureUsage::Color;
+            DXGI_FORMAT   Format = DXGI_FORMAT_UNKNOWN;
+            bool          bCooked = false;
+
+            std::uint64_t ResidentBytes = 0u;
+            std::uint64_t ContentHash   = 0u;  //~ of the source file bytes, 0 when unread
+
+            // Packed into a shared array, Staging and Srv stay null
+            std::uint32_t ArrayPage  = KFE_INVALID_INDEX;
+            std::uint32_t ArraySlice = 0u;
+
+            // Streaming, cooked textures whose full chain is larger than the initial size
+            KFE_COOKED_TEXTURE         Stream{};           //~ mapping the finer mips come from
+            std::vector<std::uint64_t> MipBytes;           //~ full chain
+            std::uint32_t              ResidentMip  = 0u;  //~ mip of the full chain at the resource top
+            std::uint32_t              InitialMip   = 0u;
+            std::uint32_t              StreamHandle = KFE_INVALID_INDEX;
+
+            KFEResidencyHandle Residency{};  //~ evictable when streamed
         };
 
         friend ISingleton<KFEImagePool>;
@@ -67,26 +133,178 @@ namespace kfe
         NODISCARD bool Initialize(_In_ const KFE_INIT_IMAGE_POOL& desc);
         NODISCARD bool IsInitialized() const noexcept;
 
+        //~ The usage picks the cooked block format, each usage of a path is its own texture.
+        //~ Every view is a Texture2DArray, small textures may share one (see GetArraySlice).
+        //~ Paths are normalized, and files with the same bytes share one texture.
         NODISCARD KFETextureSRV* GetImageSrv(
             _In_ const std::string& path,
-            _In_ ID3D12GraphicsCommandList* cmdList);
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            _In_ ETextureUsage usage = ETextureUsage::Color);
 
         NODISCARD KFETexture* GetTexture(
-            _In_ const std::string& path) noexcept;
+            _In_ const std::string& path,
+            _In_ ETextureUsage usage = ETextureUsage::Color) noexcept;
+
+        //~ Slice of the texture in its GetImageSrv view, 0 unless it is packed
+        NODISCARD std::uint32_t GetArraySlice(
+            _In_ const std::string& path,
+            _In_ ETextureUsage usage = ETextureUsage::Color) const noexcept;
 
         NODISCARD bool Reload(
             _In_ const std::string& path,
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            _In_ ETextureUsage usage = ETextureUsage::Color);
+
+        //~ Decodes every request on a worker pool (cooked mapping or stb_image), then
+        //~ records all the uploads on cmdList from the calling thread, so GetImageSrv
+        //~ for those paths is a lookup afterwards. Duplicates, empty paths and textures
+        //~ already in the pool are skipped. Returns how many of the requests are resident.
+        std::uint32_t Prefetch(
+            _In_ const std::vector<KFE_IMAGE_REQUEST>& requests,
             _In_ ID3D12GraphicsCommandList* cmdList);
 
         void Clear() noexcept;
         NODISCARD std::size_t GetTextureCount() const noexcept;
 
+        //~ One ORM texture for three separate maps (KFETextureCooker::PackORM), packed on
+        //~ the cook worker. The first call queues it, outPath is set once it is Ready.
+        //~ Results are remembered, a failed triplet is not packed again this session.
+        NODISCARD EPackedORMState RequestPackedORM(
+            _In_ const KFE_ORM_SOURCES& sources,
+            _Out_ std::string& outPath);
+
+        //~ On by default. Fresh .kftex files upload as is, no runtime mip generation.
+        //~ A miss loads the source as before and cooks it in the background for next time.
+        void SetTextureCooking(bool enabled, const KFE_TEXTURE_COOK_DESC& desc = {}) noexcept;
+
+        //~ On by default. Small textures of the same format, size and mip count are
+        //~ uploaded as slices of shared Texture2DArrays. Applies to later loads.
+        void SetTexturePacking(const KFE_TEXTURE_PACKING_DESC& desc) noexcept;
+        NODISCARD KFE_TEXTURE_PACKING_STATS GetPackingStats() const noexcept;
+
+        //~ On by default. Cooked textures load their mips up to InitialMaxSize, finer ones
+        //~ stream in for what is on screen, within BudgetBytes. Applies to later loads.
+        void SetTextureStreaming(const KFE_TEXTURE_STREAMING_DESC& desc) noexcept;
+        NODISCARD KFE_TEXTURE_STREAMING_STATS GetStreamingStats() const noexcept;
+
+        //~ On by default. A path not in the pool is hashed before loading, a file with the
+        //~ same bytes and usage as a resident one shares its texture.
+        void SetContentDedup(bool enabled) noexcept;
+        NODISCARD KFE_TEXTURE_DEDUP_STATS GetDedupStats() const noexcept;
+
+        //~ Absolute, lexically normal, forward slashes, lower case on Windows
+        NODISCARD static std::string NormalizePath(_In_ const std::string& path);
+
+        //~ KFE_INVALID_INDEX when the texture is not streamed
+        NODISCARD std::uint32_t GetStreamHandle(
+            _In_ const std::string& path,
+            _In_ ETextureUsage usage = ETextureUsage::Color) const noexcept;
+
+        //~ Called while drawing, the largest size of the frame wins
+        void ReportTextureUse(_In_ std::uint32_t streamHandle, _In_ float screenPixels) noexcept;
+
+        //~ Once per frame on the frame's list, before drawing. Rebuilds textures whose
+        //~ target mip moved and frees replaced resources after their fence value completes.
+        void UpdateStreaming(
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            _In_ ID3D12Fence* fence,
+            _In_ std::uint64_t fenceValue);
+
+        //~ Bumped whenever a streamed texture gets a new SRV, holders of SRV pointers rebind
+        NODISCARD std::uint64_t GetResidencyGeneration() const noexcept { return m_residencyGeneration; }
+
     private:
+        //~ CPU side of a load, filled off the render thread
+        struct DecodedImage
+        {
+            KFE_COOKED_TEXTURE            Cooked{};   //~ valid when a fresh cook was mapped
+            std::shared_ptr<std::uint8_t> Pixels;     //~ RGBA8 from stb_image otherwise
+            std::uint32_t                 Width = 0u;
+            std::uint32_t                 Height = 0u;
+            bool                          bCook = false;
+        };
+
         bool LoadTextureInternal(
             _In_ const std::string& path,
             _In_ ID3D12GraphicsCommandList* cmdList,
             _Inout_ TextureData& outData);
 
+        //~ Thread safe, touches no pool state besides the cook settings
+        bool DecodeImage(
+            _In_ const std::string& path,
+            _In_ ETextureUsage usage,
+            _Out_ DecodedImage& outImage,
+            _In_ bool bAllowCooked = true) noexcept;
+
+        bool UploadDecoded(
+            _In_ const std::string& path,
+            _In_ const DecodedImage& image,
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            _Inout_ TextureData& outData);
+
+        bool UploadCooked(
+            _In_ const std::string& path,
+            _In_ const KFE_COOKED_TEXTURE& cooked,
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            _Inout_ TextureData& outData);
+
+        //~ Resource holding mips [firstMip, end) of the cooked chain
+        bool UploadCookedRange(
+            _In_ const std::string& path,
+            _In_ const KFE_COOKED_TEXTURE& cooked,
+            _In_ std::uint32_t firstMip,
+            _In_ ID3D12GraphicsCommandList* cmdList,
+            _Inout_ TextureData& outData);
+
+        // Keys and content dedup
+        NODISCARD std::string ResolveKey(_In_ const std::string& path, _In_ ETextureUsage usage) const;
+        NODISCARD const std::string& CanonicalPath(_In_ const std::string& path) const;
+
+        //~ Key of a resident texture with the bytes of path, null when there is none
+        const std::string* FindContentOwner(
+            _In_ const std::string& path,
+            _In_ ETextureUsage usage,
+            _Out_ std::uint64_t& outHash);
+
+        void AddAlias(_In_ const std::string& key, _In_ const std::string& ownerKey);
+        void ForgetContent(_In_ const std::string& ownerKey);
+
+        // Array packing
+        NODISCARD bool CanPack(std::uint32_t width, std::uint32_t height) const noexcept;
+
+        //~ mips is the whole chain, RowPitch in texel or block rows like a cooked file.
+        //~ Only fills the upload buffer, the shared array is read by frames in flight so
+        //~ the copy is recorded on the frame's list by RecordPackedUploads.
+        bool UploadPacked(
+            _In_ const std::string& path,
+            _In_ DXGI_FORMAT format,
+            _In_ const std::vector<KFE_COOKED_MIP>& mips,
+            _Inout_ TextureData& outData);
+
+        void RecordPackedUploads(_In_ ID3D12GraphicsCommandList* cmdList) noexcept;
+
+        void ReleasePacked(_Inout_ TextureData& data) noexcept;
+        KFETextureSRV* GetSrvOf(_In_ const TextureData& data) const noexcept;
+
+        bool CreateSrv(
+            _In_ const std::string& path,
+            _Inout_ std::unique_ptr<KFEStagingTexture>& staging,
+            _In_ DXGI_FORMAT format,
+            _In_ std::uint32_t mipLevels,
+            _Inout_ TextureData& outData);
+
+        // Streaming
+        void RegisterStream(_Inout_ TextureData& data);
+        //~ data must already live in m_imagePool, the eviction callback keeps its address
+        void TrackResidency(_Inout_ TextureData& data);
+        void RetireCompleted(_In_ std::uint64_t completedValue) noexcept;
+        void QueuePageIn(_In_ std::uint32_t handle, _In_ const TextureData& data, _In_ std::uint32_t targetMip);
+        void PageInWorker(std::stop_token stop) noexcept;
+
+        // Background cooking
+        void QueueCook(const std::string& path, ETextureUsage usage);
+        void CookWorker(std::stop_token stop) noexcept;
+
         // Mip generation
         bool InitializeMipGenPipeline();
         bool GenerateMips(
@@ -98,6 +316,16 @@ namespace kfe
     private:
         std::unordered_map<std::string, TextureData> m_imagePool{};
 
+        //~ Pool key -> key of the entry holding the same bytes
+        std::unordered_map<std::string, std::string>   m_keyAliases{};
+        //~ Content hash (seeded with the usage) -> owner key
+        std::unordered_map<std::uint64_t, std::string> m_contentOwners{};
+        //~ Caller path -> NormalizePath, saves the filesystem calls
+        mutable std::unordered_map<std::string, std::string> m_canonicalPaths{};
+
+        bool          m_bContentDedup{ true };
+        std::uint64_t m_dedupHits{ 0u };
+
         KFEDevice* m_pDevice{ nullptr };
         KFEResourceHeap* m_pResourceHeap{ nullptr };
         KFESamplerHeap* m_pSamplerHeap{ nullptr };
@@ -107,5 +335,83 @@ namespace kfe
         bool m_bMipGenInitialized{ false };
         Microsoft::WRL::ComPtr<ID3D12RootSignature> m_pMipGenRootSignature;
         Microsoft::WRL::ComPtr<ID3D12PipelineState> m_pMipGenPSO;
+
+        //~ One Texture2DArray per format, size and mip count, new ones when full
+        struct ArrayPage
+        {
+            DXGI_FORMAT                        Format = DXGI_FORMAT_UNKNOWN;
+            std::uint32_t                      Width = 0u;
+            std::uint32_t                      Height = 0u;
+            std::uint32_t                      Mips = 1u;
+            std::unique_ptr<KFEStagingTexture> Staging;
+            std::unique_ptr<KFETextureSRV>     Srv;
+            std::vector<std::uint8_t>          Used;      //~ per slice
+            std::vector<std::uint8_t>          Resident;  //~ per slice, out of COPY_DEST after its first copy
+            std::vector<std::uint32_t>         Pending;   //~ slices written to the upload buffer, not copied yet
+        };
+
+        KFE_TEXTURE_PACKING_DESC m_packDesc{};
+        std::vector<ArrayPage>   m_arrayPages;
+
+        KFE_TEXTURE_STREAMING_DESC  m_streamDesc{};
+        KFE_TEXTURE_STREAMING_STATS m_streamStats{};
+        std::uint64_t               m_streamFrame{ 0u };
+        std::uint64_t               m_residencyGeneration{ 0u };
+
+        struct StreamSlot
+        {
+            float         FramePixels = 0.0f; //~ largest size reported this frame
+            float         HeldPixels  = 0.0f; //~ what the arbiter sees, lingers after the use stops
+            std::uint64_t HeldFrame   = 0u;
+        };
+        std::vector<StreamSlot> m_streamSlots;
+
+        //~ Replaced resources, alive until the GPU is past FenceValue
+        struct RetiredTexture
+        {
+            std::unique_ptr<KFEStagingTexture> Staging;
+            std::unique_ptr<KFETextureSRV>     Srv;
+            std::uint64_t                      FenceValue = 0u;
+        };
+        std::vector<RetiredTexture> m_retired;
+
+        struct PageInJob
+        {
+            std::uint32_t               Handle = KFE_INVALID_INDEX;
+            std::uint32_t               Mip = 0u;
+            std::vector<KFE_COOKED_MIP> Mips;     //~ levels to touch
+            std::shared_ptr<const void> Backing;  //~ keeps the mapping alive
+        };
+
+        std::mutex                                        m_pageInMutex;
+        std::condition_variable_any                       m_pageInCv;
+        std::deque<PageInJob>                             m_pageInJobs;
+        std::unordered_map<std::uint32_t, std::uint32_t>  m_pageInQueued;  //~ handle -> mip asked for
+        std::unordered_map<std::uint32_t, std::uint32_t>  m_pagedIn;       //~ handle -> finest mip touched
+        std::jthread                                      m_pageInWorker;
+
+        bool                  m_bCookTextures{ true };
+        KFE_TEXTURE_COOK_DESC m_cookDesc{};
+
+        struct CookJob
+        {
+            std::string   Path;
+            ETextureUsage Usage = ETextureUsage::Color;
+        };
+
+        std::mutex                      m_cookMutex;
+        std::condition_variable_any     m_cookCv;
+        std::deque<CookJob>             m_cookJobs;
+        std::unordered_set<std::string> m_cookQueued;  //~ cooked paths queued this session
+
+        struct PackedORM
+        {
+            EPackedORMState State = EPackedORMState::Pending;
+            std::string     Path{};
+        };
+
+        std::deque<KFE_ORM_SOURCES>                m_ormJobs;   //~ served before cook jobs
+        std::unordered_map<std::string, PackedORM> m_ormPacks;  //~ by MakeORMKey, under m_cookMutex
+        std::jthread                    m_cookWorker;  //~ last member, joined first
     };
 } // namespace kfe
@@ -31,6 +31,7 @@ namespace kfe
         void ChildShadowPass(const KFE_RENDER_OBJECT_DESC& desc) override;
 
         //~ Child Specifics 
+        bool ChildPrepareBuild() override;
         bool ChildBuild  (const KFE_BUILD_OBJECT_DESC& desc) override;
         void ChildUpdate (const KFE_UPDATE_OBJECT_DESC& desc) override;
         bool ChildDestroy() override;
@@ -111,6 +111,7 @@ namespace kfe
 
         DirectX::XMFLOAT3 CameraRightWS;
         DirectX::XMFLOAT3 CameraUpWS;
+        float             CameraFovY;
 
         // Render target / viewport
         DirectX::XMFLOAT2 Resolution;
@@ -220,6 +221,7 @@ namespace kfe
         std::string VertexShader      { "" };
         std::string PixelShader       { "" };
         std::string ShadowVertexShader{ "" };
+        bool        CompactVertices   { false }; //~ Quantized KFEMeshVertexCompact input layout, models only
         bool        Dirty             { false };
 
         JsonLoader GetJsonData() const
@@ -229,6 +231,7 @@ namespace kfe
             root["VertexShader"]       = VertexShader;
             root["PixelShader"]        = PixelShader;
             root["ShadowVertexShader"] = ShadowVertexShader;
+            root["CompactVertices"]    = CompactVertices;
             return root;
         }
 
@@ -237,6 +240,7 @@ namespace kfe
             if (loader.Contains("VertexShader"))       VertexShader       = loader["VertexShader"].GetValue();
             if (loader.Contains("PixelShader"))        PixelShader        = loader["PixelShader"].GetValue();
             if (loader.Contains("ShadowVertexShader")) ShadowVertexShader = loader["ShadowVertexShader"].GetValue();
+            if (loader.Contains("CompactVertices"))    CompactVertices    = loader["CompactVertices"].AsBool();
         }
 
         void ImguiView(float deltaTime, SceneInfo& info)
@@ -248,6 +252,7 @@ namespace kfe
             changed |= ImguiEditString("Vertex Shader", VertexShader);
             changed |= ImguiEditString("Pixel Shader", PixelShader);
             changed |= ImguiEditString("Shadow VS", ShadowVertexShader);
+            changed |= ImGui::Checkbox("Compact Vertices", &CompactVertices);
 
             if (changed)
             {
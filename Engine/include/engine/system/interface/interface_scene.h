@@ -61,6 +61,9 @@ namespace kfe
 
         void Update(const KFE_UPDATE_OBJECT_DESC& desc);
 
+        //~ Starts background work the build depends on (imports), polled every
+        //~ frame by the render queue. Build is called once this returns true.
+        NODISCARD bool PrepareBuild();
         NODISCARD bool Build(_In_ const KFE_BUILD_OBJECT_DESC& desc);
         NODISCARD bool Destroy();
 
@@ -95,6 +98,7 @@ namespace kfe
         virtual void ChildShadowPass(_In_ const KFE_RENDER_OBJECT_DESC& desc) = 0;
         
         //~ Building and views
+        NODISCARD virtual bool ChildPrepareBuild() { return true; }
         NODISCARD virtual bool ChildBuild    (_In_ const KFE_BUILD_OBJECT_DESC& desc) = 0;
                   virtual void ChildUpdate   (const KFE_UPDATE_OBJECT_DESC& desc)     = 0;
                   virtual void ChildImguiViewHeader(float deltaTime)                  = 0;
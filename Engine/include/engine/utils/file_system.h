@@ -13,9 +13,12 @@
 #include "engine/core.h"
 
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <memory>
 
+class KFEMappedFile;
+
 class KFE_API KFEFileSystem
 {
 public:
@@ -46,6 +49,40 @@ public:
     NODISCARD bool          IsOpen     () const;
     NODISCARD std::uint64_t GetFileSize() const;
 
+    //~ Read-only view of the whole file, for loaders that can parse from memory.
+    //~ Fails on missing or empty files.
+    NODISCARD static bool MapForRead(_In_ const std::string& path, _Out_ KFEMappedFile& outView);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+/// <summary>
+/// Read-only memory mapped view of a whole file.
+/// The mapped bytes stay valid until Close() or destruction.
+/// Win32 file mapping on Windows, mmap elsewhere.
+/// </summary>
+class KFE_API KFEMappedFile
+{
+public:
+     KFEMappedFile();
+    ~KFEMappedFile();
+
+    KFEMappedFile(const KFEMappedFile&) = delete;
+    KFEMappedFile(KFEMappedFile&&);
+
+    KFEMappedFile& operator=(const KFEMappedFile&) = delete;
+    KFEMappedFile& operator=(KFEMappedFile&&);
+
+    NODISCARD bool Open(_In_ const std::string& path);
+    void Close();
+
+    NODISCARD bool                IsOpen () const;
+    NODISCARD const std::uint8_t* GetData() const;
+    NODISCARD std::uint64_t       GetSize() const;
+    NODISCARD std::string_view    GetText() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> m_impl;
@@ -14,6 +14,7 @@
 #include "EngineAPI.h"
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <sstream>
 #include <cstdint>
@@ -108,6 +109,7 @@ public:
     //~ Serialization helpers
     std::string ToFormattedString(int indent = 0) const;
     void        FromStream(std::istream& input);
+    void        FromString(std::string_view input);
 
     //~ Typed access with optional defaults
     [[nodiscard]] float AsFloat(float defaultValue = 0.0f)   const;
@@ -124,10 +126,13 @@ public:
 
 private:
     void        Serialize(std::ostream& output, int indent) const;
-    void        ParseObject(std::istream& input);
-    static void SkipWhitespace(std::istream& input);
-    static bool ConsumeChar(std::istream& input, char expected);
-    static std::string ReadQuotedString(std::istream& input);
+    //~ Parsers consume input from the front
+    void        ParseObject(std::string_view& input);
+    static void SkipWhitespace(std::string_view& input);
+    static bool ConsumeChar(std::string_view& input, char expected);
+    static int  Peek(std::string_view input);
+    static std::string ReadQuotedString(std::string_view& input);
+    static std::string ReadToken(std::string_view& input);
     static std::string EscapeString(const std::string& s);
 
 private:
@@ -15,6 +15,8 @@
 #include "engine/system/registry/registry_scene.h"
 #include "engine/system/registry/registry_light.h"
 #include "engine/render_manager/components/render_queue.h"
+#include "engine/render_manager/assets_library/model/mesh_cache.h"
+#include "engine/utils/helpers.h"
 #include "engine/system/exception/base_exception.h"
 
 #include <algorithm>
@@ -121,6 +123,27 @@ namespace kfe
         m_sceneObjectView.clear();
         m_sceneViewDirty = true;
 
+        //~ Queue every model the map references for background import up front,
+        //~ objects stream in as their imports finish
+        std::vector<std::string> modelPaths;
+
+        for (const auto& [idKey, node] : loader)
+        {
+            if (!node.Contains("Data"))
+                continue;
+
+            const JsonLoader& dataNode = node["Data"];
+            if (!dataNode.Contains("ModelPath"))
+                continue;
+
+            const std::string& modelPath = dataNode["ModelPath"].GetValue();
+            if (kfe_helpers::IsFile(modelPath))
+                modelPaths.push_back(modelPath);
+        }
+
+        if (!modelPaths.empty())
+            KFEMeshCache::Instance().PrefetchCPUAsync(modelPaths);
+
         for (const auto& [idKey, node] : loader)
         {
             if (!node.Contains("Type") || !node.Contains("Data"))
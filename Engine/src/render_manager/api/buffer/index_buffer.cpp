@@ -203,7 +203,16 @@ bool kfe::KFEIndexBuffer::Impl::Initialize(const KFE_INDEX_BUFFER_CREATE_DESC& d
         return false;
     }
 
-    const std::uint64_t usableSize = bufferSize - m_offsetInBytes;
+    const std::uint64_t remaining = bufferSize - m_offsetInBytes;
+    if (desc.SizeInBytes > remaining)
+    {
+        LOG_ERROR(
+            "KFEIndexBuffer::Impl::Initialize: SizeInBytes ({}) exceeds the remaining buffer size ({}).",
+            desc.SizeInBytes, remaining);
+        return false;
+    }
+
+    const std::uint64_t usableSize = desc.SizeInBytes ? desc.SizeInBytes : remaining;
     if (usableSize < indexSize)
     {
         LOG_ERROR(
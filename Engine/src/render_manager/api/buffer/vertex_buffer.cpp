@@ -190,7 +190,16 @@ bool kfe::KFEVertexBuffer::Impl::Initialize(const KFE_VERTEX_BUFFER_CREATE_DESC&
         return false;
     }
 
-    const std::uint64_t usableSize = bufferSize - m_offsetInBytes;
+    const std::uint64_t remaining = bufferSize - m_offsetInBytes;
+    if (desc.SizeInBytes > remaining)
+    {
+        LOG_ERROR(
+            "KFEVertexBuffer::Impl::Initialize: SizeInBytes ({}) exceeds the remaining buffer size ({}).",
+            desc.SizeInBytes, remaining);
+        return false;
+    }
+
+    const std::uint64_t usableSize = desc.SizeInBytes ? desc.SizeInBytes : remaining;
     if (usableSize < desc.StrideInBytes)
     {
         LOG_ERROR(
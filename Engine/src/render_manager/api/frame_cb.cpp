@@ -30,6 +30,14 @@ namespace kfe
             return false;
         }
 
+        //~ Each slice is its own committed resource, 64 KB at least
+        KFE_RESIDENCY_REGISTER_DESC residency{};
+        residency.Name     = "KFEFrameConstantBuffer";
+        residency.Category = EResidencyCategory::ConstantBuffer;
+        for (const auto& s : m_slices)
+            residency.SizeInBytes += KFEResidencyManager::QueryAllocationBytes(desc.Device, s.Buffer->GetNative());
+
+        m_residency   = KFEResidencyManager::Instance().Register(std::move(residency));
         m_initialized = true;
         return true;
     }
@@ -43,6 +51,7 @@ namespace kfe
         }
 
         m_slices.clear();
+        m_residency.Reset();
         m_frameCount = 0u;
         m_frameIndex = 0u;
         m_sizeBytes = 0u;
@@ -0,0 +1,669 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : geometry_arena.cpp
+ *  -----------------------------------------------------------------------------
+ */
+#include "pch.h"
+#include "engine/render_manager/api/pool/geometry_arena.h"
+
+#include "engine/utils/logger.h"
+#include "engine/render_manager/api/buffer/buffer.h"
+#include "engine/render_manager/api/components/device.h"
+#include "engine/render_manager/api/pool/residency_manager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	constexpr std::uint64_t kUploadAlignment = 16u;
+	constexpr std::size_t   kKeepFreeUploadPages = 2u;
+
+	constexpr std::uint64_t AlignUp(std::uint64_t v, std::uint64_t alignment) noexcept
+	{
+		return (v + alignment - 1u) & ~(alignment - 1u);
+	}
+}
+
+#pragma region Impl_Declaration
+
+class kfe::KFEGeometryArena::Impl
+{
+	struct Page
+	{
+		KFEBuffer             Buffer   {};
+		KFEOffsetAllocator    Allocator{};
+		KFEResidencyHandle    Residency{}; //~ pinned, meshes are not streamed
+	};
+
+	struct UploadPage
+	{
+		KFEBuffer     Buffer    {};
+		std::uint8_t* Mapped    { nullptr };
+		std::uint64_t Head      { 0u };
+		ID3D12Fence*  Fence     { nullptr };
+		std::uint64_t FenceValue{ 0u };
+	};
+
+	struct PendingFree
+	{
+		KFE_GEOMETRY_ALLOCATION Allocation     {};
+		ID3D12Fence*            Fence          { nullptr }; //~ copy queue
+		std::uint64_t           FenceValue     { 0u };
+		ID3D12Fence*            FrameFence     { nullptr }; //~ graphics queue
+		std::uint64_t           FrameFenceValue{ 0u };
+
+		NODISCARD bool IsComplete() const noexcept
+		{
+			return Impl::IsComplete(Fence, FenceValue) && Impl::IsComplete(FrameFence, FrameFenceValue);
+		}
+	};
+public:
+	 Impl() = default;
+	~Impl() = default;
+
+	NODISCARD bool Initialize(const KFE_GEOMETRY_ARENA_CREATE_DESC& desc);
+
+	NODISCARD KFE_GEOMETRY_ALLOCATION Allocate(EGeometryArenaBuffer type, std::uint64_t sizeInBytes, std::uint64_t alignment) noexcept;
+	NODISCARD bool                    Upload  (const KFE_GEOMETRY_ALLOCATION& allocation, const KFE_GEOMETRY_UPLOAD_DESC& desc) noexcept;
+
+	void SetFrameFence(ID3D12Fence* fence, std::uint64_t fenceValue) noexcept;
+
+	void Free   (const KFE_GEOMETRY_ALLOCATION& allocation) noexcept;
+	void Collect() noexcept;
+	void Trim   () noexcept;
+	void Destroy() noexcept;
+
+	NODISCARD KFEBuffer*               GetBuffer(const KFE_GEOMETRY_ALLOCATION& allocation) const noexcept;
+	NODISCARD KFE_GEOMETRY_ARENA_STATS GetStats () const noexcept;
+
+	bool m_bReady{ false };
+
+private:
+	using PageList = std::vector<std::unique_ptr<Page>>;
+
+	NODISCARD PageList&       Pages(EGeometryArenaBuffer type)       noexcept;
+	NODISCARD const PageList& Pages(EGeometryArenaBuffer type) const noexcept;
+
+	NODISCARD Page*       CreatePage      (EGeometryArenaBuffer type, std::uint64_t minBytes) noexcept;
+	NODISCARD UploadPage* AcquireUpload   (std::uint64_t sizeInBytes, ID3D12Fence* fence) noexcept;
+	NODISCARD bool        CreateUploadPage(std::uint64_t minBytes) noexcept;
+
+	void CollectLocked   () noexcept;
+	void FreeNow         (const KFE_GEOMETRY_ALLOCATION& allocation) noexcept;
+
+	static bool IsComplete(ID3D12Fence* fence, std::uint64_t value) noexcept;
+
+private:
+	mutable std::mutex m_mutex;
+
+	KFEDevice*    m_pDevice        { nullptr };
+	std::uint64_t m_vertexPageBytes{ 64ull << 20 };
+	std::uint64_t m_indexPageBytes { 32ull << 20 };
+	std::uint64_t m_uploadPageBytes{ 16ull << 20 };
+
+	PageList m_vertexPages{};
+	PageList m_indexPages {};
+
+	std::vector<std::unique_ptr<UploadPage>> m_uploadPages{};
+	std::vector<PendingFree>                 m_pendingFrees{};
+
+	//~ Latest fence seen by Upload, frees wait for it
+	ID3D12Fence*  m_pLastFence     { nullptr };
+	std::uint64_t m_lastFenceValue { 0u };
+
+	//~ Frame being recorded, frees wait for it too
+	ID3D12Fence*  m_pFrameFence     { nullptr };
+	std::uint64_t m_frameFenceValue { 0u };
+};
+
+#pragma endregion
+
+#pragma region GeometryArena_Implementation
+
+kfe::KFEGeometryArena::KFEGeometryArena() noexcept
+	: m_impl(std::make_unique<kfe::KFEGeometryArena::Impl>())
+{}
+
+kfe::KFEGeometryArena::~KFEGeometryArena() noexcept = default;
+
+_Use_decl_annotations_
+bool kfe::KFEGeometryArena::Initialize(const KFE_GEOMETRY_ARENA_CREATE_DESC& desc)
+{
+	return m_impl->Initialize(desc);
+}
+
+bool kfe::KFEGeometryArena::IsReady() const noexcept
+{
+	return m_impl->m_bReady;
+}
+
+kfe::KFE_GEOMETRY_ALLOCATION kfe::KFEGeometryArena::Allocate(
+	EGeometryArenaBuffer type, std::uint64_t sizeInBytes, std::uint64_t alignment) noexcept
+{
+	return m_impl->Allocate(type, sizeInBytes, alignment);
+}
+
+_Use_decl_annotations_
+bool kfe::KFEGeometryArena::Upload(const KFE_GEOMETRY_ALLOCATION& allocation, const KFE_GEOMETRY_UPLOAD_DESC& desc) noexcept
+{
+	return m_impl->Upload(allocation, desc);
+}
+
+_Use_decl_annotations_
+void kfe::KFEGeometryArena::SetFrameFence(ID3D12Fence* fence, std::uint64_t fenceValue) noexcept
+{
+	m_impl->SetFrameFence(fence, fenceValue);
+}
+
+_Use_decl_annotations_
+void kfe::KFEGeometryArena::Free(const KFE_GEOMETRY_ALLOCATION& allocation) noexcept
+{
+	m_impl->Free(allocation);
+}
+
+void kfe::KFEGeometryArena::Collect() noexcept
+{
+	m_impl->Collect();
+}
+
+void kfe::KFEGeometryArena::Trim() noexcept
+{
+	m_impl->Trim();
+}
+
+void kfe::KFEGeometryArena::Destroy() noexcept
+{
+	m_impl->Destroy();
+}
+
+_Use_decl_annotations_
+kfe::KFEBuffer* kfe::KFEGeometryArena::GetBuffer(const KFE_GEOMETRY_ALLOCATION& allocation) const noexcept
+{
+	return m_impl->GetBuffer(allocation);
+}
+
+kfe::KFE_GEOMETRY_ARENA_STATS kfe::KFEGeometryArena::GetStats() const noexcept
+{
+	return m_impl->GetStats();
+}
+
+#pragma endregion
+
+#pragma region Impl_Implementation
+
+_Use_decl_annotations_
+bool kfe::KFEGeometryArena::Impl::Initialize(const KFE_GEOMETRY_ARENA_CREATE_DESC& desc)
+{
+	if (!desc.Device || !desc.Device->GetNative())
+	{
+		LOG_ERROR("KFEGeometryArena::Impl::Initialize: Device or native device is null.");
+		return false;
+	}
+
+	if (desc.VertexPageBytes == 0u || desc.IndexPageBytes == 0u || desc.UploadPageBytes == 0u)
+	{
+		LOG_ERROR("KFEGeometryArena::Impl::Initialize: Page sizes must be > 0.");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_bReady && m_pDevice != desc.Device)
+	{
+		LOG_ERROR("KFEGeometryArena::Impl::Initialize: Already initialized with another device.");
+		return false;
+	}
+
+	//~ New sizes only apply to pages created from now on
+	m_pDevice		  = desc.Device;
+	m_vertexPageBytes = AlignUp(desc.VertexPageBytes, kUploadAlignment);
+	m_indexPageBytes  = AlignUp(desc.IndexPageBytes,  kUploadAlignment);
+	m_uploadPageBytes = AlignUp(desc.UploadPageBytes, kUploadAlignment);
+	m_bReady		  = true;
+
+	LOG_INFO("KFEGeometryArena: vertex pages {} MB, index pages {} MB, upload pages {} MB",
+		m_vertexPageBytes >> 20, m_indexPageBytes >> 20, m_uploadPageBytes >> 20);
+
+	return true;
+}
+
+kfe::KFE_GEOMETRY_ALLOCATION kfe::KFEGeometryArena::Impl::Allocate(
+	EGeometryArenaBuffer type, std::uint64_t sizeInBytes, std::uint64_t alignment) noexcept
+{
+	KFE_GEOMETRY_ALLOCATION allocation{};
+	allocation.Type = type;
+
+	if (!m_bReady || sizeInBytes == 0u)
+	{
+		LOG_ERROR("KFEGeometryArena::Allocate: Arena not initialized or zero sized request.");
+		return allocation;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	CollectLocked();
+
+	PageList& pages = Pages(type);
+	for (std::size_t i = 0u; i < pages.size(); ++i)
+	{
+		const KFE_OFFSET_ALLOCATION range = pages[i]->Allocator.Allocate(sizeInBytes, alignment);
+		if (range.IsValid())
+		{
+			allocation.Page	 = static_cast<std::uint32_t>(i);
+			allocation.Range = range;
+			return allocation;
+		}
+	}
+
+	Page* page = CreatePage(type, sizeInBytes + alignment);
+	if (!page)
+	{
+		return allocation;
+	}
+
+	const KFE_OFFSET_ALLOCATION range = page->Allocator.Allocate(sizeInBytes, alignment);
+	if (range.IsValid())
+	{
+		allocation.Page	 = static_cast<std::uint32_t>(pages.size() - 1u);
+		allocation.Range = range;
+	}
+
+	return allocation;
+}
+
+_Use_decl_annotations_
+bool kfe::KFEGeometryArena::Impl::Upload(const KFE_GEOMETRY_ALLOCATION& allocation, const KFE_GEOMETRY_UPLOAD_DESC& desc) noexcept
+{
+	if (!desc.CommandList || !desc.Data || desc.SizeInBytes == 0u)
+	{
+		LOG_ERROR("KFEGeometryArena::Upload: Invalid upload descriptor.");
+		return false;
+	}
+
+	if (!allocation.IsValid() || desc.SizeInBytes > allocation.Range.Size)
+	{
+		LOG_ERROR("KFEGeometryArena::Upload: {} bytes do not fit the allocation.", desc.SizeInBytes);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	PageList& pages = Pages(allocation.Type);
+	if (allocation.Page >= pages.size() || !pages[allocation.Page])
+	{
+		LOG_ERROR("KFEGeometryArena::Upload: Page {} does not exist.", allocation.Page);
+		return false;
+	}
+
+	Page& page = *pages[allocation.Page];
+
+	//~ Without a fence of its own the upload retires with the frame being recorded
+	ID3D12Fence*  fence		 = desc.Fence ? desc.Fence	   : m_pFrameFence;
+	std::uint64_t fenceValue = desc.Fence ? desc.FenceValue : m_frameFenceValue;
+	if (!fence)
+	{
+		LOG_ERROR("KFEGeometryArena::Upload: No fence given and no frame fence set, the upload memory could never be reused.");
+		return false;
+	}
+
+	UploadPage* upload = AcquireUpload(desc.SizeInBytes, fence);
+	if (!upload)
+	{
+		return false;
+	}
+
+	const std::uint64_t srcOffset = upload->Head;
+	std::memcpy(upload->Mapped + srcOffset, desc.Data, static_cast<std::size_t>(desc.SizeInBytes));
+	upload->Head = AlignUp(srcOffset + desc.SizeInBytes, kUploadAlignment);
+
+	upload->Fence	   = fence;
+	upload->FenceValue = (std::max)(upload->FenceValue, fenceValue);
+	if (desc.Fence)
+	{
+		m_pLastFence	 = desc.Fence;
+		m_lastFenceValue = desc.FenceValue;
+	}
+
+	//~ Pages live in COMMON, buffers are promoted to COPY_DEST by the copy and to
+	//~ vertex / index reads by the draws, then decay back once each list executes.
+	//~ No barrier is recorded so a page other frames are drawing from is never transitioned.
+	desc.CommandList->CopyBufferRegion(
+		page.Buffer.GetNative(), allocation.Range.Offset,
+		upload->Buffer.GetNative(), srcOffset,
+		desc.SizeInBytes);
+
+	return true;
+}
+
+_Use_decl_annotations_
+void kfe::KFEGeometryArena::Impl::SetFrameFence(ID3D12Fence* fence, std::uint64_t fenceValue) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_pFrameFence	  = fence;
+	m_frameFenceValue = fenceValue;
+}
+
+_Use_decl_annotations_
+void kfe::KFEGeometryArena::Impl::Free(const KFE_GEOMETRY_ALLOCATION& allocation) noexcept
+{
+	if (!allocation.IsValid())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	PendingFree pending{};
+	pending.Allocation		= allocation;
+	pending.Fence			= m_pLastFence;
+	pending.FenceValue		= m_lastFenceValue;
+	pending.FrameFence		= m_pFrameFence;
+	pending.FrameFenceValue = m_frameFenceValue;
+
+	if (pending.IsComplete())
+	{
+		FreeNow(allocation);
+		return;
+	}
+
+	m_pendingFrees.push_back(pending);
+}
+
+void kfe::KFEGeometryArena::Impl::Collect() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	CollectLocked();
+}
+
+void kfe::KFEGeometryArena::Impl::Trim() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	CollectLocked();
+
+	//~ Allocations index pages by position, so only trailing pages can go
+	for (PageList* pages : { &m_vertexPages, &m_indexPages })
+	{
+		while (pages->size() > 1u && pages->back()->Allocator.IsEmpty())
+		{
+			const bool pending = std::any_of(m_pendingFrees.begin(), m_pendingFrees.end(),
+				[&](const PendingFree& p)
+				{
+					return &Pages(p.Allocation.Type) == pages && p.Allocation.Page == pages->size() - 1u;
+				});
+
+			if (pending)
+				break;
+
+			(void)pages->back()->Buffer.Destroy();
+			pages->pop_back();
+		}
+	}
+}
+
+void kfe::KFEGeometryArena::Impl::Destroy() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto& page : m_vertexPages) (void)page->Buffer.Destroy();
+	for (auto& page : m_indexPages)  (void)page->Buffer.Destroy();
+	for (auto& page : m_uploadPages) (void)page->Buffer.Destroy();
+
+	m_vertexPages .clear();
+	m_indexPages  .clear();
+	m_uploadPages .clear();
+	m_pendingFrees.clear();
+
+	m_pLastFence	 = nullptr;
+	m_lastFenceValue = 0u;
+
+	m_pFrameFence	  = nullptr;
+	m_frameFenceValue = 0u;
+}
+
+_Use_decl_annotations_
+kfe::KFEBuffer* kfe::KFEGeometryArena::Impl::GetBuffer(const KFE_GEOMETRY_ALLOCATION& allocation) const noexcept
+{
+	if (!allocation.IsValid())
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const PageList& pages = Pages(allocation.Type);
+	if (allocation.Page >= pages.size())
+	{
+		return nullptr;
+	}
+
+	return &pages[allocation.Page]->Buffer;
+}
+
+kfe::KFE_GEOMETRY_ARENA_STATS kfe::KFEGeometryArena::Impl::GetStats() const noexcept
+{
+	KFE_GEOMETRY_ARENA_STATS stats{};
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto accumulate = [](const PageList& pages, KFE_OFFSET_ALLOCATOR_STATS& out)
+		{
+			for (const auto& page : pages)
+			{
+				const KFE_OFFSET_ALLOCATOR_STATS s = page->Allocator.GetStats();
+				out.Capacity		 += s.Capacity;
+				out.UsedBytes		 += s.UsedBytes;
+				out.FreeBytes		 += s.FreeBytes;
+				out.LargestFreeBlock  = (std::max)(out.LargestFreeBlock, s.LargestFreeBlock);
+				out.FreeBlockCount	 += s.FreeBlockCount;
+				out.AllocationCount	 += s.AllocationCount;
+			}
+
+			out.Fragmentation = out.FreeBytes > 0u
+				? 1.0f - static_cast<float>(static_cast<double>(out.LargestFreeBlock) / static_cast<double>(out.FreeBytes))
+				: 0.0f;
+		};
+
+	stats.VertexPages = static_cast<std::uint32_t>(m_vertexPages.size());
+	stats.IndexPages  = static_cast<std::uint32_t>(m_indexPages.size());
+	accumulate(m_vertexPages, stats.Vertex);
+	accumulate(m_indexPages,  stats.Index);
+
+	stats.UploadPages = static_cast<std::uint32_t>(m_uploadPages.size());
+	for (const auto& page : m_uploadPages)
+	{
+		stats.UploadBytes += page->Buffer.GetSizeInBytes();
+	}
+
+	stats.PendingFrees = static_cast<std::uint32_t>(m_pendingFrees.size());
+	return stats;
+}
+
+kfe::KFEGeometryArena::Impl::PageList& kfe::KFEGeometryArena::Impl::Pages(EGeometryArenaBuffer type) noexcept
+{
+	return type == EGeometryArenaBuffer::Vertex ? m_vertexPages : m_indexPages;
+}
+
+const kfe::KFEGeometryArena::Impl::PageList& kfe::KFEGeometryArena::Impl::Pages(EGeometryArenaBuffer type) const noexcept
+{
+	return type == EGeometryArenaBuffer::Vertex ? m_vertexPages : m_indexPages;
+}
+
+kfe::KFEGeometryArena::Impl::Page* kfe::KFEGeometryArena::Impl::CreatePage(EGeometryArenaBuffer type, std::uint64_t minBytes) noexcept
+{
+	const bool			vertex = type == EGeometryArenaBuffer::Vertex;
+	const std::uint64_t bytes  = (std::max)(vertex ? m_vertexPageBytes : m_indexPageBytes,
+											AlignUp(minBytes, kUploadAlignment));
+
+	auto page = std::make_unique<Page>();
+
+	KFE_CREATE_BUFFER_DESC bufferDesc{};
+	bufferDesc.Device		 = m_pDevice;
+	bufferDesc.SizeInBytes	 = bytes;
+	bufferDesc.HeapType		 = D3D12_HEAP_TYPE_DEFAULT;
+	bufferDesc.ResourceFlags = static_cast<D3D12_RESOURCE_FLAGS>(0);
+	bufferDesc.InitialState	 = D3D12_RESOURCE_STATE_COMMON;
+	bufferDesc.DebugName	 = vertex ? "KFEGeometryArena_VertexPage" : "KFEGeometryArena_IndexPage";
+
+	if (!page->Buffer.Initialize(bufferDesc))
+	{
+		LOG_ERROR("KFEGeometryArena: Failed to create a {} byte {} page.", bytes, vertex ? "vertex" : "index");
+		return nullptr;
+	}
+
+	KFE_OFFSET_ALLOCATOR_CREATE_DESC allocatorDesc{};
+	allocatorDesc.Capacity	   = bytes;
+	allocatorDesc.MinAlignment = kUploadAlignment;
+
+	if (!page->Allocator.Initialize(allocatorDesc))
+	{
+		(void)page->Buffer.Destroy();
+		return nullptr;
+	}
+
+	KFE_RESIDENCY_REGISTER_DESC residency{};
+	residency.Name		  = bufferDesc.DebugName;
+	residency.Category	  = EResidencyCategory::Mesh;
+	residency.SizeInBytes = KFEResidencyManager::QueryAllocationBytes(m_pDevice, page->Buffer.GetNative());
+	page->Residency		  = KFEResidencyManager::Instance().Register(std::move(residency));
+
+	PageList& pages = Pages(type);
+	pages.push_back(std::move(page));
+
+	LOG_INFO("KFEGeometryArena: Added {} page {} ({} MB)",
+		vertex ? "vertex" : "index", pages.size() - 1u, bytes >> 20);
+
+	return pages.back().get();
+}
+
+kfe::KFEGeometryArena::Impl::UploadPage* kfe::KFEGeometryArena::Impl::AcquireUpload(std::uint64_t sizeInBytes, ID3D12Fence* fence) noexcept
+{
+	//~ Current page is the last one, it keeps taking uploads on the same fence until it is full
+	if (!m_uploadPages.empty())
+	{
+		UploadPage* current = m_uploadPages.back().get();
+		if ((!current->Fence || current->Fence == fence) &&
+			current->Head + sizeInBytes <= current->Buffer.GetSizeInBytes())
+		{
+			return current;
+		}
+	}
+
+	//~ Recycle a completed page that is large enough
+	for (std::size_t i = 0u; i + 1u < m_uploadPages.size(); ++i)
+	{
+		UploadPage& page = *m_uploadPages[i];
+		if (page.Head == 0u && page.Buffer.GetSizeInBytes() >= sizeInBytes)
+		{
+			std::unique_ptr<UploadPage> reused = std::move(m_uploadPages[i]);
+			m_uploadPages.erase(m_uploadPages.begin() + static_cast<std::ptrdiff_t>(i));
+			m_uploadPages.push_back(std::move(reused));
+			return m_uploadPages.back().get();
+		}
+	}
+
+	if (!CreateUploadPage(sizeInBytes))
+	{
+		return nullptr;
+	}
+
+	return m_uploadPages.back().get();
+}
+
+bool kfe::KFEGeometryArena::Impl::CreateUploadPage(std::uint64_t minBytes) noexcept
+{
+	const std::uint64_t bytes = (std::max)(m_uploadPageBytes, AlignUp(minBytes, kUploadAlignment));
+
+	auto page = std::make_unique<UploadPage>();
+
+	KFE_CREATE_BUFFER_DESC bufferDesc{};
+	bufferDesc.Device		 = m_pDevice;
+	bufferDesc.SizeInBytes	 = bytes;
+	bufferDesc.HeapType		 = D3D12_HEAP_TYPE_UPLOAD;
+	bufferDesc.ResourceFlags = static_cast<D3D12_RESOURCE_FLAGS>(0);
+	bufferDesc.InitialState	 = D3D12_RESOURCE_STATE_GENERIC_READ;
+	bufferDesc.DebugName	 = "KFEGeometryArena_Upload";
+
+	if (!page->Buffer.Initialize(bufferDesc))
+	{
+		LOG_ERROR("KFEGeometryArena: Failed to create a {} byte upload page.", bytes);
+		return false;
+	}
+
+	page->Mapped = static_cast<std::uint8_t*>(page->Buffer.GetMappedData());
+	if (!page->Mapped)
+	{
+		LOG_ERROR("KFEGeometryArena: Upload page did not provide a mapped pointer.");
+		(void)page->Buffer.Destroy();
+		return false;
+	}
+
+	m_uploadPages.push_back(std::move(page));
+	return true;
+}
+
+void kfe::KFEGeometryArena::Impl::CollectLocked() noexcept
+{
+	//~ Deferred frees
+	auto done = std::partition(m_pendingFrees.begin(), m_pendingFrees.end(),
+		[](const PendingFree& p) { return !p.IsComplete(); });
+
+	for (auto it = done; it != m_pendingFrees.end(); ++it)
+	{
+		FreeNow(it->Allocation);
+	}
+	m_pendingFrees.erase(done, m_pendingFrees.end());
+
+	//~ Upload pages whose copies have executed start over
+	for (auto& page : m_uploadPages)
+	{
+		if (page->Head > 0u && page->Fence && IsComplete(page->Fence, page->FenceValue))
+		{
+			page->Head		 = 0u;
+			page->Fence		 = nullptr;
+			page->FenceValue = 0u;
+		}
+	}
+
+	//~ Keep a couple of idle pages behind the current one, release the rest
+	std::size_t freePages = 0u;
+	for (std::size_t i = 0u; i + 1u < m_uploadPages.size();)
+	{
+		UploadPage& page = *m_uploadPages[i];
+
+		if (page.Head == 0u && ++freePages > kKeepFreeUploadPages)
+		{
+			(void)page.Buffer.Destroy();
+			m_uploadPages.erase(m_uploadPages.begin() + static_cast<std::ptrdiff_t>(i));
+			continue;
+		}
+
+		++i;
+	}
+}
+
+void kfe::KFEGeometryArena::Impl::FreeNow(const KFE_GEOMETRY_ALLOCATION& allocation) noexcept
+{
+	PageList& pages = Pages(allocation.Type);
+	if (allocation.Page >= pages.size())
+	{
+		LOG_ERROR("KFEGeometryArena::Free: Page {} does not exist.", allocation.Page);
+		return;
+	}
+
+	(void)pages[allocation.Page]->Allocator.Free(allocation.Range);
+}
+
+bool kfe::KFEGeometryArena::Impl::IsComplete(ID3D12Fence* fence, std::uint64_t value) noexcept
+{
+	return !fence || fence->GetCompletedValue() >= value;
+}
+
+#pragma endregion
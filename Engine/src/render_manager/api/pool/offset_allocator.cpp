@@ -0,0 +1,476 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : offset_allocator.cpp
+ *  -----------------------------------------------------------------------------
+ */
+#include "pch.h"
+#include "engine/render_manager/api/pool/offset_allocator.h"
+
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	constexpr bool IsPowerOfTwo(std::uint64_t v) noexcept
+	{
+		return v != 0u && (v & (v - 1u)) == 0u;
+	}
+
+	constexpr std::uint64_t AlignUp(std::uint64_t v, std::uint64_t alignment) noexcept
+	{
+		return (v + alignment - 1u) & ~(alignment - 1u);
+	}
+}
+
+#pragma region Impl_Declaration
+
+class kfe::KFEOffsetAllocator::Impl
+{
+	using FreeByOffset = std::map<std::uint64_t, std::uint64_t>;      //~ offset -> size
+	using FreeBySize   = std::multimap<std::uint64_t, std::uint64_t>; //~ size -> offset
+	using LiveMap      = std::unordered_map<std::uint64_t, std::uint64_t>; //~ offset -> reserved size
+public:
+	 Impl() = default;
+	~Impl() = default;
+
+	NODISCARD bool Initialize(const KFE_OFFSET_ALLOCATOR_CREATE_DESC& desc);
+
+	NODISCARD KFE_OFFSET_ALLOCATION Allocate(std::uint64_t size, std::uint64_t alignment) noexcept;
+	NODISCARD bool                  Free    (const KFE_OFFSET_ALLOCATION& allocation) noexcept;
+
+	void Reset() noexcept;
+
+	NODISCARD KFE_OFFSET_ALLOCATOR_STATS GetStats() const noexcept;
+	NODISCARD bool                       Validate() const noexcept;
+
+	std::uint64_t m_capacity    { 0u };
+	std::uint64_t m_minAlignment{ 16u };
+	bool          m_bInitialized{ false };
+	LiveMap       m_live        {};
+
+private:
+	void InsertFree(std::uint64_t offset, std::uint64_t size) noexcept;
+	void EraseFree (FreeByOffset::iterator it) noexcept;
+
+private:
+	FreeByOffset  m_freeByOffset{};
+	FreeBySize    m_freeBySize  {};
+	std::uint64_t m_usedBytes   { 0u };
+};
+
+#pragma endregion
+
+#pragma region OffsetAllocator_Implementation
+
+kfe::KFEOffsetAllocator::KFEOffsetAllocator() noexcept
+	: m_impl(std::make_unique<kfe::KFEOffsetAllocator::Impl>())
+{}
+
+kfe::KFEOffsetAllocator::~KFEOffsetAllocator() noexcept = default;
+
+kfe::KFEOffsetAllocator::KFEOffsetAllocator(KFEOffsetAllocator&&)				 noexcept = default;
+kfe::KFEOffsetAllocator& kfe::KFEOffsetAllocator::operator=(KFEOffsetAllocator&&) noexcept = default;
+
+_Use_decl_annotations_
+bool kfe::KFEOffsetAllocator::Initialize(const KFE_OFFSET_ALLOCATOR_CREATE_DESC& desc)
+{
+	return m_impl->Initialize(desc);
+}
+
+kfe::KFE_OFFSET_ALLOCATION kfe::KFEOffsetAllocator::Allocate(std::uint64_t size, std::uint64_t alignment) noexcept
+{
+	return m_impl->Allocate(size, alignment);
+}
+
+_Use_decl_annotations_
+bool kfe::KFEOffsetAllocator::Free(const KFE_OFFSET_ALLOCATION& allocation) noexcept
+{
+	return m_impl->Free(allocation);
+}
+
+void kfe::KFEOffsetAllocator::Reset() noexcept
+{
+	m_impl->Reset();
+}
+
+kfe::KFE_OFFSET_ALLOCATOR_STATS kfe::KFEOffsetAllocator::GetStats() const noexcept
+{
+	return m_impl->GetStats();
+}
+
+std::uint64_t kfe::KFEOffsetAllocator::GetCapacity() const noexcept
+{
+	return m_impl->m_capacity;
+}
+
+bool kfe::KFEOffsetAllocator::IsInitialized() const noexcept
+{
+	return m_impl->m_bInitialized;
+}
+
+bool kfe::KFEOffsetAllocator::IsEmpty() const noexcept
+{
+	return m_impl->m_live.empty();
+}
+
+bool kfe::KFEOffsetAllocator::Validate() const noexcept
+{
+	return m_impl->Validate();
+}
+
+_Use_decl_annotations_
+kfe::KFE_OFFSET_ALLOCATOR_BENCH_RESULT kfe::KFEOffsetAllocator::RunBenchmark(
+	const KFE_OFFSET_ALLOCATOR_BENCH_DESC& desc) noexcept
+{
+	using Clock = std::chrono::steady_clock;
+
+	KFE_OFFSET_ALLOCATOR_BENCH_RESULT result{};
+
+	KFEOffsetAllocator allocator{};
+	KFE_OFFSET_ALLOCATOR_CREATE_DESC createDesc{};
+	createDesc.Capacity		= desc.Capacity;
+	createDesc.MinAlignment = 16u;
+
+	if (!allocator.Initialize(createDesc))
+	{
+		return result;
+	}
+
+	std::mt19937                                 rng(desc.Seed);
+	std::uniform_real_distribution<float>        chance(0.0f, 1.0f);
+	std::uniform_int_distribution<std::uint64_t> sizes(
+		(std::max)(desc.MinSize, std::uint64_t{ 1u }),
+		(std::max)(desc.MinSize, desc.MaxSize));
+
+	std::vector<KFE_OFFSET_ALLOCATION> live;
+	live.reserve(desc.Operations);
+
+	double allocNs = 0.0;
+	double freeNs  = 0.0;
+	bool   consistent = true;
+
+	for (std::uint32_t op = 0u; op < desc.Operations; ++op)
+	{
+		if (!live.empty() && chance(rng) < desc.FreeChance)
+		{
+			std::uniform_int_distribution<std::size_t> pick(0u, live.size() - 1u);
+			const std::size_t index = pick(rng);
+
+			const auto start = Clock::now();
+			const bool freed = allocator.Free(live[index]);
+			freeNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+			consistent = consistent && freed;
+			live[index] = live.back();
+			live.pop_back();
+			++result.Frees;
+		}
+		else
+		{
+			const std::uint64_t size = sizes(rng);
+
+			const auto start = Clock::now();
+			const KFE_OFFSET_ALLOCATION allocation = allocator.Allocate(size, desc.Alignment);
+			allocNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+			++result.Allocations;
+			if (allocation.IsValid())
+			{
+				live.push_back(allocation);
+			}
+			else
+			{
+				++result.FailedAllocations;
+			}
+		}
+
+		if ((op & 1023u) == 1023u)
+		{
+			const KFE_OFFSET_ALLOCATOR_STATS stats = allocator.GetStats();
+			result.PeakUsedBytes	 = (std::max)(result.PeakUsedBytes, stats.UsedBytes);
+			result.PeakFragmentation = (std::max)(result.PeakFragmentation, stats.Fragmentation);
+			consistent = consistent && allocator.Validate();
+		}
+	}
+
+	for (const auto& allocation : live)
+	{
+		consistent = allocator.Free(allocation) && consistent;
+	}
+
+	//~ Everything merged back into one block
+	const KFE_OFFSET_ALLOCATOR_STATS finalStats = allocator.GetStats();
+	consistent = consistent && allocator.Validate() && allocator.IsEmpty() &&
+		finalStats.FreeBlockCount == 1u && finalStats.FreeBytes == desc.Capacity;
+
+	result.AllocateNs  = result.Allocations ? allocNs / result.Allocations : 0.0;
+	result.FreeNs	   = result.Frees		? freeNs  / result.Frees	   : 0.0;
+	result.bConsistent = consistent;
+
+	LOG_INFO("KFEOffsetAllocator::RunBenchmark: allocs={}, frees={}, failed={}, alloc={:.1f}ns, free={:.1f}ns, peakUsed={} bytes, peakFragmentation={:.3f}, consistent={}",
+		result.Allocations, result.Frees, result.FailedAllocations,
+		result.AllocateNs, result.FreeNs,
+		result.PeakUsedBytes, result.PeakFragmentation,
+		result.bConsistent);
+
+	return result;
+}
+
+#pragma endregion
+
+#pragma region Impl_Implementation
+
+_Use_decl_annotations_
+bool kfe::KFEOffsetAllocator::Impl::Initialize(const KFE_OFFSET_ALLOCATOR_CREATE_DESC& desc)
+{
+	if (desc.Capacity == 0u)
+	{
+		LOG_ERROR("KFEOffsetAllocator::Impl::Initialize: Capacity must be > 0.");
+		return false;
+	}
+
+	if (!IsPowerOfTwo(desc.MinAlignment))
+	{
+		LOG_ERROR("KFEOffsetAllocator::Impl::Initialize: MinAlignment ({}) is not a power of two.", desc.MinAlignment);
+		return false;
+	}
+
+	m_capacity	   = desc.Capacity & ~(desc.MinAlignment - 1u);
+	m_minAlignment = desc.MinAlignment;
+
+	if (m_capacity == 0u)
+	{
+		LOG_ERROR("KFEOffsetAllocator::Impl::Initialize: Capacity ({}) is smaller than MinAlignment ({}).",
+			desc.Capacity, desc.MinAlignment);
+		return false;
+	}
+
+	m_bInitialized = true;
+	Reset();
+	return true;
+}
+
+kfe::KFE_OFFSET_ALLOCATION kfe::KFEOffsetAllocator::Impl::Allocate(std::uint64_t size, std::uint64_t alignment) noexcept
+{
+	if (!m_bInitialized || size == 0u || size > m_capacity)
+	{
+		return {};
+	}
+
+	if (alignment == 0u)
+	{
+		alignment = m_minAlignment;
+	}
+
+	if (!IsPowerOfTwo(alignment))
+	{
+		LOG_ERROR("KFEOffsetAllocator::Allocate: alignment ({}) is not a power of two.", alignment);
+		return {};
+	}
+
+	//~ Blocks always start and end on MinAlignment, so only larger alignments need padding
+	alignment = (std::max)(alignment, m_minAlignment);
+	const std::uint64_t reserved = AlignUp(size, m_minAlignment);
+
+	//~ Smallest block that still fits once its start is aligned
+	for (auto it = m_freeBySize.lower_bound(reserved); it != m_freeBySize.end(); ++it)
+	{
+		const std::uint64_t blockOffset = it->second;
+		const std::uint64_t blockSize	= it->first;
+		const std::uint64_t aligned		= AlignUp(blockOffset, alignment);
+		const std::uint64_t padding		= aligned - blockOffset;
+
+		if (padding + reserved > blockSize)
+		{
+			continue;
+		}
+
+		EraseFree(m_freeByOffset.find(blockOffset));
+
+		if (padding > 0u)
+		{
+			InsertFree(blockOffset, padding);
+		}
+
+		const std::uint64_t tail = blockSize - padding - reserved;
+		if (tail > 0u)
+		{
+			InsertFree(aligned + reserved, tail);
+		}
+
+		m_live.emplace(aligned, reserved);
+		m_usedBytes += reserved;
+
+		KFE_OFFSET_ALLOCATION allocation{};
+		allocation.Offset = aligned;
+		allocation.Size	  = size;
+		return allocation;
+	}
+
+	return {};
+}
+
+_Use_decl_annotations_
+bool kfe::KFEOffsetAllocator::Impl::Free(const KFE_OFFSET_ALLOCATION& allocation) noexcept
+{
+	if (!allocation.IsValid())
+	{
+		return false;
+	}
+
+	auto live = m_live.find(allocation.Offset);
+	if (live == m_live.end())
+	{
+		LOG_ERROR("KFEOffsetAllocator::Free: offset {} is not a live allocation.", allocation.Offset);
+		return false;
+	}
+
+	std::uint64_t offset = live->first;
+	std::uint64_t size	 = live->second;
+
+	m_usedBytes -= size;
+	m_live.erase(live);
+
+	//~ Merge with the following block
+	auto next = m_freeByOffset.lower_bound(offset);
+	if (next != m_freeByOffset.end() && next->first == offset + size)
+	{
+		size += next->second;
+		auto erase = next++;
+		EraseFree(erase);
+	}
+
+	//~ Merge with the preceding block
+	if (next != m_freeByOffset.begin())
+	{
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == offset)
+		{
+			offset = prev->first;
+			size  += prev->second;
+			EraseFree(prev);
+		}
+	}
+
+	InsertFree(offset, size);
+	return true;
+}
+
+void kfe::KFEOffsetAllocator::Impl::Reset() noexcept
+{
+	m_freeByOffset.clear();
+	m_freeBySize  .clear();
+	m_live		  .clear();
+	m_usedBytes = 0u;
+
+	if (m_capacity > 0u)
+	{
+		InsertFree(0u, m_capacity);
+	}
+}
+
+kfe::KFE_OFFSET_ALLOCATOR_STATS kfe::KFEOffsetAllocator::Impl::GetStats() const noexcept
+{
+	KFE_OFFSET_ALLOCATOR_STATS stats{};
+	stats.Capacity		  = m_capacity;
+	stats.UsedBytes		  = m_usedBytes;
+	stats.FreeBytes		  = m_capacity - m_usedBytes;
+	stats.LargestFreeBlock = m_freeBySize.empty() ? 0u : m_freeBySize.rbegin()->first;
+	stats.FreeBlockCount  = static_cast<std::uint32_t>(m_freeByOffset.size());
+	stats.AllocationCount = static_cast<std::uint32_t>(m_live.size());
+	stats.Fragmentation	  = stats.FreeBytes > 0u
+		? 1.0f - static_cast<float>(static_cast<double>(stats.LargestFreeBlock) / static_cast<double>(stats.FreeBytes))
+		: 0.0f;
+	return stats;
+}
+
+bool kfe::KFEOffsetAllocator::Impl::Validate() const noexcept
+{
+	if (m_freeByOffset.size() != m_freeBySize.size())
+	{
+		return false;
+	}
+
+	std::uint64_t freeBytes = 0u;
+	std::uint64_t prevEnd	= 0u;
+	bool		  first		= true;
+
+	for (const auto& [offset, size] : m_freeByOffset)
+	{
+		if (size == 0u || offset + size > m_capacity)
+		{
+			return false;
+		}
+
+		//~ Overlapping or unmerged neighbours
+		if (!first && offset <= prevEnd)
+		{
+			return false;
+		}
+
+		freeBytes += size;
+		prevEnd	   = offset + size;
+		first	   = false;
+	}
+
+	std::uint64_t liveBytes = 0u;
+	for (const auto& [offset, size] : m_live)
+	{
+		if (offset + size > m_capacity)
+		{
+			return false;
+		}
+
+		auto after = m_freeByOffset.upper_bound(offset);
+		if (after != m_freeByOffset.end() && after->first < offset + size)
+		{
+			return false;
+		}
+
+		if (after != m_freeByOffset.begin())
+		{
+			auto before = std::prev(after);
+			if (before->first + before->second > offset)
+			{
+				return false;
+			}
+		}
+
+		liveBytes += size;
+	}
+
+	return liveBytes == m_usedBytes && freeBytes + liveBytes == m_capacity;
+}
+
+void kfe::KFEOffsetAllocator::Impl::InsertFree(std::uint64_t offset, std::uint64_t size) noexcept
+{
+	m_freeByOffset.emplace(offset, size);
+	m_freeBySize  .emplace(size, offset);
+}
+
+void kfe::KFEOffsetAllocator::Impl::EraseFree(FreeByOffset::iterator it) noexcept
+{
+	auto [first, last] = m_freeBySize.equal_range(it->second);
+	for (auto bySize = first; bySize != last; ++bySize)
+	{
+		if (bySize->second == it->first)
+		{
+			m_freeBySize.erase(bySize);
+			break;
+		}
+	}
+
+	m_freeByOffset.erase(it);
+}
+
+#pragma endregion
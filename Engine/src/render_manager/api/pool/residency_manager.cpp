@@ -0,0 +1,636 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : residency_manager.cpp
+ *  -----------------------------------------------------------------------------
+ */
+#include "pch.h"
+#include "engine/render_manager/api/pool/residency_manager.h"
+
+#include "engine/utils/logger.h"
+#include "engine/render_manager/api/components/device.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <d3d12.h>
+#include <dxgi1_4.h>
+
+namespace
+{
+	constexpr std::size_t kCategoryCount = static_cast<std::size_t>(kfe::EResidencyCategory::Count);
+
+	constexpr std::size_t ToIndex(kfe::EResidencyCategory category) noexcept
+	{
+		return static_cast<std::size_t>(category);
+	}
+
+	//~ Upload heap memory lives in system memory on discrete GPUs
+	constexpr bool IsLocal(kfe::EResidencyCategory category) noexcept
+	{
+		return category != kfe::EResidencyCategory::ConstantBuffer;
+	}
+
+	const char* CategoryName(kfe::EResidencyCategory category) noexcept
+	{
+		switch (category)
+		{
+		case kfe::EResidencyCategory::Texture:		  return "Texture";
+		case kfe::EResidencyCategory::Mesh:			  return "Mesh";
+		case kfe::EResidencyCategory::RenderTarget:	  return "RenderTarget";
+		case kfe::EResidencyCategory::ConstantBuffer: return "ConstantBuffer";
+		default:									  return "Unknown";
+		}
+	}
+}
+
+#pragma region Impl_Declaration
+
+class kfe::KFEResidencyManager::Impl
+{
+	struct Entry
+	{
+		std::string					   Name		   {};
+		EResidencyCategory			   Category	   { EResidencyCategory::Texture };
+		std::uint64_t				   Bytes	   { 0u };
+		std::function<std::uint64_t()> Evict	   {};
+		std::uint64_t				   LastUsed	   { 0u };
+		std::uint64_t				   Serial	   { 0u }; //~ tells a reused id from the one an eviction was for
+		bool						   bAlive	   { false };
+		bool						   bEvicted	   { false }; //~ nothing left to give until the next Touch
+	};
+
+	struct Eviction
+	{
+		std::uint32_t				   Id	  { KFE_INVALID_INDEX };
+		std::uint64_t				   Serial { 0u };
+		std::uint64_t				   Bytes  { 0u }; //~ at selection, a Resize from the callback wins
+		std::function<std::uint64_t()> Evict  {};
+	};
+public:
+	 Impl() = default;
+	~Impl() = default;
+
+	void SetBudgetSource(std::unique_ptr<IKFEResidencyBudgetSource> source) noexcept;
+	void SetDesc		(const KFE_RESIDENCY_DESC& desc) noexcept;
+
+	NODISCARD std::uint32_t Register(KFE_RESIDENCY_REGISTER_DESC&& desc);
+
+	void Unregister(std::uint32_t id) noexcept;
+	void Resize	   (std::uint32_t id, std::uint64_t sizeInBytes) noexcept;
+	void Touch	   (std::uint32_t id) noexcept;
+
+	std::uint64_t BeginFrame() noexcept;
+
+	NODISCARD std::uint64_t		  GetBudgetFor(EResidencyCategory category) const noexcept;
+	NODISCARD KFE_RESIDENCY_STATS GetStats	  () const noexcept;
+
+private:
+	NODISCARD Entry* Find(std::uint32_t id) noexcept;
+
+	void AddBytes	(const Entry& entry) noexcept;
+	void RemoveBytes(const Entry& entry) noexcept;
+
+	NODISCARD std::uint64_t RefreshBudgetLocked() noexcept;
+
+private:
+	mutable std::mutex m_mutex;
+
+	KFE_RESIDENCY_DESC						   m_desc{};
+	std::unique_ptr<IKFEResidencyBudgetSource> m_pSource{};
+
+	std::vector<Entry>		   m_entries{};
+	std::vector<std::uint32_t> m_freeIds{};
+	std::uint64_t			   m_nextSerial{ 1u };
+
+	std::uint64_t m_frame		  { 0u };
+	std::uint64_t m_budgetBytes	  { 0u };
+	std::uint64_t m_localBytes	  { 0u };
+	std::uint64_t m_peakLocalBytes{ 0u };
+	std::uint64_t m_overBudget	  { 0u };
+
+	std::array<KFE_RESIDENCY_CATEGORY_STATS, kCategoryCount> m_categories{};
+};
+
+#pragma endregion
+
+#pragma region Budget_Sources
+
+std::uint64_t kfe::KFEAdapterBudgetSource::QueryBudgetBytes() noexcept
+{
+	if (!m_pAdapter)
+	{
+		return 0u;
+	}
+
+	DXGI_QUERY_VIDEO_MEMORY_INFO info{};
+	if (FAILED(m_pAdapter->QueryVideoMemoryInfo(0u, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info)))
+	{
+		return 0u;
+	}
+
+	return info.Budget;
+}
+
+#pragma endregion
+
+#pragma region Handle_Implementation
+
+void kfe::KFEResidencyHandle::Reset() noexcept
+{
+	if (IsValid())
+	{
+		m_pOwner->Unregister(m_id);
+	}
+
+	m_pOwner = nullptr;
+	m_id	 = KFE_INVALID_INDEX;
+}
+
+void kfe::KFEResidencyHandle::Touch() const noexcept
+{
+	if (IsValid())
+	{
+		m_pOwner->Touch(m_id);
+	}
+}
+
+void kfe::KFEResidencyHandle::Resize(std::uint64_t sizeInBytes) const noexcept
+{
+	if (IsValid())
+	{
+		m_pOwner->Resize(m_id, sizeInBytes);
+	}
+}
+
+#pragma endregion
+
+#pragma region ResidencyManager_Implementation
+
+kfe::KFEResidencyManager::KFEResidencyManager() noexcept
+	: m_impl(std::make_unique<kfe::KFEResidencyManager::Impl>())
+{}
+
+kfe::KFEResidencyManager::~KFEResidencyManager() noexcept = default;
+
+void kfe::KFEResidencyManager::SetBudgetSource(std::unique_ptr<IKFEResidencyBudgetSource> source) noexcept
+{
+	m_impl->SetBudgetSource(std::move(source));
+}
+
+_Use_decl_annotations_
+void kfe::KFEResidencyManager::SetDesc(const KFE_RESIDENCY_DESC& desc) noexcept
+{
+	m_impl->SetDesc(desc);
+}
+
+_Use_decl_annotations_
+kfe::KFEResidencyHandle kfe::KFEResidencyManager::Register(KFE_RESIDENCY_REGISTER_DESC desc)
+{
+	return KFEResidencyHandle{ this, m_impl->Register(std::move(desc)) };
+}
+
+void kfe::KFEResidencyManager::Unregister(std::uint32_t id) noexcept
+{
+	m_impl->Unregister(id);
+}
+
+void kfe::KFEResidencyManager::Resize(std::uint32_t id, std::uint64_t sizeInBytes) noexcept
+{
+	m_impl->Resize(id, sizeInBytes);
+}
+
+void kfe::KFEResidencyManager::Touch(std::uint32_t id) noexcept
+{
+	m_impl->Touch(id);
+}
+
+std::uint64_t kfe::KFEResidencyManager::BeginFrame() noexcept
+{
+	return m_impl->BeginFrame();
+}
+
+std::uint64_t kfe::KFEResidencyManager::GetBudgetFor(EResidencyCategory category) const noexcept
+{
+	return m_impl->GetBudgetFor(category);
+}
+
+kfe::KFE_RESIDENCY_STATS kfe::KFEResidencyManager::GetStats() const noexcept
+{
+	return m_impl->GetStats();
+}
+
+_Use_decl_annotations_
+std::uint64_t kfe::KFEResidencyManager::QueryAllocationBytes(KFEDevice* device, ID3D12Resource* resource) noexcept
+{
+	if (!device || !device->GetNative() || !resource)
+	{
+		return 0u;
+	}
+
+	const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	const D3D12_RESOURCE_ALLOCATION_INFO info = device->GetNative()->GetResourceAllocationInfo(0u, 1u, &desc);
+
+	//~ UINT64_MAX flags an invalid desc
+	return info.SizeInBytes == UINT64_MAX ? 0u : info.SizeInBytes;
+}
+
+bool kfe::KFEResidencyManager::RunSelfTest() noexcept
+{
+	bool ok = true;
+	auto Check = [&ok](bool condition, const char* what) noexcept
+		{
+			if (!condition)
+			{
+				LOG_ERROR("KFEResidencyManager::RunSelfTest: {}", what);
+				ok = false;
+			}
+		};
+
+	//~ Declared before the handles so they unregister first
+	KFEResidencyManager manager{};
+
+	auto source = std::make_unique<KFEFixedBudgetSource>(1000u);
+	KFEFixedBudgetSource* budget = source.get();
+	manager.SetBudgetSource(std::move(source));
+
+	KFE_RESIDENCY_DESC desc{};
+	desc.BudgetFraction	= 1.0f;
+	desc.MinIdleFrames	= 2u;
+	manager.SetDesc(desc);
+
+	//~ Streamed textures drop to a 100 byte initial mip when evicted
+	int aEvictions = 0;
+	int bEvictions = 0;
+
+	KFE_RESIDENCY_REGISTER_DESC reg{};
+	reg.Name		= "a";
+	reg.Category	= EResidencyCategory::Texture;
+	reg.SizeInBytes = 400u;
+	reg.Evict		= [&aEvictions]() noexcept -> std::uint64_t { ++aEvictions; return 300u; };
+	KFEResidencyHandle a = manager.Register(reg);
+
+	reg.Name  = "b";
+	reg.Evict = [&bEvictions]() noexcept -> std::uint64_t { ++bEvictions; return 300u; };
+	KFEResidencyHandle b = manager.Register(reg);
+
+	reg.Name		= "mesh";
+	reg.Category	= EResidencyCategory::Mesh;
+	reg.SizeInBytes = 300u;
+	reg.Evict		= nullptr;
+	KFEResidencyHandle mesh = manager.Register(reg);
+
+	reg.Name		= "cb";
+	reg.Category	= EResidencyCategory::ConstantBuffer;
+	reg.SizeInBytes = 5000u;
+	KFEResidencyHandle cb = manager.Register(reg);
+
+	KFE_RESIDENCY_STATS stats = manager.GetStats();
+	Check(a.IsValid() && b.IsValid() && mesh.IsValid() && cb.IsValid(), "registration hands out handles");
+	Check(stats.LocalBytes == 1100u, "constant buffers do not count against the local budget");
+	Check(stats.Categories[ToIndex(EResidencyCategory::Texture)].EvictableBytes == 800u, "evictable bytes per category");
+
+	//~ Over budget, but nothing has been idle long enough
+	manager.BeginFrame();
+	stats = manager.GetStats();
+	Check(aEvictions == 0 && bEvictions == 0, "young resources are not evicted");
+	Check(stats.OverBudgetFrames == 1u, "a frame left over budget is counted");
+
+	b.Touch();
+	manager.BeginFrame();
+	stats = manager.GetStats();
+	Check(aEvictions == 1 && bEvictions == 0, "the least recently used goes first");
+	Check(stats.LocalBytes == 800u, "eviction releases what the callback promised");
+
+	//~ a already gave what it could, b was just used
+	budget->SetBudgetBytes(500u);
+	b.Touch();
+	manager.BeginFrame();
+	Check(aEvictions == 1 && bEvictions == 0, "an evicted resource is not asked twice");
+
+	manager.BeginFrame();
+	stats = manager.GetStats();
+	Check(bEvictions == 1, "b goes once idle");
+	Check(stats.LocalBytes == 500u, "back within budget");
+	Check(stats.OverBudgetFrames == 2u, "only frames still over are counted");
+	Check(stats.PeakLocalBytes == 1100u, "peak holds the high water mark");
+
+	const KFE_RESIDENCY_CATEGORY_STATS& textures = stats.Categories[ToIndex(EResidencyCategory::Texture)];
+	Check(textures.Evictions == 2u && textures.EvictedBytes == 600u, "eviction counters");
+	Check(manager.GetBudgetFor(EResidencyCategory::Texture) == 200u, "category budget leaves room for the rest");
+
+	//~ Streaming back in after a use
+	a.Touch();
+	a.Resize(400u);
+	Check(manager.GetStats().LocalBytes == 800u, "resize updates the total");
+
+	a.Reset();
+	stats = manager.GetStats();
+	Check(!a.IsValid(), "reset invalidates the handle");
+	Check(stats.Categories[ToIndex(EResidencyCategory::Texture)].Resources == 1u, "unregister drops the resource");
+	Check(stats.LocalBytes == 400u, "unregister drops the bytes");
+
+	KFEResidencyHandle moved = std::move(b);
+	Check(!b.IsValid() && moved.IsValid(), "handles move");
+
+	manager.SetBudgetSource(nullptr);
+	manager.BeginFrame();
+	Check(manager.GetBudgetFor(EResidencyCategory::Texture) == UINT64_MAX, "no source means no budget");
+
+	if (ok)
+		LOG_SUCCESS("KFEResidencyManager::RunSelfTest: All checks passed.");
+
+	return ok;
+}
+
+#pragma endregion
+
+#pragma region Impl_Implementation
+
+void kfe::KFEResidencyManager::Impl::SetBudgetSource(std::unique_ptr<IKFEResidencyBudgetSource> source) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pSource = std::move(source);
+	(void)RefreshBudgetLocked();
+}
+
+void kfe::KFEResidencyManager::Impl::SetDesc(const KFE_RESIDENCY_DESC& desc) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_desc = desc;
+	m_desc.BudgetFraction = std::clamp(m_desc.BudgetFraction, 0.0f, 1.0f);
+	(void)RefreshBudgetLocked();
+}
+
+std::uint32_t kfe::KFEResidencyManager::Impl::Register(KFE_RESIDENCY_REGISTER_DESC&& desc)
+{
+	if (desc.Category >= EResidencyCategory::Count)
+	{
+		LOG_ERROR("KFEResidencyManager::Register: '{}' has no valid category.", desc.Name);
+		return KFE_INVALID_INDEX;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::uint32_t id = KFE_INVALID_INDEX;
+	if (!m_freeIds.empty())
+	{
+		id = m_freeIds.back();
+		m_freeIds.pop_back();
+	}
+	else
+	{
+		id = static_cast<std::uint32_t>(m_entries.size());
+		m_entries.emplace_back();
+	}
+
+	Entry& entry   = m_entries[id];
+	entry.Name	   = std::move(desc.Name);
+	entry.Category = desc.Category;
+	entry.Bytes	   = desc.SizeInBytes;
+	entry.Evict	   = std::move(desc.Evict);
+	entry.LastUsed = m_frame;
+	entry.Serial   = m_nextSerial++;
+	entry.bAlive   = true;
+	entry.bEvicted = false;
+
+	KFE_RESIDENCY_CATEGORY_STATS& category = m_categories[ToIndex(entry.Category)];
+	++category.Resources;
+	AddBytes(entry);
+
+	return id;
+}
+
+void kfe::KFEResidencyManager::Impl::Unregister(std::uint32_t id) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Entry* entry = Find(id);
+	if (!entry)
+	{
+		return;
+	}
+
+	RemoveBytes(*entry);
+	--m_categories[ToIndex(entry->Category)].Resources;
+
+	*entry = Entry{};
+	m_freeIds.push_back(id);
+}
+
+void kfe::KFEResidencyManager::Impl::Resize(std::uint32_t id, std::uint64_t sizeInBytes) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Entry* entry = Find(id);
+	if (!entry)
+	{
+		return;
+	}
+
+	RemoveBytes(*entry);
+	entry->Bytes = sizeInBytes;
+	AddBytes(*entry);
+}
+
+void kfe::KFEResidencyManager::Impl::Touch(std::uint32_t id) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (Entry* entry = Find(id))
+	{
+		entry->LastUsed = m_frame;
+		entry->bEvicted = false;
+	}
+}
+
+std::uint64_t kfe::KFEResidencyManager::Impl::BeginFrame() noexcept
+{
+	std::vector<Eviction> evictions{};
+	std::uint64_t budget = 0u;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		++m_frame;
+		budget = RefreshBudgetLocked();
+
+		if (budget == 0u || m_localBytes <= budget)
+		{
+			return 0u;
+		}
+
+		std::vector<std::uint32_t> candidates{};
+		for (std::uint32_t id = 0u; id < m_entries.size(); ++id)
+		{
+			const Entry& entry = m_entries[id];
+			if (!entry.bAlive || !entry.Evict || entry.bEvicted || entry.Bytes == 0u || !IsLocal(entry.Category))
+				continue;
+
+			//~ Still referenced by a frame in flight
+			if (m_frame - entry.LastUsed < m_desc.MinIdleFrames)
+				continue;
+
+			candidates.push_back(id);
+		}
+
+		std::sort(candidates.begin(), candidates.end(),
+			[&](std::uint32_t lhs, std::uint32_t rhs)
+			{
+				return m_entries[lhs].LastUsed < m_entries[rhs].LastUsed;
+			});
+
+		//~ The callbacks may take less than Bytes, so this only decides how many to ask
+		const std::uint64_t overage = m_localBytes - budget;
+		std::uint64_t		covered = 0u;
+
+		for (const std::uint32_t id : candidates)
+		{
+			if (covered >= overage || evictions.size() >= m_desc.MaxEvictionsPerFrame)
+				break;
+
+			Entry& entry   = m_entries[id];
+			entry.bEvicted = true;
+			covered		  += entry.Bytes;
+
+			evictions.push_back(Eviction{ id, entry.Serial, entry.Bytes, entry.Evict });
+		}
+	}
+
+	//~ Outside the lock, owners take their own locks and may call back into Resize
+	std::vector<std::uint64_t> released(evictions.size(), 0u);
+	for (std::size_t i = 0u; i < evictions.size(); ++i)
+	{
+		released[i] = evictions[i].Evict();
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::uint64_t total = 0u;
+	for (std::size_t i = 0u; i < evictions.size(); ++i)
+	{
+		Entry* entry = Find(evictions[i].Id);
+		if (!entry || entry->Serial != evictions[i].Serial)
+			continue;
+
+		KFE_RESIDENCY_CATEGORY_STATS& category = m_categories[ToIndex(entry->Category)];
+		++category.Evictions;
+		category.EvictedBytes += released[i];
+		total				  += released[i];
+
+		//~ Already reported by the owner
+		if (entry->Bytes != evictions[i].Bytes)
+			continue;
+
+		RemoveBytes(*entry);
+		entry->Bytes -= (std::min)(released[i], entry->Bytes);
+		AddBytes(*entry);
+
+		LOG_INFO("KFEResidencyManager: Evicted {} KB of {} '{}'",
+			released[i] >> 10, CategoryName(entry->Category), entry->Name);
+	}
+
+	if (m_localBytes > budget)
+	{
+		++m_overBudget;
+	}
+
+	return total;
+}
+
+std::uint64_t kfe::KFEResidencyManager::Impl::GetBudgetFor(EResidencyCategory category) const noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_budgetBytes == 0u || category >= EResidencyCategory::Count)
+	{
+		return UINT64_MAX;
+	}
+
+	const std::uint64_t own	   = IsLocal(category) ? m_categories[ToIndex(category)].Bytes : 0u;
+	const std::uint64_t others = m_localBytes - own;
+
+	return m_budgetBytes > others ? m_budgetBytes - others : 0u;
+}
+
+kfe::KFE_RESIDENCY_STATS kfe::KFEResidencyManager::Impl::GetStats() const noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	KFE_RESIDENCY_STATS stats{};
+	stats.Frame			   = m_frame;
+	stats.BudgetBytes	   = m_budgetBytes;
+	stats.LocalBytes	   = m_localBytes;
+	stats.PeakLocalBytes   = m_peakLocalBytes;
+	stats.OverBudgetFrames = m_overBudget;
+	stats.Categories	   = m_categories;
+	return stats;
+}
+
+kfe::KFEResidencyManager::Impl::Entry* kfe::KFEResidencyManager::Impl::Find(std::uint32_t id) noexcept
+{
+	if (id >= m_entries.size() || !m_entries[id].bAlive)
+	{
+		return nullptr;
+	}
+
+	return &m_entries[id];
+}
+
+void kfe::KFEResidencyManager::Impl::AddBytes(const Entry& entry) noexcept
+{
+	KFE_RESIDENCY_CATEGORY_STATS& category = m_categories[ToIndex(entry.Category)];
+	category.Bytes += entry.Bytes;
+
+	if (entry.Evict)
+	{
+		category.EvictableBytes += entry.Bytes;
+	}
+
+	if (IsLocal(entry.Category))
+	{
+		m_localBytes	 += entry.Bytes;
+		m_peakLocalBytes  = (std::max)(m_peakLocalBytes, m_localBytes);
+	}
+}
+
+void kfe::KFEResidencyManager::Impl::RemoveBytes(const Entry& entry) noexcept
+{
+	KFE_RESIDENCY_CATEGORY_STATS& category = m_categories[ToIndex(entry.Category)];
+	category.Bytes -= entry.Bytes;
+
+	if (entry.Evict)
+	{
+		category.EvictableBytes -= entry.Bytes;
+	}
+
+	if (IsLocal(entry.Category))
+	{
+		m_localBytes -= entry.Bytes;
+	}
+}
+
+std::uint64_t kfe::KFEResidencyManager::Impl::RefreshBudgetLocked() noexcept
+{
+	if (m_desc.BudgetBytes > 0u)
+	{
+		m_budgetBytes = m_desc.BudgetBytes;
+	}
+	else if (m_pSource)
+	{
+		const std::uint64_t reported = m_pSource->QueryBudgetBytes();
+		m_budgetBytes = static_cast<std::uint64_t>(static_cast<double>(reported) * m_desc.BudgetFraction);
+	}
+	else
+	{
+		m_budgetBytes = 0u;
+	}
+
+	return m_budgetBytes;
+}
+
+#pragma endregion
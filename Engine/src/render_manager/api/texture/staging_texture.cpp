@@ -21,6 +21,7 @@
 #include <d3d12.h>
 #include <dxgiformat.h>
 #include <cstring>
+#include <vector>
 
 #pragma region Impl_Declaration
 
@@ -55,9 +56,20 @@ public:
         _In_ const void* data,
         std::uint32_t    srcRowPitchBytes) noexcept;
 
+    NODISCARD bool WriteSubresource(
+        std::uint32_t    subresource,
+        _In_ const void* data,
+        std::uint32_t    srcRowPitchBytes) noexcept;
+
     NODISCARD bool RecordUploadToTexture(
         _In_ ID3D12GraphicsCommandList* cmdList) const noexcept;
 
+    NODISCARD bool RecordUploadRange(
+        _In_ ID3D12GraphicsCommandList* cmdList,
+        std::uint32_t firstSubresource,
+        std::uint32_t count,
+        bool          bResident) const noexcept;
+
 private:
     KFEDevice* m_pDevice{ nullptr };
     KFEBuffer   m_uploadBuffer{};
@@ -71,10 +83,10 @@ private:
     std::uint32_t m_mipLevels{ 1u };
     std::uint32_t m_arraySize{ 1u };
 
-    // Copyable footprint data for CopyTextureRegion
-    D3D12_PLACED_SUBRESOURCE_FOOTPRINT m_footprint{};
-    UINT   m_numRows{ 0u };
-    UINT64 m_rowSizeInBytes{ 0u };
+    // Copyable footprint data for CopyTextureRegion, one per uploadable subresource
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> m_footprints;
+    std::vector<UINT>                               m_numRows;
+    std::vector<std::uint8_t>                       m_written;
     UINT64 m_totalBytes{ 0u };
 
     bool   m_bInitialized{ false };
@@ -174,6 +186,15 @@ bool kfe::KFEStagingTexture::WritePixels(
     return m_impl->WritePixels(data, srcRowPitchBytes);
 }
 
+_Use_decl_annotations_
+bool kfe::KFEStagingTexture::WriteSubresource(
+    std::uint32_t    subresource,
+    _In_ const void* data,
+    std::uint32_t    srcRowPitchBytes) noexcept
+{
+    return m_impl->WriteSubresource(subresource, data, srcRowPitchBytes);
+}
+
 _Use_decl_annotations_
 bool kfe::KFEStagingTexture::RecordUploadToTexture(
     _In_ ID3D12GraphicsCommandList* cmdList) const noexcept
@@ -181,6 +202,15 @@ bool kfe::KFEStagingTexture::RecordUploadToTexture(
     return m_impl->RecordUploadToTexture(cmdList);
 }
 
+bool kfe::KFEStagingTexture::RecordUploadRange(
+    _In_ ID3D12GraphicsCommandList* cmdList,
+    std::uint32_t firstSubresource,
+    std::uint32_t count,
+    bool          bResident) const noexcept
+{
+    return m_impl->RecordUploadRange(cmdList, firstSubresource, count, bResident);
+}
+
 #pragma endregion
 
 #pragma region Impl_Implementation
@@ -223,8 +253,9 @@ bool kfe::KFEStagingTexture::Impl::Initialize(const KFE_STAGING_TEXTURE_CREATE_D
     m_mipLevels = (desc.MipLevels == 0u ? 1u : desc.MipLevels);
     m_arraySize = (desc.ArraySize == 0u ? 1u : desc.ArraySize);
     m_mappedUpload = nullptr;
-    m_numRows = 0u;
-    m_rowSizeInBytes = 0u;
+    m_footprints.clear();
+    m_numRows.clear();
+    m_written.clear();
     m_totalBytes = 0u;
 
     ID3D12Device* nativeDevice = m_pDevice->GetNative();
@@ -241,26 +272,31 @@ bool kfe::KFEStagingTexture::Impl::Initialize(const KFE_STAGING_TEXTURE_CREATE_D
     texDesc.SampleDesc.Count = 1;
     texDesc.SampleDesc.Quality = 0;
     texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-    texDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    texDesc.Flags = desc.AllowUnorderedAccess
+        ? D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
+        : D3D12_RESOURCE_FLAG_NONE;
+
+    const UINT allSubresources = m_mipLevels * m_arraySize;
+    const UINT numSubresources = (desc.UploadSubresources == 0u || desc.UploadSubresources > allSubresources)
+        ? allSubresources
+        : desc.UploadSubresources;
 
-    UINT   numSubresources = 1u;
     UINT64 totalBytes = 0u;
-    UINT   numRows = 0u;
-    UINT64 rowSizeInBytes = 0u;
+    m_footprints.resize(numSubresources);
+    m_numRows.resize(numSubresources);
+    m_written.assign(numSubresources, 0u);
 
     nativeDevice->GetCopyableFootprints(
         &texDesc,
         0,               // FirstSubresource
         numSubresources, // NumSubresources
         0,               // BaseOffset
-        &m_footprint,
-        &numRows,
-        &rowSizeInBytes,
+        m_footprints.data(),
+        m_numRows.data(),
+        nullptr,
         &totalBytes
     );
 
-    m_numRows = numRows;
-    m_rowSizeInBytes = rowSizeInBytes;
     m_totalBytes = totalBytes;
 
     // Create upload buffer
@@ -301,7 +337,7 @@ bool kfe::KFEStagingTexture::Impl::Initialize(const KFE_STAGING_TEXTURE_CREATE_D
     texCreate.HeapType = D3D12_HEAP_TYPE_DEFAULT;
     texCreate.InitialState = D3D12_RESOURCE_STATE_COPY_DEST;
     texCreate.ClearValue = nullptr;
-    texCreate.ResourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    texCreate.ResourceFlags = texDesc.Flags;
 
     if (!m_texture.Initialize(texCreate))
     {
@@ -345,8 +381,9 @@ bool kfe::KFEStagingTexture::Impl::Destroy() noexcept
     m_format = DXGI_FORMAT_UNKNOWN;
     m_mipLevels = 1u;
     m_arraySize = 1u;
-    m_numRows = 0u;
-    m_rowSizeInBytes = 0u;
+    m_footprints.clear();
+    m_numRows.clear();
+    m_written.clear();
     m_totalBytes = 0u;
     m_bInitialized = false;
 
@@ -413,47 +450,67 @@ _Use_decl_annotations_
 bool kfe::KFEStagingTexture::Impl::WritePixels(
     _In_ const void* data,
     std::uint32_t    srcRowPitchBytes) noexcept
+{
+    return WriteSubresource(0u, data, srcRowPitchBytes);
+}
+
+_Use_decl_annotations_
+bool kfe::KFEStagingTexture::Impl::WriteSubresource(
+    std::uint32_t    subresource,
+    _In_ const void* data,
+    std::uint32_t    srcRowPitchBytes) noexcept
 {
     if (!m_bInitialized)
     {
-        LOG_ERROR("KFEStagingTexture::Impl::WritePixels: Staging texture not initialized.");
+        LOG_ERROR("KFEStagingTexture::Impl::WriteSubresource: Staging texture not initialized.");
         return false;
     }
 
     if (!data)
     {
-        LOG_ERROR("KFEStagingTexture::Impl::WritePixels: Source data pointer is null.");
+        LOG_ERROR("KFEStagingTexture::Impl::WriteSubresource: Source data pointer is null.");
         return false;
     }
 
     if (!m_mappedUpload)
     {
-        LOG_ERROR("KFEStagingTexture::Impl::WritePixels: Upload buffer mapped pointer is null.");
+        LOG_ERROR("KFEStagingTexture::Impl::WriteSubresource: Upload buffer mapped pointer is null.");
         return false;
     }
 
-    if (m_numRows == 0u || m_totalBytes == 0u)
+    if (subresource >= m_footprints.size())
     {
-        LOG_ERROR("KFEStagingTexture::Impl::WritePixels: Invalid footprint info (NumRows/TotalBytes == 0).");
+        LOG_ERROR("KFEStagingTexture::Impl::WriteSubresource: Subresource {} has no upload space ({} reserved).",
+            subresource, m_footprints.size());
+        return false;
+    }
+
+    const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = m_footprints[subresource];
+    const UINT numRows = m_numRows[subresource];
+
+    if (numRows == 0u || m_totalBytes == 0u)
+    {
+        LOG_ERROR("KFEStagingTexture::Impl::WriteSubresource: Invalid footprint info (NumRows/TotalBytes == 0).");
         return false;
     }
 
     auto* dstBase = static_cast<std::uint8_t*>(m_mappedUpload);
     const auto* srcBase = static_cast<const std::uint8_t*>(data);
 
-    for (UINT row = 0; row < m_numRows; ++row)
+    for (UINT row = 0; row < numRows; ++row)
     {
-        std::uint8_t* dstRow = dstBase + m_footprint.Offset + row * m_footprint.Footprint.RowPitch;
+        std::uint8_t* dstRow = dstBase + footprint.Offset + static_cast<std::size_t>(row) * footprint.Footprint.RowPitch;
         const std::uint8_t* srcRow = srcBase + static_cast<std::size_t>(row) * srcRowPitchBytes;
 
         const UINT copySize = static_cast<UINT>(
-            srcRowPitchBytes < m_footprint.Footprint.RowPitch
+            srcRowPitchBytes < footprint.Footprint.RowPitch
             ? srcRowPitchBytes
-            : m_footprint.Footprint.RowPitch);
+            : footprint.Footprint.RowPitch);
 
         std::memcpy(dstRow, srcRow, copySize);
     }
 
+    m_written[subresource] = 1u;
     return true;
 }
 
@@ -482,22 +539,29 @@ bool kfe::KFEStagingTexture::Impl::RecordUploadToTexture(
         return false;
     }
 
-    D3D12_TEXTURE_COPY_LOCATION srcLocation{};
-    srcLocation.pResource = uploadRes;
-    srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    srcLocation.PlacedFootprint = m_footprint;
-
-    D3D12_TEXTURE_COPY_LOCATION dstLocation{};
-    dstLocation.pResource = defaultRes;
-    dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    dstLocation.SubresourceIndex = 0u;
-
-    cmdList->CopyTextureRegion(
-        &dstLocation,
-        0, 0, 0,
-        &srcLocation,
-        nullptr
-    );
+    // Subresource 0 always goes, as before; the rest only once written
+    for (std::size_t sub = 0; sub < m_footprints.size(); ++sub)
+    {
+        if (sub > 0u && !m_written[sub])
+            continue;
+
+        D3D12_TEXTURE_COPY_LOCATION srcLocation{};
+        srcLocation.pResource = uploadRes;
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = m_footprints[sub];
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation{};
+        dstLocation.pResource = defaultRes;
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = static_cast<UINT>(sub);
+
+        cmdList->CopyTextureRegion(
+            &dstLocation,
+            0, 0, 0,
+            &srcLocation,
+            nullptr
+        );
+    }
 
     D3D12_RESOURCE_BARRIER barrier{};
     barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -512,4 +576,81 @@ bool kfe::KFEStagingTexture::Impl::RecordUploadToTexture(
     return true;
 }
 
+bool kfe::KFEStagingTexture::Impl::RecordUploadRange(
+    _In_ ID3D12GraphicsCommandList* cmdList,
+    std::uint32_t firstSubresource,
+    std::uint32_t count,
+    bool          bResident) const noexcept
+{
+    if (!m_bInitialized)
+    {
+        LOG_ERROR("KFEStagingTexture::Impl::RecordUploadRange: Staging texture not initialized.");
+        return false;
+    }
+
+    if (!cmdList)
+    {
+        LOG_ERROR("KFEStagingTexture::Impl::RecordUploadRange: cmdList is null.");
+        return false;
+    }
+
+    if (count == 0u || static_cast<std::size_t>(firstSubresource) + count > m_footprints.size())
+    {
+        LOG_ERROR("KFEStagingTexture::Impl::RecordUploadRange: Range [{}, {}) is outside the {} reserved subresources.",
+            firstSubresource, firstSubresource + count, m_footprints.size());
+        return false;
+    }
+
+    ID3D12Resource* uploadRes = m_uploadBuffer.GetNative();
+    ID3D12Resource* defaultRes = m_texture.GetNative();
+
+    if (!uploadRes || !defaultRes)
+    {
+        LOG_ERROR("KFEStagingTexture::Impl::RecordUploadRange: Underlying resources are null.");
+        return false;
+    }
+
+    //~ One barrier per subresource in the range, the others may be sampled meanwhile
+    std::vector<D3D12_RESOURCE_BARRIER> barriers(count);
+    for (std::uint32_t i = 0u; i < count; ++i)
+    {
+        D3D12_RESOURCE_BARRIER& barrier = barriers[i];
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        barrier.Transition.pResource = defaultRes;
+        barrier.Transition.Subresource = firstSubresource + i;
+        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+    }
+
+    if (bResident)
+    {
+        cmdList->ResourceBarrier(count, barriers.data());
+    }
+
+    for (std::uint32_t sub = firstSubresource; sub < firstSubresource + count; ++sub)
+    {
+        D3D12_TEXTURE_COPY_LOCATION srcLocation{};
+        srcLocation.pResource = uploadRes;
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = m_footprints[sub];
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation{};
+        dstLocation.pResource = defaultRes;
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = static_cast<UINT>(sub);
+
+        cmdList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+    }
+
+    for (D3D12_RESOURCE_BARRIER& barrier : barriers)
+    {
+        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    }
+    cmdList->ResourceBarrier(count, barriers.data());
+
+    return true;
+}
+
 #pragma endregion
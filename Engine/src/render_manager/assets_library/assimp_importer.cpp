@@ -10,9 +10,13 @@
 #include "pch.h"
 
 #include "engine/render_manager/assets_library/model/assimp_importer.h"
+#include "engine/render_manager/assets_library/model/tangent_space.h"
+#include "engine/render_manager/assets_library/model/vertex_kernels.h"
+#include "engine/utils/file_system.h"
 #include "engine/utils/logger.h"
 
 #include <algorithm>
+#include <cctype>
 #include <filesystem>
 
 #include <assimp/Importer.hpp>
@@ -21,6 +25,21 @@
 
 namespace kfe::import
 {
+    //~ Formats whose scene lives in the one file. Others (OBJ + MTL, glTF + .bin, ...)
+    //~ open siblings by relative path, which an in-memory read cannot resolve.
+    static bool IsSelfContained(const std::string& filePath, std::string& outHint)
+    {
+        outHint = std::filesystem::path(filePath).extension().string();
+        if (!outHint.empty() && outHint.front() == '.')
+            outHint.erase(0, 1);
+
+        std::transform(outHint.begin(), outHint.end(), outHint.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        return outHint == "fbx" || outHint == "glb" || outHint == "ply"
+            || outHint == "stl" || outHint == "3ds";
+    }
+
     static Float4x4 ConvertMatrix(const aiMatrix4x4& src)
     {
         Float4x4 dst{};
@@ -31,64 +50,30 @@ namespace kfe::import
         return dst;
     }
 
-    static void NormalizeSceneToUnitBox(kfe::import::ImportedScene& scene)
+    //~ Center and uniform scale that fit the scene bounds into a unit box,
+    //~ identity for a degenerate scene
+    static void ComputeUnitBoxTransform(const Float3& sceneMin,
+        const Float3& sceneMax,
+        Float3& outCenter,
+        float& outScale)
     {
-        using kfe::import::Float3;
+        outCenter = { 0.0f, 0.0f, 0.0f };
+        outScale = 1.0f;
 
-        Float3 globalMin{ 1e30f,  1e30f,  1e30f };
-        Float3 globalMax{ -1e30f, -1e30f, -1e30f };
-
-        for (auto& mesh : scene.Meshes)
-        {
-            globalMin.x = std::min(globalMin.x, mesh.AABBMin.x);
-            globalMin.y = std::min(globalMin.y, mesh.AABBMin.y);
-            globalMin.z = std::min(globalMin.z, mesh.AABBMin.z);
-
-            globalMax.x = std::max(globalMax.x, mesh.AABBMax.x);
-            globalMax.y = std::max(globalMax.y, mesh.AABBMax.y);
-            globalMax.z = std::max(globalMax.z, mesh.AABBMax.z);
-        }
-
-        Float3 center{
-            0.5f * (globalMin.x + globalMax.x),
-            0.5f * (globalMin.y + globalMax.y),
-            0.5f * (globalMin.z + globalMax.z)
-        };
-
-        Float3 extent{
-            globalMax.x - globalMin.x,
-            globalMax.y - globalMin.y,
-            globalMax.z - globalMin.z
-        };
+        if (sceneMin.x > sceneMax.x)
+            return;
 
-        const float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        const float maxExtent = std::max(sceneMax.x - sceneMin.x,
+            std::max(sceneMax.y - sceneMin.y, sceneMax.z - sceneMin.z));
         if (maxExtent <= 1e-6f)
             return;
 
-        const float invScale = 1.0f / maxExtent;
-
-        for (auto& mesh : scene.Meshes)
-        {
-            mesh.AABBMin = { 1e30f,  1e30f,  1e30f };
-            mesh.AABBMax = { -1e30f, -1e30f, -1e30f };
-
-            for (auto& v : mesh.Vertices)
-            {
-                auto p = v.Position;
-                p.x = (p.x - center.x) * invScale;
-                p.y = (p.y - center.y) * invScale;
-                p.z = (p.z - center.z) * invScale;
-                v.Position = p;
-
-                mesh.AABBMin.x = std::min(mesh.AABBMin.x, p.x);
-                mesh.AABBMin.y = std::min(mesh.AABBMin.y, p.y);
-                mesh.AABBMin.z = std::min(mesh.AABBMin.z, p.z);
-
-                mesh.AABBMax.x = std::max(mesh.AABBMax.x, p.x);
-                mesh.AABBMax.y = std::max(mesh.AABBMax.y, p.y);
-                mesh.AABBMax.z = std::max(mesh.AABBMax.z, p.z);
-            }
-        }
+        outCenter = {
+            0.5f * (sceneMin.x + sceneMax.x),
+            0.5f * (sceneMin.y + sceneMax.y),
+            0.5f * (sceneMin.z + sceneMax.z)
+        };
+        outScale = 1.0f / maxExtent;
     }
 
     static void ConvertNodeRecursive(const aiScene* scene,
@@ -115,9 +100,24 @@ namespace kfe::import
     AssimpImporter::AssimpImporter() = default;
     AssimpImporter::~AssimpImporter() = default;
 
+    std::uint32_t AssimpImporter::GetPostProcessFlags() const noexcept
+    {
+        unsigned int flags =
+            aiProcess_Triangulate |
+            aiProcess_JoinIdenticalVertices |
+            aiProcess_ConvertToLeftHanded |
+            aiProcess_FlipUVs |
+            aiProcess_FlipWindingOrder;
+
+        if (m_tangentSpace == EImportTangentSpace::Assimp)
+            flags |= aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace;
+
+        return static_cast<std::uint32_t>(flags);
+    }
+
     bool AssimpImporter::LoadFromFile(const std::string& filePath,
         ImportedScene& outScene,
-        std::string& outErrorMessage) noexcept
+        std::string& outErrorMessage) const noexcept
     {
         outScene.Clear();
         outErrorMessage.clear();
@@ -133,16 +133,21 @@ namespace kfe::import
 
         Assimp::Importer importer;
 
-        const unsigned int flags =
-            aiProcess_Triangulate |
-            aiProcess_JoinIdenticalVertices |
-            aiProcess_GenSmoothNormals |
-            aiProcess_CalcTangentSpace |
-            aiProcess_ConvertToLeftHanded |
-            aiProcess_FlipUVs |
-            aiProcess_FlipWindingOrder;
+        const unsigned int flags = GetPostProcessFlags();
+
+        //~ Self contained formats parse from the mapped file, Assimp keeps no copy of it
+        const aiScene* scene = nullptr;
+        std::string    hint;
+        KFEMappedFile  view{};
 
-        const aiScene* scene = importer.ReadFile(filePath, flags);
+        if (IsSelfContained(filePath, hint) && KFEFileSystem::MapForRead(filePath, view))
+        {
+            scene = importer.ReadFileFromMemory(view.GetData(),
+                static_cast<std::size_t>(view.GetSize()), flags, hint.c_str());
+        }
+
+        if (!scene)
+            scene = importer.ReadFile(filePath, flags);
 
         if (!scene)
         {
@@ -158,6 +163,25 @@ namespace kfe::import
             return false;
         }
 
+        //~ Scene bounds first, the unit box transform is applied while converting
+        static_assert(sizeof(aiVector3D) == 3u * sizeof(float), "Vertex kernels expect float aiVector3D");
+
+        Float3 sceneMin{ 1e30f,  1e30f,  1e30f };
+        Float3 sceneMax{ -1e30f, -1e30f, -1e30f };
+
+        for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+        {
+            const aiMesh* srcMesh = scene->mMeshes[meshIndex];
+            if (!srcMesh || srcMesh->mNumVertices == 0u)
+                continue;
+
+            KFEVertexKernels::ReduceAABB(&srcMesh->mVertices[0].x, srcMesh->mNumVertices, sceneMin, sceneMax);
+        }
+
+        Float3 center{};
+        float scale = 1.0f;
+        ComputeUnitBoxTransform(sceneMin, sceneMax, center, scale);
+
         //~ Meshes
         outScene.Meshes.reserve(scene->mNumMeshes);
 
@@ -169,72 +193,36 @@ namespace kfe::import
 
             ImportedMesh mesh{};
             mesh.Name = srcMesh->mName.C_Str();
+            mesh.MaterialIndex = srcMesh->mMaterialIndex;
 
-            const bool hasNormals = srcMesh->HasNormals();
-            const bool hasTangents = srcMesh->HasTangentsAndBitangents();
-            bool hasUV[KFE_MAX_UV_CHANNELS] = { false, false };
+            KFE_VERTEX_SOURCE_STREAMS streams{};
+            streams.VertexCount = srcMesh->mNumVertices;
 
-            for (std::uint32_t ch = 0; ch < KFE_MAX_UV_CHANNELS; ++ch)
-                hasUV[ch] = srcMesh->HasTextureCoords(ch);
-
-            mesh.Vertices.resize(srcMesh->mNumVertices);
-
-            for (unsigned int v = 0; v < srcMesh->mNumVertices; ++v)
+            if (srcMesh->mNumVertices > 0u)
             {
-                ImportedVertex& outV = mesh.Vertices[v];
-
-                const aiVector3D& p = srcMesh->mVertices[v];
-                outV.Position = { p.x, p.y, p.z };
-
-                mesh.AABBMin.x = std::min(mesh.AABBMin.x, outV.Position.x);
-                mesh.AABBMin.y = std::min(mesh.AABBMin.y, outV.Position.y);
-                mesh.AABBMin.z = std::min(mesh.AABBMin.z, outV.Position.z);
-
-                mesh.AABBMax.x = std::max(mesh.AABBMax.x, outV.Position.x);
-                mesh.AABBMax.y = std::max(mesh.AABBMax.y, outV.Position.y);
-                mesh.AABBMax.z = std::max(mesh.AABBMax.z, outV.Position.z);
-
-                if (hasNormals)
-                {
-                    const aiVector3D& n = srcMesh->mNormals[v];
-                    outV.Normal = { n.x, n.y, n.z };
-                    outV.HasNormal = true;
-                }
-                else
-                {
-                    outV.HasNormal = false;
-                }
-
-                if (hasTangents)
-                {
-                    outV.HasTangent = true;
+                streams.Positions = &srcMesh->mVertices[0].x;
 
-                    const aiVector3D& t = srcMesh->mTangents[v];
-                    const aiVector3D& bt = srcMesh->mBitangents[v];
+                if (srcMesh->HasNormals())
+                    streams.Normals = &srcMesh->mNormals[0].x;
 
-                    outV.Tangent = { t.x,  t.y,  t.z };
-                    outV.Bitangent = { bt.x, bt.y, bt.z };
-                }
-                else
+                if (srcMesh->HasTangentsAndBitangents())
                 {
-                    outV.HasTangent = false;
+                    streams.Tangents = &srcMesh->mTangents[0].x;
+                    streams.Bitangents = &srcMesh->mBitangents[0].x;
                 }
 
                 for (std::uint32_t ch = 0; ch < KFE_MAX_UV_CHANNELS; ++ch)
                 {
-                    if (hasUV[ch])
-                    {
-                        const aiVector3D& uv = srcMesh->mTextureCoords[ch][v];
-                        outV.UV[ch] = { uv.x, uv.y };
-                        outV.HasUV[ch] = true;
-                    }
-                    else
-                    {
-                        outV.HasUV[ch] = false;
-                    }
+                    if (srcMesh->HasTextureCoords(ch))
+                        streams.UV[ch] = &srcMesh->mTextureCoords[ch][0].x;
                 }
             }
 
+            //~ One pass: stream conversion, unit box transform and mesh bounds
+            mesh.Vertices.resize(srcMesh->mNumVertices);
+            KFEVertexKernels::ConvertVertices(streams, center, scale,
+                mesh.Vertices.data(), mesh.AABBMin, mesh.AABBMax);
+
             mesh.Indices.reserve(srcMesh->mNumFaces * 3u);
 
             for (unsigned int f = 0; f < srcMesh->mNumFaces; ++f)
@@ -254,7 +242,9 @@ namespace kfe::import
             outScene.Meshes.emplace_back(std::move(mesh));
         }
 
-        NormalizeSceneToUnitBox(outScene);
+        //~ Runs on the final left handed data, the same space Assimp's steps see
+        if (m_tangentSpace == EImportTangentSpace::Engine)
+            KFETangentSpace::ProcessScene(outScene);
 
         //~ Node hierarchy
         ConvertNodeRecursive(scene, scene->mRootNode, outScene.RootNode);
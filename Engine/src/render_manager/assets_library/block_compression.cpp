@@ -0,0 +1,626 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : block_compression.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/texture/block_compression.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace kfe
+{
+    namespace
+    {
+        //~ BC7 4 bit index weights, out of 64
+        constexpr std::int32_t kWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        struct BlockTexels
+        {
+            float Px[16][4];
+        };
+
+        BlockTexels ToFloat(const std::uint8_t* rgba) noexcept
+        {
+            BlockTexels block{};
+            for (int i = 0; i < 16; ++i)
+                for (int c = 0; c < 4; ++c)
+                    block.Px[i][c] = static_cast<float>(rgba[i * 4 + c]);
+            return block;
+        }
+
+        //~ Mean and dominant direction of the first `channels` channels, power iteration
+        void PrincipalAxis(const BlockTexels& block, int channels, float mean[4], float axis[4]) noexcept
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                mean[c] = 0.0f;
+                axis[c] = 0.0f;
+            }
+
+            for (int i = 0; i < 16; ++i)
+                for (int c = 0; c < channels; ++c)
+                    mean[c] += block.Px[i][c];
+
+            for (int c = 0; c < channels; ++c)
+                mean[c] *= 1.0f / 16.0f;
+
+            float cov[4][4]{};
+            for (int i = 0; i < 16; ++i)
+            {
+                float d[4]{};
+                for (int c = 0; c < channels; ++c)
+                    d[c] = block.Px[i][c] - mean[c];
+
+                for (int r = 0; r < channels; ++r)
+                    for (int c = 0; c < channels; ++c)
+                        cov[r][c] += d[r] * d[c];
+            }
+
+            float v[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+            for (int iter = 0; iter < 8; ++iter)
+            {
+                float next[4]{};
+                for (int r = 0; r < channels; ++r)
+                    for (int c = 0; c < channels; ++c)
+                        next[r] += cov[r][c] * v[c];
+
+                float len = 0.0f;
+                for (int c = 0; c < channels; ++c)
+                    len += next[c] * next[c];
+
+                if (len <= 1e-12f)
+                    break;
+
+                len = 1.0f / std::sqrt(len);
+                for (int c = 0; c < channels; ++c)
+                    v[c] = next[c] * len;
+            }
+
+            for (int c = 0; c < channels; ++c)
+                axis[c] = v[c];
+        }
+
+        //~ Block extremes along the axis, the endpoints before quantization
+        void AxisExtremes(const BlockTexels& block, int channels, const float mean[4], const float axis[4],
+            float lo[4], float hi[4]) noexcept
+        {
+            float tMin = 1e30f;
+            float tMax = -1e30f;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < channels; ++c)
+                    t += (block.Px[i][c] - mean[c]) * axis[c];
+                tMin = (std::min)(tMin, t);
+                tMax = (std::max)(tMax, t);
+            }
+
+            for (int c = 0; c < 4; ++c)
+            {
+                lo[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+                hi[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+            }
+        }
+
+#pragma region BC1_Colour
+
+        std::uint16_t Pack565(const float c[3]) noexcept
+        {
+            const auto r = static_cast<std::uint32_t>(std::lround(std::clamp(c[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+            const auto g = static_cast<std::uint32_t>(std::lround(std::clamp(c[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+            const auto b = static_cast<std::uint32_t>(std::lround(std::clamp(c[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+            return static_cast<std::uint16_t>((r << 11u) | (g << 5u) | b);
+        }
+
+        void Unpack565(std::uint16_t v, std::int32_t out[3]) noexcept
+        {
+            const std::int32_t r = (v >> 11) & 31;
+            const std::int32_t g = (v >> 5) & 63;
+            const std::int32_t b = v & 31;
+            out[0] = (r << 3) | (r >> 2);
+            out[1] = (g << 2) | (g >> 4);
+            out[2] = (b << 3) | (b >> 2);
+        }
+
+        //~ Four colour palette, returns the summed squared error
+        std::int32_t SelectColourIndices(const std::uint8_t* rgba, std::uint16_t c0, std::uint16_t c1,
+            std::uint8_t indices[16]) noexcept
+        {
+            std::int32_t pal[4][3];
+            Unpack565(c0, pal[0]);
+            Unpack565(c1, pal[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+                pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+            }
+
+            std::int32_t total = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                std::int32_t best = 0x7FFFFFFF;
+                for (int p = 0; p < 4; ++p)
+                {
+                    std::int32_t err = 0;
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        const std::int32_t d = rgba[i * 4 + c] - pal[p][c];
+                        err += d * d;
+                    }
+
+                    if (err < best)
+                    {
+                        best = err;
+                        indices[i] = static_cast<std::uint8_t>(p);
+                    }
+                }
+                total += best;
+            }
+            return total;
+        }
+
+        //~ Least squares endpoints for fixed indices
+        bool RefitColour(const BlockTexels& block, const std::uint8_t indices[16], float c0[3], float c1[3]) noexcept
+        {
+            constexpr float kW0[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+            float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+            float ax[3]{}, bx[3]{};
+
+            for (int i = 0; i < 16; ++i)
+            {
+                const float a = kW0[indices[i]];
+                const float b = 1.0f - a;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (int c = 0; c < 3; ++c)
+                {
+                    ax[c] += a * block.Px[i][c];
+                    bx[c] += b * block.Px[i][c];
+                }
+            }
+
+            const float det = aa * bb - ab * ab;
+            if (std::fabs(det) < 1e-6f)
+                return false;
+
+            const float inv = 1.0f / det;
+            for (int c = 0; c < 3; ++c)
+            {
+                c0[c] = (ax[c] * bb - bx[c] * ab) * inv;
+                c1[c] = (bx[c] * aa - ax[c] * ab) * inv;
+            }
+            return true;
+        }
+
+        //~ Always the four colour mode (c0 > c1), BC3 reads it that way regardless
+        void EncodeColourBlock(const std::uint8_t* rgba, std::uint8_t* out8) noexcept
+        {
+            const BlockTexels block = ToFloat(rgba);
+
+            float mean[4], axis[4], lo[4], hi[4];
+            PrincipalAxis(block, 3, mean, axis);
+            AxisExtremes(block, 3, mean, axis, lo, hi);
+
+            std::uint16_t c0 = Pack565(hi);
+            std::uint16_t c1 = Pack565(lo);
+            std::uint8_t indices[16]{};
+            std::int32_t error = SelectColourIndices(rgba, c0, c1, indices);
+
+            float r0[3], r1[3];
+            if (error > 0 && RefitColour(block, indices, r0, r1))
+            {
+                const std::uint16_t n0 = Pack565(r0);
+                const std::uint16_t n1 = Pack565(r1);
+                std::uint8_t refit[16]{};
+                const std::int32_t refitError = SelectColourIndices(rgba, n0, n1, refit);
+                if (refitError < error)
+                {
+                    c0 = n0;
+                    c1 = n1;
+                    error = refitError;
+                    std::memcpy(indices, refit, sizeof(indices));
+                }
+            }
+
+            if (c0 < c1)
+            {
+                std::swap(c0, c1);
+                constexpr std::uint8_t kSwap[4] = { 1, 0, 3, 2 };
+                for (auto& index : indices)
+                    index = kSwap[index];
+            }
+            else if (c0 == c1)
+            {
+                std::memset(indices, 0, sizeof(indices));
+            }
+
+            std::uint32_t bits = 0u;
+            for (int i = 0; i < 16; ++i)
+                bits |= static_cast<std::uint32_t>(indices[i]) << (2 * i);
+
+            out8[0] = static_cast<std::uint8_t>(c0 & 0xFFu);
+            out8[1] = static_cast<std::uint8_t>(c0 >> 8);
+            out8[2] = static_cast<std::uint8_t>(c1 & 0xFFu);
+            out8[3] = static_cast<std::uint8_t>(c1 >> 8);
+            std::memcpy(out8 + 4, &bits, sizeof(bits));
+        }
+
+#pragma endregion
+
+#pragma region BC4_Channel
+
+        //~ Eight value mode, endpoints at the channel range
+        void EncodeChannelBlock(const std::uint8_t* rgba, std::uint32_t channel, std::uint8_t* out8) noexcept
+        {
+            std::int32_t lo = 255;
+            std::int32_t hi = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                const std::int32_t v = rgba[i * 4 + channel];
+                lo = (std::min)(lo, v);
+                hi = (std::max)(hi, v);
+            }
+
+            out8[0] = static_cast<std::uint8_t>(hi);
+            out8[1] = static_cast<std::uint8_t>(lo);
+
+            std::uint64_t bits = 0u;
+            if (hi != lo)
+            {
+                std::int32_t pal[8];
+                pal[0] = hi;
+                pal[1] = lo;
+                for (int k = 2; k < 8; ++k)
+                    pal[k] = ((8 - k) * hi + (k - 1) * lo + 3) / 7;
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    const std::int32_t v = rgba[i * 4 + channel];
+                    std::int32_t best = 0x7FFFFFFF;
+                    std::uint64_t index = 0u;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        const std::int32_t d = std::abs(v - pal[k]);
+                        if (d < best)
+                        {
+                            best = d;
+                            index = static_cast<std::uint64_t>(k);
+                        }
+                    }
+                    bits |= index << (3 * i);
+                }
+            }
+
+            for (int b = 0; b < 6; ++b)
+                out8[2 + b] = static_cast<std::uint8_t>((bits >> (8 * b)) & 0xFFu);
+        }
+
+#pragma endregion
+
+#pragma region BC7_Mode6
+
+        struct BitWriter
+        {
+            std::uint64_t Lo = 0u;
+            std::uint64_t Hi = 0u;
+            std::uint32_t Pos = 0u;
+
+            void Put(std::uint32_t value, std::uint32_t count) noexcept
+            {
+                for (std::uint32_t b = 0; b < count; ++b, ++Pos)
+                {
+                    const std::uint64_t bit = (value >> b) & 1u;
+                    if (Pos < 64u)
+                        Lo |= bit << Pos;
+                    else
+                        Hi |= bit << (Pos - 64u);
+                }
+            }
+        };
+
+        struct Mode6Candidate
+        {
+            std::int32_t  Q[2][4]{};    //~ 7 bit endpoints
+            std::int32_t  P[2]{};       //~ p-bits
+            std::uint8_t  Indices[16]{};
+            std::int64_t  Error = INT64_MAX;
+        };
+
+        //~ Index choice by projection onto the endpoint line, then the two neighbours
+        std::int64_t SelectMode6Indices(const std::uint8_t* rgba, const std::int32_t ep[2][4],
+            std::uint8_t indices[16]) noexcept
+        {
+            std::int32_t pal[16][4];
+            for (int k = 0; k < 16; ++k)
+                for (int c = 0; c < 4; ++c)
+                    pal[k][c] = ((64 - kWeights4[k]) * ep[0][c] + kWeights4[k] * ep[1][c] + 32) >> 6;
+
+            float dir[4];
+            float dd = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                dir[c] = static_cast<float>(ep[1][c] - ep[0][c]);
+                dd += dir[c] * dir[c];
+            }
+            const float invDD = dd > 0.0f ? 15.0f / dd : 0.0f;
+
+            std::int64_t total = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < 4; ++c)
+                    t += (static_cast<float>(rgba[i * 4 + c]) - static_cast<float>(ep[0][c])) * dir[c];
+
+                const int guess = std::clamp(static_cast<int>(std::lround(t * invDD)), 0, 15);
+
+                std::int32_t best = 0x7FFFFFFF;
+                for (int k = (std::max)(guess - 1, 0); k <= (std::min)(guess + 1, 15); ++k)
+                {
+                    std::int32_t err = 0;
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        const std::int32_t d = rgba[i * 4 + c] - pal[k][c];
+                        err += d * d;
+                    }
+
+                    if (err < best)
+                    {
+                        best = err;
+                        indices[i] = static_cast<std::uint8_t>(k);
+                    }
+                }
+                total += best;
+            }
+            return total;
+        }
+
+        //~ Tries the four p-bit pairs for continuous endpoints lo/hi
+        void QuantizeMode6(const std::uint8_t* rgba, const float e0[4], const float e1[4], Mode6Candidate& best) noexcept
+        {
+            for (std::int32_t p0 = 0; p0 < 2; ++p0)
+            {
+                for (std::int32_t p1 = 0; p1 < 2; ++p1)
+                {
+                    Mode6Candidate cand{};
+                    cand.P[0] = p0;
+                    cand.P[1] = p1;
+
+                    std::int32_t ep[2][4];
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        cand.Q[0][c] = std::clamp(static_cast<std::int32_t>(std::lround((e0[c] - p0) * 0.5f)), 0, 127);
+                        cand.Q[1][c] = std::clamp(static_cast<std::int32_t>(std::lround((e1[c] - p1) * 0.5f)), 0, 127);
+                        ep[0][c] = (cand.Q[0][c] << 1) | p0;
+                        ep[1][c] = (cand.Q[1][c] << 1) | p1;
+                    }
+
+                    cand.Error = SelectMode6Indices(rgba, ep, cand.Indices);
+                    if (cand.Error < best.Error)
+                        best = cand;
+                }
+            }
+        }
+
+        bool RefitMode6(const BlockTexels& block, const std::uint8_t indices[16], float e0[4], float e1[4]) noexcept
+        {
+            float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+            float ax[4]{}, bx[4]{};
+
+            for (int i = 0; i < 16; ++i)
+            {
+                const float b = static_cast<float>(kWeights4[indices[i]]) / 64.0f;
+                const float a = 1.0f - b;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (int c = 0; c < 4; ++c)
+                {
+                    ax[c] += a * block.Px[i][c];
+                    bx[c] += b * block.Px[i][c];
+                }
+            }
+
+            const float det = aa * bb - ab * ab;
+            if (std::fabs(det) < 1e-6f)
+                return false;
+
+            const float inv = 1.0f / det;
+            for (int c = 0; c < 4; ++c)
+            {
+                e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inv, 0.0f, 255.0f);
+                e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inv, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        void EncodeMode6(const std::uint8_t* rgba, std::uint8_t* out16) noexcept
+        {
+            const BlockTexels block = ToFloat(rgba);
+
+            float mean[4], axis[4], lo[4], hi[4];
+            PrincipalAxis(block, 4, mean, axis);
+            AxisExtremes(block, 4, mean, axis, lo, hi);
+
+            Mode6Candidate best{};
+            QuantizeMode6(rgba, lo, hi, best);
+
+            for (int pass = 0; pass < 2 && best.Error > 0; ++pass)
+            {
+                float e0[4], e1[4];
+                if (!RefitMode6(block, best.Indices, e0, e1))
+                    break;
+
+                const std::int64_t before = best.Error;
+                QuantizeMode6(rgba, e0, e1, best);
+                if (best.Error >= before)
+                    break;
+            }
+
+            //~ Anchor texel index must have its top bit clear
+            if (best.Indices[0] & 8u)
+            {
+                for (int c = 0; c < 4; ++c)
+                    std::swap(best.Q[0][c], best.Q[1][c]);
+                std::swap(best.P[0], best.P[1]);
+                for (auto& index : best.Indices)
+                    index = static_cast<std::uint8_t>(15u - index);
+            }
+
+            BitWriter w{};
+            w.Put(1u << 6, 7);
+            for (int c = 0; c < 4; ++c)
+            {
+                w.Put(static_cast<std::uint32_t>(best.Q[0][c]), 7);
+                w.Put(static_cast<std::uint32_t>(best.Q[1][c]), 7);
+            }
+            w.Put(static_cast<std::uint32_t>(best.P[0]), 1);
+            w.Put(static_cast<std::uint32_t>(best.P[1]), 1);
+
+            w.Put(best.Indices[0], 3);
+            for (int i = 1; i < 16; ++i)
+                w.Put(best.Indices[i], 4);
+
+            std::memcpy(out16, &w.Lo, 8);
+            std::memcpy(out16 + 8, &w.Hi, 8);
+        }
+
+#pragma endregion
+
+        void GatherBlock(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height,
+            std::uint32_t bx, std::uint32_t by, std::uint8_t out[64]) noexcept
+        {
+            for (std::uint32_t y = 0; y < 4u; ++y)
+            {
+                const std::uint32_t sy = (std::min)(by * 4u + y, height - 1u);
+                for (std::uint32_t x = 0; x < 4u; ++x)
+                {
+                    const std::uint32_t sx = (std::min)(bx * 4u + x, width - 1u);
+                    std::memcpy(out + (y * 4u + x) * 4u,
+                        rgba + (static_cast<std::size_t>(sy) * width + sx) * 4u, 4u);
+                }
+            }
+        }
+    }
+
+    void KFEBlockCompression::EncodeBC1(const std::uint8_t* rgba, std::uint8_t* out8) noexcept
+    {
+        EncodeColourBlock(rgba, out8);
+    }
+
+    void KFEBlockCompression::EncodeBC3(const std::uint8_t* rgba, std::uint8_t* out16) noexcept
+    {
+        EncodeChannelBlock(rgba, 3u, out16);
+        EncodeColourBlock(rgba, out16 + 8);
+    }
+
+    void KFEBlockCompression::EncodeBC4(const std::uint8_t* rgba, std::uint32_t channel, std::uint8_t* out8) noexcept
+    {
+        EncodeChannelBlock(rgba, (std::min)(channel, 3u), out8);
+    }
+
+    void KFEBlockCompression::EncodeBC5(const std::uint8_t* rgba, std::uint8_t* out16) noexcept
+    {
+        EncodeChannelBlock(rgba, 0u, out16);
+        EncodeChannelBlock(rgba, 1u, out16 + 8);
+    }
+
+    void KFEBlockCompression::EncodeBC7(const std::uint8_t* rgba, std::uint8_t* out16) noexcept
+    {
+        EncodeMode6(rgba, out16);
+    }
+
+    std::uint32_t KFEBlockCompression::GetBlockBytes(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC4_UNORM:
+            return 8u;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+            return 16u;
+        default:
+            return 0u;
+        }
+    }
+
+    bool KFEBlockCompression::CompressImage(DXGI_FORMAT format,
+                                            const std::uint8_t* rgba,
+                                            std::uint32_t width,
+                                            std::uint32_t height,
+                                            std::uint8_t* out,
+                                            std::uint32_t threadCount) noexcept
+    {
+        const std::uint32_t blockBytes = GetBlockBytes(format);
+        if (!rgba || !out || width == 0u || height == 0u || blockBytes == 0u)
+            return false;
+
+        const std::uint32_t blocksX = (width + 3u) / 4u;
+        const std::uint32_t blocksY = (height + 3u) / 4u;
+
+        auto EncodeRow = [&](std::uint32_t by) noexcept
+            {
+                std::uint8_t texels[64];
+                std::uint8_t* dst = out + static_cast<std::size_t>(by) * blocksX * blockBytes;
+
+                for (std::uint32_t bx = 0; bx < blocksX; ++bx, dst += blockBytes)
+                {
+                    GatherBlock(rgba, width, height, bx, by, texels);
+
+                    switch (format)
+                    {
+                    case DXGI_FORMAT_BC1_UNORM: EncodeBC1(texels, dst);     break;
+                    case DXGI_FORMAT_BC3_UNORM: EncodeBC3(texels, dst);     break;
+                    case DXGI_FORMAT_BC4_UNORM: EncodeBC4(texels, 0u, dst); break;
+                    case DXGI_FORMAT_BC5_UNORM: EncodeBC5(texels, dst);     break;
+                    default:                    EncodeBC7(texels, dst);     break;
+                    }
+                }
+            };
+
+        if (threadCount == 0u)
+            threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+        threadCount = (std::min)(threadCount, blocksY);
+
+        if (threadCount <= 1u)
+        {
+            for (std::uint32_t by = 0; by < blocksY; ++by)
+                EncodeRow(by);
+            return true;
+        }
+
+        //~ Rows of blocks handed out one at a time, output is independent of the split
+        std::atomic<std::uint32_t> nextRow{ 0u };
+        auto Worker = [&]() noexcept
+            {
+                for (std::uint32_t by = nextRow.fetch_add(1u); by < blocksY; by = nextRow.fetch_add(1u))
+                    EncodeRow(by);
+            };
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(threadCount - 1u);
+            for (std::uint32_t t = 1u; t < threadCount; ++t)
+                workers.emplace_back(Worker);
+            Worker();
+        }
+
+        return true;
+    }
+}
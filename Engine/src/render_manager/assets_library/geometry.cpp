@@ -11,12 +11,29 @@
 #include "pch.h"
 
 #include "engine/render_manager/assets_library/model/geometry.h"
+#include "engine/render_manager/assets_library/model/mesh_optimizer.h"
 #include "engine/utils/logger.h"
 
+#include <cstddef>
+#include <cstring>
+
 namespace kfe
 {
     using namespace DirectX;
 
+    //~ BuildFromImportedMesh copies vertices as raw bytes
+    using import::ImportedVertex;
+    static_assert(sizeof(ImportedVertex) == sizeof(KFEMeshVertex));
+    static_assert(offsetof(ImportedVertex, Normal)     == offsetof(KFEMeshVertex, Normal));
+    static_assert(offsetof(ImportedVertex, Tangent)    == offsetof(KFEMeshVertex, Tangent));
+    static_assert(offsetof(ImportedVertex, Bitangent)  == offsetof(KFEMeshVertex, Bitangent));
+    static_assert(offsetof(ImportedVertex, UV)         == offsetof(KFEMeshVertex, UV0));
+    static_assert(offsetof(ImportedVertex, UV) + sizeof(import::Float2) == offsetof(KFEMeshVertex, UV1));
+    static_assert(offsetof(ImportedVertex, HasNormal)  == offsetof(KFEMeshVertex, HasNormal));
+    static_assert(offsetof(ImportedVertex, HasTangent) == offsetof(KFEMeshVertex, HasTangent));
+    static_assert(offsetof(ImportedVertex, HasUV)      == offsetof(KFEMeshVertex, HasUV0));
+    static_assert(offsetof(ImportedVertex, HasUV) + 1u == offsetof(KFEMeshVertex, HasUV1));
+
     KFEMeshGeometry::KFEMeshGeometry()
         : m_aabbMin(1e30f, 1e30f, 1e30f)
         , m_aabbMax(-1e30f, -1e30f, -1e30f)
@@ -32,9 +49,20 @@ namespace kfe
         : m_name(std::move(other.m_name))
         , m_vertices(std::move(other.m_vertices))
         , m_indices(std::move(other.m_indices))
+        , m_meshlets(std::move(other.m_meshlets))
+        , m_lods(std::move(other.m_lods))
+        , m_vertexView(other.m_vertexView)
+        , m_indexView(other.m_indexView)
+        , m_meshletView(other.m_meshletView)
+        , m_lodView(other.m_lodView)
+        , m_pBacking(std::move(other.m_pBacking))
         , m_aabbMin(other.m_aabbMin)
         , m_aabbMax(other.m_aabbMax)
     {
+        other.m_vertexView = {};
+        other.m_indexView = {};
+        other.m_meshletView = {};
+        other.m_lodView = {};
         other.m_aabbMin = XMFLOAT3(1e30f, 1e30f, 1e30f);
         other.m_aabbMax = XMFLOAT3(-1e30f, -1e30f, -1e30f);
     }
@@ -46,20 +74,127 @@ namespace kfe
             m_name = std::move(other.m_name);
             m_vertices = std::move(other.m_vertices);
             m_indices = std::move(other.m_indices);
+            m_meshlets = std::move(other.m_meshlets);
+            m_lods = std::move(other.m_lods);
+            m_vertexView = other.m_vertexView;
+            m_indexView = other.m_indexView;
+            m_meshletView = other.m_meshletView;
+            m_lodView = other.m_lodView;
+            m_pBacking = std::move(other.m_pBacking);
             m_aabbMin = other.m_aabbMin;
             m_aabbMax = other.m_aabbMax;
 
+            other.m_vertexView = {};
+            other.m_indexView = {};
+            other.m_meshletView = {};
+            other.m_lodView = {};
             other.m_aabbMin = XMFLOAT3(1e30f, 1e30f, 1e30f);
             other.m_aabbMax = XMFLOAT3(-1e30f, -1e30f, -1e30f);
         }
         return *this;
     }
 
+    void KFEMeshGeometry::MakeOwnedLod0()
+    {
+        const std::size_t lod0Count = m_lodView.empty()
+            ? m_indexView.size()
+            : static_cast<std::size_t>(m_lodView.front().IndexCount);
+
+        if (IsExternal())
+        {
+            m_vertices.assign(m_vertexView.begin(), m_vertexView.end());
+            m_indices.assign(m_indexView.begin(), m_indexView.begin() + lod0Count);
+            m_meshlets.assign(m_meshletView.begin(), m_meshletView.end());
+            m_pBacking.reset();
+        }
+        else
+        {
+            m_indices.resize(lod0Count);
+        }
+
+        m_lods.clear();
+        m_vertexView = m_vertices;
+        m_indexView = m_indices;
+        m_meshletView = m_meshlets;
+        m_lodView = {};
+    }
+
+    bool KFEMeshGeometry::Optimize(const KFE_MESH_OPTIMIZE_DESC& desc, KFE_MESH_OPTIMIZE_STATS* outStats) noexcept
+    {
+        if (!IsValid())
+            return false;
+
+        MakeOwnedLod0();
+
+        const bool ok = KFEMeshOptimizer::Optimize(m_vertices, m_indices, desc, outStats);
+
+        m_vertexView = m_vertices;
+        m_indexView = m_indices;
+
+        //~ Triangle order changed, meshlet ranges are stale
+        m_meshlets.clear();
+        m_meshletView = {};
+
+        return ok;
+    }
+
+    bool KFEMeshGeometry::BuildMeshlets(const KFE_MESHLET_BUILD_DESC& desc, KFE_MESHLET_BUILD_STATS* outStats) noexcept
+    {
+        if (!IsValid())
+            return false;
+
+        MakeOwnedLod0();
+
+        if (!KFEMeshletBuilder::Build(m_vertices, m_indices, desc, m_meshlets, outStats))
+        {
+            LOG_WARNING("KFEMeshGeometry::BuildMeshlets: Failed for mesh '{}'", m_name);
+            m_meshlets.clear();
+            m_meshletView = {};
+            m_indexView = m_indices;
+            return false;
+        }
+
+        //~ Meshlet order is a walk over neighbours, keep vertex fetch in that order too
+        KFEMeshOptimizer::OptimizeVertexFetch(m_vertices, m_indices);
+
+        m_vertexView = m_vertices;
+        m_indexView = m_indices;
+        m_meshletView = m_meshlets;
+
+        return true;
+    }
+
+    bool KFEMeshGeometry::BuildLods(const KFE_MESH_LOD_DESC& desc) noexcept
+    {
+        if (!IsValid())
+            return false;
+
+        MakeOwnedLod0();
+
+        const bool ok = KFEMeshSimplifier::BuildLodChain(m_vertices, m_indices, desc, m_lods);
+        if (!ok)
+        {
+            LOG_WARNING("KFEMeshGeometry::BuildLods: Failed for mesh '{}'", m_name);
+        }
+
+        m_indexView = m_indices;
+        m_lodView = m_lods;
+
+        return ok;
+    }
+
     void KFEMeshGeometry::Clear() noexcept
     {
         m_name.clear();
         m_vertices.clear();
         m_indices.clear();
+        m_meshlets.clear();
+        m_lods.clear();
+        m_vertexView = {};
+        m_indexView = {};
+        m_meshletView = {};
+        m_lodView = {};
+        m_pBacking.reset();
 
         m_aabbMin = XMFLOAT3(1e30f, 1e30f, 1e30f);
         m_aabbMax = XMFLOAT3(-1e30f, -1e30f, -1e30f);
@@ -81,50 +216,47 @@ namespace kfe
         m_aabbMin = XMFLOAT3(src.AABBMin.x, src.AABBMin.y, src.AABBMin.z);
         m_aabbMax = XMFLOAT3(src.AABBMax.x, src.AABBMax.y, src.AABBMax.z);
 
+        //~ ImportedVertex already carries the engine defaults for missing attributes
         m_vertices.resize(src.Vertices.size());
+        std::memcpy(m_vertices.data(), src.Vertices.data(), src.Vertices.size() * sizeof(KFEMeshVertex));
         m_indices = src.Indices;
 
-        for (std::size_t i = 0; i < src.Vertices.size(); ++i)
-        {
-            const kfe::import::ImportedVertex& inV = src.Vertices[i];
-            KFEMeshVertex& outV = m_vertices[i];
+        m_vertexView = m_vertices;
+        m_indexView = m_indices;
 
-            //~ Position
-            outV.Position = XMFLOAT3(inV.Position.x, inV.Position.y, inV.Position.z);
+        LOG_INFO("KFEMeshGeometry::BuildFromImportedMesh: Built mesh '{}' (verts={}, indices={})",
+            m_name, m_vertices.size(), m_indices.size());
 
-            //~ Normal
-            outV.HasNormal = inV.HasNormal;
-            outV.Normal = inV.HasNormal
-                ? XMFLOAT3(inV.Normal.x, inV.Normal.y, inV.Normal.z)
-                : XMFLOAT3(0.0f, 1.0f, 0.0f);
+        return true;
+    }
 
-            //~ Tangent / Bitangent
-            outV.HasTangent = inV.HasTangent;
-            if (inV.HasTangent)
-            {
-                outV.Tangent = XMFLOAT3(inV.Tangent.x, inV.Tangent.y, inV.Tangent.z);
-                outV.Bitangent = XMFLOAT3(inV.Bitangent.x, inV.Bitangent.y, inV.Bitangent.z);
-            }
-            else
-            {
-                outV.Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
-                outV.Bitangent = XMFLOAT3(0.0f, 0.0f, 1.0f);
-            }
-
-            //~ UVs (geometry only, no texture meaning)
-            outV.HasUV0 = inV.HasUV[0];
-            outV.UV0 = inV.HasUV[0]
-                ? XMFLOAT2(inV.UV[0].x, inV.UV[0].y)
-                : XMFLOAT2(0.0f, 0.0f);
-
-            outV.HasUV1 = inV.HasUV[1];
-            outV.UV1 = inV.HasUV[1]
-                ? XMFLOAT2(inV.UV[1].x, inV.UV[1].y)
-                : XMFLOAT2(0.0f, 0.0f);
+    bool KFEMeshGeometry::BuildFromView(
+        const std::string& name,
+        std::span<const KFEMeshVertex> vertices,
+        std::span<const std::uint32_t> indices,
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax,
+        std::shared_ptr<const void> backing,
+        std::span<const KFE_MESHLET> meshlets,
+        std::span<const KFE_MESH_LOD> lods) noexcept
+    {
+        Clear();
+
+        if (vertices.empty() || indices.empty())
+        {
+            LOG_WARNING("KFEMeshGeometry::BuildFromView: Source mesh '{}' is empty", name);
+            return false;
         }
 
-        LOG_INFO("KFEMeshGeometry::BuildFromImportedMesh: Built mesh '{}' (verts={}, indices={})",
-            m_name, m_vertices.size(), m_indices.size());
+        m_name = name;
+        m_aabbMin = aabbMin;
+        m_aabbMax = aabbMax;
+
+        m_vertexView = vertices;
+        m_indexView = indices;
+        m_meshletView = meshlets;
+        m_lodView = lods;
+        m_pBacking = std::move(backing);
 
         return true;
     }
@@ -134,14 +266,24 @@ namespace kfe
         return m_name;
     }
 
-    const std::vector<KFEMeshVertex>& KFEMeshGeometry::GetVertices() const noexcept
+    std::span<const KFEMeshVertex> KFEMeshGeometry::GetVertices() const noexcept
     {
-        return m_vertices;
+        return m_vertexView;
     }
 
-    const std::vector<std::uint32_t>& KFEMeshGeometry::GetIndices() const noexcept
+    std::span<const std::uint32_t> KFEMeshGeometry::GetIndices() const noexcept
     {
-        return m_indices;
+        return m_indexView;
+    }
+
+    std::span<const KFE_MESHLET> KFEMeshGeometry::GetMeshlets() const noexcept
+    {
+        return m_meshletView;
+    }
+
+    std::span<const KFE_MESH_LOD> KFEMeshGeometry::GetLods() const noexcept
+    {
+        return m_lodView;
     }
 
     const XMFLOAT3& KFEMeshGeometry::GetAABBMin() const noexcept
@@ -156,11 +298,39 @@ namespace kfe
 
     bool KFEMeshGeometry::IsValid() const noexcept
     {
-        return !m_vertices.empty() && !m_indices.empty();
+        return !m_vertexView.empty() && !m_indexView.empty();
     }
 
-    std::vector<D3D12_INPUT_ELEMENT_DESC> KFEMeshGeometry::GetInputLayout() noexcept
+    bool KFEMeshGeometry::IsExternal() const noexcept
     {
+        return m_pBacking != nullptr;
+    }
+
+    bool KFEMeshGeometry::CanUseIndex16() const noexcept
+    {
+        return !m_vertexView.empty() && m_vertexView.size() <= 0xFFFFu;
+    }
+
+    std::vector<D3D12_INPUT_ELEMENT_DESC> KFEMeshGeometry::GetInputLayout(EMeshVertexFormat format) noexcept
+    {
+        if (format == EMeshVertexFormat::Compact)
+        {
+            const UINT offsetPosition = static_cast<UINT>(offsetof(KFEMeshVertexCompact, Position));
+            const UINT offsetNormal = static_cast<UINT>(offsetof(KFEMeshVertexCompact, Normal));
+            const UINT offsetTangent = static_cast<UINT>(offsetof(KFEMeshVertexCompact, Tangent));
+            const UINT offsetUV0 = static_cast<UINT>(offsetof(KFEMeshVertexCompact, UV0));
+            const UINT offsetUV1 = static_cast<UINT>(offsetof(KFEMeshVertexCompact, UV1));
+
+            return
+            {
+                { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, offsetPosition, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+                { "NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       0, offsetNormal,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+                { "TANGENT",  0, DXGI_FORMAT_R16G16_SNORM,       0, offsetTangent,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+                { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,       0, offsetUV0,      D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+                { "TEXCOORD", 1, DXGI_FORMAT_R16G16_FLOAT,       0, offsetUV1,      D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+            };
+        }
+
         const UINT offsetPosition = 0;
         const UINT offsetNormal = offsetPosition + sizeof(XMFLOAT3);
         const UINT offsetTangent = offsetNormal + sizeof(XMFLOAT3);
@@ -178,4 +348,11 @@ namespace kfe
             { "TEXCOORD",  1, DXGI_FORMAT_R32G32_FLOAT,    0, offsetUV1,       D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
         };
     }
+
+    std::uint32_t KFEMeshGeometry::GetVertexStride(EMeshVertexFormat format) noexcept
+    {
+        return format == EMeshVertexFormat::Compact
+            ? static_cast<std::uint32_t>(sizeof(KFEMeshVertexCompact))
+            : static_cast<std::uint32_t>(sizeof(KFEMeshVertex));
+    }
 }
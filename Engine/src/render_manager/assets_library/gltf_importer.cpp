@@ -0,0 +1,1365 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : gltf_importer.cpp
+ *  Purpose   : glTF 2.0 / GLB parsing, accessor reads and the conversion to the
+ *              engine conventions the Assimp path produces.
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/gltf_importer.h"
+#include "engine/render_manager/assets_library/model/tangent_space.h"
+#include "engine/render_manager/assets_library/model/vertex_kernels.h"
+#include "engine/utils/file_system.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace kfe::import
+{
+    namespace
+    {
+        constexpr std::uint32_t kGlbMagic     = 0x46546C67u; //~ "glTF"
+        constexpr std::uint32_t kGlbChunkJson = 0x4E4F534Au; //~ "JSON"
+        constexpr std::uint32_t kGlbChunkBin  = 0x004E4942u; //~ "BIN\0"
+
+        constexpr std::uint32_t kComponentByte          = 5120u;
+        constexpr std::uint32_t kComponentUnsignedByte  = 5121u;
+        constexpr std::uint32_t kComponentShort         = 5122u;
+        constexpr std::uint32_t kComponentUnsignedShort = 5123u;
+        constexpr std::uint32_t kComponentUnsignedInt   = 5125u;
+        constexpr std::uint32_t kComponentFloat         = 5126u;
+
+        constexpr std::uint32_t kModeTriangles     = 4u;
+        constexpr std::uint32_t kModeTriangleStrip = 5u;
+        constexpr std::uint32_t kModeTriangleFan   = 6u;
+
+        constexpr std::uint32_t kMaxJsonDepth = 128u;
+        constexpr std::uint32_t kMaxNodeDepth = 256u;
+
+#pragma region Json
+
+        //~ Minimal DOM, glTF needs arrays which JsonLoader does not parse
+        struct JsonValue
+        {
+            enum class EType : std::uint8_t { Null, Bool, Number, String, Array, Object };
+
+            EType                    Type   = EType::Null;
+            bool                     Bool   = false;
+            double                   Number = 0.0;
+            std::string              String;
+            std::vector<JsonValue>   Items;  //~ array elements or object values
+            std::vector<std::string> Keys;   //~ object keys, parallel to Items
+
+            bool IsArray () const noexcept { return Type == EType::Array; }
+            bool IsObject() const noexcept { return Type == EType::Object; }
+            bool IsNumber() const noexcept { return Type == EType::Number; }
+
+            const JsonValue* Find(std::string_view key) const noexcept
+            {
+                if (Type != EType::Object)
+                    return nullptr;
+
+                for (std::size_t i = 0; i < Keys.size(); ++i)
+                {
+                    if (Keys[i] == key)
+                        return &Items[i];
+                }
+                return nullptr;
+            }
+
+            //~ nullptr when out of range or not an array
+            const JsonValue* At(std::size_t index) const noexcept
+            {
+                return (Type == EType::Array && index < Items.size()) ? &Items[index] : nullptr;
+            }
+
+            std::size_t Size() const noexcept
+            {
+                return Type == EType::Array ? Items.size() : 0u;
+            }
+
+            double NumberOr(std::string_view key, double fallback) const noexcept
+            {
+                const JsonValue* v = Find(key);
+                return (v && v->IsNumber()) ? v->Number : fallback;
+            }
+
+            //~ Index fields, ~0 when missing or negative
+            std::uint32_t IndexOr(std::string_view key) const noexcept
+            {
+                const JsonValue* v = Find(key);
+                if (!v || !v->IsNumber() || v->Number < 0.0)
+                    return ~0u;
+                return static_cast<std::uint32_t>(v->Number);
+            }
+
+            std::string_view StringOr(std::string_view key, std::string_view fallback) const noexcept
+            {
+                const JsonValue* v = Find(key);
+                return (v && v->Type == EType::String) ? std::string_view{ v->String } : fallback;
+            }
+        };
+
+        class JsonParser
+        {
+        public:
+            explicit JsonParser(std::string_view text) noexcept
+                : m_text(text)
+            {
+            }
+
+            bool Parse(JsonValue& out, std::string& error)
+            {
+                if (!ParseValue(out, 0u))
+                {
+                    error = "JSON parse error at byte " + std::to_string(m_pos) + ": " + m_error;
+                    return false;
+                }
+
+                SkipWhitespace();
+                if (m_pos != m_text.size())
+                {
+                    error = "Trailing data after JSON at byte " + std::to_string(m_pos);
+                    return false;
+                }
+                return true;
+            }
+
+        private:
+            void SkipWhitespace() noexcept
+            {
+                while (m_pos < m_text.size())
+                {
+                    const char c = m_text[m_pos];
+                    if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                        break;
+                    ++m_pos;
+                }
+            }
+
+            bool Fail(const char* message)
+            {
+                m_error = message;
+                return false;
+            }
+
+            bool Literal(std::string_view word)
+            {
+                if (m_text.substr(m_pos, word.size()) != word)
+                    return Fail("invalid literal");
+                m_pos += word.size();
+                return true;
+            }
+
+            bool ParseValue(JsonValue& out, std::uint32_t depth)
+            {
+                if (depth > kMaxJsonDepth)
+                    return Fail("nesting too deep");
+
+                SkipWhitespace();
+                if (m_pos >= m_text.size())
+                    return Fail("unexpected end");
+
+                switch (m_text[m_pos])
+                {
+                case '{': return ParseObject(out, depth);
+                case '[': return ParseArray(out, depth);
+                case '"':
+                    out.Type = JsonValue::EType::String;
+                    return ParseString(out.String);
+                case 't':
+                    out.Type = JsonValue::EType::Bool;
+                    out.Bool = true;
+                    return Literal("true");
+                case 'f':
+                    out.Type = JsonValue::EType::Bool;
+                    out.Bool = false;
+                    return Literal("false");
+                case 'n':
+                    out.Type = JsonValue::EType::Null;
+                    return Literal("null");
+                default:
+                    return ParseNumber(out);
+                }
+            }
+
+            bool ParseObject(JsonValue& out, std::uint32_t depth)
+            {
+                out.Type = JsonValue::EType::Object;
+                ++m_pos; //~ {
+
+                SkipWhitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == '}')
+                {
+                    ++m_pos;
+                    return true;
+                }
+
+                for (;;)
+                {
+                    SkipWhitespace();
+                    if (m_pos >= m_text.size() || m_text[m_pos] != '"')
+                        return Fail("expected object key");
+
+                    std::string key;
+                    if (!ParseString(key))
+                        return false;
+
+                    SkipWhitespace();
+                    if (m_pos >= m_text.size() || m_text[m_pos] != ':')
+                        return Fail("expected ':'");
+                    ++m_pos;
+
+                    out.Keys.emplace_back(std::move(key));
+                    out.Items.emplace_back();
+                    if (!ParseValue(out.Items.back(), depth + 1u))
+                        return false;
+
+                    SkipWhitespace();
+                    if (m_pos >= m_text.size())
+                        return Fail("unterminated object");
+
+                    if (m_text[m_pos] == ',')
+                    {
+                        ++m_pos;
+                        continue;
+                    }
+                    if (m_text[m_pos] == '}')
+                    {
+                        ++m_pos;
+                        return true;
+                    }
+                    return Fail("expected ',' or '}'");
+                }
+            }
+
+            bool ParseArray(JsonValue& out, std::uint32_t depth)
+            {
+                out.Type = JsonValue::EType::Array;
+                ++m_pos; //~ [
+
+                SkipWhitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == ']')
+                {
+                    ++m_pos;
+                    return true;
+                }
+
+                for (;;)
+                {
+                    out.Items.emplace_back();
+                    if (!ParseValue(out.Items.back(), depth + 1u))
+                        return false;
+
+                    SkipWhitespace();
+                    if (m_pos >= m_text.size())
+                        return Fail("unterminated array");
+
+                    if (m_text[m_pos] == ',')
+                    {
+                        ++m_pos;
+                        continue;
+                    }
+                    if (m_text[m_pos] == ']')
+                    {
+                        ++m_pos;
+                        return true;
+                    }
+                    return Fail("expected ',' or ']'");
+                }
+            }
+
+            bool ParseHex4(std::uint32_t& out)
+            {
+                if (m_pos + 4u > m_text.size())
+                    return Fail("short \\u escape");
+
+                out = 0u;
+                for (std::size_t i = 0; i < 4u; ++i)
+                {
+                    const char c = m_text[m_pos++];
+                    out <<= 4u;
+                    if      (c >= '0' && c <= '9') out |= static_cast<std::uint32_t>(c - '0');
+                    else if (c >= 'a' && c <= 'f') out |= static_cast<std::uint32_t>(c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F') out |= static_cast<std::uint32_t>(c - 'A' + 10);
+                    else return Fail("bad \\u escape");
+                }
+                return true;
+            }
+
+            static void AppendUtf8(std::string& out, std::uint32_t cp)
+            {
+                if (cp < 0x80u)
+                {
+                    out.push_back(static_cast<char>(cp));
+                }
+                else if (cp < 0x800u)
+                {
+                    out.push_back(static_cast<char>(0xC0u | (cp >> 6u)));
+                    out.push_back(static_cast<char>(0x80u | (cp & 0x3Fu)));
+                }
+                else if (cp < 0x10000u)
+                {
+                    out.push_back(static_cast<char>(0xE0u | (cp >> 12u)));
+                    out.push_back(static_cast<char>(0x80u | ((cp >> 6u) & 0x3Fu)));
+                    out.push_back(static_cast<char>(0x80u | (cp & 0x3Fu)));
+                }
+                else
+                {
+                    out.push_back(static_cast<char>(0xF0u | (cp >> 18u)));
+                    out.push_back(static_cast<char>(0x80u | ((cp >> 12u) & 0x3Fu)));
+                    out.push_back(static_cast<char>(0x80u | ((cp >> 6u) & 0x3Fu)));
+                    out.push_back(static_cast<char>(0x80u | (cp & 0x3Fu)));
+                }
+            }
+
+            bool ParseString(std::string& out)
+            {
+                ++m_pos; //~ opening quote
+
+                for (;;)
+                {
+                    //~ Copy the run up to the next quote or escape in one go
+                    const std::size_t start = m_pos;
+                    while (m_pos < m_text.size() && m_text[m_pos] != '"' && m_text[m_pos] != '\\')
+                        ++m_pos;
+                    out.append(m_text.data() + start, m_pos - start);
+
+                    if (m_pos >= m_text.size())
+                        return Fail("unterminated string");
+
+                    if (m_text[m_pos] == '"')
+                    {
+                        ++m_pos;
+                        return true;
+                    }
+
+                    ++m_pos; //~ backslash
+                    if (m_pos >= m_text.size())
+                        return Fail("unterminated escape");
+
+                    const char e = m_text[m_pos++];
+                    switch (e)
+                    {
+                    case '"':  out.push_back('"');  break;
+                    case '\\': out.push_back('\\'); break;
+                    case '/':  out.push_back('/');  break;
+                    case 'b':  out.push_back('\b'); break;
+                    case 'f':  out.push_back('\f'); break;
+                    case 'n':  out.push_back('\n'); break;
+                    case 'r':  out.push_back('\r'); break;
+                    case 't':  out.push_back('\t'); break;
+                    case 'u':
+                    {
+                        std::uint32_t cp = 0u;
+                        if (!ParseHex4(cp))
+                            return false;
+
+                        //~ Surrogate pair
+                        if (cp >= 0xD800u && cp <= 0xDBFFu &&
+                            m_pos + 1u < m_text.size() && m_text[m_pos] == '\\' && m_text[m_pos + 1u] == 'u')
+                        {
+                            m_pos += 2u;
+                            std::uint32_t low = 0u;
+                            if (!ParseHex4(low))
+                                return false;
+                            cp = 0x10000u + ((cp - 0xD800u) << 10u) + (low - 0xDC00u);
+                        }
+
+                        AppendUtf8(out, cp);
+                        break;
+                    }
+                    default:
+                        return Fail("unknown escape");
+                    }
+                }
+            }
+
+            bool ParseNumber(JsonValue& out)
+            {
+                const char* first = m_text.data() + m_pos;
+                const char* last  = m_text.data() + m_text.size();
+
+                double value = 0.0;
+                const auto [ptr, ec] = std::from_chars(first, last, value);
+                if (ec != std::errc{} || ptr == first)
+                    return Fail("invalid number");
+
+                out.Type   = JsonValue::EType::Number;
+                out.Number = value;
+                m_pos += static_cast<std::size_t>(ptr - first);
+                return true;
+            }
+
+        private:
+            std::string_view m_text;
+            std::size_t      m_pos{ 0u };
+            const char*      m_error{ "" };
+        };
+
+#pragma endregion
+
+#pragma region Buffers
+
+        bool DecodeBase64(std::string_view text, std::vector<std::uint8_t>& out)
+        {
+            auto Value = [](char c) -> int
+                {
+                    if (c >= 'A' && c <= 'Z') return c - 'A';
+                    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+                    if (c >= '0' && c <= '9') return c - '0' + 52;
+                    if (c == '+' || c == '-') return 62;
+                    if (c == '/' || c == '_') return 63;
+                    return -1;
+                };
+
+            out.clear();
+            out.reserve(text.size() / 4u * 3u);
+
+            std::uint32_t bits = 0u;
+            int count = 0;
+
+            for (const char c : text)
+            {
+                if (c == '=')
+                    break;
+
+                const int v = Value(c);
+                if (v < 0)
+                    return false;
+
+                bits = (bits << 6u) | static_cast<std::uint32_t>(v);
+                count += 6;
+
+                if (count >= 8)
+                {
+                    count -= 8;
+                    out.push_back(static_cast<std::uint8_t>((bits >> count) & 0xFFu));
+                }
+            }
+            return true;
+        }
+
+        std::string DecodeUri(std::string_view uri)
+        {
+            std::string out;
+            out.reserve(uri.size());
+
+            for (std::size_t i = 0; i < uri.size(); ++i)
+            {
+                if (uri[i] == '%' && i + 2u < uri.size())
+                {
+                    unsigned value = 0u;
+                    const auto [ptr, ec] = std::from_chars(uri.data() + i + 1u, uri.data() + i + 3u, value, 16);
+                    if (ec == std::errc{} && ptr == uri.data() + i + 3u)
+                    {
+                        out.push_back(static_cast<char>(value));
+                        i += 2u;
+                        continue;
+                    }
+                }
+                out.push_back(uri[i]);
+            }
+            return out;
+        }
+
+        //~ Keeps the mappings (and decoded data URIs) alive while accessors are read
+        struct GltfDocument
+        {
+            JsonValue                                   Json;
+            std::vector<std::unique_ptr<KFEMappedFile>> Mappings;
+            std::vector<std::vector<std::uint8_t>>      Decoded;
+            std::vector<std::span<const std::uint8_t>>  Buffers;
+        };
+
+        bool LoadBuffers(const std::filesystem::path& baseDir,
+            std::span<const std::uint8_t> glbBin,
+            GltfDocument& doc,
+            std::string& error)
+        {
+            const JsonValue* buffers = doc.Json.Find("buffers");
+            const std::size_t count = buffers ? buffers->Size() : 0u;
+            doc.Buffers.resize(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const JsonValue& buffer = *buffers->At(i);
+                const auto byteLength = static_cast<std::uint64_t>(buffer.NumberOr("byteLength", 0.0));
+                const std::string_view uri = buffer.StringOr("uri", {});
+
+                std::span<const std::uint8_t> bytes{};
+
+                if (uri.empty())
+                {
+                    //~ Only the first buffer may live in the GLB binary chunk
+                    if (i != 0u || glbBin.empty())
+                    {
+                        error = "Buffer " + std::to_string(i) + " has no uri";
+                        return false;
+                    }
+                    bytes = glbBin;
+                }
+                else if (uri.starts_with("data:"))
+                {
+                    const std::size_t comma = uri.find(',');
+                    if (comma == std::string_view::npos || uri.substr(0, comma).find(";base64") == std::string_view::npos)
+                    {
+                        error = "Buffer " + std::to_string(i) + " has an unsupported data uri";
+                        return false;
+                    }
+
+                    auto& decoded = doc.Decoded.emplace_back();
+                    if (!DecodeBase64(uri.substr(comma + 1u), decoded))
+                    {
+                        error = "Buffer " + std::to_string(i) + " has invalid base64";
+                        return false;
+                    }
+                    bytes = { decoded.data(), decoded.size() };
+                }
+                else
+                {
+                    const std::filesystem::path file = baseDir / std::filesystem::u8path(DecodeUri(uri));
+
+                    auto mapping = std::make_unique<KFEMappedFile>();
+                    if (!mapping->Open(file.string()))
+                    {
+                        error = "Failed to map buffer '" + file.string() + "'";
+                        return false;
+                    }
+
+                    bytes = { mapping->GetData(), static_cast<std::size_t>(mapping->GetSize()) };
+                    doc.Mappings.emplace_back(std::move(mapping));
+                }
+
+                if (bytes.size() < byteLength)
+                {
+                    error = "Buffer " + std::to_string(i) + " is shorter than its byteLength";
+                    return false;
+                }
+
+                doc.Buffers[i] = bytes.first(static_cast<std::size_t>(byteLength));
+            }
+
+            return true;
+        }
+
+#pragma endregion
+
+#pragma region Accessors
+
+        std::uint32_t ComponentSize(std::uint32_t componentType) noexcept
+        {
+            switch (componentType)
+            {
+            case kComponentByte:
+            case kComponentUnsignedByte:  return 1u;
+            case kComponentShort:
+            case kComponentUnsignedShort: return 2u;
+            case kComponentUnsignedInt:
+            case kComponentFloat:         return 4u;
+            default:                      return 0u;
+            }
+        }
+
+        std::uint32_t ComponentCount(std::string_view type) noexcept
+        {
+            if (type == "SCALAR") return 1u;
+            if (type == "VEC2")   return 2u;
+            if (type == "VEC3")   return 3u;
+            if (type == "VEC4")   return 4u;
+            if (type == "MAT4")   return 16u;
+            return 0u;
+        }
+
+        //~ Strided view into a mapped buffer, nothing is copied
+        struct AccessorView
+        {
+            const std::uint8_t* Data          = nullptr; //~ nullptr = all zeros (no bufferView)
+            std::size_t         Count         = 0u;
+            std::size_t         Stride        = 0u;
+            std::uint32_t       ComponentType = 0u;
+            std::uint32_t       Components    = 0u;
+            bool                Normalized    = false;
+            const JsonValue*    Json          = nullptr;
+
+            bool IsValid() const noexcept { return Count > 0u && Components > 0u; }
+
+            //~ Tightly packed float3, the layout the vertex kernels stream
+            const float* PackedFloat3() const noexcept
+            {
+                return (Data && ComponentType == kComponentFloat && Components == 3u && Stride == 12u)
+                    ? reinterpret_cast<const float*>(Data)
+                    : nullptr;
+            }
+
+            float Read(std::size_t index, std::uint32_t component) const noexcept
+            {
+                if (!Data)
+                    return 0.0f;
+
+                const std::uint8_t* p = Data + index * Stride + component * ComponentSize(ComponentType);
+                switch (ComponentType)
+                {
+                case kComponentFloat:
+                {
+                    float v;
+                    std::memcpy(&v, p, sizeof(v));
+                    return v;
+                }
+                case kComponentUnsignedByte:
+                    return Normalized ? *p / 255.0f : static_cast<float>(*p);
+                case kComponentByte:
+                {
+                    const auto v = static_cast<std::int8_t>(*p);
+                    return Normalized ? (std::max)(v / 127.0f, -1.0f) : static_cast<float>(v);
+                }
+                case kComponentUnsignedShort:
+                {
+                    std::uint16_t v;
+                    std::memcpy(&v, p, sizeof(v));
+                    return Normalized ? v / 65535.0f : static_cast<float>(v);
+                }
+                case kComponentShort:
+                {
+                    std::int16_t v;
+                    std::memcpy(&v, p, sizeof(v));
+                    return Normalized ? (std::max)(v / 32767.0f, -1.0f) : static_cast<float>(v);
+                }
+                default:
+                    return 0.0f;
+                }
+            }
+
+            std::uint32_t ReadIndex(std::size_t index) const noexcept
+            {
+                if (!Data)
+                    return 0u;
+
+                const std::uint8_t* p = Data + index * Stride;
+                switch (ComponentType)
+                {
+                case kComponentUnsignedByte:
+                    return *p;
+                case kComponentUnsignedShort:
+                {
+                    std::uint16_t v;
+                    std::memcpy(&v, p, sizeof(v));
+                    return v;
+                }
+                case kComponentUnsignedInt:
+                {
+                    std::uint32_t v;
+                    std::memcpy(&v, p, sizeof(v));
+                    return v;
+                }
+                default:
+                    return ~0u;
+                }
+            }
+        };
+
+        bool ResolveAccessor(const GltfDocument& doc,
+            std::uint32_t accessorIndex,
+            AccessorView& out,
+            std::string& error)
+        {
+            const JsonValue* accessors = doc.Json.Find("accessors");
+            const JsonValue* accessor = accessors ? accessors->At(accessorIndex) : nullptr;
+            if (!accessor)
+            {
+                error = "Accessor " + std::to_string(accessorIndex) + " does not exist";
+                return false;
+            }
+
+            if (accessor->Find("sparse"))
+            {
+                error = "Sparse accessors are not supported";
+                return false;
+            }
+
+            out = {};
+            out.Json          = accessor;
+            out.Count         = static_cast<std::size_t>(accessor->NumberOr("count", 0.0));
+            out.ComponentType = static_cast<std::uint32_t>(accessor->NumberOr("componentType", 0.0));
+            out.Components    = ComponentCount(accessor->StringOr("type", {}));
+
+            if (const JsonValue* normalized = accessor->Find("normalized"))
+                out.Normalized = normalized->Bool;
+
+            const std::uint32_t componentSize = ComponentSize(out.ComponentType);
+            if (componentSize == 0u || out.Components == 0u)
+            {
+                error = "Accessor " + std::to_string(accessorIndex) + " has an unknown type";
+                return false;
+            }
+
+            const std::size_t elementSize = static_cast<std::size_t>(componentSize) * out.Components;
+            out.Stride = elementSize;
+
+            const std::uint32_t viewIndex = accessor->IndexOr("bufferView");
+            if (viewIndex == ~0u)
+                return true; //~ zero filled
+
+            const JsonValue* views = doc.Json.Find("bufferViews");
+            const JsonValue* view = views ? views->At(viewIndex) : nullptr;
+            if (!view)
+            {
+                error = "BufferView " + std::to_string(viewIndex) + " does not exist";
+                return false;
+            }
+
+            const std::uint32_t bufferIndex = view->IndexOr("buffer");
+            if (bufferIndex >= doc.Buffers.size())
+            {
+                error = "BufferView " + std::to_string(viewIndex) + " references a missing buffer";
+                return false;
+            }
+
+            const auto viewOffset     = static_cast<std::size_t>(view->NumberOr("byteOffset", 0.0));
+            const auto viewLength     = static_cast<std::size_t>(view->NumberOr("byteLength", 0.0));
+            const auto viewStride     = static_cast<std::size_t>(view->NumberOr("byteStride", 0.0));
+            const auto accessorOffset = static_cast<std::size_t>(accessor->NumberOr("byteOffset", 0.0));
+
+            if (viewStride != 0u)
+                out.Stride = viewStride;
+
+            const std::span<const std::uint8_t> buffer = doc.Buffers[bufferIndex];
+            const std::size_t required = out.Count == 0u
+                ? 0u
+                : accessorOffset + out.Stride * (out.Count - 1u) + elementSize;
+
+            if (viewOffset + viewLength > buffer.size() || required > viewLength)
+            {
+                error = "Accessor " + std::to_string(accessorIndex) + " reads past its buffer";
+                return false;
+            }
+
+            out.Data = buffer.data() + viewOffset + accessorOffset;
+            return true;
+        }
+
+#pragma endregion
+
+#pragma region Geometry
+
+        Float3 Cross(const Float3& a, const Float3& b) noexcept
+        {
+            return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        }
+
+        //~ Rows/columns laid out like ConvertMatrix(aiMatrix4x4): column vectors,
+        //~ translation in the last column
+        Float4x4 ReadNodeTransform(const JsonValue& node)
+        {
+            Float4x4 m{};
+
+            if (const JsonValue* matrix = node.Find("matrix"); matrix && matrix->Size() == 16u)
+            {
+                //~ glTF stores column major
+                for (std::size_t c = 0; c < 4u; ++c)
+                    for (std::size_t r = 0; r < 4u; ++r)
+                        m.m[r][c] = static_cast<float>(matrix->At(c * 4u + r)->Number);
+                return m;
+            }
+
+            auto ReadVec = [&node](std::string_view key, std::size_t size, const float* fallback, float* out)
+                {
+                    const JsonValue* v = node.Find(key);
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        const JsonValue* item = v ? v->At(i) : nullptr;
+                        out[i] = (item && item->IsNumber()) ? static_cast<float>(item->Number) : fallback[i];
+                    }
+                };
+
+            constexpr float kZero[3]     = { 0.0f, 0.0f, 0.0f };
+            constexpr float kOne[3]      = { 1.0f, 1.0f, 1.0f };
+            constexpr float kIdentity[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+            float t[3], s[3], q[4];
+            ReadVec("translation", 3u, kZero, t);
+            ReadVec("scale", 3u, kOne, s);
+            ReadVec("rotation", 4u, kIdentity, q);
+
+            const float x = q[0], y = q[1], z = q[2], w = q[3];
+            const float r[3][3] = {
+                { 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - z * w),        2.0f * (x * z + y * w) },
+                { 2.0f * (x * y + z * w),        1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - x * w) },
+                { 2.0f * (x * z - y * w),        2.0f * (y * z + x * w),        1.0f - 2.0f * (x * x + y * y) },
+            };
+
+            //~ T * R * S
+            for (std::size_t row = 0; row < 3u; ++row)
+            {
+                for (std::size_t col = 0; col < 3u; ++col)
+                    m.m[row][col] = r[row][col] * s[col];
+                m.m[row][3] = t[row];
+            }
+            m.m[3][0] = 0.0f; m.m[3][1] = 0.0f; m.m[3][2] = 0.0f; m.m[3][3] = 1.0f;
+            return m;
+        }
+
+        //~ Mirror on z, what MakeLeftHanded does to node transforms
+        void MakeLeftHanded(Float4x4& m) noexcept
+        {
+            m.m[0][2] = -m.m[0][2];
+            m.m[1][2] = -m.m[1][2];
+            m.m[2][3] = -m.m[2][3];
+            m.m[2][0] = -m.m[2][0];
+            m.m[2][1] = -m.m[2][1];
+        }
+
+        bool ConvertNodeRecursive(const JsonValue& nodes,
+            std::uint32_t nodeIndex,
+            const std::vector<std::vector<std::uint32_t>>& meshPrimitives,
+            std::vector<std::uint8_t>& visiting,
+            std::uint32_t depth,
+            ImportedNode& dst)
+        {
+            const JsonValue* node = nodes.At(nodeIndex);
+            if (!node || depth > kMaxNodeDepth || visiting[nodeIndex])
+                return false;
+
+            visiting[nodeIndex] = 1u;
+
+            dst.Name = std::string{ node->StringOr("name", {}) };
+            if (dst.Name.empty())
+                dst.Name = "Node_" + std::to_string(nodeIndex);
+
+            dst.LocalTransform = ReadNodeTransform(*node);
+            MakeLeftHanded(dst.LocalTransform);
+
+            const std::uint32_t meshIndex = node->IndexOr("mesh");
+            if (meshIndex < meshPrimitives.size())
+                dst.MeshIndices = meshPrimitives[meshIndex];
+
+            if (const JsonValue* children = node->Find("children"))
+            {
+                dst.Children.reserve(children->Size());
+                for (std::size_t c = 0; c < children->Size(); ++c)
+                {
+                    const JsonValue* child = children->At(c);
+                    if (!child || !child->IsNumber())
+                        continue;
+
+                    ImportedNode childNode{};
+                    if (ConvertNodeRecursive(nodes, static_cast<std::uint32_t>(child->Number),
+                        meshPrimitives, visiting, depth + 1u, childNode))
+                    {
+                        dst.Children.emplace_back(std::move(childNode));
+                    }
+                }
+            }
+
+            visiting[nodeIndex] = 0u;
+            return true;
+        }
+
+#pragma endregion
+
+        //~ Geometry extensions that change how accessors must be decoded
+        bool UsesUnsupportedExtension(const JsonValue& json, std::string& error)
+        {
+            const JsonValue* required = json.Find("extensionsRequired");
+            for (std::size_t i = 0; required && i < required->Size(); ++i)
+            {
+                const std::string& name = required->At(i)->String;
+                if (name == "KHR_draco_mesh_compression" ||
+                    name == "EXT_meshopt_compression"    ||
+                    name == "KHR_meshopt_compression"    ||
+                    name == "KHR_mesh_quantization")
+                {
+                    error = "Required extension '" + name + "' is not supported";
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ReadPositionBounds(const AccessorView& positions, Float3& inOutMin, Float3& inOutMax)
+        {
+            //~ POSITION accessors must carry min/max, no pass over the data needed
+            const JsonValue* min = positions.Json->Find("min");
+            const JsonValue* max = positions.Json->Find("max");
+            if (min && max && min->Size() >= 3u && max->Size() >= 3u)
+            {
+                inOutMin.x = (std::min)(inOutMin.x, static_cast<float>(min->At(0)->Number));
+                inOutMin.y = (std::min)(inOutMin.y, static_cast<float>(min->At(1)->Number));
+                inOutMin.z = (std::min)(inOutMin.z, static_cast<float>(min->At(2)->Number));
+                inOutMax.x = (std::max)(inOutMax.x, static_cast<float>(max->At(0)->Number));
+                inOutMax.y = (std::max)(inOutMax.y, static_cast<float>(max->At(1)->Number));
+                inOutMax.z = (std::max)(inOutMax.z, static_cast<float>(max->At(2)->Number));
+                return true;
+            }
+
+            if (const float* packed = positions.PackedFloat3())
+            {
+                KFEVertexKernels::ReduceAABB(packed, positions.Count, inOutMin, inOutMax);
+                return true;
+            }
+
+            for (std::size_t i = 0; i < positions.Count; ++i)
+            {
+                const float x = positions.Read(i, 0u), y = positions.Read(i, 1u), z = positions.Read(i, 2u);
+                inOutMin = { (std::min)(inOutMin.x, x), (std::min)(inOutMin.y, y), (std::min)(inOutMin.z, z) };
+                inOutMax = { (std::max)(inOutMax.x, x), (std::max)(inOutMax.y, y), (std::max)(inOutMax.z, z) };
+            }
+            return true;
+        }
+
+        bool ConvertPrimitive(const GltfDocument& doc,
+            const JsonValue& primitive,
+            const Float3& center,
+            float scale,
+            ImportedMesh& mesh,
+            std::string& error)
+        {
+            const JsonValue* attributes = primitive.Find("attributes");
+            if (!attributes)
+            {
+                error = "Primitive has no attributes";
+                return false;
+            }
+
+            AccessorView positions{};
+            if (!ResolveAccessor(doc, attributes->IndexOr("POSITION"), positions, error))
+                return false;
+
+            if (positions.ComponentType != kComponentFloat || positions.Components != 3u)
+            {
+                error = "POSITION must be float3";
+                return false;
+            }
+
+            const std::size_t vertexCount = positions.Count;
+
+            AccessorView normals{}, tangents{}, uvs[KFE_MAX_UV_CHANNELS]{};
+
+            const bool hasNormals = attributes->IndexOr("NORMAL") != ~0u;
+            if (hasNormals && !ResolveAccessor(doc, attributes->IndexOr("NORMAL"), normals, error))
+                return false;
+
+            const bool hasTangents = hasNormals && attributes->IndexOr("TANGENT") != ~0u;
+            if (hasTangents && !ResolveAccessor(doc, attributes->IndexOr("TANGENT"), tangents, error))
+                return false;
+
+            bool hasUV[KFE_MAX_UV_CHANNELS]{};
+            for (std::uint32_t ch = 0; ch < KFE_MAX_UV_CHANNELS; ++ch)
+            {
+                const std::string key = "TEXCOORD_" + std::to_string(ch);
+                hasUV[ch] = attributes->IndexOr(key) != ~0u;
+                if (hasUV[ch] && !ResolveAccessor(doc, attributes->IndexOr(key), uvs[ch], error))
+                    return false;
+            }
+
+            if ((hasNormals  && (normals.Count  != vertexCount || normals.Components  != 3u)) ||
+                (hasTangents && (tangents.Count != vertexCount || tangents.Components != 4u)) ||
+                (hasUV[0]    && (uvs[0].Count   != vertexCount || uvs[0].Components   != 2u)) ||
+                (hasUV[1]    && (uvs[1].Count   != vertexCount || uvs[1].Components   != 2u)))
+            {
+                error = "Vertex attributes disagree on count or type";
+                return false;
+            }
+
+            //~ Positions and normals stream straight from the mapping when tightly packed,
+            //~ interleaved layouts are read per element below
+            mesh.Vertices.resize(vertexCount);
+
+            KFE_VERTEX_SOURCE_STREAMS streams{};
+            streams.VertexCount = vertexCount;
+            streams.Positions   = positions.PackedFloat3();
+            streams.Normals     = hasNormals ? normals.PackedFloat3() : nullptr;
+
+            if (streams.Positions)
+            {
+                KFEVertexKernels::ConvertVertices(streams, center, scale,
+                    mesh.Vertices.data(), mesh.AABBMin, mesh.AABBMax);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    Float3& p = mesh.Vertices[i].Position;
+                    p = { (positions.Read(i, 0u) - center.x) * scale,
+                          (positions.Read(i, 1u) - center.y) * scale,
+                          (positions.Read(i, 2u) - center.z) * scale };
+
+                    mesh.AABBMin = { (std::min)(mesh.AABBMin.x, p.x), (std::min)(mesh.AABBMin.y, p.y), (std::min)(mesh.AABBMin.z, p.z) };
+                    mesh.AABBMax = { (std::max)(mesh.AABBMax.x, p.x), (std::max)(mesh.AABBMax.y, p.y), (std::max)(mesh.AABBMax.z, p.z) };
+                }
+            }
+
+            for (std::size_t i = 0; i < vertexCount; ++i)
+            {
+                ImportedVertex& v = mesh.Vertices[i];
+
+                if (hasNormals && !streams.Normals)
+                    v.Normal = { normals.Read(i, 0u), normals.Read(i, 1u), normals.Read(i, 2u) };
+                v.HasNormal = hasNormals;
+
+                //~ glTF already has the top left UV origin the engine uses
+                for (std::uint32_t ch = 0; ch < KFE_MAX_UV_CHANNELS; ++ch)
+                {
+                    if (hasUV[ch])
+                        v.UV[ch] = { uvs[ch].Read(i, 0u), uvs[ch].Read(i, 1u) };
+                    v.HasUV[ch] = hasUV[ch];
+                }
+
+                v.HasTangent = false;
+                if (hasTangents)
+                {
+                    v.Tangent = { tangents.Read(i, 0u), tangents.Read(i, 1u), tangents.Read(i, 2u) };
+                    const float handedness = tangents.Read(i, 3u) < 0.0f ? -1.0f : 1.0f;
+
+                    const Float3 b = Cross(v.Normal, v.Tangent);
+                    v.Bitangent  = { b.x * handedness, b.y * handedness, b.z * handedness };
+                    v.HasTangent = true;
+                }
+
+                //~ Right to left handed, mirror on z
+                v.Position.z = -v.Position.z;
+                v.Normal.z   = -v.Normal.z;
+                if (hasTangents)
+                {
+                    v.Tangent.z   = -v.Tangent.z;
+                    v.Bitangent.z = -v.Bitangent.z;
+                }
+            }
+
+            const float minZ = mesh.AABBMin.z;
+            mesh.AABBMin.z = -mesh.AABBMax.z;
+            mesh.AABBMax.z = -minZ;
+
+            //~ Indices, strips and fans become lists
+            std::vector<std::uint32_t> source;
+            const std::uint32_t indicesIndex = primitive.IndexOr("indices");
+            if (indicesIndex != ~0u)
+            {
+                AccessorView indices{};
+                if (!ResolveAccessor(doc, indicesIndex, indices, error))
+                    return false;
+
+                if (indices.Components != 1u || indices.ComponentType == kComponentFloat)
+                {
+                    error = "Indices must be unsigned integer scalars";
+                    return false;
+                }
+
+                source.resize(indices.Count);
+                for (std::size_t i = 0; i < indices.Count; ++i)
+                {
+                    source[i] = indices.ReadIndex(i);
+                    if (source[i] >= vertexCount)
+                    {
+                        error = "Index out of range";
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                source.resize(vertexCount);
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                    source[i] = static_cast<std::uint32_t>(i);
+            }
+
+            const auto mode = static_cast<std::uint32_t>(primitive.NumberOr("mode", kModeTriangles));
+
+            //~ Emitted with the winding already flipped (FlipWindingOrder)
+            auto Emit = [&mesh](std::uint32_t a, std::uint32_t b, std::uint32_t c)
+                {
+                    mesh.Indices.push_back(c);
+                    mesh.Indices.push_back(b);
+                    mesh.Indices.push_back(a);
+                };
+
+            switch (mode)
+            {
+            case kModeTriangles:
+                mesh.Indices.reserve(source.size());
+                for (std::size_t i = 0; i + 2u < source.size(); i += 3u)
+                    Emit(source[i], source[i + 1u], source[i + 2u]);
+                break;
+
+            case kModeTriangleStrip:
+                mesh.Indices.reserve(source.size() * 3u);
+                for (std::size_t i = 0; i + 2u < source.size(); ++i)
+                {
+                    if (i & 1u) Emit(source[i + 1u], source[i], source[i + 2u]);
+                    else        Emit(source[i], source[i + 1u], source[i + 2u]);
+                }
+                break;
+
+            case kModeTriangleFan:
+                mesh.Indices.reserve(source.size() * 3u);
+                for (std::size_t i = 1; i + 1u < source.size(); ++i)
+                    Emit(source[0], source[i], source[i + 1u]);
+                break;
+
+            default:
+                error = "Primitive mode " + std::to_string(mode) + " has no triangles";
+                return false;
+            }
+
+            //~ Generated in engine space, on the final winding, like the Assimp path.
+            //~ Both skip meshes that already have the attribute.
+            const KFE_TANGENT_SPACE_DESC tangentDesc{};
+            (void)KFETangentSpace::GenerateNormals(mesh, tangentDesc);
+            (void)KFETangentSpace::GenerateTangents(mesh, tangentDesc);
+
+            return true;
+        }
+    } // namespace
+
+    GltfImporter::GltfImporter() = default;
+    GltfImporter::~GltfImporter() = default;
+
+    bool GltfImporter::CanLoad(const std::string& filePath) noexcept
+    {
+        std::string ext = std::filesystem::path(filePath).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        return ext == ".gltf" || ext == ".glb";
+    }
+
+    std::uint32_t GltfImporter::GetImportFlags() noexcept
+    {
+        //~ High bit keeps it apart from any aiProcess combination, low bits version it
+        return 0x80000000u | 2u;
+    }
+
+    bool GltfImporter::LoadFromFile(const std::string& filePath,
+        ImportedScene& outScene,
+        std::string& outErrorMessage) const noexcept
+    {
+        outScene.Clear();
+        outErrorMessage.clear();
+
+        auto Fail = [&](std::string message)
+            {
+                outErrorMessage = std::move(message);
+                LOG_ERROR("GltfImporter: '{}': {}", filePath, outErrorMessage);
+                outScene.Clear();
+                return false;
+            };
+
+        KFEMappedFile file{};
+        if (!file.Open(filePath))
+            return Fail("Failed to map file");
+
+        LOG_INFO("GltfImporter: Loading scene '{}'", filePath);
+
+        const std::uint8_t* data = file.GetData();
+        const std::size_t   size = static_cast<std::size_t>(file.GetSize());
+
+        GltfDocument doc{};
+        std::string_view jsonText{};
+        std::span<const std::uint8_t> glbBin{};
+
+        auto ReadU32 = [data](std::size_t offset)
+            {
+                std::uint32_t v;
+                std::memcpy(&v, data + offset, sizeof(v));
+                return v;
+            };
+
+        if (size >= 12u && ReadU32(0u) == kGlbMagic)
+        {
+            if (ReadU32(4u) != 2u)
+                return Fail("Only GLB version 2 is supported");
+
+            const std::size_t length = (std::min)(static_cast<std::size_t>(ReadU32(8u)), size);
+
+            for (std::size_t offset = 12u; offset + 8u <= length;)
+            {
+                const std::size_t chunkLength = ReadU32(offset);
+                const std::uint32_t chunkType = ReadU32(offset + 4u);
+                offset += 8u;
+
+                if (chunkLength > length - offset)
+                    return Fail("GLB chunk runs past the end of the file");
+
+                if (chunkType == kGlbChunkJson && jsonText.empty())
+                    jsonText = { reinterpret_cast<const char*>(data + offset), chunkLength };
+                else if (chunkType == kGlbChunkBin && glbBin.empty())
+                    glbBin = { data + offset, chunkLength };
+
+                offset += (chunkLength + 3u) & ~std::size_t{ 3u };
+            }
+
+            if (jsonText.empty())
+                return Fail("GLB has no JSON chunk");
+        }
+        else
+        {
+            jsonText = { reinterpret_cast<const char*>(data), size };
+        }
+
+        //~ UTF-8 BOM
+        if (jsonText.starts_with("\xEF\xBB\xBF"))
+            jsonText.remove_prefix(3u);
+
+        std::string error;
+        if (!JsonParser(jsonText).Parse(doc.Json, error))
+            return Fail(error);
+
+        if (!doc.Json.IsObject())
+            return Fail("Root is not an object");
+
+        if (UsesUnsupportedExtension(doc.Json, error))
+            return Fail(error);
+
+        const std::filesystem::path baseDir = std::filesystem::path(filePath).parent_path();
+        if (!LoadBuffers(baseDir, glbBin, doc, error))
+            return Fail(error);
+
+        const JsonValue* meshes = doc.Json.Find("meshes");
+        if (!meshes || meshes->Size() == 0u)
+            return Fail("File has no meshes");
+
+        //~ Scene bounds first, the unit box transform is applied while converting
+        Float3 sceneMin{ 1e30f,  1e30f,  1e30f };
+        Float3 sceneMax{ -1e30f, -1e30f, -1e30f };
+
+        for (std::size_t m = 0; m < meshes->Size(); ++m)
+        {
+            const JsonValue* primitives = meshes->At(m)->Find("primitives");
+            for (std::size_t p = 0; primitives && p < primitives->Size(); ++p)
+            {
+                const JsonValue* attributes = primitives->At(p)->Find("attributes");
+                const std::uint32_t accessor = attributes ? attributes->IndexOr("POSITION") : ~0u;
+
+                AccessorView positions{};
+                if (accessor != ~0u && ResolveAccessor(doc, accessor, positions, error))
+                    ReadPositionBounds(positions, sceneMin, sceneMax);
+            }
+        }
+
+        Float3 center{ 0.0f, 0.0f, 0.0f };
+        float scale = 1.0f;
+        if (sceneMin.x <= sceneMax.x)
+        {
+            const float maxExtent = (std::max)(sceneMax.x - sceneMin.x,
+                (std::max)(sceneMax.y - sceneMin.y, sceneMax.z - sceneMin.z));
+            if (maxExtent > 1e-6f)
+            {
+                center = { 0.5f * (sceneMin.x + sceneMax.x),
+                           0.5f * (sceneMin.y + sceneMax.y),
+                           0.5f * (sceneMin.z + sceneMax.z) };
+                scale = 1.0f / maxExtent;
+            }
+        }
+
+        //~ One ImportedMesh per primitive, the same split Assimp makes
+        std::vector<std::vector<std::uint32_t>> meshPrimitives(meshes->Size());
+
+        for (std::size_t m = 0; m < meshes->Size(); ++m)
+        {
+            const JsonValue& srcMesh = *meshes->At(m);
+            const JsonValue* primitives = srcMesh.Find("primitives");
+            const std::size_t primitiveCount = primitives ? primitives->Size() : 0u;
+
+            std::string baseName{ srcMesh.StringOr("name", {}) };
+            if (baseName.empty())
+                baseName = "Mesh_" + std::to_string(m);
+
+            for (std::size_t p = 0; p < primitiveCount; ++p)
+            {
+                ImportedMesh mesh{};
+                mesh.Name = primitiveCount > 1u ? baseName + "_" + std::to_string(p) : baseName;
+                mesh.MaterialIndex = primitives->At(p)->IndexOr("material");
+
+                if (!ConvertPrimitive(doc, *primitives->At(p), center, scale, mesh, error))
+                    return Fail("Mesh '" + mesh.Name + "': " + error);
+
+                meshPrimitives[m].push_back(static_cast<std::uint32_t>(outScene.Meshes.size()));
+                outScene.Meshes.emplace_back(std::move(mesh));
+            }
+        }
+
+        //~ Node hierarchy, a single scene root becomes the root node
+        const JsonValue* nodes = doc.Json.Find("nodes");
+        const std::size_t nodeCount = nodes ? nodes->Size() : 0u;
+
+        std::vector<std::uint32_t> roots;
+        const JsonValue* scenes = doc.Json.Find("scenes");
+        const std::uint32_t sceneIndex = doc.Json.IndexOr("scene");
+        const JsonValue* scene = scenes ? scenes->At(sceneIndex == ~0u ? 0u : sceneIndex) : nullptr;
+
+        if (const JsonValue* sceneNodes = scene ? scene->Find("nodes") : nullptr)
+        {
+            for (std::size_t i = 0; i < sceneNodes->Size(); ++i)
+                roots.push_back(static_cast<std::uint32_t>(sceneNodes->At(i)->Number));
+        }
+        else
+        {
+            //~ No scene, every node nobody parents is a root
+            std::vector<std::uint8_t> isChild(nodeCount, 0u);
+            for (std::size_t n = 0; n < nodeCount; ++n)
+            {
+                const JsonValue* children = nodes->At(n)->Find("children");
+                for (std::size_t c = 0; children && c < children->Size(); ++c)
+                {
+                    const auto child = static_cast<std::size_t>(children->At(c)->Number);
+                    if (child < nodeCount)
+                        isChild[child] = 1u;
+                }
+            }
+            for (std::size_t n = 0; n < nodeCount; ++n)
+            {
+                if (!isChild[n])
+                    roots.push_back(static_cast<std::uint32_t>(n));
+            }
+        }
+
+        std::vector<std::uint8_t> visiting(nodeCount, 0u);
+        std::vector<ImportedNode> rootNodes;
+
+        for (const std::uint32_t root : roots)
+        {
+            ImportedNode node{};
+            if (root < nodeCount && ConvertNodeRecursive(*nodes, root, meshPrimitives, visiting, 0u, node))
+                rootNodes.emplace_back(std::move(node));
+        }
+
+        if (rootNodes.size() == 1u)
+        {
+            outScene.RootNode = std::move(rootNodes.front());
+        }
+        else
+        {
+            outScene.RootNode.Name = "ROOT";
+            DirectX::XMStoreFloat4x4(&outScene.RootNode.LocalTransform, DirectX::XMMatrixIdentity());
+            outScene.RootNode.Children = std::move(rootNodes);
+
+            //~ Nothing instanced the meshes, reference them all from the root
+            if (outScene.RootNode.Children.empty())
+            {
+                for (std::uint32_t i = 0; i < outScene.Meshes.size(); ++i)
+                    outScene.RootNode.MeshIndices.push_back(i);
+            }
+        }
+
+        LOG_INFO("GltfImporter: Imported successfully (Meshes={}, Buffers={}, Mapped={})",
+            outScene.Meshes.size(), doc.Buffers.size(), doc.Mappings.size() + 1u);
+
+        return true;
+    }
+
+} // namespace kfe::import
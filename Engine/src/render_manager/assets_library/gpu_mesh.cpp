@@ -11,9 +11,9 @@
 #include "pch.h"
 
 #include "engine/render_manager/assets_library/model/gpu_mesh.h"
+#include "engine/render_manager/assets_library/model/vertex_quantizer.h"
 #include "engine/utils/logger.h"
 
-#include "engine/render_manager/api/buffer/staging_buffer.h"
 #include "engine/render_manager/api/buffer/vertex_buffer.h"
 #include "engine/render_manager/api/buffer/index_buffer.h"
 #include "engine/render_manager/api/buffer/buffer.h"
@@ -35,13 +35,21 @@ namespace kfe
         : m_name(std::move(other.m_name))
         , m_vertexCount(other.m_vertexCount)
         , m_indexCount(other.m_indexCount)
-        , m_pVBStaging(std::move(other.m_pVBStaging))
-        , m_pIBStaging(std::move(other.m_pIBStaging))
+        , m_bIndex16(other.m_bIndex16)
+        , m_vertexFormat(other.m_vertexFormat)
+        , m_aabbMin(other.m_aabbMin)
+        , m_aabbMax(other.m_aabbMax)
+        , m_meshlets(std::move(other.m_meshlets))
+        , m_lods(std::move(other.m_lods))
+        , m_vbAllocation(other.m_vbAllocation)
+        , m_ibAllocation(other.m_ibAllocation)
         , m_pVertexView(std::move(other.m_pVertexView))
         , m_pIndexView(std::move(other.m_pIndexView))
     {
         other.m_vertexCount = 0u;
         other.m_indexCount = 0u;
+        other.m_vbAllocation = {};
+        other.m_ibAllocation = {};
     }
 
     KFEGpuMesh& KFEGpuMesh::operator=(KFEGpuMesh&& other) noexcept
@@ -53,14 +61,22 @@ namespace kfe
             m_name = std::move(other.m_name);
             m_vertexCount = other.m_vertexCount;
             m_indexCount = other.m_indexCount;
-
-            m_pVBStaging = std::move(other.m_pVBStaging);
-            m_pIBStaging = std::move(other.m_pIBStaging);
+            m_bIndex16 = other.m_bIndex16;
+            m_vertexFormat = other.m_vertexFormat;
+            m_aabbMin = other.m_aabbMin;
+            m_aabbMax = other.m_aabbMax;
+            m_meshlets = std::move(other.m_meshlets);
+            m_lods = std::move(other.m_lods);
+
+            m_vbAllocation = other.m_vbAllocation;
+            m_ibAllocation = other.m_ibAllocation;
             m_pVertexView = std::move(other.m_pVertexView);
             m_pIndexView = std::move(other.m_pIndexView);
 
             other.m_vertexCount = 0u;
             other.m_indexCount = 0u;
+            other.m_vbAllocation = {};
+            other.m_ibAllocation = {};
         }
         return *this;
     }
@@ -69,11 +85,22 @@ namespace kfe
     {
         m_pVertexView.reset();
         m_pIndexView.reset();
-        m_pVBStaging.reset();
-        m_pIBStaging.reset();
+
+        //~ The arena may already be gone during shutdown
+        if (auto* arena = KFEGeometryArena::TryGet())
+        {
+            arena->Free(m_vbAllocation);
+            arena->Free(m_ibAllocation);
+        }
+        m_vbAllocation = {};
+        m_ibAllocation = {};
 
         m_vertexCount = 0u;
         m_indexCount = 0u;
+        m_bIndex16 = false;
+        m_vertexFormat = EMeshVertexFormat::Full;
+        m_meshlets.clear();
+        m_lods.clear();
         m_name.clear();
     }
 
@@ -115,122 +142,133 @@ namespace kfe
             m_name = desc.DebugName;
         }
 
-        const std::uint32_t vbSize =
-            static_cast<std::uint32_t>(vertices.size() * sizeof(KFEMeshVertex));
+        m_vertexFormat = desc.VertexFormat;
+        m_aabbMin = geom.GetAABBMin();
+        m_aabbMax = geom.GetAABBMax();
 
-        const std::uint32_t ibSize =
-            static_cast<std::uint32_t>(indices.size() * sizeof(std::uint32_t));
+        const auto meshlets = geom.GetMeshlets();
+        m_meshlets.assign(meshlets.begin(), meshlets.end());
 
-        auto* cmdListNative = desc.CommandList;
-        if (!cmdListNative)
+        const auto lods = geom.GetLods();
+        if (lods.empty())
+            m_lods.push_back({ 0u, m_indexCount, 0.0f, 0u });
+        else
+            m_lods.assign(lods.begin(), lods.end());
+
+        //~ Compact vertices only live long enough to be copied into the upload page
+        std::vector<KFEMeshVertexCompact> compactVertices;
+        const void* vertexData = vertices.data();
+
+        if (m_vertexFormat == EMeshVertexFormat::Compact)
         {
-            LOG_ERROR("KFEGpuMesh::Build: CommandList native pointer is null");
-            Destroy();
-            return false;
+            KFEVertexQuantizer::EncodeAll(vertices, m_aabbMin, m_aabbMax, compactVertices);
+            vertexData = compactVertices.data();
+
+#if defined(_DEBUG) || defined(DEBUG)
+            const KFE_VERTEX_QUANTIZATION_ERROR error =
+                KFEVertexQuantizer::MeasureRoundTrip(vertices, m_aabbMin, m_aabbMax);
+            if (!error.WithinBounds)
+            {
+                LOG_WARNING("KFEGpuMesh::Build: Compact vertices of '{}' exceed the format bounds, position {:.5f}, normal {:.2f} deg, tangent {:.2f} deg, uv {:.5f}",
+                    m_name, error.MaxPositionError, error.MaxNormalDegrees, error.MaxTangentDegrees, error.MaxUVError);
+            }
+#endif
         }
 
-        //~ Vertex staging buffer
-        m_pVBStaging = std::make_unique<KFEStagingBuffer>();
+        const std::uint32_t vertexStride = KFEMeshGeometry::GetVertexStride(m_vertexFormat);
 
-        KFE_STAGING_BUFFER_CREATE_DESC vbDesc{};
-        vbDesc.Device = desc.Device;
-        vbDesc.SizeInBytes = vbSize;
+        const std::uint32_t vbSize =
+            static_cast<std::uint32_t>(vertices.size() * vertexStride);
+
+        //~ Narrow indices only live long enough to be copied into the upload page
+        std::vector<std::uint16_t> narrowIndices;
+        const void* indexData = indices.data();
 
-        if (!m_pVBStaging->Initialize(vbDesc))
+        m_bIndex16 = desc.AllowIndex16 && geom.CanUseIndex16();
+        if (m_bIndex16)
         {
-            LOG_ERROR("KFEGpuMesh::Build: Failed to initialize Vertex Staging Buffer for '{}'", m_name);
-            Destroy();
-            return false;
+            narrowIndices.assign(indices.begin(), indices.end());
+            indexData = narrowIndices.data();
         }
 
-        if (!m_pVBStaging->WriteBytes(vertices.data(), vbSize, 0u))
+        const std::uint32_t ibSize = GetIndexBufferBytes();
+
+        auto* cmdListNative = desc.CommandList;
+        if (!cmdListNative)
         {
-            LOG_ERROR("KFEGpuMesh::Build: Failed to write Vertex Staging Buffer for '{}'", m_name);
+            LOG_ERROR("KFEGpuMesh::Build: CommandList native pointer is null");
             Destroy();
             return false;
         }
 
-        if (!m_pVBStaging->RecordUploadToDefault(cmdListNative, vbSize, 0u, 0u))
+        //~ Suballocate from the shared pages
+        KFEGeometryArena& arena = KFEGeometryArena::Instance();
+        if (!arena.IsReady())
         {
-            LOG_ERROR("KFEGpuMesh::Build: Failed to record upload for Vertex Staging Buffer '{}'", m_name);
-            Destroy();
-            return false;
+            KFE_GEOMETRY_ARENA_CREATE_DESC arenaDesc{};
+            arenaDesc.Device = desc.Device;
+
+            if (!arena.Initialize(arenaDesc))
+            {
+                LOG_ERROR("KFEGpuMesh::Build: Failed to initialize the geometry arena for '{}'", m_name);
+                Destroy();
+                return false;
+            }
         }
 
-        //~ Index staging buffer
-        m_pIBStaging = std::make_unique<KFEStagingBuffer>();
-
-        KFE_STAGING_BUFFER_CREATE_DESC ibDesc{};
-        ibDesc.Device = desc.Device;
-        ibDesc.SizeInBytes = ibSize;
+        m_vbAllocation = arena.Allocate(EGeometryArenaBuffer::Vertex, vbSize);
+        m_ibAllocation = arena.Allocate(EGeometryArenaBuffer::Index, ibSize);
 
-        if (!m_pIBStaging->Initialize(ibDesc))
+        if (!m_vbAllocation.IsValid() || !m_ibAllocation.IsValid())
         {
-            LOG_ERROR("KFEGpuMesh::Build: Failed to initialize Index Staging Buffer for '{}'", m_name);
+            LOG_ERROR("KFEGpuMesh::Build: Geometry arena is out of memory for '{}'", m_name);
             Destroy();
             return false;
         }
 
-        if (!m_pIBStaging->WriteBytes(indices.data(), ibSize, 0u))
-        {
-            LOG_ERROR("KFEGpuMesh::Build: Failed to write Index Staging Buffer for '{}'", m_name);
-            Destroy();
-            return false;
-        }
+        KFE_GEOMETRY_UPLOAD_DESC upload{};
+        upload.CommandList = cmdListNative;
+        upload.Fence = desc.Fence;
+        upload.FenceValue = desc.FenceValue;
 
-        if (!m_pIBStaging->RecordUploadToDefault(cmdListNative, ibSize, 0u, 0u))
+        upload.Data = vertexData;
+        upload.SizeInBytes = vbSize;
+        if (!arena.Upload(m_vbAllocation, upload))
         {
-            LOG_ERROR("KFEGpuMesh::Build: Failed to record upload for Index Staging Buffer '{}'", m_name);
+            LOG_ERROR("KFEGpuMesh::Build: Failed to record vertex upload for '{}'", m_name);
             Destroy();
             return false;
         }
 
-        //~ Default buffers
-        KFEBuffer* vbDefault = m_pVBStaging->GetDefaultBuffer();
-        KFEBuffer* ibDefault = m_pIBStaging->GetDefaultBuffer();
-
-        if (!vbDefault || !vbDefault->GetNative())
+        upload.Data = indexData;
+        upload.SizeInBytes = ibSize;
+        if (!arena.Upload(m_ibAllocation, upload))
         {
-            LOG_ERROR("KFEGpuMesh::Build: VB default buffer is null for '{}'", m_name);
+            LOG_ERROR("KFEGpuMesh::Build: Failed to record index upload for '{}'", m_name);
             Destroy();
             return false;
         }
 
-        if (!ibDefault || !ibDefault->GetNative())
+        KFEBuffer* vbPage = arena.GetBuffer(m_vbAllocation);
+        KFEBuffer* ibPage = arena.GetBuffer(m_ibAllocation);
+
+        if (!vbPage || !ibPage)
         {
-            LOG_ERROR("KFEGpuMesh::Build: IB default buffer is null for '{}'", m_name);
+            LOG_ERROR("KFEGpuMesh::Build: Geometry arena page missing for '{}'", m_name);
             Destroy();
             return false;
         }
 
-        //~ Resource barriers
-        D3D12_RESOURCE_BARRIER barriers[2]{};
-
-        barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        barriers[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-        barriers[0].Transition.pResource = vbDefault->GetNative();
-        barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
-
-        barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        barriers[1].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-        barriers[1].Transition.pResource = ibDefault->GetNative();
-        barriers[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-        barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_INDEX_BUFFER;
-
-        cmdListNative->ResourceBarrier(2u, barriers);
-
         //~ Vertex buffer view
         m_pVertexView = std::make_unique<KFEVertexBuffer>();
 
         KFE_VERTEX_BUFFER_CREATE_DESC vbViewDesc{};
         vbViewDesc.DebugName = m_name.c_str();
         vbViewDesc.Device = desc.Device;
-        vbViewDesc.OffsetInBytes = 0u;
-        vbViewDesc.ResourceBuffer = vbDefault;
-        vbViewDesc.StrideInBytes = sizeof(KFEMeshVertex);
+        vbViewDesc.OffsetInBytes = m_vbAllocation.Range.Offset;
+        vbViewDesc.SizeInBytes = vbSize;
+        vbViewDesc.ResourceBuffer = vbPage;
+        vbViewDesc.StrideInBytes = vertexStride;
 
         if (!m_pVertexView->Initialize(vbViewDesc))
         {
@@ -244,9 +282,10 @@ namespace kfe
 
         KFE_INDEX_BUFFER_CREATE_DESC ibViewDesc{};
         ibViewDesc.Device = desc.Device;
-        ibViewDesc.Format = DXGI_FORMAT_R32_UINT;
-        ibViewDesc.OffsetInBytes = 0u;
-        ibViewDesc.ResourceBuffer = ibDefault;
+        ibViewDesc.Format = GetIndexFormat();
+        ibViewDesc.OffsetInBytes = m_ibAllocation.Range.Offset;
+        ibViewDesc.SizeInBytes = ibSize;
+        ibViewDesc.ResourceBuffer = ibPage;
 
         if (!m_pIndexView->Initialize(ibViewDesc))
         {
@@ -255,8 +294,11 @@ namespace kfe
             return false;
         }
 
-        LOG_INFO("KFEGpuMesh::Build: Built GPU mesh '{}' (verts={}, indices={})",
-            m_name, m_vertexCount, m_indexCount);
+        LOG_INFO("KFEGpuMesh::Build: Built GPU mesh '{}' (verts={}, indices={}, vbBytes={} @ page {}+{}, ibBytes={} @ page {}+{}, index{})",
+            m_name, m_vertexCount, m_indexCount,
+            vbSize, m_vbAllocation.Page, m_vbAllocation.Range.Offset,
+            ibSize, m_ibAllocation.Page, m_ibAllocation.Range.Offset,
+            m_bIndex16 ? 16 : 32);
 
         return true;
     }
@@ -276,6 +318,23 @@ namespace kfe
         return m_indexCount;
     }
 
+    DXGI_FORMAT KFEGpuMesh::GetIndexFormat() const noexcept
+    {
+        return m_bIndex16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+    }
+
+    std::uint32_t KFEGpuMesh::GetIndexBufferBytes() const noexcept
+    {
+        return m_indexCount * (m_bIndex16
+            ? static_cast<std::uint32_t>(sizeof(std::uint16_t))
+            : static_cast<std::uint32_t>(sizeof(std::uint32_t)));
+    }
+
+    std::uint32_t KFEGpuMesh::GetVertexBufferBytes() const noexcept
+    {
+        return m_vertexCount * KFEMeshGeometry::GetVertexStride(m_vertexFormat);
+    }
+
     const KFEVertexBuffer* KFEGpuMesh::GetVertexBufferView() const noexcept
     {
         return m_pVertexView.get();
@@ -286,6 +345,43 @@ namespace kfe
         return m_pIndexView.get();
     }
 
+    EMeshVertexFormat KFEGpuMesh::GetVertexFormat() const noexcept
+    {
+        return m_vertexFormat;
+    }
+
+    XMMATRIX KFEGpuMesh::GetPositionDequantize() const noexcept
+    {
+        if (m_vertexFormat != EMeshVertexFormat::Compact)
+            return XMMatrixIdentity();
+
+        return XMMatrixScaling(
+                m_aabbMax.x - m_aabbMin.x,
+                m_aabbMax.y - m_aabbMin.y,
+                m_aabbMax.z - m_aabbMin.z) *
+            XMMatrixTranslation(m_aabbMin.x, m_aabbMin.y, m_aabbMin.z);
+    }
+
+    std::span<const KFE_MESHLET> KFEGpuMesh::GetMeshlets() const noexcept
+    {
+        return m_meshlets;
+    }
+
+    std::span<const KFE_MESH_LOD> KFEGpuMesh::GetLods() const noexcept
+    {
+        return m_lods;
+    }
+
+    const XMFLOAT3& KFEGpuMesh::GetAABBMin() const noexcept
+    {
+        return m_aabbMin;
+    }
+
+    const XMFLOAT3& KFEGpuMesh::GetAABBMax() const noexcept
+    {
+        return m_aabbMax;
+    }
+
     bool KFEGpuMesh::IsValid() const noexcept
     {
         return (m_pVertexView != nullptr) &&
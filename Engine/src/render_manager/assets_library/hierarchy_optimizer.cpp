@@ -0,0 +1,375 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : hierarchy_optimizer.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/hierarchy_optimizer.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace kfe
+{
+    using import::Float3;
+    using import::Float4x4;
+    using import::ImportedMesh;
+    using import::ImportedNode;
+    using import::ImportedScene;
+    using import::ImportedVertex;
+
+    namespace
+    {
+        //~ Imported transforms keep Assimp's layout: column vectors, translation in m[r][3]
+        Float4x4 Identity() noexcept
+        {
+            Float4x4 m{};
+            m.m[0][0] = m.m[1][1] = m.m[2][2] = m.m[3][3] = 1.0f;
+            return m;
+        }
+
+        Float4x4 Multiply(const Float4x4& a, const Float4x4& b) noexcept
+        {
+            Float4x4 r{};
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int col = 0; col < 4; ++col)
+                {
+                    r.m[row][col] =
+                        a.m[row][0] * b.m[0][col] + a.m[row][1] * b.m[1][col] +
+                        a.m[row][2] * b.m[2][col] + a.m[row][3] * b.m[3][col];
+                }
+            }
+            return r;
+        }
+
+        float Determinant3(const Float4x4& m) noexcept
+        {
+            return m.m[0][0] * (m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1])
+                 - m.m[0][1] * (m.m[1][0] * m.m[2][2] - m.m[1][2] * m.m[2][0])
+                 + m.m[0][2] * (m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0]);
+        }
+
+        Float3 TransformPoint(const Float4x4& m, const Float3& p) noexcept
+        {
+            return {
+                m.m[0][0] * p.x + m.m[0][1] * p.y + m.m[0][2] * p.z + m.m[0][3],
+                m.m[1][0] * p.x + m.m[1][1] * p.y + m.m[1][2] * p.z + m.m[1][3],
+                m.m[2][0] * p.x + m.m[2][1] * p.y + m.m[2][2] * p.z + m.m[2][3] };
+        }
+
+        Float3 TransformVector(const Float4x4& m, const Float3& v) noexcept
+        {
+            return {
+                m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z,
+                m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z,
+                m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z };
+        }
+
+        //~ Cofactors of the 3x3 part, det * inverse transpose, what normals need
+        Float4x4 Cofactor3(const Float4x4& m) noexcept
+        {
+            Float4x4 c{};
+            c.m[0][0] = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+            c.m[0][1] = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+            c.m[0][2] = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+            c.m[1][0] = m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2];
+            c.m[1][1] = m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0];
+            c.m[1][2] = m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1];
+            c.m[2][0] = m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1];
+            c.m[2][1] = m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2];
+            c.m[2][2] = m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0];
+            return c;
+        }
+
+        Float3 NormalizeOr(const Float3& v, const Float3& fallback) noexcept
+        {
+            const float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+            if (len <= 1e-20f)
+                return fallback;
+            return { v.x / len, v.y / len, v.z / len };
+        }
+
+        std::uint32_t CountNodes(const ImportedNode& node) noexcept
+        {
+            std::uint32_t count = 1u;
+            for (const auto& child : node.Children)
+                count += CountNodes(child);
+            return count;
+        }
+
+        //~ Single owner per mesh, or a count above one when it is instanced
+        struct MeshOwner
+        {
+            ImportedNode* Node = nullptr;
+            Float4x4      World{};
+            std::uint32_t References = 0u;
+        };
+
+        //~ World is relative to the root node, the root's own transform still applies
+        void GatherOwners(ImportedNode& node, const Float4x4& world, std::vector<MeshOwner>& owners)
+        {
+            for (const std::uint32_t meshIndex : node.MeshIndices)
+            {
+                if (meshIndex >= owners.size())
+                    continue;
+
+                MeshOwner& owner = owners[meshIndex];
+                if (owner.References++ == 0u)
+                {
+                    owner.Node  = &node;
+                    owner.World = world;
+                }
+            }
+
+            for (auto& child : node.Children)
+                GatherOwners(child, Multiply(world, child.LocalTransform), owners);
+        }
+
+        std::uint8_t AttributeMask(const ImportedMesh& mesh) noexcept
+        {
+            if (mesh.Vertices.empty())
+                return 0u;
+
+            const ImportedVertex& v = mesh.Vertices.front();
+            return static_cast<std::uint8_t>(
+                (v.HasNormal  ? 1u : 0u) | (v.HasTangent ? 2u : 0u) |
+                (v.HasUV[0]   ? 4u : 0u) | (v.HasUV[1]   ? 8u : 0u));
+        }
+
+        //~ Appends src baked by world, mirrored transforms flip the winding back
+        void AppendBaked(const ImportedMesh& src, const Float4x4& world, ImportedMesh& dst)
+        {
+            const float det = Determinant3(world);
+            const Float4x4 normalMatrix = Cofactor3(world);
+            const float normalSign = det < 0.0f ? -1.0f : 1.0f;
+
+            const auto base = static_cast<std::uint32_t>(dst.Vertices.size());
+
+            for (const ImportedVertex& v : src.Vertices)
+            {
+                ImportedVertex out = v;
+                out.Position = TransformPoint(world, v.Position);
+
+                if (v.HasNormal)
+                {
+                    const Float3 n = TransformVector(normalMatrix, v.Normal);
+                    out.Normal = NormalizeOr({ n.x * normalSign, n.y * normalSign, n.z * normalSign }, v.Normal);
+                }
+
+                if (v.HasTangent)
+                {
+                    out.Tangent   = NormalizeOr(TransformVector(world, v.Tangent), v.Tangent);
+                    out.Bitangent = NormalizeOr(TransformVector(world, v.Bitangent), v.Bitangent);
+                }
+
+                dst.AABBMin = { (std::min)(dst.AABBMin.x, out.Position.x), (std::min)(dst.AABBMin.y, out.Position.y), (std::min)(dst.AABBMin.z, out.Position.z) };
+                dst.AABBMax = { (std::max)(dst.AABBMax.x, out.Position.x), (std::max)(dst.AABBMax.y, out.Position.y), (std::max)(dst.AABBMax.z, out.Position.z) };
+
+                dst.Vertices.push_back(out);
+            }
+
+            for (std::size_t t = 0; t + 2u < src.Indices.size(); t += 3u)
+            {
+                const std::uint32_t i0 = base + src.Indices[t + 0u];
+                const std::uint32_t i1 = base + src.Indices[t + 1u];
+                const std::uint32_t i2 = base + src.Indices[t + 2u];
+
+                if (det < 0.0f)
+                    dst.Indices.insert(dst.Indices.end(), { i2, i1, i0 });
+                else
+                    dst.Indices.insert(dst.Indices.end(), { i0, i1, i2 });
+            }
+        }
+
+        std::uint32_t MergeSubmeshes(ImportedScene& scene, const KFE_HIERARCHY_OPTIMIZE_DESC& desc)
+        {
+            const std::size_t meshCount = scene.Meshes.size();
+
+            std::vector<MeshOwner> owners(meshCount);
+            GatherOwners(scene.RootNode, Identity(), owners);
+
+            //~ Groups in order of first appearance, keeps the output stable
+            std::vector<std::uint64_t> groupOrder;
+            std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> groups;
+
+            for (std::uint32_t i = 0; i < meshCount; ++i)
+            {
+                const ImportedMesh& mesh = scene.Meshes[i];
+                const MeshOwner& owner = owners[i];
+
+                if (owner.References != 1u || mesh.Vertices.empty() || mesh.Indices.size() < 3u)
+                    continue;
+
+                if (std::fabs(Determinant3(owner.World)) <= 1e-12f)
+                    continue;
+
+                const std::uint64_t key = (std::uint64_t{ mesh.MaterialIndex } << 8u) | AttributeMask(mesh);
+                auto [it, inserted] = groups.try_emplace(key);
+                if (inserted)
+                    groupOrder.push_back(key);
+                it->second.push_back(i);
+            }
+
+            std::vector<std::uint8_t> removed(meshCount, 0u);
+            std::vector<ImportedMesh> merged;
+            std::uint32_t foldedMeshes = 0u;
+
+            for (const std::uint64_t key : groupOrder)
+            {
+                const std::vector<std::uint32_t>& members = groups[key];
+                if (members.size() < 2u)
+                    continue;
+
+                //~ Split into batches that stay under the vertex limit
+                std::size_t begin = 0u;
+                while (begin < members.size())
+                {
+                    std::size_t end = begin;
+                    std::size_t vertices = 0u;
+                    while (end < members.size() &&
+                        (end == begin || vertices + scene.Meshes[members[end]].Vertices.size() <= desc.MaxMergedVertices))
+                    {
+                        vertices += scene.Meshes[members[end]].Vertices.size();
+                        ++end;
+                    }
+
+                    if (end - begin >= 2u)
+                    {
+                        ImportedMesh batch{};
+                        batch.Name = scene.Meshes[members[begin]].Name + "_Merged";
+                        batch.MaterialIndex = scene.Meshes[members[begin]].MaterialIndex;
+                        batch.Vertices.reserve(vertices);
+
+                        for (std::size_t m = begin; m < end; ++m)
+                        {
+                            const std::uint32_t meshIndex = members[m];
+                            AppendBaked(scene.Meshes[meshIndex], owners[meshIndex].World, batch);
+
+                            auto& refs = owners[meshIndex].Node->MeshIndices;
+                            refs.erase(std::remove(refs.begin(), refs.end(), meshIndex), refs.end());
+                            removed[meshIndex] = 1u;
+                            ++foldedMeshes;
+                        }
+
+                        merged.emplace_back(std::move(batch));
+                    }
+
+                    begin = end;
+                }
+            }
+
+            if (merged.empty())
+                return 0u;
+
+            //~ Compact: untouched meshes keep their order, merged ones go last on the root
+            std::vector<std::uint32_t> remap(meshCount, ~0u);
+            std::vector<ImportedMesh> meshes;
+            meshes.reserve(meshCount - foldedMeshes + merged.size());
+
+            for (std::uint32_t i = 0; i < meshCount; ++i)
+            {
+                if (removed[i])
+                    continue;
+                remap[i] = static_cast<std::uint32_t>(meshes.size());
+                meshes.emplace_back(std::move(scene.Meshes[i]));
+            }
+
+            auto Remap = [&remap](auto& self, ImportedNode& node) -> void
+                {
+                    for (auto& index : node.MeshIndices)
+                        index = index < remap.size() ? remap[index] : ~0u;
+
+                    node.MeshIndices.erase(std::remove(node.MeshIndices.begin(), node.MeshIndices.end(), ~0u),
+                        node.MeshIndices.end());
+
+                    for (auto& child : node.Children)
+                        self(self, child);
+                };
+            Remap(Remap, scene.RootNode);
+
+            const std::uint32_t batches = static_cast<std::uint32_t>(merged.size());
+            for (auto& batch : merged)
+            {
+                scene.RootNode.MeshIndices.push_back(static_cast<std::uint32_t>(meshes.size()));
+                meshes.emplace_back(std::move(batch));
+            }
+
+            scene.Meshes = std::move(meshes);
+
+            LOG_INFO("KFEHierarchyOptimizer: merged {} meshes into {}", foldedMeshes, batches);
+            return batches;
+        }
+
+        //~ Bottom up, so every child left under a node carries meshes
+        void CollapseChildren(ImportedNode& node)
+        {
+            for (auto& child : node.Children)
+                CollapseChildren(child);
+
+            std::vector<ImportedNode> kept;
+            kept.reserve(node.Children.size());
+
+            for (auto& child : node.Children)
+            {
+                if (child.HasMeshes())
+                {
+                    kept.emplace_back(std::move(child));
+                    continue;
+                }
+
+                for (auto& grandChild : child.Children)
+                {
+                    grandChild.LocalTransform = Multiply(child.LocalTransform, grandChild.LocalTransform);
+                    kept.emplace_back(std::move(grandChild));
+                }
+            }
+
+            node.Children = std::move(kept);
+        }
+    }
+
+    bool KFEHierarchyOptimizer::Optimize(ImportedScene& scene,
+                                         const KFE_HIERARCHY_OPTIMIZE_DESC& desc,
+                                         KFE_HIERARCHY_OPTIMIZE_STATS* outStats) noexcept
+    {
+        KFE_HIERARCHY_OPTIMIZE_STATS stats{};
+        stats.NodesBefore  = CountNodes(scene.RootNode);
+        stats.MeshesBefore = static_cast<std::uint32_t>(scene.Meshes.size());
+
+        if (desc.bMergeSubmeshes)
+        {
+            const std::uint32_t meshesBefore = stats.MeshesBefore;
+            stats.MergeBatches = MergeSubmeshes(scene, desc);
+            stats.MergedMeshes = meshesBefore + stats.MergeBatches - static_cast<std::uint32_t>(scene.Meshes.size());
+        }
+
+        //~ After merging, nodes emptied by it go as well
+        if (desc.bCollapseNodes)
+            CollapseChildren(scene.RootNode);
+
+        stats.NodesAfter  = CountNodes(scene.RootNode);
+        stats.MeshesAfter = static_cast<std::uint32_t>(scene.Meshes.size());
+
+        const bool changed = stats.NodesAfter != stats.NodesBefore || stats.MergeBatches > 0u;
+        if (changed)
+        {
+            LOG_INFO("KFEHierarchyOptimizer: nodes {} -> {}, meshes {} -> {}",
+                stats.NodesBefore, stats.NodesAfter, stats.MeshesBefore, stats.MeshesAfter);
+        }
+
+        if (outStats)
+            *outStats = stats;
+
+        return changed;
+    }
+}
@@ -19,18 +19,746 @@
 #include "engine/render_manager/api/commands/graphics_list.h"
 #include "engine/render_manager/api/heap/heap_cbv_srv_uav.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <span>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+namespace
+{
+    std::uint64_t SceneBytes(const kfe::import::ImportedScene& scene) noexcept
+    {
+        std::uint64_t bytes = 0u;
+        for (const auto& mesh : scene.Meshes)
+        {
+            bytes += mesh.Vertices.capacity() * sizeof(kfe::import::ImportedVertex);
+            bytes += mesh.Indices.capacity()  * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+
+    std::uint64_t CollisionBytes(const std::vector<kfe::KFE_MESH_COLLISION_DATA>& collision) noexcept
+    {
+        std::uint64_t bytes = 0u;
+        for (const auto& mesh : collision)
+        {
+            bytes += mesh.Positions.capacity() * sizeof(DirectX::XMFLOAT3);
+            bytes += mesh.Indices.capacity()   * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+
+    //~ Views, so cooked geometry counts its mapped bytes as well
+    std::uint64_t GeometryBytes(const kfe::KFEMeshGeometry& geom) noexcept
+    {
+        return geom.GetVertices().size_bytes() + geom.GetIndices().size_bytes() +
+               geom.GetMeshlets().size_bytes() + geom.GetLods().size_bytes();
+    }
+
+    std::uint64_t GpuMeshBytes(const kfe::KFEGpuMesh& mesh) noexcept
+    {
+        return std::uint64_t{ mesh.GetVertexBufferBytes() } + mesh.GetIndexBufferBytes();
+    }
+
+    //~ 8 bytes per step multiply-xorshift, collisions are caught by the byte compare
+    //~ (by HashBytesAlt and the sizes once the matching entry released its CPU copy)
+    std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed) noexcept
+    {
+        constexpr std::uint64_t kMul = 0x9E3779B97F4A7C15ull;
+
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        std::uint64_t h = seed ^ (size * kMul);
+
+        std::size_t i = 0u;
+        for (; i + 8u <= size; i += 8u)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            h = (h ^ word) * kMul;
+            h ^= h >> 29;
+        }
+
+        std::uint64_t tail = 0u;
+        if (i < size)
+            std::memcpy(&tail, bytes + i, size - i);
+        h = (h ^ tail) * kMul;
+        h ^= h >> 32;
+        return h;
+    }
+
+    //~ Murmur style mix with a rotating state, unrelated to HashBytes, so a trimmed
+    //~ slot only matches when both 64 bit hashes agree
+    std::uint64_t HashBytesAlt(const void* data, std::size_t size, std::uint64_t seed) noexcept
+    {
+        constexpr std::uint64_t kMul = 0xC6A4A7935BD1E995ull;
+
+        const auto mix = [](std::uint64_t k) noexcept
+        {
+            k *= kMul;
+            k ^= k >> 47;
+            return k * kMul;
+        };
+
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        std::uint64_t h = seed ^ (size * 0xFF51AFD7ED558CCDull);
+
+        std::size_t i = 0u;
+        for (; i + 8u <= size; i += 8u)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            h ^= mix(word);
+            h = ((h << 27) | (h >> 37)) * 5u + 0x52DCE729u;
+        }
+
+        std::uint64_t tail = 0u;
+        if (i < size)
+            std::memcpy(&tail, bytes + i, size - i);
+        h ^= mix(tail);
+
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    template<typename T>
+    std::uint64_t HashValue(const T& value, std::uint64_t seed) noexcept
+    {
+        return HashBytes(&value, sizeof(value), seed);
+    }
+
+    template<typename T>
+    bool SameSpan(std::span<const T> a, std::span<const T> b) noexcept
+    {
+        return a.size() == b.size() &&
+               (a.empty() || std::memcmp(a.data(), b.data(), a.size_bytes()) == 0);
+    }
+} // namespace
+
 namespace kfe
 {
+#pragma region Handle
+
+    KFEMeshCacheHandle::KFEMeshCacheHandle(KFE_MESH_CACHE_SHARE* share) noexcept
+        : m_pShare(share)
+    {
+        if (m_pShare)
+            KFEMeshCache::Instance().AddRef(m_pShare);
+    }
+
+    KFEMeshCacheHandle::~KFEMeshCacheHandle() noexcept
+    {
+        Reset();
+    }
+
+    KFEMeshCacheHandle::KFEMeshCacheHandle(const KFEMeshCacheHandle& other) noexcept
+        : KFEMeshCacheHandle(other.m_pShare)
+    {
+    }
+
+    KFEMeshCacheHandle::KFEMeshCacheHandle(KFEMeshCacheHandle&& other) noexcept
+        : m_pShare(std::exchange(other.m_pShare, nullptr))
+    {
+    }
+
+    KFEMeshCacheHandle& KFEMeshCacheHandle::operator=(const KFEMeshCacheHandle& other) noexcept
+    {
+        if (this != &other)
+        {
+            KFEMeshCacheHandle copy{ other };
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    KFEMeshCacheHandle& KFEMeshCacheHandle::operator=(KFEMeshCacheHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_pShare = std::exchange(other.m_pShare, nullptr);
+        }
+        return *this;
+    }
+
+    void KFEMeshCacheHandle::Reset() noexcept
+    {
+        if (!m_pShare)
+            return;
+
+        //~ The cache may already be gone during shutdown, its entries went with it
+        if (KFEMeshCache* cache = KFEMeshCache::TryGet())
+            cache->Release(m_pShare);
+
+        m_pShare = nullptr;
+    }
+
+#pragma endregion
+
     KFEMeshCache::KFEMeshCache() = default;
     KFEMeshCache::~KFEMeshCache() = default;
 
     void KFEMeshCache::Clear() noexcept
     {
-        m_cache.clear();
-        m_shares.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            m_prefetched.clear();
+            m_failedImports.clear();
+        }
+
+        std::vector<std::string> unused;
+        for (const auto& [key, share] : m_shares)
+        {
+            if (share.RefCount == 0u)
+                unused.push_back(key);
+        }
+
+        for (const auto& key : unused)
+            EraseEntry(key);
+
+        //~ Entries that never got a share (failed rebuilds) have no handles either
+        std::erase_if(m_cache, [this](const auto& kv)
+            {
+                return !m_shares.contains(kv.first);
+            });
+
+        RecountBytes();
+
+        if (!m_shares.empty())
+        {
+            LOG_WARNING("KFEMeshCache::Clear: {} model(s) still referenced, kept",
+                static_cast<std::uint32_t>(m_shares.size()));
+        }
+    }
+
+    void KFEMeshCache::AddRef(KFE_MESH_CACHE_SHARE* share) noexcept
+    {
+        ++share->RefCount;
+        share->LastUsed = ++m_tick;
+    }
+
+    void KFEMeshCache::Release(KFE_MESH_CACHE_SHARE* share) noexcept
+    {
+        if (share->RefCount == 0u)
+        {
+            LOG_WARNING("KFEMeshCache::Release: reference count already zero");
+            return;
+        }
+
+        share->LastUsed = ++m_tick;
+
+        if (--share->RefCount == 0u)
+            EvictUnused();
+    }
+
+    void KFEMeshCache::EraseEntry(const std::string& key) noexcept
+    {
+        //~ KFEGpuMesh::Destroy hands its ranges back to the arena, which reuses
+        //~ them only after the last upload fence. Meshes shared with another
+        //~ entry stay alive through its pointers.
+        m_cache.erase(key);
+        m_shares.erase(key);
+    }
+
+    void KFEMeshCache::RecountBytes() noexcept
+    {
+        std::unordered_set<const void*> seen;
+
+        std::uint64_t cpuHeld = 0u;
+        std::uint64_t gpuHeld = 0u;
+        m_cpuBytes = 0u;
+        m_gpuBytes = 0u;
+
+        for (const auto& [key, entry] : m_cache)
+        {
+            cpuHeld += entry.CPUBytes;
+            gpuHeld += entry.GPUBytes;
+
+            if (entry.SceneCPU)
+                m_cpuBytes += SceneBytes(*entry.SceneCPU);
+            m_cpuBytes += CollisionBytes(entry.CollisionCPU);
+
+            for (const auto& geom : entry.MeshesCPU)
+            {
+                if (geom && seen.insert(geom.get()).second)
+                    m_cpuBytes += GeometryBytes(*geom);
+            }
+
+            for (const auto& mesh : entry.MeshesGPU)
+            {
+                if (mesh && seen.insert(mesh.get()).second)
+                    m_gpuBytes += GpuMeshBytes(*mesh);
+            }
+        }
+
+        m_dedupCPUBytesSaved = cpuHeld - (std::min)(cpuHeld, m_cpuBytes);
+        m_dedupGPUBytesSaved = gpuHeld - (std::min)(gpuHeld, m_gpuBytes);
+
+        std::erase_if(m_dedup, [](const auto& kv)
+            {
+                return kv.second.Geometry.expired() && kv.second.Mesh.expired();
+            });
+    }
+
+    std::uint32_t KFEMeshCache::EvictUnused() noexcept
+    {
+        auto OverBudget = [this]() noexcept
+            {
+                return (m_budget.CPUBytes != 0u && m_cpuBytes > m_budget.CPUBytes) ||
+                       (m_budget.GPUBytes != 0u && m_gpuBytes > m_budget.GPUBytes);
+            };
+
+        std::uint32_t evicted = 0u;
+
+        while (OverBudget())
+        {
+            //~ Few models are cached at once, a scan beats keeping a list in sync
+            auto victim = m_shares.end();
+            for (auto it = m_shares.begin(); it != m_shares.end(); ++it)
+            {
+                if (it->second.RefCount != 0u)
+                    continue;
+
+                if (victim == m_shares.end() || it->second.LastUsed < victim->second.LastUsed)
+                    victim = it;
+            }
+
+            if (victim == m_shares.end())
+                break;  //~ everything left is in use
+
+            const std::string key = victim->first;
+            const KFE_MESH_CACHE_ENTRY* entry = victim->second.Entry;
+
+            LOG_INFO("KFEMeshCache: Evicting '{}' (cpu={} bytes, gpu={} bytes)",
+                key,
+                entry ? entry->CPUBytes : 0u,
+                entry ? entry->GPUBytes : 0u);
+
+            EraseEntry(key);
+            RecountBytes();
+            ++evicted;
+        }
+
+        m_evictions += evicted;
+        return evicted;
+    }
+
+    void KFEMeshCache::SetBudget(const KFE_MESH_CACHE_BUDGET& budget) noexcept
+    {
+        m_budget = budget;
+        EvictUnused();
+    }
+
+    const KFE_MESH_CACHE_BUDGET& KFEMeshCache::GetBudget() const noexcept
+    {
+        return m_budget;
+    }
+
+    std::uint64_t KFEMeshCache::ComputeCPUBytes(const KFE_MESH_CACHE_ENTRY& entry) noexcept
+    {
+        std::uint64_t bytes = entry.SceneCPU ? SceneBytes(*entry.SceneCPU) : 0u;
+        bytes += CollisionBytes(entry.CollisionCPU);
+
+        for (const auto& geom : entry.MeshesCPU)
+        {
+            if (geom)
+                bytes += GeometryBytes(*geom);
+        }
+
+        return bytes;
+    }
+
+    std::uint64_t KFEMeshCache::TrimEntryCPU(KFE_MESH_CACHE_ENTRY& entry) noexcept
+    {
+        if (entry.Retention == EMeshCPURetention::All || entry.bCPUTrimmed)
+            return 0u;
+
+        const std::uint64_t before = ComputeCPUBytes(entry);
+
+        if (entry.Retention == EMeshCPURetention::Collision)
+        {
+            entry.CollisionCPU.resize(entry.MeshesCPU.size());
+
+            for (std::size_t i = 0; i < entry.MeshesCPU.size(); ++i)
+            {
+                const KFEMeshGeometry* geom = entry.MeshesCPU[i].get();
+                if (!geom)
+                    continue;
+
+                const auto vertices = geom->GetVertices();
+                const auto indices  = geom->GetIndices();
+                const auto lods     = geom->GetLods();
+
+                KFE_MESH_COLLISION_DATA& dst = entry.CollisionCPU[i];
+                dst.Positions.resize(vertices.size());
+                for (std::size_t v = 0; v < vertices.size(); ++v)
+                    dst.Positions[v] = vertices[v].Position;
+
+                //~ The index buffer holds every LOD, LOD0 is enough for collision
+                std::size_t first = 0u;
+                std::size_t count = indices.size();
+                if (!lods.empty() && lods[0].IndexOffset + std::size_t{ lods[0].IndexCount } <= indices.size())
+                {
+                    first = lods[0].IndexOffset;
+                    count = lods[0].IndexCount;
+                }
+                dst.Indices.assign(indices.begin() + first, indices.begin() + first + count);
+            }
+        }
+
+        //~ Names and AABBs stay for KFEModel::BuildFromShare
+        if (entry.SceneCPU)
+        {
+            for (auto& mesh : entry.SceneCPU->Meshes)
+            {
+                std::vector<import::ImportedVertex>().swap(mesh.Vertices);
+                std::vector<std::uint32_t>().swap(mesh.Indices);
+            }
+        }
+
+        //~ Geometry shared with another entry lives on through that entry
+        entry.MeshesCPU.clear();
+        entry.MeshesCPU.shrink_to_fit();
+        entry.bCPUTrimmed = true;
+        entry.CPUBytes = ComputeCPUBytes(entry);
+
+        return before - (std::min)(before, entry.CPUBytes);
+    }
+
+    void KFEMeshCache::SetCPURetention(EMeshCPURetention retention) noexcept
+    {
+        m_retention = retention;
+    }
+
+    EMeshCPURetention KFEMeshCache::GetCPURetention() const noexcept
+    {
+        return m_retention;
+    }
+
+    void KFEMeshCache::SetCPURetention(const std::string& path,
+        EMeshCPURetention retention,
+        EMeshVertexFormat vertexFormat) noexcept
+    {
+        const std::string key = MakeCacheKey(path, vertexFormat);
+        m_retentionOverrides[key] = retention;
+
+        auto it = m_cache.find(key);
+        if (it == m_cache.end())
+            return;
+
+        KFE_MESH_CACHE_ENTRY& entry = it->second;
+        if (entry.bCPUTrimmed)
+        {
+            if (retention != entry.Retention)
+            {
+                LOG_WARNING("KFEMeshCache: '{}' already released its CPU data, the new retention applies on reload", key);
+            }
+            return;
+        }
+
+        entry.Retention = retention;
+
+        //~ Still waiting on its upload, TrimUploadedCPU picks the new policy up
+        const bool pending = std::any_of(m_pendingTrims.begin(), m_pendingTrims.end(),
+            [&key](const PendingTrim& p) { return p.Key == key; });
+        if (pending)
+            return;
+
+        if (const std::uint64_t freed = TrimEntryCPU(entry))
+        {
+            m_trimmedCPUBytes += freed;
+            RecountBytes();
+            LOG_INFO("KFEMeshCache: Released {} CPU bytes of '{}'", freed, key);
+        }
+    }
+
+    std::uint32_t KFEMeshCache::TrimUploadedCPU() noexcept
+    {
+        if (m_pendingTrims.empty())
+            return 0u;
+
+        std::uint32_t trimmed = 0u;
+        std::uint64_t freed = 0u;
+
+        std::erase_if(m_pendingTrims, [&](const PendingTrim& p)
+            {
+                if (p.Fence && p.Fence->GetCompletedValue() < p.FenceValue)
+                    return false;
+
+                //~ Evicted or rebuilt meanwhile, nothing left to do for this one
+                auto it = m_cache.find(p.Key);
+                if (it != m_cache.end())
+                {
+                    if (const std::uint64_t bytes = TrimEntryCPU(it->second))
+                    {
+                        freed += bytes;
+                        ++trimmed;
+                    }
+                }
+                return true;
+            });
+
+        if (trimmed > 0u)
+        {
+            m_trimmedCPUBytes += freed;
+            RecountBytes();
+
+            LOG_INFO("KFEMeshCache: Released CPU copies of {} model(s), {} bytes ({} bytes since startup)",
+                trimmed, freed, m_trimmedCPUBytes);
+        }
+
+        return trimmed;
+    }
+
+    std::uint64_t KFEMeshCache::ComputeGPUBytes(const KFE_MESH_CACHE_ENTRY& entry) noexcept
+    {
+        std::uint64_t bytes = 0u;
+
+        for (const auto& mesh : entry.MeshesGPU)
+        {
+            if (mesh)
+                bytes += GpuMeshBytes(*mesh);
+        }
+
+        return bytes;
+    }
+
+    void KFEMeshCache::HashMeshes(KFE_MESH_CACHE_ENTRY& entry) noexcept
+    {
+        entry.MeshHashes.assign(entry.MeshesCPU.size(), 0u);
+        entry.MeshDigests.assign(entry.MeshesCPU.size(), 0u);
+
+        for (std::size_t i = 0; i < entry.MeshesCPU.size(); ++i)
+        {
+            const KFEMeshGeometry* geom = entry.MeshesCPU[i].get();
+            if (!geom)
+                continue;
+
+            //~ Meshlets and LODs derive from these with the same build settings
+            const auto vertices = geom->GetVertices();
+            const auto indices  = geom->GetIndices();
+
+            std::uint64_t h = HashBytes(vertices.data(), vertices.size_bytes(), 0u);
+            h = HashBytes(indices.data(), indices.size_bytes(), h);
+            entry.MeshHashes[i] = h;
+
+            std::uint64_t d = HashBytesAlt(vertices.data(), vertices.size_bytes(), 0u);
+            d = HashBytesAlt(indices.data(), indices.size_bytes(), d);
+            entry.MeshDigests[i] = d;
+        }
+    }
+
+    KFEMeshCache::DedupSlot* KFEMeshCache::FindDuplicate(
+        std::uint64_t hash,
+        std::uint64_t digest,
+        const KFEMeshGeometry& geometry,
+        EMeshVertexFormat vertexFormat) noexcept
+    {
+        auto [first, last] = m_dedup.equal_range(hash);
+        for (auto it = first; it != last; ++it)
+        {
+            DedupSlot& slot = it->second;
+            if (slot.VertexFormat != vertexFormat)
+                continue;
+
+            const auto mesh = slot.Mesh.lock();
+            if (!mesh)
+                continue;
+
+            //~ Its entry released the CPU copy, only the hashes and sizes are left
+            const auto other = slot.Geometry.lock();
+            if (!other)
+            {
+                if (slot.Digest                == digest &&
+                    mesh->GetVertexCount()     == geometry.GetVertices().size() &&
+                    mesh->GetIndexCount()      == geometry.GetIndices().size()  &&
+                    mesh->GetMeshlets().size() == geometry.GetMeshlets().size() &&
+                    mesh->GetLods().size()     == (std::max)(geometry.GetLods().size(), std::size_t{ 1u }))
+                {
+                    return &slot;
+                }
+                continue;
+            }
+
+            if (other.get() == &geometry)
+                return &slot;
+
+            if (SameSpan(other->GetVertices(), geometry.GetVertices()) &&
+                SameSpan(other->GetIndices(),  geometry.GetIndices())  &&
+                other->GetMeshlets().size() == geometry.GetMeshlets().size() &&
+                other->GetLods().size()     == geometry.GetLods().size())
+            {
+                return &slot;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void KFEMeshCache::SetGeometryDedup(bool enabled) noexcept
+    {
+        m_bDedupGeometry = enabled;
     }
 
-    bool KFEMeshCache::BuildEntryCPU(const std::string& path, KFE_MESH_CACHE_ENTRY& entry) noexcept
+    void KFEMeshCache::SetTangentSpace(import::EImportTangentSpace mode) noexcept
+    {
+        m_importer.SetTangentSpace(mode);
+    }
+
+    std::vector<KFE_MESH_CACHE_ENTRY_INFO> KFEMeshCache::GetEntryInfo() const noexcept
+    {
+        std::vector<KFE_MESH_CACHE_ENTRY_INFO> info;
+        info.reserve(m_cache.size());
+
+        for (const auto& [key, entry] : m_cache)
+        {
+            KFE_MESH_CACHE_ENTRY_INFO row{};
+            row.Key       = key;
+            row.MeshCount = static_cast<std::uint32_t>(entry.MeshesGPU.size());
+            row.SharedMeshes = entry.SharedMeshes;
+            row.CPUBytes  = entry.CPUBytes;
+            row.GPUBytes  = entry.GPUBytes;
+            row.Retention = entry.Retention;
+            row.bCPUTrimmed = entry.bCPUTrimmed;
+
+            auto it = m_shares.find(key);
+            if (it != m_shares.end())
+                row.RefCount = it->second.RefCount;
+
+            info.emplace_back(std::move(row));
+        }
+
+        return info;
+    }
+
+    KFE_MESH_CACHE_STATS KFEMeshCache::GetStats() const noexcept
+    {
+        KFE_MESH_CACHE_STATS stats{};
+        stats.CPUBytes  = m_cpuBytes;
+        stats.GPUBytes  = m_gpuBytes;
+        stats.CPUBudget = m_budget.CPUBytes;
+        stats.GPUBudget = m_budget.GPUBytes;
+        stats.Evictions = m_evictions;
+        stats.DedupCPUBytesSaved = m_dedupCPUBytesSaved;
+        stats.DedupGPUBytesSaved = m_dedupGPUBytesSaved;
+        stats.PendingTrims       = static_cast<std::uint32_t>(m_pendingTrims.size());
+        stats.TrimmedCPUBytes    = m_trimmedCPUBytes;
+
+        for (const auto& [key, share] : m_shares)
+        {
+            if (share.RefCount == 0u)
+                ++stats.Unreferenced;
+        }
+
+        //~ Shared meshes are uploaded once, count them once
+        std::unordered_set<const KFEGpuMesh*> seen;
+
+        for (const auto& [key, entry] : m_cache)
+        {
+            ++stats.Models;
+            stats.SharedMeshes += entry.SharedMeshes;
+            if (entry.bCPUTrimmed)
+                ++stats.TrimmedModels;
+
+            for (const auto& mesh : entry.MeshesGPU)
+            {
+                if (!mesh || !mesh->IsValid() || !seen.insert(mesh.get()).second)
+                    continue;
+
+                ++stats.Meshes;
+                stats.IndexBytes += mesh->GetIndexBufferBytes();
+
+                if (mesh->GetIndexFormat() == DXGI_FORMAT_R16_UINT)
+                {
+                    ++stats.Index16Meshes;
+                    stats.IndexBytesSaved += static_cast<std::uint64_t>(mesh->GetIndexCount()) * sizeof(std::uint16_t);
+                }
+                else
+                {
+                    ++stats.Index32Meshes;
+                }
+            }
+        }
+
+        return stats;
+    }
+
+    void KFEMeshCache::SetImportOptimization(bool enabled, const KFE_MESH_OPTIMIZE_DESC& desc) noexcept
+    {
+        m_bOptimizeOnImport = enabled;
+        m_optimizeDesc = desc;
+    }
+
+    void KFEMeshCache::SetImportMeshlets(bool enabled, const KFE_MESHLET_BUILD_DESC& desc) noexcept
+    {
+        m_bBuildMeshlets = enabled;
+        m_meshletDesc = desc;
+    }
+
+    void KFEMeshCache::SetImportLods(bool enabled, const KFE_MESH_LOD_DESC& desc) noexcept
+    {
+        m_bBuildLods = enabled;
+        m_lodDesc = desc;
+    }
+
+    void KFEMeshCache::SetImportHierarchyOptimization(bool enabled, const KFE_HIERARCHY_OPTIMIZE_DESC& desc) noexcept
+    {
+        m_bOptimizeHierarchy = enabled;
+        m_hierarchyDesc = desc;
+    }
+
+    std::string KFEMeshCache::MakeCacheKey(const std::string& path, EMeshVertexFormat vertexFormat)
+    {
+        return vertexFormat == EMeshVertexFormat::Compact ? path + "#compact" : path;
+    }
+
+    std::uint64_t KFEMeshCache::GetBuildHash() const noexcept
+    {
+        //~ Field by field, the descs have padding
+        std::uint64_t h = 0u;
+
+        if (m_bOptimizeOnImport)
+        {
+            h = HashValue(m_optimizeDesc.CacheSize, h);
+            h = HashValue(m_optimizeDesc.OptimizeOverdraw, h);
+            h = HashValue(m_optimizeDesc.OverdrawThreshold, h);
+            h = HashValue(m_optimizeDesc.OptimizeFetch, h);
+        }
+
+        if (m_bBuildMeshlets)
+        {
+            h = HashValue(m_meshletDesc.MaxVertices, h);
+            h = HashValue(m_meshletDesc.MaxTriangles, h);
+            h = HashValue(m_meshletDesc.ConeWeight, h);
+        }
+
+        if (m_bBuildLods)
+        {
+            h = HashValue(m_lodDesc.LodCount, h);
+            h = HashValue(m_lodDesc.Reduction, h);
+            h = HashValue(m_lodDesc.MaxError, h);
+            h = HashValue(m_lodDesc.MinTriangles, h);
+            h = HashValue(m_lodDesc.CacheSize, h);
+        }
+
+        if (m_bOptimizeHierarchy)
+        {
+            h = HashValue(m_hierarchyDesc.bCollapseNodes, h);
+            h = HashValue(m_hierarchyDesc.bMergeSubmeshes, h);
+            h = HashValue(m_hierarchyDesc.MaxMergedVertices, h);
+        }
+
+        return h;
+    }
+
+    bool KFEMeshCache::BuildEntryCPU(const std::string& path, KFE_MESH_CACHE_ENTRY& entry) const noexcept
     {
         entry.SceneCPU.reset();
         entry.MeshesCPU.clear();
@@ -39,8 +767,43 @@ namespace kfe
         std::unique_ptr<import::ImportedScene> importedScene =
             std::make_unique<import::ImportedScene>();
 
+        //~ glTF goes through the native importer, cooked files remember which one ran
+        const bool bNativeGltf = import::GltfImporter::CanLoad(path);
+        std::uint32_t importFlags = bNativeGltf
+            ? import::GltfImporter::GetImportFlags()
+            : m_importer.GetPostProcessFlags();
+        const std::uint32_t buildFlags =
+            (m_bOptimizeOnImport ? KFE_KFMESH_BUILD_OPTIMIZED : 0u) |
+            (m_bBuildMeshlets    ? KFE_KFMESH_BUILD_MESHLETS  : 0u) |
+            (m_bBuildLods        ? KFE_KFMESH_BUILD_LODS      : 0u) |
+            (m_bOptimizeHierarchy ? KFE_KFMESH_BUILD_COLLAPSED : 0u);
+        const std::uint64_t buildHash = GetBuildHash();
+
+        //~ Cooked file first, importers only when it is missing or stale.
+        //~ A glTF that fell back to Assimp last time was cooked with Assimp's flags.
+        if (m_cooker.LoadCooked(path, importFlags, buildFlags, buildHash, *importedScene, entry.MeshesCPU) ||
+            (bNativeGltf && m_cooker.LoadCooked(path, m_importer.GetPostProcessFlags(),
+                buildFlags, buildHash, *importedScene, entry.MeshesCPU)))
+        {
+            entry.SceneCPU = std::move(importedScene);
+            HashMeshes(entry);
+            return true;
+        }
+
         std::string errorMsg;
-        if (!m_importer.LoadFromFile(path, *importedScene, errorMsg))
+        bool bImported = false;
+
+        if (bNativeGltf)
+        {
+            bImported = m_gltfImporter.LoadFromFile(path, *importedScene, errorMsg);
+            if (!bImported)
+            {
+                LOG_WARNING("Native glTF import of '{}' failed ({}), falling back to Assimp", path, errorMsg);
+                importFlags = m_importer.GetPostProcessFlags();
+            }
+        }
+
+        if (!bImported && !m_importer.LoadFromFile(path, *importedScene, errorMsg))
         {
             LOG_ERROR("Failed to import '{}': {}", path, errorMsg);
             return false;
@@ -52,6 +815,9 @@ namespace kfe
             return false;
         }
 
+        if (m_bOptimizeHierarchy)
+            KFEHierarchyOptimizer::Optimize(*importedScene, m_hierarchyDesc);
+
         entry.SceneCPU = std::move(importedScene);
 
         const auto& srcMeshes = entry.SceneCPU->Meshes;
@@ -62,7 +828,7 @@ namespace kfe
         {
             const auto& importedMesh = srcMeshes[i];
 
-            auto geom = std::make_unique<KFEMeshGeometry>();
+            auto geom = std::make_shared<KFEMeshGeometry>();
             if (!geom->BuildFromImportedMesh(importedMesh))
             {
                 LOG_ERROR("Failed to build geometry for mesh[{}] '{}' in '{}'",
@@ -70,6 +836,58 @@ namespace kfe
                 return false;
             }
 
+            if (m_bOptimizeOnImport)
+            {
+                KFE_MESH_OPTIMIZE_STATS stats{};
+                if (geom->Optimize(m_optimizeDesc, &stats))
+                {
+                    LOG_INFO("Optimized mesh[{}] '{}': ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, clusters={}, overdraw={}",
+                        i, importedMesh.Name,
+                        stats.ACMRBefore, stats.ACMRAfter,
+                        stats.ATVRBefore, stats.ATVRAfter,
+                        stats.ClusterCount, stats.OverdrawApplied);
+                }
+                else
+                {
+                    LOG_WARNING("Failed to optimize mesh[{}] '{}' in '{}', keeping file order",
+                        i, importedMesh.Name, path);
+                }
+            }
+
+            if (m_bBuildMeshlets)
+            {
+                KFE_MESHLET_BUILD_STATS stats{};
+                if (geom->BuildMeshlets(m_meshletDesc, &stats))
+                {
+                    LOG_INFO("Meshlets mesh[{}] '{}': count={}, avg verts={:.1f}, avg tris={:.1f}, cones disabled={}, {:.2f} ms",
+                        i, importedMesh.Name,
+                        stats.MeshletCount, stats.AverageVertices, stats.AverageTriangles,
+                        stats.ConesDisabled, stats.BuildMilliseconds);
+                }
+                else
+                {
+                    LOG_WARNING("Failed to build meshlets for mesh[{}] '{}' in '{}', drawing it whole",
+                        i, importedMesh.Name, path);
+                }
+            }
+
+            if (m_bBuildLods)
+            {
+                if (geom->BuildLods(m_lodDesc))
+                {
+                    for (const KFE_MESH_LOD& lod : geom->GetLods())
+                    {
+                        LOG_INFO("LOD mesh[{}] '{}': tris={}, error={:.5f}",
+                            i, importedMesh.Name, lod.IndexCount / 3u, lod.Error);
+                    }
+                }
+                else
+                {
+                    LOG_WARNING("Failed to build LODs for mesh[{}] '{}' in '{}'",
+                        i, importedMesh.Name, path);
+                }
+            }
+
             entry.MeshesCPU.emplace_back(std::move(geom));
         }
 
@@ -77,14 +895,257 @@ namespace kfe
             path,
             static_cast<std::uint32_t>(entry.MeshesCPU.size()));
 
+        if (!m_cooker.SaveCooked(path, importFlags, buildFlags, buildHash, *entry.SceneCPU, entry.MeshesCPU))
+        {
+            LOG_WARNING("Failed to cook '{}', it will be imported again next launch", path);
+        }
+
+        HashMeshes(entry);
         return true;
     }
 
+    KFEMeshCache::EPrefetchResult KFEMeshCache::TakePrefetchedCPU(const std::string& path, KFE_MESH_CACHE_ENTRY& entry) noexcept
+    {
+        PrefetchFuture future;
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+            if (m_failedImports.contains(path))
+                return EPrefetchResult::Failed;
+
+            auto it = m_prefetched.find(path);
+            if (it == m_prefetched.end())
+                return EPrefetchResult::None;
+
+            future = it->second;
+            m_prefetched.erase(it);
+        }
+
+        std::shared_ptr<KFE_MESH_CACHE_ENTRY> prepared = future.get();
+        if (!prepared)
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            m_failedImports.insert(path);
+            return EPrefetchResult::Failed;
+        }
+
+        entry = std::move(*prepared);
+        return EPrefetchResult::Ready;
+    }
+
+    std::uint32_t KFEMeshCache::PrefetchCPU(const std::vector<std::string>& paths, EMeshVertexFormat vertexFormat) noexcept
+    {
+        struct PrefetchJob
+        {
+            std::string                                        Path;
+            std::promise<std::shared_ptr<KFE_MESH_CACHE_ENTRY>> Promise;
+        };
+
+        std::vector<PrefetchJob> jobs;
+        std::vector<PrefetchFuture> waits;
+
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+            std::unordered_set<std::string> seen;
+            jobs.reserve(paths.size());
+
+            for (const auto& path : paths)
+            {
+                if (path.empty() || !seen.insert(path).second)
+                    continue;
+
+                //~ Asked for explicitly, a failed import gets another try
+                m_failedImports.erase(path);
+
+                if (m_cache.contains(MakeCacheKey(path, vertexFormat)))
+                    continue;
+
+                //~ Someone else is already importing it, just wait for theirs
+                auto it = m_prefetched.find(path);
+                if (it != m_prefetched.end())
+                {
+                    waits.push_back(it->second);
+                    continue;
+                }
+
+                PrefetchJob job{};
+                job.Path = path;
+                m_prefetched.emplace(path, job.Promise.get_future().share());
+                jobs.emplace_back(std::move(job));
+            }
+        }
+
+        std::atomic<std::uint32_t> next{ 0u };
+        std::atomic<std::uint32_t> succeeded{ 0u };
+
+        auto Worker = [&]() noexcept
+            {
+                for (;;)
+                {
+                    const std::uint32_t index = next.fetch_add(1u, std::memory_order_relaxed);
+                    if (index >= jobs.size())
+                        return;
+
+                    PrefetchJob& job = jobs[index];
+
+                    auto prepared = std::make_shared<KFE_MESH_CACHE_ENTRY>();
+                    if (BuildEntryCPU(job.Path, *prepared))
+                    {
+                        succeeded.fetch_add(1u, std::memory_order_relaxed);
+                        job.Promise.set_value(std::move(prepared));
+                    }
+                    else
+                    {
+                        LOG_ERROR("PrefetchCPU: Failed to prepare '{}'", job.Path);
+                        job.Promise.set_value(nullptr);
+                    }
+                }
+            };
+
+        const std::uint32_t hardware = (std::max)(1u, std::thread::hardware_concurrency());
+        const std::uint32_t workerCount = (std::min)(hardware, static_cast<std::uint32_t>(jobs.size()));
+
+        if (workerCount > 1u)
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(workerCount - 1u);
+
+            for (std::uint32_t i = 1u; i < workerCount; ++i)
+                workers.emplace_back(Worker);
+
+            Worker();
+        }   //~ joined here
+        else
+        {
+            Worker();
+        }
+
+        for (const auto& wait : waits)
+        {
+            if (wait.get())
+                succeeded.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        LOG_INFO("KFEMeshCache::PrefetchCPU: Prepared {}/{} models on {} workers",
+            succeeded.load(),
+            static_cast<std::uint32_t>(jobs.size() + waits.size()),
+            (std::max)(workerCount, 1u));
+
+        return succeeded.load();
+    }
+
+    void KFEMeshCache::PrefetchCPUAsync(const std::vector<std::string>& paths) noexcept
+    {
+        {
+            //~ Asked for explicitly, failed imports get another try
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            for (const auto& path : paths)
+                m_failedImports.erase(path);
+        }
+
+        QueueStreamJobs(paths);
+    }
+
+    bool KFEMeshCache::RequestCPU(const std::string& path, EMeshVertexFormat vertexFormat) noexcept
+    {
+        if (path.empty() || m_cache.contains(MakeCacheKey(path, vertexFormat)))
+            return true;
+
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+            //~ GetOrCreate fails right away for it
+            if (m_failedImports.contains(path))
+                return true;
+
+            auto it = m_prefetched.find(path);
+            if (it != m_prefetched.end())
+                return it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        QueueStreamJobs({ path });
+        return false;
+    }
+
+    void KFEMeshCache::QueueStreamJobs(const std::vector<std::string>& paths) noexcept
+    {
+        std::vector<StreamJob> jobs;
+
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+            for (const auto& path : paths)
+            {
+                if (path.empty() || m_prefetched.contains(path))
+                    continue;
+
+                StreamJob job{};
+                job.Path = path;
+                m_prefetched.emplace(path, job.Promise.get_future().share());
+                jobs.emplace_back(std::move(job));
+            }
+        }
+
+        if (jobs.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+
+            for (auto& job : jobs)
+                m_streamJobs.emplace_back(std::move(job));
+
+            //~ Leave a core for the render thread
+            if (m_streamWorkers.empty())
+            {
+                const std::uint32_t hardware = (std::max)(2u, std::thread::hardware_concurrency());
+                const std::uint32_t workerCount = (std::min)(hardware - 1u, 4u);
+
+                m_streamWorkers.reserve(workerCount);
+                for (std::uint32_t i = 0u; i < workerCount; ++i)
+                    m_streamWorkers.emplace_back([this](std::stop_token stop) { StreamWorker(stop); });
+            }
+        }
+
+        m_streamCv.notify_all();
+    }
+
+    void KFEMeshCache::StreamWorker(std::stop_token stop) noexcept
+    {
+        for (;;)
+        {
+            StreamJob job{};
+            {
+                std::unique_lock<std::mutex> lock(m_streamMutex);
+                if (!m_streamCv.wait(lock, stop, [this]() { return !m_streamJobs.empty(); }))
+                    return;
+
+                job = std::move(m_streamJobs.front());
+                m_streamJobs.pop_front();
+            }
+
+            auto prepared = std::make_shared<KFE_MESH_CACHE_ENTRY>();
+            if (BuildEntryCPU(job.Path, *prepared))
+            {
+                job.Promise.set_value(std::move(prepared));
+            }
+            else
+            {
+                LOG_ERROR("KFEMeshCache: Background import failed for '{}'", job.Path);
+                job.Promise.set_value(nullptr);
+            }
+        }
+    }
+
     bool KFEMeshCache::BuildEntryGPU(
         KFEDevice* device,
         ID3D12GraphicsCommandList* cmdList,
         KFEResourceHeap* resourceHeap,
         const std::string& path,
+        EMeshVertexFormat vertexFormat,
+        ID3D12Fence* fence,
+        std::uint64_t fenceValue,
         KFE_MESH_CACHE_ENTRY& entry) noexcept
     {
         (void)resourceHeap;
@@ -103,6 +1164,7 @@ namespace kfe
 
         entry.MeshesGPU.clear();
         entry.MeshesGPU.reserve(entry.MeshesCPU.size());
+        entry.SharedMeshes = 0u;
 
         const auto& srcMeshes = entry.SceneCPU->Meshes;
 
@@ -115,13 +1177,31 @@ namespace kfe
                 return false;
             }
 
-            auto gpuMesh = std::make_unique<KFEGpuMesh>();
+            const bool hashed = m_bDedupGeometry && i < entry.MeshHashes.size() && i < entry.MeshDigests.size();
+            if (hashed)
+            {
+                if (DedupSlot* slot = FindDuplicate(entry.MeshHashes[i], entry.MeshDigests[i], *geom, vertexFormat))
+                {
+                    //~ The CPU copy goes too, this entry's geometry is released here.
+                    //~ A trimmed slot has none, keep ours then.
+                    if (auto shared = slot->Geometry.lock())
+                        entry.MeshesCPU[i] = std::move(shared);
+                    entry.MeshesGPU.emplace_back(slot->Mesh.lock());
+                    ++entry.SharedMeshes;
+                    continue;
+                }
+            }
+
+            auto gpuMesh = std::make_shared<KFEGpuMesh>();
 
             KFE_GPU_MESH_BUILD_DESC buildDesc{};
             buildDesc.Device = device;
             buildDesc.CommandList = cmdList;
             buildDesc.Geometry = geom;
             buildDesc.DebugName = srcMeshes[i].Name.c_str();
+            buildDesc.VertexFormat = vertexFormat;
+            buildDesc.Fence = fence;
+            buildDesc.FenceValue = fenceValue;
 
             if (!gpuMesh->Build(buildDesc))
             {
@@ -130,12 +1210,39 @@ namespace kfe
                 return false;
             }
 
+            if (hashed)
+            {
+                DedupSlot slot{};
+                slot.Geometry = entry.MeshesCPU[i];
+                slot.Mesh = gpuMesh;
+                slot.VertexFormat = vertexFormat;
+                slot.Digest = entry.MeshDigests[i];
+                m_dedup.emplace(entry.MeshHashes[i], std::move(slot));
+            }
+
             entry.MeshesGPU.emplace_back(std::move(gpuMesh));
         }
 
-        LOG_INFO("Built GPU meshes for '{}' (meshes={})",
+        entry.VertexFormat = vertexFormat;
+
+        std::uint32_t index16 = 0u;
+        for (const auto& mesh : entry.MeshesGPU)
+        {
+            if (mesh->GetIndexFormat() == DXGI_FORMAT_R16_UINT)
+                ++index16;
+        }
+
+        LOG_INFO("Built GPU meshes for '{}' (meshes={}, shared={}, 16 bit indices={})",
             path,
-            static_cast<std::uint32_t>(entry.MeshesGPU.size()));
+            static_cast<std::uint32_t>(entry.MeshesGPU.size()),
+            entry.SharedMeshes,
+            index16);
+
+        const KFE_GEOMETRY_ARENA_STATS arena = KFEGeometryArena::Instance().GetStats();
+        LOG_INFO("Geometry arena: vertex {}/{} bytes in {} page(s), index {}/{} bytes in {} page(s), fragmentation {:.3f}/{:.3f}",
+            arena.Vertex.UsedBytes, arena.Vertex.Capacity, arena.VertexPages,
+            arena.Index.UsedBytes, arena.Index.Capacity, arena.IndexPages,
+            arena.Vertex.Fragmentation, arena.Index.Fragmentation);
 
         return true;
     }
@@ -146,9 +1253,14 @@ namespace kfe
             KFEDevice* device,
             ID3D12GraphicsCommandList* cmdList,
             KFEResourceHeap* resourceHeap,
-            KFE_MESH_CACHE_SHARE*& outShare) noexcept
+            KFEMeshCacheHandle& outHandle,
+            EMeshVertexFormat vertexFormat,
+            ID3D12Fence* fence,
+            std::uint64_t fenceValue) noexcept
     {
-        outShare = nullptr;
+        outHandle.Reset();
+
+        TrimUploadedCPU();
 
         if (path.empty())
         {
@@ -162,30 +1274,22 @@ namespace kfe
             return false;
         }
 
+        const std::string key = MakeCacheKey(path, vertexFormat);
+
         //~ Cache hit
         {
-            auto it = m_cache.find(path);
+            auto it = m_cache.find(key);
             if (it != m_cache.end())
             {
                 KFE_MESH_CACHE_ENTRY& entry = it->second;
                 if (entry.IsValid())
                 {
-                    auto itShare = m_shares.find(path);
-                    if (itShare == m_shares.end())
-                    {
-                        KFE_MESH_CACHE_SHARE share{};
-                        share.Entry = &entry;
-                        share.MeshCount = static_cast<std::uint32_t>(entry.MeshesGPU.size());
+                    auto [shareIt, _] = m_shares.try_emplace(key);
+                    shareIt->second.Entry = &entry;
+                    shareIt->second.MeshCount = static_cast<std::uint32_t>(entry.MeshesGPU.size());
 
-                        auto [shareIt, _] = m_shares.insert_or_assign(path, share);
-                        outShare = &shareIt->second;
-                    }
-                    else
-                    {
-                        outShare = &itShare->second;
-                    }
-
-                    return outShare && outShare->IsValid();
+                    outHandle = KFEMeshCacheHandle{ &shareIt->second };
+                    return outHandle.IsValid();
                 }
 
                 LOG_WARNING("Existing entry for '{}' invalid, rebuilding", path);
@@ -194,32 +1298,73 @@ namespace kfe
 
         KFE_MESH_CACHE_ENTRY entry{};
 
-        if (!BuildEntryCPU(path, entry))
+        switch (TakePrefetchedCPU(path, entry))
         {
-            LOG_ERROR("BuildEntryCPU failed for '{}'", path);
+        case EPrefetchResult::Ready:
+            break;
+
+        case EPrefetchResult::Failed:
+            //~ Importing it again here would stall the render thread for the same error
+            LOG_ERROR("Background import of '{}' failed, not building it", path);
             return false;
+
+        case EPrefetchResult::None:
+        default:
+            if (!BuildEntryCPU(path, entry))
+            {
+                LOG_ERROR("BuildEntryCPU failed for '{}'", path);
+                return false;
+            }
+            break;
         }
 
-        if (!BuildEntryGPU(device, cmdList, resourceHeap, path, entry))
+        if (!BuildEntryGPU(device, cmdList, resourceHeap, path, vertexFormat, fence, fenceValue, entry))
         {
             LOG_ERROR("BuildEntryGPU failed for '{}'", path);
             return false;
         }
 
-        auto [itInserted, _] = m_cache.insert_or_assign(path, std::move(entry));
+        entry.CPUBytes = ComputeCPUBytes(entry);
+        entry.GPUBytes = ComputeGPUBytes(entry);
+
+        const auto overrideIt = m_retentionOverrides.find(key);
+        entry.Retention = overrideIt != m_retentionOverrides.end() ? overrideIt->second : m_retention;
+
+        auto [itInserted, _] = m_cache.insert_or_assign(key, std::move(entry));
         KFE_MESH_CACHE_ENTRY* finalEntry = &itInserted->second;
 
-        KFE_MESH_CACHE_SHARE share{};
-        share.Entry = finalEntry;
-        share.MeshCount = static_cast<std::uint32_t>(finalEntry->MeshesGPU.size());
+        //~ try_emplace keeps the count of handles to a rebuilt entry
+        auto [shareIt, __] = m_shares.try_emplace(key);
+        shareIt->second.Entry = finalEntry;
+        shareIt->second.MeshCount = static_cast<std::uint32_t>(finalEntry->MeshesGPU.size());
+
+        outHandle = KFEMeshCacheHandle{ &shareIt->second };
 
-        auto [shareIt, __] = m_shares.insert_or_assign(path, share);
-        outShare = &shareIt->second;
+        //~ Released once the copy is done, without a fence the upload pages already hold the data
+        if (finalEntry->Retention != EMeshCPURetention::All)
+        {
+            m_pendingTrims.push_back({ key, fence, fenceValue });
+            TrimUploadedCPU();
+        }
 
-        LOG_INFO("KFEMeshCache::GetOrCreate: Cached '{}' (meshes={})",
+        RecountBytes();
+
+        LOG_INFO("KFEMeshCache::GetOrCreate: Cached '{}' (meshes={}, shared={}, cpu={} bytes, gpu={} bytes)",
             path,
-            share.MeshCount);
+            shareIt->second.MeshCount,
+            finalEntry->SharedMeshes,
+            finalEntry->CPUBytes,
+            finalEntry->GPUBytes);
+
+        if (finalEntry->SharedMeshes > 0u)
+        {
+            LOG_INFO("KFEMeshCache: Dedup saves {} CPU bytes, {} GPU bytes",
+                m_dedupCPUBytesSaved, m_dedupGPUBytesSaved);
+        }
+
+        //~ Held now, so only older unused models can go
+        EvictUnused();
 
-        return outShare && outShare->IsValid();
+        return outHandle.IsValid();
     }
 }
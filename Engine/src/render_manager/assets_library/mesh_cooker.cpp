@@ -0,0 +1,509 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mesh_cooker.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/mesh_cooker.h"
+#include "engine/utils/file_system.h"
+#include "engine/utils/logger.h"
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace kfe
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        inline constexpr std::uint64_t KFMESH_PAYLOAD_ALIGNMENT = 16u;
+
+        static std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment) noexcept
+        {
+            return (value + alignment - 1u) & ~(alignment - 1u);
+        }
+
+        static bool QuerySourceStamp(const std::string& path,
+            std::int64_t& outWriteTime,
+            std::uint64_t& outSize) noexcept
+        {
+            std::error_code ec;
+
+            const auto size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+
+            const auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return false;
+
+            outWriteTime = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+            outSize = static_cast<std::uint64_t>(size);
+            return true;
+        }
+
+        static bool IsRangeInside(std::uint64_t offset, std::uint64_t bytes, std::uint64_t fileSize) noexcept
+        {
+            return offset <= fileSize && bytes <= fileSize - offset;
+        }
+
+        static std::uint32_t AppendString(std::string& table, const std::string& str)
+        {
+            const std::uint32_t offset = static_cast<std::uint32_t>(table.size());
+            table.append(str);
+            return offset;
+        }
+
+        static bool ReadNodeRecursive(
+            const KFE_KFMESH_NODE_RECORD* nodes,
+            std::uint32_t nodeCount,
+            const std::uint32_t* nodeMeshIndices,
+            std::uint32_t nodeMeshIndexCount,
+            const char* strings,
+            std::uint64_t stringBytes,
+            std::uint32_t nodeIndex,
+            std::uint32_t depth,
+            import::ImportedNode& dst) noexcept
+        {
+            //~ Breadth first order means a child always has a bigger index than its parent
+            if (nodeIndex >= nodeCount || depth > nodeCount)
+                return false;
+
+            const KFE_KFMESH_NODE_RECORD& src = nodes[nodeIndex];
+
+            if (!IsRangeInside(src.NameOffset, src.NameLength, stringBytes))
+                return false;
+
+            if (!IsRangeInside(src.FirstMeshIndex, src.MeshIndexCount, nodeMeshIndexCount))
+                return false;
+
+            if (src.ChildCount > 0u &&
+                (src.FirstChild <= nodeIndex || !IsRangeInside(src.FirstChild, src.ChildCount, nodeCount)))
+                return false;
+
+            dst.Name.assign(strings + src.NameOffset, src.NameLength);
+            std::memcpy(&dst.LocalTransform, src.LocalTransform, sizeof(src.LocalTransform));
+
+            dst.MeshIndices.assign(
+                nodeMeshIndices + src.FirstMeshIndex,
+                nodeMeshIndices + src.FirstMeshIndex + src.MeshIndexCount);
+
+            dst.Children.resize(src.ChildCount);
+
+            for (std::uint32_t c = 0; c < src.ChildCount; ++c)
+            {
+                if (!ReadNodeRecursive(nodes, nodeCount, nodeMeshIndices, nodeMeshIndexCount,
+                    strings, stringBytes, src.FirstChild + c, depth + 1u, dst.Children[c]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    KFEMeshCooker::KFEMeshCooker() = default;
+    KFEMeshCooker::~KFEMeshCooker() = default;
+
+    std::string KFEMeshCooker::GetCookedPath(const std::string& sourcePath)
+    {
+        return sourcePath + KFE_KFMESH_EXTENSION;
+    }
+
+    bool KFEMeshCooker::LoadCooked(
+        const std::string& sourcePath,
+        std::uint32_t importFlags,
+        std::uint32_t buildFlags,
+        std::uint64_t buildHash,
+        import::ImportedScene& outScene,
+        std::vector<std::shared_ptr<KFEMeshGeometry>>& outMeshes) const noexcept
+    {
+        outScene.Clear();
+        outMeshes.clear();
+
+        const std::string cookedPath = GetCookedPath(sourcePath);
+
+        std::error_code ec;
+        if (!std::filesystem::exists(cookedPath, ec))
+            return false;
+
+        std::int64_t  sourceTime = 0;
+        std::uint64_t sourceSize = 0u;
+        if (!QuerySourceStamp(sourcePath, sourceTime, sourceSize))
+            return false;
+
+        auto mapped = std::make_shared<KFEMappedFile>();
+        if (!mapped->Open(cookedPath))
+        {
+            LOG_WARNING("KFEMeshCooker: Failed to map '{}'", cookedPath);
+            return false;
+        }
+
+        const std::uint8_t* base = mapped->GetData();
+        const std::uint64_t fileSize = mapped->GetSize();
+
+        if (fileSize < sizeof(KFE_KFMESH_HEADER))
+        {
+            LOG_WARNING("KFEMeshCooker: '{}' is truncated", cookedPath);
+            return false;
+        }
+
+        KFE_KFMESH_HEADER header{};
+        std::memcpy(&header, base, sizeof(header));
+
+        if (header.Magic != KFE_KFMESH_MAGIC || header.Version != KFE_KFMESH_VERSION)
+        {
+            LOG_INFO("KFEMeshCooker: '{}' has an old version, recooking", cookedPath);
+            return false;
+        }
+
+        if (header.ImportFlags != importFlags ||
+            header.BuildFlags != buildFlags ||
+            header.BuildHash != buildHash ||
+            header.VertexStride != sizeof(KFEMeshVertex))
+        {
+            LOG_INFO("KFEMeshCooker: '{}' was cooked with different import settings, recooking", cookedPath);
+            return false;
+        }
+
+        if (header.SourceWriteTime != sourceTime || header.SourceSize != sourceSize)
+        {
+            LOG_INFO("KFEMeshCooker: Source '{}' changed since cook, recooking", sourcePath);
+            return false;
+        }
+
+        if (header.FileSize != fileSize ||
+            header.MeshCount == 0u ||
+            header.NodeCount == 0u ||
+            !IsRangeInside(header.MeshTableOffset,
+                static_cast<std::uint64_t>(header.MeshCount) * sizeof(KFE_KFMESH_MESH_RECORD), fileSize) ||
+            !IsRangeInside(header.NodeTableOffset,
+                static_cast<std::uint64_t>(header.NodeCount) * sizeof(KFE_KFMESH_NODE_RECORD), fileSize) ||
+            !IsRangeInside(header.NodeMeshIndexOffset,
+                static_cast<std::uint64_t>(header.NodeMeshIndexCount) * sizeof(std::uint32_t), fileSize) ||
+            !IsRangeInside(header.StringTableOffset, header.StringTableSize, fileSize) ||
+            (header.MeshTableOffset % alignof(KFE_KFMESH_MESH_RECORD)) != 0u ||
+            (header.NodeTableOffset % alignof(KFE_KFMESH_NODE_RECORD)) != 0u ||
+            (header.NodeMeshIndexOffset % alignof(std::uint32_t)) != 0u)
+        {
+            LOG_WARNING("KFEMeshCooker: '{}' has a corrupt header", cookedPath);
+            return false;
+        }
+
+        const auto* meshRecords = reinterpret_cast<const KFE_KFMESH_MESH_RECORD*>(base + header.MeshTableOffset);
+        const auto* nodeRecords = reinterpret_cast<const KFE_KFMESH_NODE_RECORD*>(base + header.NodeTableOffset);
+        const auto* nodeMeshIndices = reinterpret_cast<const std::uint32_t*>(base + header.NodeMeshIndexOffset);
+        const char* strings = reinterpret_cast<const char*>(base + header.StringTableOffset);
+
+        //~ Every geometry keeps the mapping alive
+        const std::shared_ptr<const void> backing = mapped;
+
+        outScene.Meshes.resize(header.MeshCount);
+        outMeshes.reserve(header.MeshCount);
+
+        for (std::uint32_t i = 0; i < header.MeshCount; ++i)
+        {
+            const KFE_KFMESH_MESH_RECORD& rec = meshRecords[i];
+
+            const std::uint64_t vertexBytes = static_cast<std::uint64_t>(rec.VertexCount) * sizeof(KFEMeshVertex);
+            const std::uint64_t indexBytes = static_cast<std::uint64_t>(rec.IndexCount) * sizeof(std::uint32_t);
+            const std::uint64_t meshletBytes = static_cast<std::uint64_t>(rec.MeshletCount) * sizeof(KFE_MESHLET);
+            const std::uint64_t lodBytes = static_cast<std::uint64_t>(rec.LodCount) * sizeof(KFE_MESH_LOD);
+
+            if (!IsRangeInside(rec.NameOffset, rec.NameLength, header.StringTableSize) ||
+                !IsRangeInside(rec.VertexOffset, vertexBytes, fileSize) ||
+                !IsRangeInside(rec.IndexOffset, indexBytes, fileSize) ||
+                !IsRangeInside(rec.MeshletOffset, meshletBytes, fileSize) ||
+                !IsRangeInside(rec.LodOffset, lodBytes, fileSize) ||
+                (rec.VertexOffset % alignof(KFEMeshVertex)) != 0u ||
+                (rec.IndexOffset % alignof(std::uint32_t)) != 0u ||
+                (rec.MeshletOffset % alignof(KFE_MESHLET)) != 0u ||
+                (rec.LodOffset % alignof(KFE_MESH_LOD)) != 0u)
+            {
+                LOG_WARNING("KFEMeshCooker: '{}' mesh[{}] is out of bounds", cookedPath, i);
+                outScene.Clear();
+                outMeshes.clear();
+                return false;
+            }
+
+            import::ImportedMesh& mesh = outScene.Meshes[i];
+            mesh.Name.assign(strings + rec.NameOffset, rec.NameLength);
+            mesh.MaterialIndex = rec.MaterialIndex;
+            mesh.AABBMin = { rec.AABBMin[0], rec.AABBMin[1], rec.AABBMin[2] };
+            mesh.AABBMax = { rec.AABBMax[0], rec.AABBMax[1], rec.AABBMax[2] };
+
+            const std::span<const KFEMeshVertex> vertices(
+                reinterpret_cast<const KFEMeshVertex*>(base + rec.VertexOffset), rec.VertexCount);
+            const std::span<const std::uint32_t> indices(
+                reinterpret_cast<const std::uint32_t*>(base + rec.IndexOffset), rec.IndexCount);
+            const std::span<const KFE_MESHLET> meshlets(
+                reinterpret_cast<const KFE_MESHLET*>(base + rec.MeshletOffset), rec.MeshletCount);
+            const std::span<const KFE_MESH_LOD> lods(
+                reinterpret_cast<const KFE_MESH_LOD*>(base + rec.LodOffset), rec.LodCount);
+
+            bool rangesValid = true;
+            for (const KFE_MESHLET& m : meshlets)
+            {
+                if (!IsRangeInside(m.IndexOffset, static_cast<std::uint64_t>(m.TriangleCount) * 3u, rec.IndexCount))
+                {
+                    rangesValid = false;
+                    break;
+                }
+            }
+
+            for (const KFE_MESH_LOD& l : lods)
+            {
+                if (!IsRangeInside(l.IndexOffset, l.IndexCount, rec.IndexCount) || (l.IndexCount % 3u) != 0u)
+                {
+                    rangesValid = false;
+                    break;
+                }
+            }
+
+            auto geom = std::make_shared<KFEMeshGeometry>();
+            if (!rangesValid ||
+                !geom->BuildFromView(mesh.Name, vertices, indices, mesh.AABBMin, mesh.AABBMax, backing, meshlets, lods))
+            {
+                LOG_WARNING("KFEMeshCooker: '{}' mesh[{}] '{}' is empty", cookedPath, i, mesh.Name);
+                outScene.Clear();
+                outMeshes.clear();
+                return false;
+            }
+
+            outMeshes.emplace_back(std::move(geom));
+        }
+
+        if (!ReadNodeRecursive(nodeRecords, header.NodeCount,
+            nodeMeshIndices, header.NodeMeshIndexCount,
+            strings, header.StringTableSize,
+            0u, 0u, outScene.RootNode))
+        {
+            LOG_WARNING("KFEMeshCooker: '{}' has a corrupt node hierarchy", cookedPath);
+            outScene.Clear();
+            outMeshes.clear();
+            return false;
+        }
+
+        LOG_INFO("KFEMeshCooker: Loaded cooked '{}' (meshes={}, nodes={}, bytes={})",
+            cookedPath, header.MeshCount, header.NodeCount, fileSize);
+
+        return true;
+    }
+
+    bool KFEMeshCooker::SaveCooked(
+        const std::string& sourcePath,
+        std::uint32_t importFlags,
+        std::uint32_t buildFlags,
+        std::uint64_t buildHash,
+        const import::ImportedScene& scene,
+        const std::vector<std::shared_ptr<KFEMeshGeometry>>& meshes) const noexcept
+    {
+        if (meshes.empty() || meshes.size() != scene.Meshes.size())
+        {
+            LOG_ERROR("KFEMeshCooker: Scene '{}' and geometry do not match, not cooking", sourcePath);
+            return false;
+        }
+
+        KFE_KFMESH_HEADER header{};
+        header.Magic = KFE_KFMESH_MAGIC;
+        header.Version = KFE_KFMESH_VERSION;
+        header.ImportFlags = importFlags;
+        header.BuildFlags = buildFlags;
+        header.BuildHash = buildHash;
+        header.VertexStride = sizeof(KFEMeshVertex);
+
+        if (!QuerySourceStamp(sourcePath, header.SourceWriteTime, header.SourceSize))
+        {
+            LOG_ERROR("KFEMeshCooker: Failed to stat source '{}'", sourcePath);
+            return false;
+        }
+
+        std::string strings;
+
+        //~ Nodes, breadth first
+        std::vector<const import::ImportedNode*> order{ &scene.RootNode };
+        std::vector<KFE_KFMESH_NODE_RECORD>      nodeRecords;
+        std::vector<std::uint32_t>               nodeMeshIndices;
+
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            const import::ImportedNode* node = order[i];
+
+            KFE_KFMESH_NODE_RECORD rec{};
+            rec.NameOffset = AppendString(strings, node->Name);
+            rec.NameLength = static_cast<std::uint32_t>(node->Name.size());
+            std::memcpy(rec.LocalTransform, &node->LocalTransform, sizeof(rec.LocalTransform));
+
+            rec.FirstMeshIndex = static_cast<std::uint32_t>(nodeMeshIndices.size());
+            rec.MeshIndexCount = static_cast<std::uint32_t>(node->MeshIndices.size());
+            nodeMeshIndices.insert(nodeMeshIndices.end(), node->MeshIndices.begin(), node->MeshIndices.end());
+
+            rec.FirstChild = static_cast<std::uint32_t>(order.size());
+            rec.ChildCount = static_cast<std::uint32_t>(node->Children.size());
+            for (const auto& child : node->Children)
+                order.push_back(&child);
+
+            nodeRecords.push_back(rec);
+        }
+
+        //~ Mesh records
+        std::vector<KFE_KFMESH_MESH_RECORD> meshRecords(meshes.size());
+
+        for (std::size_t i = 0; i < meshes.size(); ++i)
+        {
+            const KFEMeshGeometry* geom = meshes[i].get();
+            if (!geom || !geom->IsValid())
+            {
+                LOG_ERROR("KFEMeshCooker: Invalid geometry mesh[{}] in '{}', not cooking", i, sourcePath);
+                return false;
+            }
+
+            KFE_KFMESH_MESH_RECORD& rec = meshRecords[i];
+            const std::string& name = scene.Meshes[i].Name;
+            rec.NameOffset = AppendString(strings, name);
+            rec.NameLength = static_cast<std::uint32_t>(name.size());
+            rec.MaterialIndex = scene.Meshes[i].MaterialIndex;
+            rec.VertexCount = static_cast<std::uint32_t>(geom->GetVertices().size());
+            rec.IndexCount = static_cast<std::uint32_t>(geom->GetIndices().size());
+            rec.MeshletCount = static_cast<std::uint32_t>(geom->GetMeshlets().size());
+            rec.LodCount = static_cast<std::uint32_t>(geom->GetLods().size());
+
+            const XMFLOAT3& mn = geom->GetAABBMin();
+            const XMFLOAT3& mx = geom->GetAABBMax();
+            rec.AABBMin[0] = mn.x; rec.AABBMin[1] = mn.y; rec.AABBMin[2] = mn.z;
+            rec.AABBMax[0] = mx.x; rec.AABBMax[1] = mx.y; rec.AABBMax[2] = mx.z;
+        }
+
+        //~ Layout
+        std::uint64_t cursor = AlignUp(sizeof(KFE_KFMESH_HEADER), KFMESH_PAYLOAD_ALIGNMENT);
+
+        header.MeshCount = static_cast<std::uint32_t>(meshRecords.size());
+        header.MeshTableOffset = cursor;
+        cursor = AlignUp(cursor + meshRecords.size() * sizeof(KFE_KFMESH_MESH_RECORD), KFMESH_PAYLOAD_ALIGNMENT);
+
+        header.NodeCount = static_cast<std::uint32_t>(nodeRecords.size());
+        header.NodeTableOffset = cursor;
+        cursor = AlignUp(cursor + nodeRecords.size() * sizeof(KFE_KFMESH_NODE_RECORD), KFMESH_PAYLOAD_ALIGNMENT);
+
+        header.NodeMeshIndexCount = static_cast<std::uint32_t>(nodeMeshIndices.size());
+        header.NodeMeshIndexOffset = cursor;
+        cursor = AlignUp(cursor + nodeMeshIndices.size() * sizeof(std::uint32_t), KFMESH_PAYLOAD_ALIGNMENT);
+
+        header.StringTableOffset = cursor;
+        header.StringTableSize = strings.size();
+        cursor = AlignUp(cursor + strings.size(), KFMESH_PAYLOAD_ALIGNMENT);
+
+        for (auto& rec : meshRecords)
+        {
+            rec.VertexOffset = cursor;
+            cursor = AlignUp(cursor + static_cast<std::uint64_t>(rec.VertexCount) * sizeof(KFEMeshVertex),
+                KFMESH_PAYLOAD_ALIGNMENT);
+
+            rec.IndexOffset = cursor;
+            cursor = AlignUp(cursor + static_cast<std::uint64_t>(rec.IndexCount) * sizeof(std::uint32_t),
+                KFMESH_PAYLOAD_ALIGNMENT);
+
+            rec.MeshletOffset = cursor;
+            cursor = AlignUp(cursor + static_cast<std::uint64_t>(rec.MeshletCount) * sizeof(KFE_MESHLET),
+                KFMESH_PAYLOAD_ALIGNMENT);
+
+            rec.LodOffset = cursor;
+            cursor = AlignUp(cursor + static_cast<std::uint64_t>(rec.LodCount) * sizeof(KFE_MESH_LOD),
+                KFMESH_PAYLOAD_ALIGNMENT);
+        }
+
+        header.FileSize = cursor;
+
+        //~ Write into a temp file then swap, so a crash never leaves a half written cook
+        const std::string cookedPath = GetCookedPath(sourcePath);
+        const std::string tempPath = cookedPath + ".tmp";
+
+        {
+            KFEFileSystem file{};
+            if (!file.OpenForWrite(tempPath))
+            {
+                LOG_ERROR("KFEMeshCooker: Failed to open '{}' for write", tempPath);
+                return false;
+            }
+
+            std::uint64_t written = 0u;
+            static constexpr std::uint8_t zeros[KFMESH_PAYLOAD_ALIGNMENT]{};
+
+            auto WriteAt = [&](std::uint64_t offset, const void* data, std::uint64_t bytes) -> bool
+                {
+                    while (written < offset)
+                    {
+                        const std::uint64_t pad = std::min<std::uint64_t>(offset - written, sizeof(zeros));
+                        if (!file.WriteBytes(zeros, static_cast<size_t>(pad)))
+                            return false;
+                        written += pad;
+                    }
+
+                    if (bytes == 0u)
+                        return true;
+
+                    if (!file.WriteBytes(data, static_cast<size_t>(bytes)))
+                        return false;
+
+                    written += bytes;
+                    return true;
+                };
+
+            bool ok = WriteAt(0u, &header, sizeof(header));
+            ok = ok && WriteAt(header.MeshTableOffset, meshRecords.data(),
+                meshRecords.size() * sizeof(KFE_KFMESH_MESH_RECORD));
+            ok = ok && WriteAt(header.NodeTableOffset, nodeRecords.data(),
+                nodeRecords.size() * sizeof(KFE_KFMESH_NODE_RECORD));
+            ok = ok && WriteAt(header.NodeMeshIndexOffset, nodeMeshIndices.data(),
+                nodeMeshIndices.size() * sizeof(std::uint32_t));
+            ok = ok && WriteAt(header.StringTableOffset, strings.data(), strings.size());
+
+            for (std::size_t i = 0; ok && i < meshes.size(); ++i)
+            {
+                const auto vertices = meshes[i]->GetVertices();
+                const auto indices = meshes[i]->GetIndices();
+                const auto meshlets = meshes[i]->GetMeshlets();
+                const auto lods = meshes[i]->GetLods();
+
+                ok = WriteAt(meshRecords[i].VertexOffset, vertices.data(), vertices.size_bytes());
+                ok = ok && WriteAt(meshRecords[i].IndexOffset, indices.data(), indices.size_bytes());
+                ok = ok && WriteAt(meshRecords[i].MeshletOffset, meshlets.data(), meshlets.size_bytes());
+                ok = ok && WriteAt(meshRecords[i].LodOffset, lods.data(), lods.size_bytes());
+            }
+
+            ok = ok && WriteAt(header.FileSize, nullptr, 0u);
+            file.Close();
+
+            if (!ok)
+            {
+                LOG_ERROR("KFEMeshCooker: Failed writing '{}'", tempPath);
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, cookedPath, ec);
+        if (ec)
+        {
+            LOG_WARNING("KFEMeshCooker: Failed to replace '{}': {}", cookedPath, ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        LOG_INFO("KFEMeshCooker: Cooked '{}' (meshes={}, nodes={}, bytes={})",
+            cookedPath, header.MeshCount, header.NodeCount, header.FileSize);
+
+        return true;
+    }
+}
@@ -0,0 +1,524 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mesh_lod.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/mesh_lod.h"
+#include "engine/render_manager/assets_library/model/geometry.h"
+#include "engine/render_manager/assets_library/model/mesh_optimizer.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace kfe
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        //~ Symmetric 4x4 plane quadric, weighted by triangle area
+        struct Quadric
+        {
+            double A2 = 0.0, B2 = 0.0, C2 = 0.0, D2 = 0.0;
+            double AB = 0.0, AC = 0.0, AD = 0.0;
+            double BC = 0.0, BD = 0.0, CD = 0.0;
+            double W  = 0.0;
+
+            void AddPlane(double a, double b, double c, double d, double weight) noexcept
+            {
+                A2 += a * a * weight; B2 += b * b * weight; C2 += c * c * weight; D2 += d * d * weight;
+                AB += a * b * weight; AC += a * c * weight; AD += a * d * weight;
+                BC += b * c * weight; BD += b * d * weight; CD += c * d * weight;
+                W  += weight;
+            }
+
+            void Add(const Quadric& q) noexcept
+            {
+                A2 += q.A2; B2 += q.B2; C2 += q.C2; D2 += q.D2;
+                AB += q.AB; AC += q.AC; AD += q.AD;
+                BC += q.BC; BD += q.BD; CD += q.CD;
+                W  += q.W;
+            }
+
+            //~ Area weighted sum of squared plane distances
+            double Evaluate(double x, double y, double z) const noexcept
+            {
+                const double r =
+                    A2 * x * x + B2 * y * y + C2 * z * z +
+                    2.0 * (AB * x * y + AC * x * z + BC * y * z) +
+                    2.0 * (AD * x + BD * y + CD * z) + D2;
+                return r > 0.0 ? r : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            double        Cost;
+            std::uint32_t From;
+            std::uint32_t To;
+        };
+
+        static std::uint64_t EdgeKey(std::uint32_t a, std::uint32_t b) noexcept
+        {
+            return a < b
+                ? (static_cast<std::uint64_t>(a) << 32) | b
+                : (static_cast<std::uint64_t>(b) << 32) | a;
+        }
+
+        static XMFLOAT3 TriangleNormal(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2) noexcept
+        {
+            const float e0x = p1.x - p0.x, e0y = p1.y - p0.y, e0z = p1.z - p0.z;
+            const float e1x = p2.x - p0.x, e1y = p2.y - p0.y, e1z = p2.z - p0.z;
+            return { e0y * e1z - e0z * e1y, e0z * e1x - e0x * e1z, e0x * e1y - e0y * e1x };
+        }
+
+        static float Dot3(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        //~ Vertices sharing a position with another vertex (UV/normal seams) and vertices
+        //~ on open or non manifold edges must not move, or the surface tears.
+        static void ClassifyLocked(std::span<const KFEMeshVertex> vertices,
+                                   std::span<const std::uint32_t> indices,
+                                   std::vector<bool>&             outLocked)
+        {
+            const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size());
+
+            std::vector<std::uint32_t> canonical(vertexCount);
+            std::vector<std::uint32_t> wedgeCount(vertexCount, 0u);
+
+            struct PositionKey
+            {
+                std::uint32_t X, Y, Z;
+                bool operator==(const PositionKey&) const noexcept = default;
+            };
+
+            struct PositionHash
+            {
+                std::size_t operator()(const PositionKey& k) const noexcept
+                {
+                    return (static_cast<std::size_t>(k.X) * 73856093u) ^
+                           (static_cast<std::size_t>(k.Y) * 19349663u) ^
+                           (static_cast<std::size_t>(k.Z) * 83492791u);
+                }
+            };
+
+            std::unordered_map<PositionKey, std::uint32_t, PositionHash> positions;
+            positions.reserve(vertexCount);
+
+            for (std::uint32_t v = 0; v < vertexCount; ++v)
+            {
+                PositionKey key{};
+                std::memcpy(&key.X, &vertices[v].Position.x, sizeof(float));
+                std::memcpy(&key.Y, &vertices[v].Position.y, sizeof(float));
+                std::memcpy(&key.Z, &vertices[v].Position.z, sizeof(float));
+
+                const auto [it, inserted] = positions.try_emplace(key, v);
+                canonical[v] = it->second;
+                ++wedgeCount[it->second];
+            }
+
+            outLocked.assign(vertexCount, false);
+
+            for (std::uint32_t v = 0; v < vertexCount; ++v)
+            {
+                if (wedgeCount[canonical[v]] > 1u)
+                    outLocked[v] = true;
+            }
+
+            std::unordered_map<std::uint64_t, std::uint32_t> edgeUse;
+            edgeUse.reserve(indices.size());
+
+            for (std::size_t i = 0; i + 2u < indices.size(); i += 3u)
+            {
+                for (std::uint32_t e = 0; e < 3u; ++e)
+                {
+                    const std::uint32_t a = canonical[indices[i + e]];
+                    const std::uint32_t b = canonical[indices[i + (e + 1u) % 3u]];
+                    ++edgeUse[EdgeKey(a, b)];
+                }
+            }
+
+            for (std::size_t i = 0; i + 2u < indices.size(); i += 3u)
+            {
+                for (std::uint32_t e = 0; e < 3u; ++e)
+                {
+                    const std::uint32_t va = indices[i + e];
+                    const std::uint32_t vb = indices[i + (e + 1u) % 3u];
+                    if (edgeUse[EdgeKey(canonical[va], canonical[vb])] != 2u)
+                    {
+                        outLocked[va] = true;
+                        outLocked[vb] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    bool KFEMeshSimplifier::Simplify(
+        std::span<const KFEMeshVertex> vertices,
+        std::span<const std::uint32_t> indices,
+        std::uint32_t targetIndexCount,
+        float targetError,
+        std::vector<std::uint32_t>& outIndices,
+        float* outError) noexcept
+    {
+        outIndices.clear();
+        if (outError)
+            *outError = 0.0f;
+
+        const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size());
+
+        if (vertexCount == 0u || indices.empty() || (indices.size() % 3u) != 0u)
+            return false;
+
+        for (const std::uint32_t v : indices)
+        {
+            if (v >= vertexCount)
+            {
+                LOG_ERROR("KFEMeshSimplifier::Simplify: index {} out of range (vertices={})", v, vertexCount);
+                return false;
+            }
+        }
+
+        try
+        {
+            outIndices.assign(indices.begin(), indices.end());
+
+            if (outIndices.size() <= targetIndexCount)
+                return true;
+
+            //~ Error is measured against the mesh extent so one threshold fits every asset
+            XMFLOAT3 mn{ 1e30f, 1e30f, 1e30f };
+            XMFLOAT3 mx{ -1e30f, -1e30f, -1e30f };
+            for (const std::uint32_t v : indices)
+            {
+                const XMFLOAT3& p = vertices[v].Position;
+                mn = { (std::min)(mn.x, p.x), (std::min)(mn.y, p.y), (std::min)(mn.z, p.z) };
+                mx = { (std::max)(mx.x, p.x), (std::max)(mx.y, p.y), (std::max)(mx.z, p.z) };
+            }
+
+            const double extent = std::sqrt(
+                static_cast<double>(mx.x - mn.x) * (mx.x - mn.x) +
+                static_cast<double>(mx.y - mn.y) * (mx.y - mn.y) +
+                static_cast<double>(mx.z - mn.z) * (mx.z - mn.z));
+
+            if (extent <= 0.0)
+                return true;
+
+            const double maxCost = (static_cast<double>(targetError) * extent) *
+                                   (static_cast<double>(targetError) * extent);
+
+            std::vector<bool> locked;
+            ClassifyLocked(vertices, indices, locked);
+
+            std::vector<Quadric> quadrics(vertexCount);
+            for (std::size_t i = 0; i < outIndices.size(); i += 3u)
+            {
+                const XMFLOAT3& p0 = vertices[outIndices[i + 0u]].Position;
+                const XMFLOAT3& p1 = vertices[outIndices[i + 1u]].Position;
+                const XMFLOAT3& p2 = vertices[outIndices[i + 2u]].Position;
+                const XMFLOAT3 n = TriangleNormal(p0, p1, p2);
+
+                const double len = std::sqrt(static_cast<double>(Dot3(n, n)));
+                if (len <= 0.0)
+                    continue;
+
+                const double a = n.x / len, b = n.y / len, c = n.z / len;
+                const double d = -(a * p0.x + b * p0.y + c * p0.z);
+                const double area = len * 0.5;
+
+                for (std::uint32_t k = 0; k < 3u; ++k)
+                    quadrics[outIndices[i + k]].AddPlane(a, b, c, d, area);
+            }
+
+            auto CollapseCost = [&](std::uint32_t from, std::uint32_t to) -> double
+                {
+                    Quadric q = quadrics[from];
+                    q.Add(quadrics[to]);
+                    if (q.W <= 0.0)
+                        return 0.0;
+
+                    const XMFLOAT3& p = vertices[to].Position;
+                    return q.Evaluate(p.x, p.y, p.z) / q.W;
+                };
+
+            std::vector<Collapse>      collapses;
+            std::vector<std::uint64_t> edges;
+            std::vector<std::uint32_t> remap(vertexCount);
+            std::vector<bool>          touched(vertexCount);
+            std::vector<std::uint32_t> adjOffsets(vertexCount + 1u);
+            std::vector<std::uint32_t> adjacency;
+
+            double resultCost = 0.0;
+
+            while (outIndices.size() > targetIndexCount)
+            {
+                const std::uint32_t triCount = static_cast<std::uint32_t>(outIndices.size() / 3u);
+
+                //~ Unique edges of the current triangle set
+                edges.clear();
+                for (std::size_t i = 0; i < outIndices.size(); i += 3u)
+                {
+                    for (std::uint32_t e = 0; e < 3u; ++e)
+                        edges.push_back(EdgeKey(outIndices[i + e], outIndices[i + (e + 1u) % 3u]));
+                }
+                std::sort(edges.begin(), edges.end());
+                edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+                collapses.clear();
+                for (const std::uint64_t key : edges)
+                {
+                    const std::uint32_t a = static_cast<std::uint32_t>(key >> 32);
+                    const std::uint32_t b = static_cast<std::uint32_t>(key & 0xFFFFFFFFu);
+
+                    const double costAB = locked[a] ? -1.0 : CollapseCost(a, b);
+                    const double costBA = locked[b] ? -1.0 : CollapseCost(b, a);
+
+                    if (costAB >= 0.0 && (costBA < 0.0 || costAB <= costBA))
+                        collapses.push_back({ costAB, a, b });
+                    else if (costBA >= 0.0)
+                        collapses.push_back({ costBA, b, a });
+                }
+
+                if (collapses.empty())
+                    break;
+
+                std::sort(collapses.begin(), collapses.end(),
+                    [](const Collapse& l, const Collapse& r) { return l.Cost < r.Cost; });
+
+                //~ Vertex -> triangle adjacency for the flip test
+                std::fill(adjOffsets.begin(), adjOffsets.end(), 0u);
+                for (const std::uint32_t v : outIndices)
+                    ++adjOffsets[v + 1u];
+                for (std::uint32_t v = 0; v < vertexCount; ++v)
+                    adjOffsets[v + 1u] += adjOffsets[v];
+
+                adjacency.resize(outIndices.size());
+                {
+                    std::vector<std::uint32_t> cursor(adjOffsets.begin(), adjOffsets.end() - 1);
+                    for (std::uint32_t t = 0; t < triCount; ++t)
+                        for (std::uint32_t k = 0; k < 3u; ++k)
+                            adjacency[cursor[outIndices[t * 3u + k]]++] = t;
+                }
+
+                for (std::uint32_t v = 0; v < vertexCount; ++v)
+                    remap[v] = v;
+                std::fill(touched.begin(), touched.end(), false);
+
+                const std::uint32_t targetTris = targetIndexCount / 3u;
+                std::uint32_t removedTris = 0u;
+                std::uint32_t applied = 0u;
+
+                for (const Collapse& c : collapses)
+                {
+                    if (c.Cost > maxCost || triCount - removedTris <= targetTris)
+                        break;
+
+                    if (touched[c.From] || touched[c.To])
+                        continue;
+
+                    //~ Reject collapses that flip a surviving triangle
+                    bool flips = false;
+                    std::uint32_t dying = 0u;
+
+                    for (std::uint32_t a = adjOffsets[c.From]; a < adjOffsets[c.From + 1u] && !flips; ++a)
+                    {
+                        const std::uint32_t t = adjacency[a];
+                        const std::uint32_t* tri = &outIndices[t * 3u];
+
+                        if (tri[0] == c.To || tri[1] == c.To || tri[2] == c.To)
+                        {
+                            ++dying;
+                            continue;
+                        }
+
+                        XMFLOAT3 before[3];
+                        XMFLOAT3 after[3];
+                        for (std::uint32_t k = 0; k < 3u; ++k)
+                        {
+                            before[k] = vertices[tri[k]].Position;
+                            after[k] = tri[k] == c.From ? vertices[c.To].Position : before[k];
+                        }
+
+                        const XMFLOAT3 n0 = TriangleNormal(before[0], before[1], before[2]);
+                        const XMFLOAT3 n1 = TriangleNormal(after[0], after[1], after[2]);
+
+                        if (Dot3(n0, n1) <= 0.0f)
+                            flips = true;
+                    }
+
+                    if (flips)
+                        continue;
+
+                    remap[c.From] = c.To;
+                    quadrics[c.To].Add(quadrics[c.From]);
+
+                    //~ Freeze the one ring so later flip tests this pass see final positions
+                    for (std::uint32_t a = adjOffsets[c.From]; a < adjOffsets[c.From + 1u]; ++a)
+                    {
+                        const std::uint32_t t = adjacency[a];
+                        for (std::uint32_t k = 0; k < 3u; ++k)
+                            touched[outIndices[t * 3u + k]] = true;
+                    }
+
+                    resultCost = (std::max)(resultCost, c.Cost);
+                    removedTris += dying;
+                    ++applied;
+                }
+
+                if (applied == 0u)
+                    break;
+
+                std::size_t write = 0u;
+                for (std::size_t i = 0; i < outIndices.size(); i += 3u)
+                {
+                    const std::uint32_t a = remap[outIndices[i + 0u]];
+                    const std::uint32_t b = remap[outIndices[i + 1u]];
+                    const std::uint32_t c = remap[outIndices[i + 2u]];
+
+                    if (a == b || b == c || a == c)
+                        continue;
+
+                    outIndices[write + 0u] = a;
+                    outIndices[write + 1u] = b;
+                    outIndices[write + 2u] = c;
+                    write += 3u;
+                }
+                outIndices.resize(write);
+            }
+
+            if (outError)
+                *outError = static_cast<float>(std::sqrt(resultCost) / extent);
+        }
+        catch (const std::bad_alloc&)
+        {
+            LOG_ERROR("KFEMeshSimplifier::Simplify: Out of memory");
+            outIndices.clear();
+            return false;
+        }
+
+        return !outIndices.empty();
+    }
+
+    bool KFEMeshSimplifier::BuildLodChain(
+        std::span<const KFEMeshVertex> vertices,
+        std::vector<std::uint32_t>& indices,
+        const KFE_MESH_LOD_DESC& desc,
+        std::vector<KFE_MESH_LOD>& outLods) noexcept
+    {
+        outLods.clear();
+
+        if (vertices.empty() || indices.empty() || (indices.size() % 3u) != 0u)
+            return false;
+
+        try
+        {
+            const std::uint32_t baseCount = static_cast<std::uint32_t>(indices.size());
+            outLods.push_back({ 0u, baseCount, 0.0f, 0u });
+
+            //~ Every level starts from LOD0 so its error is measured against the real surface
+            const std::vector<std::uint32_t> base(indices.begin(), indices.end());
+            std::vector<std::uint32_t> level;
+
+            std::uint32_t previousCount = baseCount;
+            float previousError = 0.0f;
+
+            for (std::uint32_t l = 1u; l < desc.LodCount; ++l)
+            {
+                const std::uint32_t targetTris = static_cast<std::uint32_t>(
+                    static_cast<float>(previousCount / 3u) * desc.Reduction);
+
+                if (targetTris < desc.MinTriangles)
+                    break;
+
+                float error = 0.0f;
+                if (!Simplify(vertices, base, targetTris * 3u, desc.MaxError, level, &error))
+                    break;
+
+                //~ Locked borders/seams or the error budget stopped it, further levels would repeat
+                if (level.size() * 20u >= static_cast<std::size_t>(previousCount) * 19u)
+                    break;
+
+                KFEMeshOptimizer::OptimizeVertexCache(level, static_cast<std::uint32_t>(vertices.size()), desc.CacheSize);
+
+                KFE_MESH_LOD lod{};
+                lod.IndexOffset = static_cast<std::uint32_t>(indices.size());
+                lod.IndexCount = static_cast<std::uint32_t>(level.size());
+                lod.Error = (std::max)(error, previousError);
+
+                indices.insert(indices.end(), level.begin(), level.end());
+                outLods.push_back(lod);
+
+                previousCount = lod.IndexCount;
+                previousError = lod.Error;
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+            LOG_ERROR("KFEMeshSimplifier::BuildLodChain: Out of memory");
+            if (!outLods.empty())
+                indices.resize(outLods.front().IndexCount);
+            outLods.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    std::uint32_t KFEMeshSimplifier::SelectLod(
+        std::span<const KFE_MESH_LOD> lods,
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax,
+        const XMMATRIX& world,
+        const KFE_MESH_LOD_SELECT_DESC& desc) noexcept
+    {
+        if (lods.size() <= 1u)
+            return 0u;
+
+        const XMVECTOR localMin = XMLoadFloat3(&aabbMin);
+        const XMVECTOR localMax = XMLoadFloat3(&aabbMax);
+
+        const XMVECTOR center = XMVector3TransformCoord(XMVectorScale(XMVectorAdd(localMin, localMax), 0.5f), world);
+
+        //~ Largest axis scale keeps the bounding sphere conservative under non uniform scale
+        const float scale = (std::max)({
+            XMVectorGetX(XMVector3Length(world.r[0])),
+            XMVectorGetX(XMVector3Length(world.r[1])),
+            XMVectorGetX(XMVector3Length(world.r[2])) });
+
+        const float diagonal = XMVectorGetX(XMVector3Length(XMVectorSubtract(localMax, localMin))) * scale;
+        const float radius = diagonal * 0.5f;
+
+        const float distance = XMVectorGetX(XMVector3Length(
+            XMVectorSubtract(center, XMLoadFloat3(&desc.CameraPosition))));
+
+        const float tanHalfFov = std::tan(desc.FovY * 0.5f);
+        if (distance <= radius || tanHalfFov <= 0.0f || diagonal <= 0.0f)
+            return 0u;
+
+        //~ Projected diameter of the bounding sphere in pixels
+        const float diameterPixels = (diagonal / (distance * tanHalfFov)) * desc.ViewportHeight * 0.5f;
+
+        std::uint32_t selected = 0u;
+        for (std::uint32_t l = 1u; l < lods.size(); ++l)
+        {
+            if (lods[l].Error * diameterPixels > desc.MaxPixelError)
+                break;
+            selected = l;
+        }
+
+        return selected;
+    }
+}
@@ -0,0 +1,436 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mesh_optimizer.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/mesh_optimizer.h"
+#include "engine/utils/logger.h"
+
+#include <cmath>
+#include <numeric>
+
+namespace kfe
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        inline constexpr std::uint32_t kInvalidVertex = 0xFFFFFFFFu;
+
+        static std::uint32_t CountCacheMisses(
+            std::span<const std::uint32_t> indices,
+            std::uint32_t vertexCount,
+            std::uint32_t cacheSize)
+        {
+            //~ A vertex is resident while fewer than cacheSize misses happened since it was loaded
+            std::vector<std::uint32_t> loadedAt(vertexCount, kInvalidVertex);
+            std::uint32_t misses = 0u;
+
+            for (const std::uint32_t v : indices)
+            {
+                if (v >= vertexCount)
+                    continue;
+
+                if (loadedAt[v] == kInvalidVertex || misses - loadedAt[v] >= cacheSize)
+                {
+                    loadedAt[v] = misses;
+                    ++misses;
+                }
+            }
+
+            return misses;
+        }
+
+        struct TriangleAdjacency
+        {
+            std::vector<std::uint32_t> Offsets;   //~ vertexCount + 1
+            std::vector<std::uint32_t> Triangles; //~ triangles per vertex
+            std::vector<std::uint32_t> Live;      //~ not yet emitted triangles per vertex
+        };
+
+        static void BuildAdjacency(
+            std::span<const std::uint32_t> indices,
+            std::uint32_t vertexCount,
+            TriangleAdjacency& adj)
+        {
+            adj.Offsets.assign(vertexCount + 1u, 0u);
+            adj.Live.assign(vertexCount, 0u);
+
+            for (const std::uint32_t v : indices)
+                ++adj.Live[v];
+
+            for (std::uint32_t v = 0; v < vertexCount; ++v)
+                adj.Offsets[v + 1u] = adj.Offsets[v] + adj.Live[v];
+
+            adj.Triangles.resize(indices.size());
+
+            std::vector<std::uint32_t> cursor(adj.Offsets.begin(), adj.Offsets.end() - 1);
+            const std::uint32_t triCount = static_cast<std::uint32_t>(indices.size() / 3u);
+
+            for (std::uint32_t t = 0; t < triCount; ++t)
+            {
+                for (std::uint32_t c = 0; c < 3u; ++c)
+                    adj.Triangles[cursor[indices[t * 3u + c]]++] = t;
+            }
+        }
+
+        static float Dot3(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+    }
+
+    float KFEMeshOptimizer::ComputeACMR(
+        std::span<const std::uint32_t> indices,
+        std::uint32_t vertexCount,
+        std::uint32_t cacheSize) noexcept
+    {
+        const std::size_t triCount = indices.size() / 3u;
+        if (triCount == 0u || cacheSize == 0u)
+            return 0.0f;
+
+        return static_cast<float>(CountCacheMisses(indices, vertexCount, cacheSize)) /
+            static_cast<float>(triCount);
+    }
+
+    float KFEMeshOptimizer::ComputeATVR(
+        std::span<const std::uint32_t> indices,
+        std::uint32_t vertexCount,
+        std::uint32_t cacheSize) noexcept
+    {
+        if (vertexCount == 0u || cacheSize == 0u)
+            return 0.0f;
+
+        std::vector<bool> used(vertexCount, false);
+        std::uint32_t unique = 0u;
+        for (const std::uint32_t v : indices)
+        {
+            if (v < vertexCount && !used[v])
+            {
+                used[v] = true;
+                ++unique;
+            }
+        }
+
+        if (unique == 0u)
+            return 0.0f;
+
+        return static_cast<float>(CountCacheMisses(indices, vertexCount, cacheSize)) /
+            static_cast<float>(unique);
+    }
+
+    void KFEMeshOptimizer::OptimizeVertexCache(
+        std::span<std::uint32_t> indices,
+        std::uint32_t vertexCount,
+        std::uint32_t cacheSize,
+        std::vector<std::uint32_t>* outClusters)
+    {
+        if (outClusters)
+            outClusters->clear();
+
+        const std::uint32_t triCount = static_cast<std::uint32_t>(indices.size() / 3u);
+        if (triCount == 0u || vertexCount == 0u)
+            return;
+
+        TriangleAdjacency adj{};
+        BuildAdjacency(indices, vertexCount, adj);
+
+        std::vector<std::uint32_t> cacheTime(vertexCount, 0u);
+        std::vector<bool>          emitted(triCount, false);
+        std::vector<std::uint32_t> deadEnd;
+        std::vector<std::uint32_t> candidates;
+        std::vector<std::uint32_t> output;
+
+        deadEnd.reserve(indices.size());
+        output.reserve(indices.size());
+
+        std::uint32_t timestamp = cacheSize + 1u;
+        std::uint32_t scan = 0u;
+
+        auto SkipDeadEnd = [&]() -> std::uint32_t
+            {
+                while (!deadEnd.empty())
+                {
+                    const std::uint32_t d = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (adj.Live[d] > 0u)
+                        return d;
+                }
+
+                while (scan < vertexCount)
+                {
+                    if (adj.Live[scan] > 0u)
+                        return scan;
+                    ++scan;
+                }
+
+                return kInvalidVertex;
+            };
+
+        std::uint32_t fan = SkipDeadEnd();
+        bool newCluster = true;
+
+        while (fan != kInvalidVertex)
+        {
+            candidates.clear();
+
+            for (std::uint32_t a = adj.Offsets[fan]; a < adj.Offsets[fan + 1u]; ++a)
+            {
+                const std::uint32_t t = adj.Triangles[a];
+                if (emitted[t])
+                    continue;
+
+                if (newCluster)
+                {
+                    if (outClusters)
+                        outClusters->push_back(static_cast<std::uint32_t>(output.size() / 3u));
+                    newCluster = false;
+                }
+
+                for (std::uint32_t c = 0; c < 3u; ++c)
+                {
+                    const std::uint32_t v = indices[t * 3u + c];
+                    output.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    --adj.Live[v];
+
+                    if (timestamp - cacheTime[v] > cacheSize)
+                        cacheTime[v] = timestamp++;
+                }
+
+                emitted[t] = true;
+            }
+
+            //~ Next fan: the oldest candidate that will still be in cache after its fan is emitted
+            std::uint32_t next = kInvalidVertex;
+            int bestPriority = -1;
+
+            for (const std::uint32_t v : candidates)
+            {
+                if (adj.Live[v] == 0u)
+                    continue;
+
+                int priority = 0;
+                if (timestamp - cacheTime[v] + 2u * adj.Live[v] <= cacheSize)
+                    priority = static_cast<int>(timestamp - cacheTime[v]);
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            if (next == kInvalidVertex)
+            {
+                next = SkipDeadEnd();
+                newCluster = true;
+            }
+
+            fan = next;
+        }
+
+        std::copy(output.begin(), output.end(), indices.begin());
+    }
+
+    bool KFEMeshOptimizer::OptimizeOverdraw(
+        std::span<std::uint32_t> indices,
+        std::span<const KFEMeshVertex> vertices,
+        std::span<const std::uint32_t> clusters,
+        std::uint32_t cacheSize,
+        float threshold)
+    {
+        const std::uint32_t triCount = static_cast<std::uint32_t>(indices.size() / 3u);
+        const std::uint32_t clusterCount = static_cast<std::uint32_t>(clusters.size());
+
+        if (triCount == 0u || clusterCount < 2u)
+            return false;
+
+        struct ClusterInfo
+        {
+            std::uint32_t First = 0u;
+            std::uint32_t Count = 0u;
+            XMFLOAT3      Centroid{ 0.0f, 0.0f, 0.0f };
+            XMFLOAT3      Normal{ 0.0f, 0.0f, 0.0f };
+            float         Area = 0.0f;
+            float         Sort = 0.0f;
+        };
+
+        std::vector<ClusterInfo> infos(clusterCount);
+
+        XMFLOAT3 meshCentroid{ 0.0f, 0.0f, 0.0f };
+        float    meshArea = 0.0f;
+
+        for (std::uint32_t c = 0; c < clusterCount; ++c)
+        {
+            ClusterInfo& info = infos[c];
+            info.First = clusters[c];
+            info.Count = (c + 1u < clusterCount ? clusters[c + 1u] : triCount) - info.First;
+
+            for (std::uint32_t t = info.First; t < info.First + info.Count; ++t)
+            {
+                const XMFLOAT3& p0 = vertices[indices[t * 3u + 0u]].Position;
+                const XMFLOAT3& p1 = vertices[indices[t * 3u + 1u]].Position;
+                const XMFLOAT3& p2 = vertices[indices[t * 3u + 2u]].Position;
+
+                const XMFLOAT3 e0{ p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+                const XMFLOAT3 e1{ p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+                const XMFLOAT3 n{ e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+
+                const float area = std::sqrt(Dot3(n, n)) * 0.5f;
+
+                info.Normal.x += n.x; info.Normal.y += n.y; info.Normal.z += n.z;
+                info.Centroid.x += (p0.x + p1.x + p2.x) * (area / 3.0f);
+                info.Centroid.y += (p0.y + p1.y + p2.y) * (area / 3.0f);
+                info.Centroid.z += (p0.z + p1.z + p2.z) * (area / 3.0f);
+                info.Area += area;
+            }
+
+            meshCentroid.x += info.Centroid.x;
+            meshCentroid.y += info.Centroid.y;
+            meshCentroid.z += info.Centroid.z;
+            meshArea += info.Area;
+
+            if (info.Area > 0.0f)
+            {
+                info.Centroid.x /= info.Area;
+                info.Centroid.y /= info.Area;
+                info.Centroid.z /= info.Area;
+            }
+        }
+
+        if (meshArea <= 0.0f)
+            return false;
+
+        meshCentroid.x /= meshArea;
+        meshCentroid.y /= meshArea;
+        meshCentroid.z /= meshArea;
+
+        //~ Clusters facing away from the centre are likely occluders, draw them first
+        for (ClusterInfo& info : infos)
+        {
+            const float len = std::sqrt(Dot3(info.Normal, info.Normal));
+            const XMFLOAT3 d{ info.Centroid.x - meshCentroid.x, info.Centroid.y - meshCentroid.y, info.Centroid.z - meshCentroid.z };
+            info.Sort = len > 0.0f ? Dot3(d, info.Normal) / len : 0.0f;
+        }
+
+        std::vector<std::uint32_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b)
+            {
+                return infos[a].Sort > infos[b].Sort;
+            });
+
+        std::vector<std::uint32_t> sorted;
+        sorted.reserve(indices.size());
+
+        for (const std::uint32_t c : order)
+        {
+            const ClusterInfo& info = infos[c];
+            sorted.insert(sorted.end(),
+                indices.begin() + info.First * 3u,
+                indices.begin() + (info.First + info.Count) * 3u);
+        }
+
+        const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size());
+        const float acmrCurrent = ComputeACMR(indices, vertexCount, cacheSize);
+        const float acmrSorted = ComputeACMR(sorted, vertexCount, cacheSize);
+
+        if (acmrSorted > acmrCurrent * threshold)
+            return false;
+
+        std::copy(sorted.begin(), sorted.end(), indices.begin());
+        return true;
+    }
+
+    std::uint32_t KFEMeshOptimizer::OptimizeVertexFetch(
+        std::vector<KFEMeshVertex>& vertices,
+        std::span<std::uint32_t> indices)
+    {
+        const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size());
+
+        std::vector<std::uint32_t> remap(vertexCount, kInvalidVertex);
+        std::vector<KFEMeshVertex> reordered;
+        reordered.reserve(vertexCount);
+
+        for (std::uint32_t& index : indices)
+        {
+            std::uint32_t& newIndex = remap[index];
+            if (newIndex == kInvalidVertex)
+            {
+                newIndex = static_cast<std::uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+
+            index = newIndex;
+        }
+
+        const std::uint32_t removed = vertexCount - static_cast<std::uint32_t>(reordered.size());
+        vertices = std::move(reordered);
+        return removed;
+    }
+
+    bool KFEMeshOptimizer::Optimize(
+        std::vector<KFEMeshVertex>& vertices,
+        std::vector<std::uint32_t>& indices,
+        const KFE_MESH_OPTIMIZE_DESC& desc,
+        KFE_MESH_OPTIMIZE_STATS* outStats) noexcept
+    {
+        if (vertices.empty() || indices.empty() || (indices.size() % 3u) != 0u || desc.CacheSize == 0u)
+            return false;
+
+        const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size());
+
+        for (const std::uint32_t v : indices)
+        {
+            if (v >= vertexCount)
+            {
+                LOG_ERROR("KFEMeshOptimizer::Optimize: index {} out of range (vertices={})", v, vertexCount);
+                return false;
+            }
+        }
+
+        KFE_MESH_OPTIMIZE_STATS stats{};
+
+        try
+        {
+            stats.ACMRBefore = ComputeACMR(indices, vertexCount, desc.CacheSize);
+            stats.ATVRBefore = ComputeATVR(indices, vertexCount, desc.CacheSize);
+
+            std::vector<std::uint32_t> clusters;
+            OptimizeVertexCache(indices, vertexCount, desc.CacheSize, &clusters);
+            stats.ClusterCount = static_cast<std::uint32_t>(clusters.size());
+
+            if (desc.OptimizeOverdraw)
+            {
+                stats.OverdrawApplied = OptimizeOverdraw(
+                    indices, vertices, clusters, desc.CacheSize, desc.OverdrawThreshold);
+            }
+
+            if (desc.OptimizeFetch)
+                stats.UnreferencedRemoved = OptimizeVertexFetch(vertices, indices);
+
+            const std::uint32_t finalCount = static_cast<std::uint32_t>(vertices.size());
+            stats.ACMRAfter = ComputeACMR(indices, finalCount, desc.CacheSize);
+            stats.ATVRAfter = ComputeATVR(indices, finalCount, desc.CacheSize);
+        }
+        catch (const std::bad_alloc&)
+        {
+            LOG_ERROR("KFEMeshOptimizer::Optimize: Out of memory");
+            return false;
+        }
+
+        if (outStats)
+            *outStats = stats;
+
+        return true;
+    }
+}
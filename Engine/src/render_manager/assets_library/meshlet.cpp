@@ -0,0 +1,460 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : meshlet.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/meshlet.h"
+#include "engine/render_manager/assets_library/model/geometry.h"
+#include "engine/utils/logger.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace kfe
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        inline constexpr std::uint32_t kInvalid = 0xFFFFFFFFu;
+
+        //~ Below this the cone is wider than ~84 degrees and almost never culls
+        inline constexpr float kMinConeDot = 0.1f;
+
+        static float Dot3(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        static XMFLOAT3 Sub3(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+        {
+            return { a.x - b.x, a.y - b.y, a.z - b.z };
+        }
+
+        static float Length3(const XMFLOAT3& v) noexcept
+        {
+            return std::sqrt(Dot3(v, v));
+        }
+
+        static XMFLOAT3 NormalizeOr(const XMFLOAT3& v, const XMFLOAT3& fallback) noexcept
+        {
+            const float len = Length3(v);
+            if (len <= 1e-20f)
+                return fallback;
+            return { v.x / len, v.y / len, v.z / len };
+        }
+
+        //~ Ritter's bounding sphere
+        static void ComputeSphere(std::span<const XMFLOAT3> points, XMFLOAT3& outCenter, float& outRadius) noexcept
+        {
+            if (points.empty())
+            {
+                outCenter = { 0.0f, 0.0f, 0.0f };
+                outRadius = 0.0f;
+                return;
+            }
+
+            auto Farthest = [&](const XMFLOAT3& from) -> const XMFLOAT3&
+                {
+                    std::size_t best = 0u;
+                    float bestDist = -1.0f;
+                    for (std::size_t i = 0; i < points.size(); ++i)
+                    {
+                        const XMFLOAT3 d = Sub3(points[i], from);
+                        const float dist = Dot3(d, d);
+                        if (dist > bestDist)
+                        {
+                            bestDist = dist;
+                            best = i;
+                        }
+                    }
+                    return points[best];
+                };
+
+            const XMFLOAT3& a = Farthest(points[0]);
+            const XMFLOAT3& b = Farthest(a);
+
+            XMFLOAT3 center{ (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f };
+            float radius = Length3(Sub3(a, b)) * 0.5f;
+
+            for (const XMFLOAT3& p : points)
+            {
+                const XMFLOAT3 d = Sub3(p, center);
+                const float dist = Length3(d);
+                if (dist > radius)
+                {
+                    const float newRadius = (radius + dist) * 0.5f;
+                    const float k = (newRadius - radius) / dist;
+                    center = { center.x + d.x * k, center.y + d.y * k, center.z + d.z * k };
+                    radius = newRadius;
+                }
+            }
+
+            outCenter = center;
+            outRadius = radius;
+        }
+    }
+
+    bool KFEMeshletBuilder::Build(
+        std::span<const KFEMeshVertex> vertices,
+        std::vector<std::uint32_t>& indices,
+        const KFE_MESHLET_BUILD_DESC& desc,
+        std::vector<KFE_MESHLET>& outMeshlets,
+        KFE_MESHLET_BUILD_STATS* outStats) noexcept
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        outMeshlets.clear();
+
+        const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size());
+        const std::uint32_t triCount = static_cast<std::uint32_t>(indices.size() / 3u);
+
+        if (vertexCount == 0u || triCount == 0u || (indices.size() % 3u) != 0u ||
+            desc.MaxVertices < 3u || desc.MaxTriangles == 0u)
+        {
+            return false;
+        }
+
+        for (const std::uint32_t v : indices)
+        {
+            if (v >= vertexCount)
+            {
+                LOG_ERROR("KFEMeshletBuilder::Build: index {} out of range (vertices={})", v, vertexCount);
+                return false;
+            }
+        }
+
+        KFE_MESHLET_BUILD_STATS stats{};
+
+        try
+        {
+            //~ Vertex -> triangle adjacency
+            std::vector<std::uint32_t> offsets(vertexCount + 1u, 0u);
+            for (const std::uint32_t v : indices)
+                ++offsets[v + 1u];
+            for (std::uint32_t v = 0; v < vertexCount; ++v)
+                offsets[v + 1u] += offsets[v];
+
+            std::vector<std::uint32_t> adjacency(indices.size());
+            {
+                std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (std::uint32_t t = 0; t < triCount; ++t)
+                    for (std::uint32_t c = 0; c < 3u; ++c)
+                        adjacency[cursor[indices[t * 3u + c]]++] = t;
+            }
+
+            //~ Unit face normals, zero for degenerate triangles
+            std::vector<XMFLOAT3> faceNormals(triCount);
+            for (std::uint32_t t = 0; t < triCount; ++t)
+            {
+                const XMFLOAT3& p0 = vertices[indices[t * 3u + 0u]].Position;
+                const XMFLOAT3& p1 = vertices[indices[t * 3u + 1u]].Position;
+                const XMFLOAT3& p2 = vertices[indices[t * 3u + 2u]].Position;
+                const XMFLOAT3 e0 = Sub3(p1, p0);
+                const XMFLOAT3 e1 = Sub3(p2, p0);
+                const XMFLOAT3 n{ e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+                faceNormals[t] = NormalizeOr(n, { 0.0f, 0.0f, 0.0f });
+            }
+
+            std::vector<bool>          used(triCount, false);
+            std::vector<std::uint32_t> vertexStamp(vertexCount, kInvalid);
+            std::vector<std::uint32_t> candidateStamp(triCount, kInvalid);
+            std::vector<std::uint32_t> candidates;
+            std::vector<std::uint32_t> meshletVertices;
+            std::vector<std::uint32_t> meshletTriangles;
+            std::vector<XMFLOAT3>      points;
+            std::vector<std::uint32_t> output;
+
+            output.reserve(indices.size());
+            meshletVertices.reserve(desc.MaxVertices);
+            meshletTriangles.reserve(desc.MaxTriangles);
+
+            std::uint32_t seedCursor = 0u;
+            std::uint32_t emitted = 0u;
+
+            while (emitted < triCount)
+            {
+                while (used[seedCursor])
+                    ++seedCursor;
+
+                const std::uint32_t meshletId = static_cast<std::uint32_t>(outMeshlets.size());
+
+                meshletVertices.clear();
+                meshletTriangles.clear();
+                candidates.clear();
+
+                XMFLOAT3 normalSum{ 0.0f, 0.0f, 0.0f };
+
+                auto AddTriangle = [&](std::uint32_t t)
+                    {
+                        used[t] = true;
+                        ++emitted;
+                        meshletTriangles.push_back(t);
+
+                        normalSum.x += faceNormals[t].x;
+                        normalSum.y += faceNormals[t].y;
+                        normalSum.z += faceNormals[t].z;
+
+                        for (std::uint32_t c = 0; c < 3u; ++c)
+                        {
+                            const std::uint32_t v = indices[t * 3u + c];
+                            if (vertexStamp[v] == meshletId)
+                                continue;
+
+                            vertexStamp[v] = meshletId;
+                            meshletVertices.push_back(v);
+
+                            for (std::uint32_t a = offsets[v]; a < offsets[v + 1u]; ++a)
+                            {
+                                const std::uint32_t n = adjacency[a];
+                                if (!used[n] && candidateStamp[n] != meshletId)
+                                {
+                                    candidateStamp[n] = meshletId;
+                                    candidates.push_back(n);
+                                }
+                            }
+                        }
+                    };
+
+                AddTriangle(seedCursor);
+
+                while (meshletTriangles.size() < desc.MaxTriangles)
+                {
+                    const XMFLOAT3 axis = NormalizeOr(normalSum, { 0.0f, 0.0f, 0.0f });
+
+                    std::size_t bestSlot = kInvalid;
+                    float       bestScore = 0.0f;
+
+                    for (std::size_t i = 0; i < candidates.size();)
+                    {
+                        const std::uint32_t t = candidates[i];
+                        if (used[t])
+                        {
+                            candidates[i] = candidates.back();
+                            candidates.pop_back();
+                            continue;
+                        }
+
+                        std::uint32_t newVertices = 0u;
+                        for (std::uint32_t c = 0; c < 3u; ++c)
+                        {
+                            if (vertexStamp[indices[t * 3u + c]] != meshletId)
+                                ++newVertices;
+                        }
+
+                        if (meshletVertices.size() + newVertices <= desc.MaxVertices)
+                        {
+                            const float score = static_cast<float>(newVertices) +
+                                desc.ConeWeight * (1.0f - Dot3(faceNormals[t], axis));
+
+                            if (bestSlot == kInvalid || score < bestScore)
+                            {
+                                bestSlot = i;
+                                bestScore = score;
+                            }
+                        }
+
+                        ++i;
+                    }
+
+                    if (bestSlot == kInvalid)
+                        break;
+
+                    const std::uint32_t best = candidates[bestSlot];
+                    candidates[bestSlot] = candidates.back();
+                    candidates.pop_back();
+
+                    AddTriangle(best);
+                }
+
+                //~ Emit triangles and bounds
+                KFE_MESHLET meshlet{};
+                meshlet.IndexOffset = static_cast<std::uint32_t>(output.size());
+                meshlet.TriangleCount = static_cast<std::uint32_t>(meshletTriangles.size());
+                meshlet.VertexCount = static_cast<std::uint32_t>(meshletVertices.size());
+
+                for (const std::uint32_t t : meshletTriangles)
+                {
+                    output.push_back(indices[t * 3u + 0u]);
+                    output.push_back(indices[t * 3u + 1u]);
+                    output.push_back(indices[t * 3u + 2u]);
+                }
+
+                points.clear();
+                for (const std::uint32_t v : meshletVertices)
+                    points.push_back(vertices[v].Position);
+
+                ComputeSphere(points, meshlet.Center, meshlet.Radius);
+
+                meshlet.ConeAxis = NormalizeOr(normalSum, { 0.0f, 0.0f, 1.0f });
+
+                float minDot = 1.0f;
+                for (const std::uint32_t t : meshletTriangles)
+                {
+                    if (Dot3(faceNormals[t], faceNormals[t]) > 0.0f)
+                        minDot = (std::min)(minDot, Dot3(faceNormals[t], meshlet.ConeAxis));
+                }
+
+                meshlet.ConeApex = meshlet.Center;
+                meshlet.ConeCutoff = 1.0f;
+
+                if (minDot > kMinConeDot)
+                {
+                    //~ Move the apex back so every triangle plane lies in front of it
+                    float maxT = 0.0f;
+                    for (const std::uint32_t t : meshletTriangles)
+                    {
+                        const XMFLOAT3& n = faceNormals[t];
+                        const float dn = Dot3(n, meshlet.ConeAxis);
+                        if (dn <= 0.0f)
+                            continue;
+
+                        const XMFLOAT3& p0 = vertices[indices[t * 3u]].Position;
+                        const float dc = Dot3(Sub3(meshlet.Center, p0), n);
+                        maxT = (std::max)(maxT, dc / dn);
+                    }
+
+                    meshlet.ConeApex =
+                    {
+                        meshlet.Center.x - meshlet.ConeAxis.x * maxT,
+                        meshlet.Center.y - meshlet.ConeAxis.y * maxT,
+                        meshlet.Center.z - meshlet.ConeAxis.z * maxT
+                    };
+                    meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+                }
+                else
+                {
+                    ++stats.ConesDisabled;
+                }
+
+                stats.AverageVertices += static_cast<float>(meshlet.VertexCount);
+                stats.AverageTriangles += static_cast<float>(meshlet.TriangleCount);
+
+                outMeshlets.push_back(meshlet);
+            }
+
+            indices = std::move(output);
+        }
+        catch (const std::bad_alloc&)
+        {
+            LOG_ERROR("KFEMeshletBuilder::Build: Out of memory");
+            outMeshlets.clear();
+            return false;
+        }
+
+        stats.MeshletCount = static_cast<std::uint32_t>(outMeshlets.size());
+        if (stats.MeshletCount > 0u)
+        {
+            stats.AverageVertices /= static_cast<float>(stats.MeshletCount);
+            stats.AverageTriangles /= static_cast<float>(stats.MeshletCount);
+        }
+
+        stats.BuildMilliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+        if (outStats)
+            *outStats = stats;
+
+        return true;
+    }
+
+    void KFEClusterCuller::Cull(
+        std::span<const KFE_MESHLET> meshlets,
+        const KFE_CLUSTER_CULL_DESC& desc,
+        std::vector<KFE_DRAW_RANGE>& outRanges,
+        KFE_CLUSTER_CULL_STATS* outStats) noexcept
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        outRanges.clear();
+
+        KFE_CLUSTER_CULL_STATS stats{};
+        stats.Tested = static_cast<std::uint32_t>(meshlets.size());
+
+        //~ Frustum planes in mesh space from the columns of MeshToClip (D3D clip z in [0, w])
+        const XMFLOAT4X4& m = desc.MeshToClip;
+        const XMFLOAT4 col0{ m._11, m._21, m._31, m._41 };
+        const XMFLOAT4 col1{ m._12, m._22, m._32, m._42 };
+        const XMFLOAT4 col2{ m._13, m._23, m._33, m._43 };
+        const XMFLOAT4 col3{ m._14, m._24, m._34, m._44 };
+
+        XMFLOAT4 planes[6] =
+        {
+            { col3.x + col0.x, col3.y + col0.y, col3.z + col0.z, col3.w + col0.w }, //~ left
+            { col3.x - col0.x, col3.y - col0.y, col3.z - col0.z, col3.w - col0.w }, //~ right
+            { col3.x + col1.x, col3.y + col1.y, col3.z + col1.z, col3.w + col1.w }, //~ bottom
+            { col3.x - col1.x, col3.y - col1.y, col3.z - col1.z, col3.w - col1.w }, //~ top
+            { col2.x,          col2.y,          col2.z,          col2.w          }, //~ near
+            { col3.x - col2.x, col3.y - col2.y, col3.z - col2.z, col3.w - col2.w }  //~ far
+        };
+
+        for (XMFLOAT4& p : planes)
+        {
+            const float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            if (len > 0.0f)
+            {
+                p.x /= len; p.y /= len; p.z /= len; p.w /= len;
+            }
+        }
+
+        for (const KFE_MESHLET& meshlet : meshlets)
+        {
+            if (desc.FrustumCull)
+            {
+                bool outside = false;
+                for (const XMFLOAT4& p : planes)
+                {
+                    const float dist = p.x * meshlet.Center.x + p.y * meshlet.Center.y + p.z * meshlet.Center.z + p.w;
+                    if (dist < -meshlet.Radius)
+                    {
+                        outside = true;
+                        break;
+                    }
+                }
+
+                if (outside)
+                {
+                    ++stats.FrustumCulled;
+                    continue;
+                }
+            }
+
+            if (desc.BackfaceCull && meshlet.ConeCutoff < 1.0f)
+            {
+                const XMFLOAT3 toApex = NormalizeOr(Sub3(meshlet.ConeApex, desc.CameraPosition), { 0.0f, 0.0f, 0.0f });
+                if (Dot3(toApex, meshlet.ConeAxis) >= meshlet.ConeCutoff)
+                {
+                    ++stats.BackfaceCulled;
+                    continue;
+                }
+            }
+
+            stats.VisibleTriangles += meshlet.TriangleCount;
+
+            const std::uint32_t indexCount = meshlet.TriangleCount * 3u;
+            if (!outRanges.empty() &&
+                outRanges.back().IndexOffset + outRanges.back().IndexCount == meshlet.IndexOffset)
+            {
+                outRanges.back().IndexCount += indexCount;
+            }
+            else
+            {
+                outRanges.push_back({ meshlet.IndexOffset, indexCount });
+            }
+        }
+
+        stats.DrawRanges = static_cast<std::uint32_t>(outRanges.size());
+        stats.CullMicroseconds = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+        if (outStats)
+            *outStats = stats;
+    }
+}
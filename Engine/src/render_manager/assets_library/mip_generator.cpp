@@ -0,0 +1,781 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : mip_generator.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/texture/mip_generator.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define KFE_MIP_GEN_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define KFE_TARGET_AVX2
+    #else
+        #include <cpuid.h>
+        #define KFE_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define KFE_MIP_GEN_X86 0
+#endif
+
+namespace kfe
+{
+    namespace
+    {
+        constexpr float         kPi          = 3.14159265358979323846f;
+        constexpr float         kSincRadius  = 3.0f;
+        constexpr float         kKaiserAlpha = 4.0f;
+        constexpr std::uint32_t kBandRows    = 64u;        //~ dst rows per filtered task
+        constexpr std::uint32_t kBoxRows     = 32u;        //~ dst rows per box task
+        constexpr std::size_t   kMinTexelsPerThread = 1u << 15;
+
+        enum class EKernelSet : std::uint32_t { Scalar, SSE2, AVX2 };
+
+#if KFE_MIP_GEN_X86
+        bool DetectAVX2() noexcept
+        {
+#if defined(_MSC_VER)
+            int info[4]{};
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx)
+                return false;
+
+            //~ OS saves the YMM state
+            if ((_xgetbv(0) & 0x6u) != 0x6u)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        EKernelSet SelectKernels() noexcept
+        {
+#if KFE_MIP_GEN_X86
+            static const EKernelSet set = DetectAVX2() ? EKernelSet::AVX2 : EKernelSet::SSE2;
+            return set;
+#else
+            return EKernelSet::Scalar;
+#endif
+        }
+
+        std::uint32_t ResolveThreads(std::uint32_t requested) noexcept
+        {
+            if (requested != 0u)
+                return requested;
+            return (std::max)(1u, std::thread::hardware_concurrency());
+        }
+
+        //~ Tasks of rowsPerTask rows handed out from an atomic counter, small work stays inline
+        template <typename Fn>
+        void ParallelRows(std::uint32_t rows,
+                          std::uint32_t rowsPerTask,
+                          std::size_t   texelsPerRow,
+                          std::uint32_t threads,
+                          Fn&&          fn)
+        {
+            const std::uint32_t tasks = (rows + rowsPerTask - 1u) / rowsPerTask;
+            const std::size_t   byWork = (static_cast<std::size_t>(rows) * texelsPerRow) / kMinTexelsPerThread;
+
+            std::uint32_t workers = (std::min)(threads, tasks);
+            workers = (std::min)(workers, static_cast<std::uint32_t>((std::max<std::size_t>)(1u, byWork)));
+
+            std::atomic<std::uint32_t> next{ 0u };
+
+            auto Worker = [&]()
+                {
+                    for (;;)
+                    {
+                        const std::uint32_t task = next.fetch_add(1u, std::memory_order_relaxed);
+                        if (task >= tasks)
+                            return;
+
+                        const std::uint32_t begin = task * rowsPerTask;
+                        fn(begin, (std::min)(rows, begin + rowsPerTask));
+                    }
+                };
+
+            if (workers <= 1u)
+            {
+                Worker();
+                return;
+            }
+
+            std::vector<std::jthread> pool;
+            pool.reserve(workers - 1u);
+            for (std::uint32_t i = 1u; i < workers; ++i)
+                pool.emplace_back(Worker);
+
+            Worker();
+        }   //~ joined here
+
+        //~ sRGB transfer
+        constexpr std::uint32_t kSrgbEncodeSteps = 1u << 16;
+
+        struct SrgbTables
+        {
+            float ToLinear[256];
+            float Thresholds[257]; //~ [c] = linear value of sRGB c - 0.5, [0] = -inf, [256] = +inf
+            std::vector<std::uint8_t> Encode; //~ seed code per 1/65536 of linear, at most one off
+        };
+
+        float SrgbToLinear(float s) noexcept
+        {
+            return s <= 0.04045f ? s / 12.92f : std::pow((s + 0.055f) / 1.055f, 2.4f);
+        }
+
+        const SrgbTables& GetSrgbTables() noexcept
+        {
+            static const SrgbTables tables = []()
+                {
+                    SrgbTables t{};
+                    for (int c = 0; c < 256; ++c)
+                    {
+                        t.ToLinear[c]   = SrgbToLinear(static_cast<float>(c) / 255.0f);
+                        t.Thresholds[c] = c == 0 ? -1e30f : SrgbToLinear((static_cast<float>(c) - 0.5f) / 255.0f);
+                    }
+                    t.Thresholds[256] = 1e30f;
+
+                    t.Encode.resize(kSrgbEncodeSteps + 1u);
+                    std::uint32_t code = 0u;
+                    for (std::uint32_t i = 0; i <= kSrgbEncodeSteps; ++i)
+                    {
+                        const float v = static_cast<float>(i) / static_cast<float>(kSrgbEncodeSteps);
+                        while (code < 255u && v >= t.Thresholds[code + 1u])
+                            ++code;
+                        t.Encode[i] = static_cast<std::uint8_t>(code);
+                    }
+                    return t;
+                }();
+            return tables;
+        }
+
+        //~ Largest code whose lower boundary is at or below v. Boundaries are further
+        //~ apart than the table step, so the seed is off by one at most.
+        std::uint8_t LinearToSrgb8(float v, const SrgbTables& t) noexcept
+        {
+            v = std::clamp(v, 0.0f, 1.0f);
+            std::uint32_t code = t.Encode[static_cast<std::uint32_t>(v * static_cast<float>(kSrgbEncodeSteps))];
+
+            if (v >= t.Thresholds[code + 1u])
+                ++code;
+            else if (v < t.Thresholds[code])
+                --code;
+
+            return static_cast<std::uint8_t>(code);
+        }
+
+        std::uint8_t QuantizeUnorm(float v) noexcept
+        {
+            return static_cast<std::uint8_t>(std::nearbyint(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+        }
+
+        //~ Shader box filter, scalar
+        void BoxRowsScalar(const std::uint8_t* src, std::uint32_t sw, std::uint32_t sh,
+                           std::uint8_t* dst, std::uint32_t dw,
+                           std::uint32_t yBegin, std::uint32_t yEnd, std::uint32_t xBegin = 0u) noexcept
+        {
+            for (std::uint32_t y = yBegin; y < yEnd; ++y)
+            {
+                const std::uint8_t* r0 = src + static_cast<std::size_t>((std::min)(y * 2u, sh - 1u)) * sw * 4u;
+                const std::uint8_t* r1 = src + static_cast<std::size_t>((std::min)(y * 2u + 1u, sh - 1u)) * sw * 4u;
+                std::uint8_t*       out = dst + static_cast<std::size_t>(y) * dw * 4u;
+
+                for (std::uint32_t x = xBegin; x < dw; ++x)
+                {
+                    const std::uint32_t x0 = (std::min)(x * 2u, sw - 1u) * 4u;
+                    const std::uint32_t x1 = (std::min)(x * 2u + 1u, sw - 1u) * 4u;
+
+                    for (std::uint32_t c = 0; c < 4u; ++c)
+                    {
+                        const float c0 = static_cast<float>(r0[x0 + c]) / 255.0f;
+                        const float c1 = static_cast<float>(r0[x1 + c]) / 255.0f;
+                        const float c2 = static_cast<float>(r1[x0 + c]) / 255.0f;
+                        const float c3 = static_cast<float>(r1[x1 + c]) / 255.0f;
+
+                        out[x * 4u + c] = QuantizeUnorm((((c0 + c1) + c2) + c3) * 0.25f);
+                    }
+                }
+            }
+        }
+
+#if KFE_MIP_GEN_X86
+        //~ Two dst texels per iteration, same operations and order as the scalar path
+        KFE_TARGET_AVX2
+        void BoxRowsAVX2(const std::uint8_t* src, std::uint32_t sw, std::uint32_t sh,
+                         std::uint8_t* dst, std::uint32_t dw,
+                         std::uint32_t yBegin, std::uint32_t yEnd) noexcept
+        {
+            const __m256 k255  = _mm256_set1_ps(255.0f);
+            const __m256 kQuar = _mm256_set1_ps(0.25f);
+            const __m256 kZero = _mm256_setzero_ps();
+            const __m256 kOne  = _mm256_set1_ps(1.0f);
+
+            for (std::uint32_t y = yBegin; y < yEnd; ++y)
+            {
+                const std::uint8_t* r0 = src + static_cast<std::size_t>((std::min)(y * 2u, sh - 1u)) * sw * 4u;
+                const std::uint8_t* r1 = src + static_cast<std::size_t>((std::min)(y * 2u + 1u, sh - 1u)) * sw * 4u;
+                std::uint8_t*       out = dst + static_cast<std::size_t>(y) * dw * 4u;
+
+                std::uint32_t x = 0u;
+
+                //~ 4 source texels per row, all inside the row
+                for (; x + 2u <= dw && x * 2u + 3u < sw; x += 2u)
+                {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x * 8u));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x * 8u));
+
+                    const __m256 a01 = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(a)), k255);
+                    const __m256 a23 = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(a, 8))), k255);
+                    const __m256 b01 = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(b)), k255);
+                    const __m256 b23 = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(b, 8))), k255);
+
+                    //~ Lane halves are the two dst texels
+                    const __m256 c0 = _mm256_permute2f128_ps(a01, a23, 0x20);
+                    const __m256 c1 = _mm256_permute2f128_ps(a01, a23, 0x31);
+                    const __m256 c2 = _mm256_permute2f128_ps(b01, b23, 0x20);
+                    const __m256 c3 = _mm256_permute2f128_ps(b01, b23, 0x31);
+
+                    __m256 s = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(c0, c1), c2), c3);
+                    s = _mm256_mul_ps(s, kQuar);
+                    s = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(s, kZero), kOne), k255);
+
+                    const __m256i i32 = _mm256_cvtps_epi32(s);  //~ round to nearest even
+                    const __m256i i16 = _mm256_packus_epi32(i32, i32);
+                    const __m256i i8  = _mm256_packus_epi16(i16, i16);
+
+                    const std::int32_t lo = _mm_cvtsi128_si32(_mm256_castsi256_si128(i8));
+                    const std::int32_t hi = _mm_cvtsi128_si32(_mm256_extracti128_si256(i8, 1));
+                    std::memcpy(out + x * 4u, &lo, 4u);
+                    std::memcpy(out + x * 4u + 4u, &hi, 4u);
+                }
+
+                if (x < dw)
+                    BoxRowsScalar(src, sw, sh, dst, dw, y, y + 1u, x);
+            }
+        }
+#endif
+
+        //~ Separable filters
+        float Sinc(float x) noexcept
+        {
+            if (std::fabs(x) < 1e-6f)
+                return 1.0f;
+            const float px = kPi * x;
+            return std::sin(px) / px;
+        }
+
+        float BesselI0(float x) noexcept
+        {
+            float sum = 1.0f;
+            float term = 1.0f;
+            const float half = x * 0.5f;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (half / static_cast<float>(k)) * (half / static_cast<float>(k));
+                sum += term;
+                if (term < sum * 1e-8f)
+                    break;
+            }
+            return sum;
+        }
+
+        float FilterRadius(EMipFilter filter) noexcept
+        {
+            return filter == EMipFilter::Box ? 0.5f : kSincRadius;
+        }
+
+        float EvalFilter(EMipFilter filter, float t) noexcept
+        {
+            const float a = std::fabs(t);
+            switch (filter)
+            {
+            case EMipFilter::Kaiser:
+            {
+                if (a >= kSincRadius)
+                    return 0.0f;
+                const float r = t / kSincRadius;
+                return Sinc(t) * BesselI0(kKaiserAlpha * std::sqrt(1.0f - r * r)) / BesselI0(kKaiserAlpha);
+            }
+            case EMipFilter::Lanczos:
+                return a < kSincRadius ? Sinc(t) * Sinc(t / kSincRadius) : 0.0f;
+            default:
+                return a < 0.5f ? 1.0f : (a == 0.5f ? 0.5f : 0.0f);
+            }
+        }
+
+        //~ TapCount source indices (edge clamped) and normalized weights per dst texel
+        struct FilterTaps
+        {
+            std::uint32_t              TapCount = 0u;
+            std::vector<std::uint32_t> Index;
+            std::vector<float>         Weight;
+        };
+
+        FilterTaps BuildTaps(EMipFilter filter, std::uint32_t srcSize, std::uint32_t dstSize)
+        {
+            FilterTaps taps{};
+
+            const float scale  = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+            const float radius = FilterRadius(filter) * (std::max)(scale, 1.0f);
+
+            taps.TapCount = (std::max)(1u, static_cast<std::uint32_t>(std::ceil(radius * 2.0f)));
+            taps.Index.resize(static_cast<std::size_t>(dstSize) * taps.TapCount);
+            taps.Weight.resize(taps.Index.size());
+
+            for (std::uint32_t d = 0; d < dstSize; ++d)
+            {
+                const float center = (static_cast<float>(d) + 0.5f) * scale - 0.5f;
+                const int   first  = static_cast<int>(std::floor(center - radius)) + 1;
+
+                std::uint32_t* index  = taps.Index.data() + static_cast<std::size_t>(d) * taps.TapCount;
+                float*         weight = taps.Weight.data() + static_cast<std::size_t>(d) * taps.TapCount;
+
+                float sum = 0.0f;
+                for (std::uint32_t k = 0; k < taps.TapCount; ++k)
+                {
+                    const int i = first + static_cast<int>(k);
+                    index[k]  = static_cast<std::uint32_t>(std::clamp(i, 0, static_cast<int>(srcSize) - 1));
+                    weight[k] = EvalFilter(filter, (static_cast<float>(i) - center) / (std::max)(scale, 1.0f));
+                    sum += weight[k];
+                }
+
+                if (std::fabs(sum) < 1e-6f)
+                {
+                    //~ Degenerate footprint, point sample the nearest texel
+                    std::fill(weight, weight + taps.TapCount, 0.0f);
+                    index[0]  = static_cast<std::uint32_t>(std::clamp(static_cast<int>(std::lround(center)), 0, static_cast<int>(srcSize) - 1));
+                    weight[0] = 1.0f;
+                    continue;
+                }
+
+                for (std::uint32_t k = 0; k < taps.TapCount; ++k)
+                    weight[k] /= sum;
+            }
+
+            return taps;
+        }
+
+        enum class ETexelSpace : std::uint32_t { Unorm, SRGB, Signed };
+
+        ETexelSpace SpaceOf(const KFE_MIP_GEN_DESC& desc) noexcept
+        {
+            if (desc.bNormalMap) return ETexelSpace::Signed;
+            if (desc.bSRGB)      return ETexelSpace::SRGB;
+            return ETexelSpace::Unorm;
+        }
+
+        void DecodeRow(const std::uint8_t* src, std::uint32_t width, ETexelSpace space, float* out) noexcept
+        {
+            const std::size_t count = static_cast<std::size_t>(width) * 4u;
+
+            switch (space)
+            {
+            case ETexelSpace::SRGB:
+            {
+                const SrgbTables& t = GetSrgbTables();
+                for (std::size_t i = 0; i < count; i += 4u)
+                {
+                    out[i + 0u] = t.ToLinear[src[i + 0u]];
+                    out[i + 1u] = t.ToLinear[src[i + 1u]];
+                    out[i + 2u] = t.ToLinear[src[i + 2u]];
+                    out[i + 3u] = static_cast<float>(src[i + 3u]) / 255.0f;
+                }
+                break;
+            }
+            case ETexelSpace::Signed:
+                for (std::size_t i = 0; i < count; i += 4u)
+                {
+                    out[i + 0u] = static_cast<float>(src[i + 0u]) * (2.0f / 255.0f) - 1.0f;
+                    out[i + 1u] = static_cast<float>(src[i + 1u]) * (2.0f / 255.0f) - 1.0f;
+                    out[i + 2u] = static_cast<float>(src[i + 2u]) * (2.0f / 255.0f) - 1.0f;
+                    out[i + 3u] = static_cast<float>(src[i + 3u]) / 255.0f;
+                }
+                break;
+            default:
+                for (std::size_t i = 0; i < count; ++i)
+                    out[i] = static_cast<float>(src[i]) / 255.0f;
+                break;
+            }
+        }
+
+        void EncodeRow(float* row, std::uint32_t width, ETexelSpace space, std::uint8_t* out) noexcept
+        {
+            const std::size_t count = static_cast<std::size_t>(width) * 4u;
+
+            switch (space)
+            {
+            case ETexelSpace::SRGB:
+            {
+                const SrgbTables& t = GetSrgbTables();
+                for (std::size_t i = 0; i < count; i += 4u)
+                {
+                    out[i + 0u] = LinearToSrgb8(row[i + 0u], t);
+                    out[i + 1u] = LinearToSrgb8(row[i + 1u], t);
+                    out[i + 2u] = LinearToSrgb8(row[i + 2u], t);
+                    out[i + 3u] = QuantizeUnorm(row[i + 3u]);
+                }
+                break;
+            }
+            case ETexelSpace::Signed:
+                for (std::size_t i = 0; i < count; i += 4u)
+                {
+                    float x = row[i + 0u], y = row[i + 1u], z = row[i + 2u];
+                    const float len = std::sqrt(x * x + y * y + z * z);
+                    if (len > 1e-6f)
+                    {
+                        x /= len; y /= len; z /= len;
+                    }
+                    else
+                    {
+                        x = 0.0f; y = 0.0f; z = 1.0f;
+                    }
+
+                    out[i + 0u] = QuantizeUnorm(x * 0.5f + 0.5f);
+                    out[i + 1u] = QuantizeUnorm(y * 0.5f + 0.5f);
+                    out[i + 2u] = QuantizeUnorm(z * 0.5f + 0.5f);
+                    out[i + 3u] = QuantizeUnorm(row[i + 3u]);
+                }
+                break;
+            default:
+                for (std::size_t i = 0; i < count; ++i)
+                    out[i] = QuantizeUnorm(row[i]);
+                break;
+            }
+        }
+
+        //~ out (dw texels) = taps over one decoded source row
+        void FilterRowH(const float* src, const FilterTaps& taps, std::uint32_t dw, float* out, EKernelSet set) noexcept
+        {
+            const std::uint32_t tapCount = taps.TapCount;
+
+#if KFE_MIP_GEN_X86
+            if (set != EKernelSet::Scalar)
+            {
+                for (std::uint32_t x = 0; x < dw; ++x)
+                {
+                    const std::uint32_t* index  = taps.Index.data() + static_cast<std::size_t>(x) * tapCount;
+                    const float*         weight = taps.Weight.data() + static_cast<std::size_t>(x) * tapCount;
+
+                    __m128 acc = _mm_setzero_ps();
+                    for (std::uint32_t k = 0; k < tapCount; ++k)
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(src + index[k] * 4u)));
+
+                    _mm_storeu_ps(out + x * 4u, acc);
+                }
+                return;
+            }
+#else
+            (void)set;
+#endif
+            for (std::uint32_t x = 0; x < dw; ++x)
+            {
+                const std::uint32_t* index  = taps.Index.data() + static_cast<std::size_t>(x) * tapCount;
+                const float*         weight = taps.Weight.data() + static_cast<std::size_t>(x) * tapCount;
+
+                float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                for (std::uint32_t k = 0; k < tapCount; ++k)
+                {
+                    const float* s = src + index[k] * 4u;
+                    acc[0] += weight[k] * s[0];
+                    acc[1] += weight[k] * s[1];
+                    acc[2] += weight[k] * s[2];
+                    acc[3] += weight[k] * s[3];
+                }
+                std::memcpy(out + x * 4u, acc, sizeof(acc));
+            }
+        }
+
+        //~ out += w * row over count floats
+        void AxpyScalar(float w, const float* row, float* out, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] += w * row[i];
+        }
+
+#if KFE_MIP_GEN_X86
+        KFE_TARGET_AVX2
+        void AxpyAVX2(float w, const float* row, float* out, std::size_t count) noexcept
+        {
+            const __m256 vw = _mm256_set1_ps(w);
+
+            std::size_t i = 0u;
+            for (; i + 8u <= count; i += 8u)
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(vw, _mm256_loadu_ps(row + i))));
+
+            AxpyScalar(w, row + i, out + i, count - i);
+        }
+#endif
+
+        //~ dst rows [yBegin, yEnd): horizontal pass over just the source rows they read
+        //~ into a band buffer, then the vertical pass row by row
+        void FilterBand(const std::uint8_t* src, std::uint32_t sw,
+                        std::uint8_t* dst, std::uint32_t dw,
+                        const FilterTaps& tapsX, const FilterTaps& tapsY,
+                        ETexelSpace space, EKernelSet set,
+                        std::uint32_t yBegin, std::uint32_t yEnd)
+        {
+            const std::uint32_t tapCount = tapsY.TapCount;
+
+            std::uint32_t rowLo = ~0u;
+            std::uint32_t rowHi = 0u;
+            for (std::uint32_t y = yBegin; y < yEnd; ++y)
+            {
+                for (std::uint32_t k = 0; k < tapCount; ++k)
+                {
+                    const std::uint32_t r = tapsY.Index[static_cast<std::size_t>(y) * tapCount + k];
+                    rowLo = (std::min)(rowLo, r);
+                    rowHi = (std::max)(rowHi, r);
+                }
+            }
+
+            const std::size_t dstFloats = static_cast<std::size_t>(dw) * 4u;
+
+            std::vector<float> decoded(static_cast<std::size_t>(sw) * 4u);
+            std::vector<float> band(static_cast<std::size_t>(rowHi - rowLo + 1u) * dstFloats);
+            std::vector<float> row(dstFloats);
+
+            for (std::uint32_t r = rowLo; r <= rowHi; ++r)
+            {
+                DecodeRow(src + static_cast<std::size_t>(r) * sw * 4u, sw, space, decoded.data());
+                FilterRowH(decoded.data(), tapsX, dw, band.data() + static_cast<std::size_t>(r - rowLo) * dstFloats, set);
+            }
+
+            for (std::uint32_t y = yBegin; y < yEnd; ++y)
+            {
+                std::fill(row.begin(), row.end(), 0.0f);
+
+                for (std::uint32_t k = 0; k < tapCount; ++k)
+                {
+                    const std::size_t tap = static_cast<std::size_t>(y) * tapCount + k;
+                    const float       w   = tapsY.Weight[tap];
+                    if (w == 0.0f)
+                        continue;
+
+                    const float* srcRow = band.data() + static_cast<std::size_t>(tapsY.Index[tap] - rowLo) * dstFloats;
+#if KFE_MIP_GEN_X86
+                    if (set == EKernelSet::AVX2)
+                    {
+                        AxpyAVX2(w, srcRow, row.data(), dstFloats);
+                        continue;
+                    }
+#endif
+                    AxpyScalar(w, srcRow, row.data(), dstFloats);
+                }
+
+                EncodeRow(row.data(), dw, space, dst + static_cast<std::size_t>(y) * dstFloats);
+            }
+        }
+
+        bool GenerateLevelWith(const std::uint8_t* src, std::uint32_t sw, std::uint32_t sh,
+                               std::uint8_t* dst, const KFE_MIP_GEN_DESC& desc, EKernelSet set)
+        {
+            const std::uint32_t dw = (std::max)(1u, sw >> 1u);
+            const std::uint32_t dh = (std::max)(1u, sh >> 1u);
+            const std::uint32_t threads = ResolveThreads(desc.ThreadCount);
+            const ETexelSpace   space = SpaceOf(desc);
+
+            if (desc.Filter == EMipFilter::Box && space == ETexelSpace::Unorm)
+            {
+                ParallelRows(dh, kBoxRows, dw, threads, [&](std::uint32_t begin, std::uint32_t end)
+                    {
+#if KFE_MIP_GEN_X86
+                        if (set == EKernelSet::AVX2)
+                        {
+                            BoxRowsAVX2(src, sw, sh, dst, dw, begin, end);
+                            return;
+                        }
+#endif
+                        BoxRowsScalar(src, sw, sh, dst, dw, begin, end);
+                    });
+                return true;
+            }
+
+            const FilterTaps tapsX = BuildTaps(desc.Filter, sw, dw);
+            const FilterTaps tapsY = BuildTaps(desc.Filter, sh, dh);
+
+            ParallelRows(dh, kBandRows, static_cast<std::size_t>(dw) * tapsX.TapCount, threads,
+                [&](std::uint32_t begin, std::uint32_t end)
+                {
+                    FilterBand(src, sw, dst, dw, tapsX, tapsY, space, set, begin, end);
+                });
+            return true;
+        }
+
+        bool GenerateChainWith(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height,
+                               const KFE_MIP_GEN_DESC& desc, EKernelSet set,
+                               std::vector<KFE_MIP_LEVEL>& outLevels)
+        {
+            outLevels.clear();
+
+            std::uint32_t w = width;
+            std::uint32_t h = height;
+            const std::uint8_t* parent = rgba;
+
+            while (w > 1u || h > 1u)
+            {
+                KFE_MIP_LEVEL level{};
+                level.Width  = (std::max)(1u, w >> 1u);
+                level.Height = (std::max)(1u, h >> 1u);
+                level.Pixels.resize(static_cast<std::size_t>(level.Width) * level.Height * 4u);
+
+                if (!GenerateLevelWith(parent, w, h, level.Pixels.data(), desc, set))
+                {
+                    outLevels.clear();
+                    return false;
+                }
+
+                outLevels.emplace_back(std::move(level));
+                parent = outLevels.back().Pixels.data();
+                w = outLevels.back().Width;
+                h = outLevels.back().Height;
+            }
+
+            return true;
+        }
+    }
+
+    const char* KFEMipGenerator::GetInstructionSet() noexcept
+    {
+        switch (SelectKernels())
+        {
+        case EKernelSet::AVX2: return "AVX2";
+        case EKernelSet::SSE2: return "SSE2";
+        default:               return "Scalar";
+        }
+    }
+
+    bool KFEMipGenerator::GenerateChain(const std::uint8_t* rgba,
+                                        std::uint32_t width,
+                                        std::uint32_t height,
+                                        const KFE_MIP_GEN_DESC& desc,
+                                        std::vector<KFE_MIP_LEVEL>& outLevels) noexcept
+    {
+        outLevels.clear();
+
+        if (!rgba || width == 0u || height == 0u)
+        {
+            LOG_ERROR("KFEMipGenerator::GenerateChain: Empty image.");
+            return false;
+        }
+
+        return GenerateChainWith(rgba, width, height, desc, SelectKernels(), outLevels);
+    }
+
+    bool KFEMipGenerator::GenerateLevel(const std::uint8_t* src,
+                                        std::uint32_t srcWidth,
+                                        std::uint32_t srcHeight,
+                                        std::uint8_t* dst,
+                                        const KFE_MIP_GEN_DESC& desc) noexcept
+    {
+        if (!src || !dst || srcWidth == 0u || srcHeight == 0u)
+        {
+            LOG_ERROR("KFEMipGenerator::GenerateLevel: Invalid level.");
+            return false;
+        }
+
+        return GenerateLevelWith(src, srcWidth, srcHeight, dst, desc, SelectKernels());
+    }
+
+    KFE_MIP_GEN_BENCH_RESULT KFEMipGenerator::RunBenchmark(std::uint32_t size, std::uint32_t threadCount) noexcept
+    {
+        using Clock = std::chrono::steady_clock;
+
+        KFE_MIP_GEN_BENCH_RESULT result{};
+        result.Size = size;
+        result.ThreadCount = ResolveThreads(threadCount);
+        result.InstructionSet = GetInstructionSet();
+
+        if (size == 0u)
+            return result;
+
+        //~ Odd height so the clamped edge reads are covered too
+        const std::uint32_t width  = size;
+        const std::uint32_t height = size - 1u + (size == 1u ? 1u : 0u);
+
+        std::vector<std::uint8_t> image(static_cast<std::size_t>(width) * height * 4u);
+        std::mt19937 rng(11u);
+        for (auto& b : image)
+            b = static_cast<std::uint8_t>(rng() & 0xFFu);
+
+        auto Ms = [](Clock::time_point a, Clock::time_point b)
+            {
+                return std::chrono::duration<double, std::milli>(b - a).count();
+            };
+
+        KFE_MIP_GEN_DESC desc{};
+        desc.ThreadCount = 1u;
+
+        std::vector<KFE_MIP_LEVEL> reference, levels, scratch;
+
+        auto t0 = Clock::now();
+        GenerateChainWith(image.data(), width, height, desc, EKernelSet::Scalar, reference);
+        auto t1 = Clock::now();
+        result.ScalarBoxMs = Ms(t0, t1);
+
+        desc.ThreadCount = result.ThreadCount;
+
+        t0 = Clock::now();
+        GenerateChainWith(image.data(), width, height, desc, SelectKernels(), levels);
+        t1 = Clock::now();
+        result.BoxMs   = Ms(t0, t1);
+        result.Speedup = result.BoxMs > 0.0 ? result.ScalarBoxMs / result.BoxMs : 0.0;
+
+        result.bMatchesShader = reference.size() == levels.size();
+        for (std::size_t i = 0; i < levels.size() && result.bMatchesShader; ++i)
+            result.bMatchesShader = reference[i].Pixels == levels[i].Pixels;
+
+        desc.bSRGB = true;
+        t0 = Clock::now();
+        GenerateChainWith(image.data(), width, height, desc, SelectKernels(), scratch);
+        t1 = Clock::now();
+        result.SRGBBoxMs = Ms(t0, t1);
+
+        desc.bSRGB = false;
+        desc.Filter = EMipFilter::Kaiser;
+        t0 = Clock::now();
+        GenerateChainWith(image.data(), width, height, desc, SelectKernels(), scratch);
+        t1 = Clock::now();
+        result.KaiserMs = Ms(t0, t1);
+
+        desc.Filter = EMipFilter::Lanczos;
+        t0 = Clock::now();
+        GenerateChainWith(image.data(), width, height, desc, SelectKernels(), scratch);
+        t1 = Clock::now();
+        result.LanczosMs = Ms(t0, t1);
+
+        LOG_INFO("KFEMipGenerator::RunBenchmark: {}x{}, box scalar {:.2f} ms, box {} x{} {:.2f} ms ({:.2f}x), "
+                 "sRGB box {:.2f} ms, Kaiser {:.2f} ms, Lanczos {:.2f} ms, matches shader={}",
+            width, height, result.ScalarBoxMs, result.InstructionSet, result.ThreadCount, result.BoxMs,
+            result.Speedup, result.SRGBBoxMs, result.KaiserMs, result.LanczosMs, result.bMatchesShader);
+
+        return result;
+    }
+}
@@ -77,7 +77,10 @@ namespace kfe
         bool KFEModel::Initialize(const std::string& path,
             KFEDevice* device,
             ID3D12GraphicsCommandList* cmdList,
-            KFEResourceHeap* heap) noexcept
+            KFEResourceHeap* heap,
+            EMeshVertexFormat vertexFormat,
+            ID3D12Fence* fence,
+            std::uint64_t fenceValue) noexcept
     {
         Reset();
 
@@ -93,20 +96,20 @@ namespace kfe
             return false;
         }
 
-        KFE_MESH_CACHE_SHARE* share = nullptr;
-        if (!KFEMeshCache::Instance().GetOrCreate(path, device, cmdList, heap, share))
+        KFEMeshCacheHandle handle{};
+        if (!KFEMeshCache::Instance().GetOrCreate(path, device, cmdList, heap, handle, vertexFormat, fence, fenceValue))
         {
             LOG_ERROR("Failed to get mesh cache share for '{}'", path);
             return false;
         }
 
-        if (!share || !share->IsValid())
+        if (!handle.IsValid())
         {
             LOG_ERROR("Invalid mesh cache share for '{}'", path);
             return false;
         }
 
-        m_pShare = share;
+        m_share = std::move(handle);
 
         //~ Build submesh table and node hierarchy view
         BuildFromShare();
@@ -123,14 +126,15 @@ namespace kfe
 
     void KFEModel::Reset() noexcept
     {
-        m_pShare = nullptr;
+        //~ Last model using the entry puts it on the cache LRU
+        m_share.Reset();
         m_submeshes.clear();
         m_root.reset();
     }
 
     bool KFEModel::IsValid() const noexcept
     {
-        return m_pShare != nullptr && m_root != nullptr && !m_submeshes.empty();
+        return m_share.Get() != nullptr && m_root != nullptr && !m_submeshes.empty();
     }
 
     const KFEModelNode* KFEModel::GetRootNode() const noexcept
@@ -145,7 +149,7 @@ namespace kfe
 
     const KFE_MESH_CACHE_SHARE* KFEModel::GetCacheShare() const noexcept
     {
-        return m_pShare;
+        return m_share.Get();
     }
 
     std::uint32_t KFEModel::GetSubmeshCount() const noexcept
@@ -168,10 +172,10 @@ namespace kfe
 
     void kfe::KFEModel::BuildFromShare() noexcept
     {
-        if (!m_pShare || !m_pShare->Entry || !m_pShare->Entry->SceneCPU)
+        if (!m_share || !m_share->Entry || !m_share->Entry->SceneCPU)
             return;
 
-        const import::ImportedScene& scene = *m_pShare->Entry->SceneCPU;
+        const import::ImportedScene& scene = *m_share->Entry->SceneCPU;
 
         const auto meshCount = scene.Meshes.size();
         m_submeshes.resize(meshCount);
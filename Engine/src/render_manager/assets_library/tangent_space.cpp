@@ -0,0 +1,551 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : tangent_space.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/tangent_space.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace kfe
+{
+    using import::Float3;
+    using import::ImportedMesh;
+    using import::ImportedVertex;
+
+    namespace
+    {
+        Float3 Add  (const Float3& a, const Float3& b) noexcept { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+        Float3 Sub  (const Float3& a, const Float3& b) noexcept { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+        Float3 Scale(const Float3& a, float s)         noexcept { return { a.x * s, a.y * s, a.z * s }; }
+        float  Dot  (const Float3& a, const Float3& b) noexcept { return a.x * b.x + a.y * b.y + a.z * b.z; }
+        Float3 Cross(const Float3& a, const Float3& b) noexcept
+        {
+            return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        }
+
+        bool Normalize(Float3& v) noexcept
+        {
+            const float len = std::sqrt(Dot(v, v));
+            if (len <= 1e-20f)
+                return false;
+            v = Scale(v, 1.0f / len);
+            return true;
+        }
+
+        //~ v minus its component along the unit normal n
+        Float3 Reject(const Float3& v, const Float3& n) noexcept
+        {
+            return Sub(v, Scale(n, Dot(n, v)));
+        }
+
+        //~ Any unit vector perpendicular to n
+        Float3 Perpendicular(const Float3& n) noexcept
+        {
+            Float3 t = std::fabs(n.x) < 0.9f ? Cross(n, Float3{ 1.0f, 0.0f, 0.0f }) : Cross(n, Float3{ 0.0f, 1.0f, 0.0f });
+            if (!Normalize(t))
+                t = { 1.0f, 0.0f, 0.0f };
+            return t;
+        }
+
+        std::uint32_t ResolveThreads(const KFE_TANGENT_SPACE_DESC& desc) noexcept
+        {
+            if (desc.ThreadCount != 0u)
+                return desc.ThreadCount;
+            return (std::max)(1u, std::thread::hardware_concurrency());
+        }
+
+        //~ Chunks are handed out from an atomic counter; each item is written by
+        //~ exactly one chunk, so scheduling order never changes a result
+        template <typename Fn>
+        std::uint32_t ParallelFor(std::size_t count, std::size_t chunk, std::uint32_t threads, const Fn& fn) noexcept
+        {
+            chunk = (std::max)(chunk, std::size_t{ 1u });
+            const std::size_t chunks = (count + chunk - 1u) / chunk;
+            const std::uint32_t workerCount = static_cast<std::uint32_t>((std::min)(std::size_t{ threads }, chunks));
+
+            if (workerCount <= 1u)
+            {
+                if (count > 0u)
+                    fn(std::size_t{ 0u }, count);
+                return 1u;
+            }
+
+            std::atomic<std::size_t> next{ 0u };
+            auto Worker = [&]()
+                {
+                    for (;;)
+                    {
+                        const std::size_t c = next.fetch_add(1u, std::memory_order_relaxed);
+                        if (c >= chunks)
+                            return;
+                        fn(c * chunk, (std::min)(count, (c + 1u) * chunk));
+                    }
+                };
+
+            std::uint32_t started = 1u;
+            {
+                std::vector<std::jthread> workers;
+                workers.reserve(workerCount - 1u);
+
+                try
+                {
+                    for (std::uint32_t i = 1u; i < workerCount; ++i)
+                    {
+                        workers.emplace_back(Worker);
+                        ++started;
+                    }
+                }
+                catch (...)
+                {
+                    //~ Out of threads, the ones that started and the caller finish the work
+                }
+
+                Worker();
+            }
+            return started;
+        }
+
+        //~ Compressed lists: item -> the corners/faces that touch it, in triangle order
+        struct Adjacency
+        {
+            std::vector<std::uint32_t> Offsets;
+            std::vector<std::uint32_t> Items;
+        };
+
+        //~ keyOfCorner(c) is the bucket of corner c, entries are pushed in corner order
+        template <typename KeyFn, typename ValueFn>
+        void BuildAdjacency(std::size_t buckets, std::size_t corners, const KeyFn& keyOfCorner,
+                            const ValueFn& valueOfCorner, Adjacency& out)
+        {
+            out.Offsets.assign(buckets + 1u, 0u);
+            for (std::size_t c = 0; c < corners; ++c)
+                ++out.Offsets[keyOfCorner(c) + 1u];
+
+            for (std::size_t b = 0; b < buckets; ++b)
+                out.Offsets[b + 1u] += out.Offsets[b];
+
+            std::vector<std::uint32_t> cursor(out.Offsets.begin(), out.Offsets.end() - 1);
+            out.Items.resize(corners);
+            for (std::size_t c = 0; c < corners; ++c)
+                out.Items[cursor[keyOfCorner(c)]++] = valueOfCorner(c);
+        }
+
+        //~ Exact position weld, group ids follow first appearance so they are stable
+        std::uint32_t WeldPositions(const ImportedMesh& mesh, std::vector<std::uint32_t>& groupOf)
+        {
+            struct PositionKey
+            {
+                std::uint32_t X, Y, Z;
+                bool operator==(const PositionKey&) const = default;
+            };
+            struct PositionHash
+            {
+                std::size_t operator()(const PositionKey& k) const noexcept
+                {
+                    std::uint64_t h = k.X * 0x9E3779B97F4A7C15ull;
+                    h ^= (h >> 29u) + k.Y * 0xBF58476D1CE4E5B9ull;
+                    h ^= (h >> 31u) + k.Z * 0x94D049BB133111EBull;
+                    return static_cast<std::size_t>(h ^ (h >> 32u));
+                }
+            };
+
+            const std::size_t n = mesh.Vertices.size();
+            groupOf.resize(n);
+
+            std::unordered_map<PositionKey, std::uint32_t, PositionHash> groups;
+            groups.reserve(n);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const Float3& p = mesh.Vertices[i].Position;
+                PositionKey key{};
+                std::memcpy(&key.X, &p.x, 4u);
+                std::memcpy(&key.Y, &p.y, 4u);
+                std::memcpy(&key.Z, &p.z, 4u);
+
+                const auto [it, _] = groups.try_emplace(key, static_cast<std::uint32_t>(groups.size()));
+                groupOf[i] = it->second;
+            }
+            return static_cast<std::uint32_t>(groups.size());
+        }
+
+        bool ValidTriangles(const ImportedMesh& mesh) noexcept
+        {
+            if (mesh.Vertices.empty() || mesh.Indices.size() < 3u)
+                return false;
+
+            const std::size_t n = mesh.Vertices.size();
+            return std::all_of(mesh.Indices.begin(), mesh.Indices.end(),
+                [n](std::uint32_t i) { return i < n; });
+        }
+
+        //~ MikkTSpace face gradients, already unit length and signed by UV winding
+        struct FaceTangent
+        {
+            Float3 Os{};
+            Float3 Ot{};
+            float  Orientation = 0.0f; //~ +1 / -1, 0 when the UV triangle is degenerate
+        };
+
+        bool BuildNormals(ImportedMesh& mesh, const KFE_TANGENT_SPACE_DESC& desc, std::uint32_t& outThreads) noexcept
+        {
+            if (!ValidTriangles(mesh))
+                return false;
+
+            if (std::all_of(mesh.Vertices.begin(), mesh.Vertices.end(),
+                [](const ImportedVertex& v) { return v.HasNormal; }))
+            {
+                return false;
+            }
+
+            const std::size_t triangleCount = mesh.Indices.size() / 3u;
+            const std::uint32_t threads = ResolveThreads(desc);
+            const std::size_t chunk = desc.TrianglesPerChunk;
+
+            std::vector<std::uint32_t> groupOf;
+            const std::uint32_t groupCount = WeldPositions(mesh, groupOf);
+
+            //~ Area weighted face normals (unnormalized cross product)
+            std::vector<Float3> faceNormals(triangleCount);
+            std::uint32_t used = ParallelFor(triangleCount, chunk, threads,
+                [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t t = begin; t < end; ++t)
+                    {
+                        const Float3& p0 = mesh.Vertices[mesh.Indices[t * 3u + 0u]].Position;
+                        const Float3& p1 = mesh.Vertices[mesh.Indices[t * 3u + 1u]].Position;
+                        const Float3& p2 = mesh.Vertices[mesh.Indices[t * 3u + 2u]].Position;
+                        faceNormals[t] = Cross(Sub(p1, p0), Sub(p2, p0));
+                    }
+                });
+
+            Adjacency groupFaces;
+            BuildAdjacency(groupCount, mesh.Indices.size(),
+                [&](std::size_t c) { return groupOf[mesh.Indices[c]]; },
+                [](std::size_t c) { return static_cast<std::uint32_t>(c / 3u); },
+                groupFaces);
+
+            //~ Sum per position in triangle order
+            std::vector<Float3> groupNormals(groupCount);
+            used = (std::max)(used, ParallelFor(groupCount, chunk, threads,
+                [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t g = begin; g < end; ++g)
+                    {
+                        Float3 sum{ 0.0f, 0.0f, 0.0f };
+                        for (std::uint32_t i = groupFaces.Offsets[g]; i < groupFaces.Offsets[g + 1u]; ++i)
+                            sum = Add(sum, faceNormals[groupFaces.Items[i]]);
+
+                        if (!Normalize(sum))
+                            sum = { 0.0f, 1.0f, 0.0f };
+                        groupNormals[g] = sum;
+                    }
+                }));
+
+            for (std::size_t i = 0; i < mesh.Vertices.size(); ++i)
+            {
+                ImportedVertex& v = mesh.Vertices[i];
+                if (v.HasNormal)
+                    continue;
+
+                v.Normal    = groupNormals[groupOf[i]];
+                v.HasNormal = true;
+            }
+
+            outThreads = used;
+            return true;
+        }
+
+        bool BuildTangents(ImportedMesh& mesh, const KFE_TANGENT_SPACE_DESC& desc,
+                           std::uint64_t& outMixed, std::uint32_t& outThreads) noexcept
+        {
+            if (!ValidTriangles(mesh))
+                return false;
+
+            const bool needed = std::any_of(mesh.Vertices.begin(), mesh.Vertices.end(),
+                [](const ImportedVertex& v) { return !v.HasTangent; });
+            const bool inputs = std::all_of(mesh.Vertices.begin(), mesh.Vertices.end(),
+                [](const ImportedVertex& v) { return v.HasNormal && v.HasUV[0]; });
+
+            if (!needed || !inputs)
+                return false;
+
+            const std::size_t triangleCount = mesh.Indices.size() / 3u;
+            const std::size_t vertexCount = mesh.Vertices.size();
+            const std::uint32_t threads = ResolveThreads(desc);
+            const std::size_t chunk = desc.TrianglesPerChunk;
+
+            //~ Face pass
+            std::vector<FaceTangent> faces(triangleCount);
+            std::uint32_t used = ParallelFor(triangleCount, chunk, threads,
+                [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t t = begin; t < end; ++t)
+                    {
+                        const ImportedVertex& a = mesh.Vertices[mesh.Indices[t * 3u + 0u]];
+                        const ImportedVertex& b = mesh.Vertices[mesh.Indices[t * 3u + 1u]];
+                        const ImportedVertex& c = mesh.Vertices[mesh.Indices[t * 3u + 2u]];
+
+                        const Float3 d1 = Sub(b.Position, a.Position);
+                        const Float3 d2 = Sub(c.Position, a.Position);
+
+                        const float t21x = b.UV[0].x - a.UV[0].x, t21y = b.UV[0].y - a.UV[0].y;
+                        const float t31x = c.UV[0].x - a.UV[0].x, t31y = c.UV[0].y - a.UV[0].y;
+
+                        const float signedArea = t21x * t31y - t21y * t31x;
+
+                        FaceTangent& face = faces[t];
+                        if (std::fabs(signedArea) <= 1e-20f)
+                            continue;
+
+                        const float sign = signedArea > 0.0f ? 1.0f : -1.0f;
+
+                        face.Os = Sub(Scale(d1, t31y), Scale(d2, t21y));
+                        face.Ot = Sub(Scale(d2, t21x), Scale(d1, t31x));
+
+                        if (!Normalize(face.Os))
+                            continue;
+                        if (!Normalize(face.Ot))
+                            face.Ot = { 0.0f, 0.0f, 0.0f };
+
+                        face.Os = Scale(face.Os, sign);
+                        face.Ot = Scale(face.Ot, sign);
+                        face.Orientation = sign;
+                    }
+                });
+
+            Adjacency vertexCorners;
+            BuildAdjacency(vertexCount, mesh.Indices.size(),
+                [&](std::size_t c) { return mesh.Indices[c]; },
+                [](std::size_t c) { return static_cast<std::uint32_t>(c); },
+                vertexCorners);
+
+            //~ Vertex pass, corners summed in triangle order
+            std::atomic<std::uint64_t> mixed{ 0u };
+            used = (std::max)(used, ParallelFor(vertexCount, chunk, threads,
+                [&](std::size_t begin, std::size_t end)
+                {
+                    std::uint64_t localMixed = 0u;
+
+                    for (std::size_t vi = begin; vi < end; ++vi)
+                    {
+                        ImportedVertex& v = mesh.Vertices[vi];
+                        if (v.HasTangent)
+                            continue;
+
+                        const Float3 n = v.Normal;
+
+                        //~ [0] orientation preserving, [1] flipped
+                        Float3 tangentSum[2]{};
+                        Float3 bitangentSum[2]{};
+                        float  weightSum[2]{};
+
+                        for (std::uint32_t i = vertexCorners.Offsets[vi]; i < vertexCorners.Offsets[vi + 1u]; ++i)
+                        {
+                            const std::uint32_t corner = vertexCorners.Items[i];
+                            const std::uint32_t t = corner / 3u;
+                            const FaceTangent& face = faces[t];
+                            if (face.Orientation == 0.0f)
+                                continue;
+
+                            Float3 tangent = Reject(face.Os, n);
+                            if (!Normalize(tangent))
+                                continue;
+
+                            //~ Corner angle in the tangent plane, as MikkTSpace weights it
+                            const std::uint32_t k = corner % 3u;
+                            const Float3& p  = v.Position;
+                            Float3 e1 = Reject(Sub(mesh.Vertices[mesh.Indices[t * 3u + (k + 1u) % 3u]].Position, p), n);
+                            Float3 e2 = Reject(Sub(mesh.Vertices[mesh.Indices[t * 3u + (k + 2u) % 3u]].Position, p), n);
+                            if (!Normalize(e1) || !Normalize(e2))
+                                continue;
+
+                            const float angle = std::acos(std::clamp(Dot(e1, e2), -1.0f, 1.0f));
+
+                            const int bucket = face.Orientation > 0.0f ? 0 : 1;
+                            tangentSum[bucket]   = Add(tangentSum[bucket], Scale(tangent, angle));
+                            bitangentSum[bucket] = Add(bitangentSum[bucket], Scale(Reject(face.Ot, n), angle));
+                            weightSum[bucket]   += angle;
+                        }
+
+                        //~ MikkTSpace would split the vertex, one tangent per vertex keeps the
+                        //~ heavier side
+                        if (weightSum[0] > 0.0f && weightSum[1] > 0.0f)
+                            ++localMixed;
+
+                        const int bucket = weightSum[1] > weightSum[0] ? 1 : 0;
+
+                        Float3 tangent = tangentSum[bucket];
+                        if (!Normalize(tangent))
+                            tangent = Perpendicular(n);
+
+                        //~ Bitangent from the frame, pointing along +v like the face gradients
+                        const Float3 frame = Cross(n, tangent);
+                        const float sign = Dot(frame, bitangentSum[bucket]) < 0.0f ? -1.0f : 1.0f;
+
+                        v.Tangent    = tangent;
+                        v.Bitangent  = Scale(frame, sign);
+                        v.HasTangent = true;
+                    }
+
+                    if (localMixed)
+                        mixed.fetch_add(localMixed, std::memory_order_relaxed);
+                }));
+
+            outMixed += mixed.load();
+            outThreads = used;
+            return true;
+        }
+    }
+
+    bool KFETangentSpace::GenerateNormals(ImportedMesh& mesh, const KFE_TANGENT_SPACE_DESC& desc) noexcept
+    {
+        std::uint32_t threads = 0u;
+        return BuildNormals(mesh, desc, threads);
+    }
+
+    bool KFETangentSpace::GenerateTangents(ImportedMesh& mesh,
+                                           const KFE_TANGENT_SPACE_DESC& desc,
+                                           std::uint64_t* outMixedHandedness) noexcept
+    {
+        std::uint64_t mixed = 0u;
+        std::uint32_t threads = 0u;
+        const bool generated = BuildTangents(mesh, desc, mixed, threads);
+
+        if (outMixedHandedness)
+            *outMixedHandedness += mixed;
+        return generated;
+    }
+
+    void KFETangentSpace::ProcessScene(import::ImportedScene& scene,
+                                       const KFE_TANGENT_SPACE_DESC& desc,
+                                       KFE_TANGENT_SPACE_STATS* outStats) noexcept
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto t0 = Clock::now();
+
+        KFE_TANGENT_SPACE_STATS stats{};
+        stats.ThreadsUsed = 1u;
+
+        for (ImportedMesh& mesh : scene.Meshes)
+        {
+            std::uint32_t threads = 1u;
+            if (desc.bGenerateNormals && BuildNormals(mesh, desc, threads))
+            {
+                ++stats.MeshesWithNormals;
+                stats.NormalsGenerated += mesh.Vertices.size();
+                stats.ThreadsUsed = (std::max)(stats.ThreadsUsed, threads);
+            }
+
+            if (desc.bGenerateTangents && BuildTangents(mesh, desc, stats.MixedHandedness, threads))
+            {
+                ++stats.MeshesWithTangents;
+                stats.TangentsGenerated += mesh.Vertices.size();
+                stats.ThreadsUsed = (std::max)(stats.ThreadsUsed, threads);
+            }
+        }
+
+        stats.Milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        if (stats.MeshesWithNormals || stats.MeshesWithTangents)
+        {
+            LOG_INFO("KFETangentSpace: normals for {} meshes ({} verts), tangents for {} meshes ({} verts, {} mixed), {} threads, {:.2f} ms",
+                stats.MeshesWithNormals, stats.NormalsGenerated,
+                stats.MeshesWithTangents, stats.TangentsGenerated, stats.MixedHandedness,
+                stats.ThreadsUsed, stats.Milliseconds);
+        }
+
+        if (outStats)
+            *outStats = stats;
+    }
+
+    KFE_TANGENT_SPACE_BENCH_RESULT KFETangentSpace::RunBenchmark(std::uint32_t gridSize, std::uint32_t threadCount) noexcept
+    {
+        using Clock = std::chrono::steady_clock;
+
+        KFE_TANGENT_SPACE_BENCH_RESULT result{};
+        if (gridSize < 2u)
+            return result;
+
+        //~ Wavy height field, a dense scan stand in
+        ImportedMesh source{};
+        const std::uint32_t side = gridSize + 1u;
+        source.Vertices.resize(static_cast<std::size_t>(side) * side);
+
+        for (std::uint32_t y = 0; y < side; ++y)
+        {
+            for (std::uint32_t x = 0; x < side; ++x)
+            {
+                const float u = static_cast<float>(x) / gridSize;
+                const float w = static_cast<float>(y) / gridSize;
+
+                ImportedVertex& v = source.Vertices[static_cast<std::size_t>(y) * side + x];
+                v.Position = { u, 0.05f * std::sin(u * 40.0f) * std::cos(w * 30.0f), w };
+                v.UV[0]    = { u, w };
+                v.HasUV[0] = true;
+            }
+        }
+
+        source.Indices.reserve(static_cast<std::size_t>(gridSize) * gridSize * 6u);
+        for (std::uint32_t y = 0; y < gridSize; ++y)
+        {
+            for (std::uint32_t x = 0; x < gridSize; ++x)
+            {
+                const std::uint32_t i0 = y * side + x;
+                const std::uint32_t i1 = i0 + 1u;
+                const std::uint32_t i2 = i0 + side;
+                const std::uint32_t i3 = i2 + 1u;
+                source.Indices.insert(source.Indices.end(), { i0, i2, i1, i1, i2, i3 });
+            }
+        }
+
+        result.TriangleCount = static_cast<std::uint32_t>(source.Indices.size() / 3u);
+
+        KFE_TANGENT_SPACE_DESC single{};
+        single.ThreadCount = 1u;
+
+        KFE_TANGENT_SPACE_DESC multi{};
+        multi.ThreadCount = threadCount;
+        result.ThreadCount = ResolveThreads(multi);
+
+        ImportedMesh a = source;
+        const auto t0 = Clock::now();
+        (void)GenerateNormals(a, single);
+        (void)GenerateTangents(a, single);
+        const auto t1 = Clock::now();
+
+        ImportedMesh b = source;
+        const auto t2 = Clock::now();
+        (void)GenerateNormals(b, multi);
+        (void)GenerateTangents(b, multi);
+        const auto t3 = Clock::now();
+
+        result.SingleThreadMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        result.MultiThreadMs  = std::chrono::duration<double, std::milli>(t3 - t2).count();
+        result.Speedup        = result.MultiThreadMs > 0.0 ? result.SingleThreadMs / result.MultiThreadMs : 0.0;
+        result.bDeterministic = std::memcmp(a.Vertices.data(), b.Vertices.data(),
+            a.Vertices.size() * sizeof(ImportedVertex)) == 0;
+
+        LOG_INFO("KFETangentSpace::RunBenchmark: {} triangles, 1 thread {:.2f} ms, {} threads {:.2f} ms, speedup {:.2f}x, deterministic={}",
+            result.TriangleCount, result.SingleThreadMs, result.ThreadCount, result.MultiThreadMs,
+            result.Speedup, result.bDeterministic);
+
+        return result;
+    }
+}
@@ -0,0 +1,669 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : texture_cooker.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/texture/texture_cooker.h"
+#include "engine/render_manager/assets_library/texture/block_compression.h"
+#include "engine/render_manager/assets_library/texture/mip_generator.h"
+#include "engine/utils/file_system.h"
+#include "engine/utils/logger.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+namespace kfe
+{
+    namespace
+    {
+        inline constexpr std::uint64_t KFTEX_PAYLOAD_ALIGNMENT = 16u;
+
+        static std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment) noexcept
+        {
+            return (value + alignment - 1u) & ~(alignment - 1u);
+        }
+
+        static bool QuerySourceStamp(const std::string& path,
+            std::int64_t& outWriteTime,
+            std::uint64_t& outSize) noexcept
+        {
+            std::error_code ec;
+
+            const auto size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+
+            const auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return false;
+
+            outWriteTime = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+            outSize = static_cast<std::uint64_t>(size);
+            return true;
+        }
+
+        static bool IsRangeInside(std::uint64_t offset, std::uint64_t bytes, std::uint64_t fileSize) noexcept
+        {
+            return offset <= fileSize && bytes <= fileSize - offset;
+        }
+
+        static std::uint32_t CalcMipLevels(std::uint32_t w, std::uint32_t h) noexcept
+        {
+            std::uint32_t levels = 1u;
+            while (w > 1u || h > 1u)
+            {
+                w = (std::max)(1u, w >> 1u);
+                h = (std::max)(1u, h >> 1u);
+                ++levels;
+            }
+            return levels;
+        }
+
+        static std::uint32_t CookFlags(ETextureUsage usage, const KFE_TEXTURE_COOK_DESC& desc) noexcept
+        {
+            std::uint32_t flags = static_cast<std::uint32_t>(desc.MipFilter) << KFE_KFTEX_COOK_MIP_FILTER_SHIFT;
+
+            if ((usage == ETextureUsage::Color || usage == ETextureUsage::Data) && desc.bColorBC7)
+                flags |= KFE_KFTEX_COOK_COLOR_BC7;
+            if (usage == ETextureUsage::Color && desc.bSRGBMips)
+                flags |= KFE_KFTEX_COOK_SRGB_MIPS;
+
+            return flags;
+        }
+
+        static bool IsCookFormat(DXGI_FORMAT format) noexcept
+        {
+            return format == DXGI_FORMAT_R8G8B8A8_UNORM || KFEBlockCompression::GetBlockBytes(format) != 0u;
+        }
+
+        //~ Row layout of one mip as the copy footprint expects it
+        static void MipLayout(DXGI_FORMAT format, std::uint32_t width, std::uint32_t height,
+            std::uint32_t& outRowPitch, std::uint32_t& outRowCount) noexcept
+        {
+            const std::uint32_t blockBytes = KFEBlockCompression::GetBlockBytes(format);
+            if (blockBytes != 0u)
+            {
+                outRowPitch = ((width + 3u) / 4u) * blockBytes;
+                outRowCount = (height + 3u) / 4u;
+                return;
+            }
+
+            outRowPitch = width * 4u;
+            outRowCount = height;
+        }
+
+        static bool DecodeRGBA(const std::string& path, std::vector<std::uint8_t>& outPixels,
+            std::uint32_t& outWidth, std::uint32_t& outHeight) noexcept
+        {
+            KFEMappedFile source{};
+            if (!KFEFileSystem::MapForRead(path, source) || source.GetSize() > static_cast<std::uint64_t>(INT_MAX))
+                return false;
+
+            int width = 0;
+            int height = 0;
+            int comp = 0;
+            stbi_uc* pixels = stbi_load_from_memory(source.GetData(), static_cast<int>(source.GetSize()),
+                &width, &height, &comp, STBI_rgb_alpha);
+            if (!pixels)
+                return false;
+
+            outWidth = static_cast<std::uint32_t>(width);
+            outHeight = static_cast<std::uint32_t>(height);
+            outPixels.assign(pixels, pixels + static_cast<std::size_t>(outWidth) * outHeight * 4u);
+            stbi_image_free(pixels);
+            return true;
+        }
+
+        //~ 32 bit uncompressed, top left origin, BGRA texels
+        static bool WriteTGA(const std::string& path, const std::uint8_t* bgra,
+            std::uint32_t width, std::uint32_t height) noexcept
+        {
+            std::uint8_t header[18]{};
+            header[2]  = 2u;
+            header[12] = static_cast<std::uint8_t>(width & 0xFFu);
+            header[13] = static_cast<std::uint8_t>(width >> 8u);
+            header[14] = static_cast<std::uint8_t>(height & 0xFFu);
+            header[15] = static_cast<std::uint8_t>(height >> 8u);
+            header[16] = 32u;
+            header[17] = 0x28u;
+
+            KFEFileSystem file{};
+            if (!file.OpenForWrite(path))
+                return false;
+
+            const bool ok = file.WriteBytes(header, sizeof(header)) &&
+                file.WriteBytes(bgra, static_cast<std::size_t>(width) * height * 4u);
+            file.Close();
+            return ok;
+        }
+    }
+
+    std::string KFETextureCooker::GetCookedPath(const std::string& sourcePath, ETextureUsage usage)
+    {
+        switch (usage)
+        {
+        case ETextureUsage::Normal: return sourcePath + ".normal" + KFE_KFTEX_EXTENSION;
+        case ETextureUsage::Single: return sourcePath + ".single" + KFE_KFTEX_EXTENSION;
+        case ETextureUsage::Data:   return sourcePath + ".data" + KFE_KFTEX_EXTENSION;
+        default:                    return sourcePath + KFE_KFTEX_EXTENSION;
+        }
+    }
+
+    DXGI_FORMAT KFETextureCooker::SelectFormat(ETextureUsage usage,
+                                               bool bHasAlpha,
+                                               std::uint32_t width,
+                                               std::uint32_t height,
+                                               const KFE_TEXTURE_COOK_DESC& desc) noexcept
+    {
+        //~ D3D12 wants the top level of a BC texture in whole blocks
+        if ((width % 4u) != 0u || (height % 4u) != 0u)
+            return DXGI_FORMAT_R8G8B8A8_UNORM;
+
+        switch (usage)
+        {
+        case ETextureUsage::Normal: return DXGI_FORMAT_BC5_UNORM;
+        case ETextureUsage::Single: return DXGI_FORMAT_BC4_UNORM;
+        default:
+            if (desc.bColorBC7)
+                return DXGI_FORMAT_BC7_UNORM;
+            return bHasAlpha ? DXGI_FORMAT_BC3_UNORM : DXGI_FORMAT_BC1_UNORM;
+        }
+    }
+
+    bool KFETextureCooker::LoadCooked(const std::string& sourcePath,
+                                      ETextureUsage usage,
+                                      const KFE_TEXTURE_COOK_DESC& desc,
+                                      KFE_COOKED_TEXTURE& outTexture) noexcept
+    {
+        outTexture = {};
+
+        const std::string cookedPath = GetCookedPath(sourcePath, usage);
+
+        std::error_code ec;
+        if (!std::filesystem::exists(cookedPath, ec))
+            return false;
+
+        std::int64_t  sourceTime = 0;
+        std::uint64_t sourceSize = 0u;
+        if (!QuerySourceStamp(sourcePath, sourceTime, sourceSize))
+            return false;
+
+        auto mapped = std::make_shared<KFEMappedFile>();
+        if (!mapped->Open(cookedPath))
+        {
+            LOG_WARNING("KFETextureCooker: Failed to map '{}'", cookedPath);
+            return false;
+        }
+
+        const std::uint8_t* base = mapped->GetData();
+        const std::uint64_t fileSize = mapped->GetSize();
+
+        if (fileSize < sizeof(KFE_KFTEX_HEADER))
+        {
+            LOG_WARNING("KFETextureCooker: '{}' is truncated", cookedPath);
+            return false;
+        }
+
+        KFE_KFTEX_HEADER header{};
+        std::memcpy(&header, base, sizeof(header));
+
+        if (header.Magic != KFE_KFTEX_MAGIC || header.Version != KFE_KFTEX_VERSION)
+        {
+            LOG_INFO("KFETextureCooker: '{}' has an old version, recooking", cookedPath);
+            return false;
+        }
+
+        if (header.Usage != static_cast<std::uint32_t>(usage) || header.CookFlags != CookFlags(usage, desc))
+        {
+            LOG_INFO("KFETextureCooker: '{}' was cooked with different settings, recooking", cookedPath);
+            return false;
+        }
+
+        if (header.SourceWriteTime != sourceTime || header.SourceSize != sourceSize)
+        {
+            LOG_INFO("KFETextureCooker: Source '{}' changed since cook, recooking", sourcePath);
+            return false;
+        }
+
+        const auto format = static_cast<DXGI_FORMAT>(header.Format);
+
+        if (header.FileSize != fileSize ||
+            !IsCookFormat(format) ||
+            header.Width == 0u || header.Height == 0u ||
+            header.MipCount == 0u || header.MipCount > CalcMipLevels(header.Width, header.Height) ||
+            !IsRangeInside(header.MipTableOffset,
+                static_cast<std::uint64_t>(header.MipCount) * sizeof(KFE_KFTEX_MIP_RECORD), fileSize) ||
+            (header.MipTableOffset % alignof(KFE_KFTEX_MIP_RECORD)) != 0u)
+        {
+            LOG_WARNING("KFETextureCooker: '{}' has a corrupt header", cookedPath);
+            return false;
+        }
+
+        const auto* records = reinterpret_cast<const KFE_KFTEX_MIP_RECORD*>(base + header.MipTableOffset);
+
+        outTexture.Format = format;
+        outTexture.Usage  = usage;
+        outTexture.Width  = header.Width;
+        outTexture.Height = header.Height;
+        outTexture.Mips.resize(header.MipCount);
+
+        for (std::uint32_t m = 0; m < header.MipCount; ++m)
+        {
+            const KFE_KFTEX_MIP_RECORD& rec = records[m];
+
+            std::uint32_t rowPitch = 0u;
+            std::uint32_t rowCount = 0u;
+            MipLayout(format, rec.Width, rec.Height, rowPitch, rowCount);
+
+            if (rec.Width != (std::max)(1u, header.Width >> m) ||
+                rec.Height != (std::max)(1u, header.Height >> m) ||
+                rec.RowPitch != rowPitch || rec.RowCount != rowCount ||
+                rec.Size != static_cast<std::uint64_t>(rowPitch) * rowCount ||
+                !IsRangeInside(rec.Offset, rec.Size, fileSize))
+            {
+                LOG_WARNING("KFETextureCooker: '{}' mip[{}] is out of bounds", cookedPath, m);
+                outTexture = {};
+                return false;
+            }
+
+            KFE_COOKED_MIP& mip = outTexture.Mips[m];
+            mip.Width    = rec.Width;
+            mip.Height   = rec.Height;
+            mip.RowPitch = rec.RowPitch;
+            mip.RowCount = rec.RowCount;
+            mip.Data     = base + rec.Offset;
+        }
+
+        outTexture.Backing = mapped;
+        return true;
+    }
+
+    bool KFETextureCooker::CookPixels(const std::uint8_t* rgba,
+                                      std::uint32_t width,
+                                      std::uint32_t height,
+                                      ETextureUsage usage,
+                                      const KFE_TEXTURE_COOK_DESC& desc,
+                                      KFE_COOKED_TEXTURE& outTexture) noexcept
+    {
+        outTexture = {};
+
+        if (!rgba || width == 0u || height == 0u)
+            return false;
+
+        bool bHasAlpha = false;
+        if ((usage == ETextureUsage::Color || usage == ETextureUsage::Data) && !desc.bColorBC7)
+        {
+            const std::size_t texels = static_cast<std::size_t>(width) * height;
+            for (std::size_t i = 0; i < texels && !bHasAlpha; ++i)
+                bHasAlpha = rgba[i * 4u + 3u] != 255u;
+        }
+
+        const DXGI_FORMAT format = SelectFormat(usage, bHasAlpha, width, height, desc);
+        const std::uint32_t mipCount = CalcMipLevels(width, height);
+
+        std::uint32_t threads = desc.ThreadCount;
+        if (threads == 0u)
+            threads = (std::max)(1u, std::thread::hardware_concurrency() / 2u);
+
+        //~ One block of memory for every payload, laid out as on disk
+        outTexture.Mips.resize(mipCount);
+        std::vector<std::uint64_t> offsets(mipCount);
+        std::uint64_t total = 0u;
+
+        for (std::uint32_t m = 0; m < mipCount; ++m)
+        {
+            KFE_COOKED_MIP& mip = outTexture.Mips[m];
+            mip.Width  = (std::max)(1u, width >> m);
+            mip.Height = (std::max)(1u, height >> m);
+            MipLayout(format, mip.Width, mip.Height, mip.RowPitch, mip.RowCount);
+
+            offsets[m] = total;
+            total = AlignUp(total + static_cast<std::uint64_t>(mip.RowPitch) * mip.RowCount, KFTEX_PAYLOAD_ALIGNMENT);
+        }
+
+        auto storage = std::make_shared<std::vector<std::uint8_t>>(static_cast<std::size_t>(total));
+
+        KFE_MIP_GEN_DESC mipDesc{};
+        mipDesc.Filter      = desc.MipFilter;
+        mipDesc.bSRGB       = usage == ETextureUsage::Color && desc.bSRGBMips;
+        mipDesc.bNormalMap  = usage == ETextureUsage::Normal;
+        mipDesc.ThreadCount = threads;
+
+        std::vector<KFE_MIP_LEVEL> chain;
+        if (!KFEMipGenerator::GenerateChain(rgba, width, height, mipDesc, chain) || chain.size() + 1u != mipCount)
+        {
+            outTexture = {};
+            return false;
+        }
+
+        for (std::uint32_t m = 0; m < mipCount; ++m)
+        {
+            KFE_COOKED_MIP& mip = outTexture.Mips[m];
+            const std::uint8_t* level = m == 0u ? rgba : chain[m - 1u].Pixels.data();
+
+            std::uint8_t* dst = storage->data() + offsets[m];
+
+            if (format == DXGI_FORMAT_R8G8B8A8_UNORM)
+            {
+                std::memcpy(dst, level, static_cast<std::size_t>(mip.RowPitch) * mip.RowCount);
+            }
+            else if (!KFEBlockCompression::CompressImage(format, level, mip.Width, mip.Height, dst, threads))
+            {
+                outTexture = {};
+                return false;
+            }
+
+            mip.Data = dst;
+        }
+
+        outTexture.Format  = format;
+        outTexture.Usage   = usage;
+        outTexture.Width   = width;
+        outTexture.Height  = height;
+        outTexture.Backing = storage;
+        return true;
+    }
+
+    bool KFETextureCooker::SaveCooked(const std::string& sourcePath,
+                                      const KFE_TEXTURE_COOK_DESC& desc,
+                                      const KFE_COOKED_TEXTURE& texture) noexcept
+    {
+        if (!texture.IsValid())
+        {
+            LOG_ERROR("KFETextureCooker: Nothing to save for '{}'", sourcePath);
+            return false;
+        }
+
+        KFE_KFTEX_HEADER header{};
+        header.Magic     = KFE_KFTEX_MAGIC;
+        header.Version   = KFE_KFTEX_VERSION;
+        header.Usage     = static_cast<std::uint32_t>(texture.Usage);
+        header.Format    = static_cast<std::uint32_t>(texture.Format);
+        header.Width     = texture.Width;
+        header.Height    = texture.Height;
+        header.MipCount  = static_cast<std::uint32_t>(texture.Mips.size());
+        header.CookFlags = CookFlags(texture.Usage, desc);
+
+        if (!QuerySourceStamp(sourcePath, header.SourceWriteTime, header.SourceSize))
+        {
+            LOG_ERROR("KFETextureCooker: Cannot stat source '{}'", sourcePath);
+            return false;
+        }
+
+        //~ Layout
+        std::uint64_t cursor = AlignUp(sizeof(KFE_KFTEX_HEADER), KFTEX_PAYLOAD_ALIGNMENT);
+
+        header.MipTableOffset = cursor;
+        cursor = AlignUp(cursor + texture.Mips.size() * sizeof(KFE_KFTEX_MIP_RECORD), KFTEX_PAYLOAD_ALIGNMENT);
+
+        std::vector<KFE_KFTEX_MIP_RECORD> records(texture.Mips.size());
+        for (std::size_t m = 0; m < texture.Mips.size(); ++m)
+        {
+            const KFE_COOKED_MIP& mip = texture.Mips[m];
+            KFE_KFTEX_MIP_RECORD& rec = records[m];
+
+            rec.Width    = mip.Width;
+            rec.Height   = mip.Height;
+            rec.RowPitch = mip.RowPitch;
+            rec.RowCount = mip.RowCount;
+            rec.Size     = static_cast<std::uint64_t>(mip.RowPitch) * mip.RowCount;
+            rec.Offset   = cursor;
+            cursor = AlignUp(cursor + rec.Size, KFTEX_PAYLOAD_ALIGNMENT);
+        }
+
+        header.FileSize = cursor;
+
+        //~ Write into a temp file then swap, so a crash never leaves a half written cook
+        const std::string cookedPath = GetCookedPath(sourcePath, texture.Usage);
+        const std::string tempPath = cookedPath + ".tmp";
+
+        {
+            KFEFileSystem file{};
+            if (!file.OpenForWrite(tempPath))
+            {
+                LOG_ERROR("KFETextureCooker: Failed to open '{}' for write", tempPath);
+                return false;
+            }
+
+            std::uint64_t written = 0u;
+            static constexpr std::uint8_t zeros[KFTEX_PAYLOAD_ALIGNMENT]{};
+
+            auto WriteAt = [&](std::uint64_t offset, const void* data, std::uint64_t bytes) -> bool
+                {
+                    while (written < offset)
+                    {
+                        const std::uint64_t pad = std::min<std::uint64_t>(offset - written, sizeof(zeros));
+                        if (!file.WriteBytes(zeros, static_cast<size_t>(pad)))
+                            return false;
+                        written += pad;
+                    }
+
+                    if (bytes == 0u)
+                        return true;
+
+                    if (!file.WriteBytes(data, static_cast<size_t>(bytes)))
+                        return false;
+
+                    written += bytes;
+                    return true;
+                };
+
+            bool ok = WriteAt(0u, &header, sizeof(header));
+            ok = ok && WriteAt(header.MipTableOffset, records.data(),
+                records.size() * sizeof(KFE_KFTEX_MIP_RECORD));
+
+            for (std::size_t m = 0; ok && m < records.size(); ++m)
+                ok = WriteAt(records[m].Offset, texture.Mips[m].Data, records[m].Size);
+
+            ok = ok && WriteAt(header.FileSize, nullptr, 0u);
+            file.Close();
+
+            if (!ok)
+            {
+                LOG_ERROR("KFETextureCooker: Failed writing '{}'", tempPath);
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, cookedPath, ec);
+        if (ec)
+        {
+            LOG_WARNING("KFETextureCooker: Failed to replace '{}': {}", cookedPath, ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        LOG_INFO("KFETextureCooker: Cooked '{}' ({}x{}, mips={}, format={}, bytes={})",
+            cookedPath, header.Width, header.Height, header.MipCount, header.Format, header.FileSize);
+
+        return true;
+    }
+
+    bool KFETextureCooker::CookFile(const std::string& sourcePath,
+                                    ETextureUsage usage,
+                                    const KFE_TEXTURE_COOK_DESC& desc) noexcept
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        int width = 0;
+        int height = 0;
+        int comp = 0;
+
+        KFEMappedFile source{};
+        if (!KFEFileSystem::MapForRead(sourcePath, source) || source.GetSize() > static_cast<std::uint64_t>(INT_MAX))
+        {
+            LOG_ERROR("KFETextureCooker: Failed to map '{}'", sourcePath);
+            return false;
+        }
+
+        stbi_uc* pixels = stbi_load_from_memory(source.GetData(), static_cast<int>(source.GetSize()),
+            &width, &height, &comp, STBI_rgb_alpha);
+        source.Close();
+        if (!pixels)
+        {
+            LOG_ERROR("KFETextureCooker: stb_image failed to load '{}'", sourcePath);
+            return false;
+        }
+
+        KFE_COOKED_TEXTURE texture{};
+        const bool cooked = CookPixels(pixels, static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height),
+            usage, desc, texture);
+        stbi_image_free(pixels);
+
+        if (!cooked)
+        {
+            LOG_ERROR("KFETextureCooker: Failed to cook '{}'", sourcePath);
+            return false;
+        }
+
+        if (!SaveCooked(sourcePath, desc, texture))
+            return false;
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("KFETextureCooker: '{}' took {:.1f} ms", sourcePath, ms);
+        return true;
+    }
+
+    std::string KFETextureCooker::GetPackedORMPath(const KFE_ORM_SOURCES& sources)
+    {
+        namespace fs = std::filesystem;
+
+        const std::string occ = fs::path(sources.Occlusion).stem().string();
+        const std::string rough = fs::path(sources.Roughness).stem().string();
+        const std::string metal = fs::path(sources.Metallic).stem().string();
+
+        //~ "cloth_Occlusion", "cloth_Roughness", "cloth_Metallic" -> "cloth"
+        std::size_t common = 0u;
+        while (common < occ.size() && common < rough.size() && common < metal.size() &&
+            occ[common] == rough[common] && occ[common] == metal[common])
+            ++common;
+
+        std::string stem = occ.substr(0u, common);
+        while (!stem.empty() && (stem.back() == '_' || stem.back() == '-' || stem.back() == '.' || stem.back() == ' '))
+            stem.pop_back();
+
+        if (stem.empty())
+            stem = "material";
+
+        //~ Another triplet with the same stem in the same folder gets its own file
+        const std::size_t key = std::hash<std::string>{}(sources.Occlusion + '|' + sources.Roughness + '|' + sources.Metallic);
+        const std::string name = std::format("{}_ORM_{:08x}.tga", stem, static_cast<std::uint32_t>(key));
+
+        return (fs::path(sources.Occlusion).parent_path() / name).generic_string();
+    }
+
+    bool KFETextureCooker::PackORM(const KFE_ORM_SOURCES& sources, std::string& outPath) noexcept
+    {
+        namespace fs = std::filesystem;
+
+        outPath.clear();
+
+        const std::string packedPath = GetPackedORMPath(sources);
+        const std::string* inputs[3] = { &sources.Occlusion, &sources.Roughness, &sources.Metallic };
+
+        std::error_code ec;
+        fs::file_time_type newest{};
+        for (const std::string* input : inputs)
+        {
+            const auto time = fs::last_write_time(*input, ec);
+            if (ec)
+                return false;
+            newest = (std::max)(newest, time);
+        }
+
+        const auto packedTime = fs::last_write_time(packedPath, ec);
+        if (!ec && packedTime >= newest)
+        {
+            outPath = packedPath;
+            return true;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::uint8_t> maps[3];
+        std::uint32_t width = 0u;
+        std::uint32_t height = 0u;
+
+        for (std::size_t i = 0; i < 3u; ++i)
+        {
+            std::uint32_t w = 0u;
+            std::uint32_t h = 0u;
+            if (!DecodeRGBA(*inputs[i], maps[i], w, h))
+            {
+                LOG_WARNING("KFETextureCooker: Cannot decode '{}' for ORM packing", *inputs[i]);
+                return false;
+            }
+
+            if (i == 0u)
+            {
+                width = w;
+                height = h;
+            }
+            else if (w != width || h != height)
+            {
+                LOG_INFO("KFETextureCooker: '{}' is {}x{}, '{}' is {}x{}, not packing ORM",
+                    *inputs[i], w, h, *inputs[0], width, height);
+                return false;
+            }
+        }
+
+        if (width > 0xFFFFu || height > 0xFFFFu)
+        {
+            LOG_INFO("KFETextureCooker: {}x{} is too large for a packed ORM", width, height);
+            return false;
+        }
+
+        //~ TGA texels are BGRA
+        const std::size_t texels = static_cast<std::size_t>(width) * height;
+        std::vector<std::uint8_t> packed(texels * 4u);
+        for (std::size_t t = 0; t < texels; ++t)
+        {
+            packed[t * 4u + 0u] = maps[2][t * 4u];
+            packed[t * 4u + 1u] = maps[1][t * 4u];
+            packed[t * 4u + 2u] = maps[0][t * 4u];
+            packed[t * 4u + 3u] = 255u;
+        }
+
+        //~ Temp file then swap, as with the cooked files
+        const std::string tempPath = packedPath + ".tmp";
+        if (!WriteTGA(tempPath, packed.data(), width, height))
+        {
+            LOG_ERROR("KFETextureCooker: Failed writing '{}'", tempPath);
+            fs::remove(tempPath, ec);
+            return false;
+        }
+
+        fs::rename(tempPath, packedPath, ec);
+        if (ec)
+        {
+            LOG_WARNING("KFETextureCooker: Failed to replace '{}': {}", packedPath, ec.message());
+            fs::remove(tempPath, ec);
+            return false;
+        }
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("KFETextureCooker: Packed ORM '{}' ({}x{}) in {:.1f} ms", packedPath, width, height, ms);
+
+        outPath = packedPath;
+        return true;
+    }
+}
@@ -9,12 +9,21 @@
 #include "engine/render_manager/api/buffer/buffer.h"
 #include "engine/utils/logger.h"
 #include "engine/utils/helpers.h"
+#include "engine/utils/file_system.h"
 
 #include "engine/render_manager/assets_library/shader_library.h"
+#include "engine/render_manager/assets_library/texture/mip_generator.h"
+#include "engine/render_manager/assets_library/texture/block_compression.h"
 
 #include <d3d12.h>
 #include <dxgiformat.h>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
 #include <wrl/client.h>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -37,6 +46,20 @@ namespace
         return levels;
     }
 
+    //~ RGBA8 with the full chain, what an uncooked load keeps resident
+    static std::uint64_t CalcChainBytes(std::uint32_t w, std::uint32_t h) noexcept
+    {
+        std::uint64_t bytes = 0u;
+        for (;;)
+        {
+            bytes += static_cast<std::uint64_t>(w) * h * 4u;
+            if (w == 1u && h == 1u)
+                return bytes;
+            w = std::max(1u, w >> 1u);
+            h = std::max(1u, h >> 1u);
+        }
+    }
+
     struct MipGenConstants
     {
         UINT SrcWidth;
@@ -45,6 +68,72 @@ namespace
         UINT DstHeight;
     };
 
+    //~ Same multiply-xorshift as the mesh cache, a hit is confirmed by comparing bytes
+    static std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed) noexcept
+    {
+        constexpr std::uint64_t kMul = 0x9E3779B97F4A7C15ull;
+
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        std::uint64_t h = seed ^ (size * kMul);
+
+        std::size_t i = 0u;
+        for (; i + 8u <= size; i += 8u)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            h = (h ^ word) * kMul;
+            h ^= h >> 29;
+        }
+
+        std::uint64_t tail = 0u;
+        if (i < size)
+            std::memcpy(&tail, bytes + i, size - i);
+        h = (h ^ tail) * kMul;
+        h ^= h >> 32;
+        return h;
+    }
+
+    //~ Seeded with the usage, the same file as colour and as normal map are two textures.
+    //~ 0 when the file cannot be read.
+    static std::uint64_t HashFile(const std::string& path, ETextureUsage usage) noexcept
+    {
+        KFEMappedFile file;
+        if (!file.Open(path) || file.GetSize() == 0u)
+            return 0u;
+
+        const std::uint64_t h = HashBytes(file.GetData(),
+            static_cast<std::size_t>(file.GetSize()),
+            static_cast<std::uint64_t>(usage) + 1u);
+        return h ? h : 1u;
+    }
+
+    static bool SameFileBytes(const std::string& a, const std::string& b) noexcept
+    {
+        KFEMappedFile fa;
+        KFEMappedFile fb;
+        if (!fa.Open(a) || !fb.Open(b) || fa.GetSize() != fb.GetSize())
+            return false;
+
+        return std::memcmp(fa.GetData(), fb.GetData(), static_cast<std::size_t>(fa.GetSize())) == 0;
+    }
+
+    //~ Colour keeps the plain path so existing lookups by path still hit
+    static std::string MakePoolKey(const std::string& path, ETextureUsage usage)
+    {
+        switch (usage)
+        {
+        case ETextureUsage::Normal: return path + "|normal";
+        case ETextureUsage::Single: return path + "|single";
+        case ETextureUsage::Data:   return path + "|data";
+        default:                    return path;
+        }
+    }
+
+    static std::string MakeORMKey(const KFE_ORM_SOURCES& sources)
+    {
+        return sources.Occlusion + '|' + sources.Roughness + '|' + sources.Metallic;
+    }
+
     inline UINT CalcSubresourceIndex(
         UINT mipSlice,
         UINT arraySlice,
@@ -120,7 +209,8 @@ bool KFEImagePool::IsInitialized() const noexcept
 _Use_decl_annotations_
 KFETextureSRV* KFEImagePool::GetImageSrv(
     const std::string& path,
-    ID3D12GraphicsCommandList* cmdList)
+    ID3D12GraphicsCommandList* cmdList,
+    ETextureUsage usage)
 {
     if (!m_bInitialized)
     {
@@ -140,21 +230,53 @@ KFETextureSRV* KFEImagePool::GetImageSrv(
         return nullptr;
     }
 
-    auto it = m_imagePool.find(path);
+    const std::string key = MakePoolKey(CanonicalPath(path), usage);
+
+    if (const auto alias = m_keyAliases.find(key); alias != m_keyAliases.end())
+    {
+        const auto owner = m_imagePool.find(alias->second);
+        if (owner != m_imagePool.end())
+        {
+            if (KFETextureSRV* srv = GetSrvOf(owner->second))
+            {
+                ++m_dedupHits;
+                return srv;
+            }
+        }
+
+        //~ Owner is gone, load the path as its own texture
+        m_keyAliases.erase(alias);
+    }
+
+    auto it = m_imagePool.find(key);
     if (it != m_imagePool.end())
     {
-        if (it->second.Srv)
-            return it->second.Srv.get();
+        if (KFETextureSRV* srv = GetSrvOf(it->second))
+            return srv;
 
         LOG_WARNING("KFEImagePool::GetImageSrv: Entry exists but SRV is null. Reloading: {}", path);
+        it->second.Residency.Reset();
         if (!LoadTextureInternal(path, cmdList, it->second))
             return nullptr;
 
-        return it->second.Srv.get();
+        //~ Size and streaming may differ from the old load, register again like Reload
+        TrackResidency(it->second);
+        return GetSrvOf(it->second);
+    }
+
+    std::uint64_t hash = 0u;
+    if (const std::string* owner = FindContentOwner(path, usage, hash))
+    {
+        const std::string ownerKey = *owner;
+        AddAlias(key, ownerKey);
+        ++m_dedupHits;
+        return GetSrvOf(m_imagePool.at(ownerKey));
     }
 
     TextureData data{};
     data.Name = path;
+    data.Usage = usage;
+    data.ContentHash = hash;
 
     if (!LoadTextureInternal(path, cmdList, data))
     {
@@ -162,30 +284,48 @@ KFETextureSRV* KFEImagePool::GetImageSrv(
         return nullptr;
     }
 
-    auto [iter, inserted] = m_imagePool.emplace(path, std::move(data));
+    auto [iter, inserted] = m_imagePool.emplace(key, std::move(data));
     if (!inserted)
     {
         LOG_WARNING("KFEImagePool::GetImageSrv: Emplace failed, updating existing entry for '{}'.", path);
     }
 
-    return iter->second.Srv.get();
+    if (hash)
+        m_contentOwners.emplace(hash, key);
+
+    TrackResidency(iter->second);
+    return GetSrvOf(iter->second);
 }
 
 _Use_decl_annotations_
-KFETexture* KFEImagePool::GetTexture(const std::string& path) noexcept
+KFETexture* KFEImagePool::GetTexture(const std::string& path, ETextureUsage usage) noexcept
 {
-    auto it = m_imagePool.find(path);
+    auto it = m_imagePool.find(ResolveKey(path, usage));
     if (it == m_imagePool.end())
         return nullptr;
 
-    if (!it->second.Staging)
+    const TextureData& data = it->second;
+    if (data.ArrayPage < m_arrayPages.size())
+        return m_arrayPages[data.ArrayPage].Staging->GetTexture();
+
+    if (!data.Staging)
         return nullptr;
 
-    return it->second.Staging->GetTexture();
+    return data.Staging->GetTexture();
+}
+
+_Use_decl_annotations_
+std::uint32_t KFEImagePool::GetArraySlice(const std::string& path, ETextureUsage usage) const noexcept
+{
+    const auto it = m_imagePool.find(ResolveKey(path, usage));
+    if (it == m_imagePool.end() || it->second.ArrayPage == KFE_INVALID_INDEX)
+        return 0u;
+
+    return it->second.ArraySlice;
 }
 
 _Use_decl_annotations_
-bool KFEImagePool::Reload(const std::string& path, ID3D12GraphicsCommandList* cmdList)
+bool KFEImagePool::Reload(const std::string& path, ID3D12GraphicsCommandList* cmdList, ETextureUsage usage)
 {
     if (!m_bInitialized)
     {
@@ -199,26 +339,35 @@ bool KFEImagePool::Reload(const std::string& path, ID3D12GraphicsCommandList* cm
         return false;
     }
 
-    auto it = m_imagePool.find(path);
+    const std::string key = MakePoolKey(CanonicalPath(path), usage);
+
+    //~ A duplicate path gets its own load, its bytes may differ from the owner's now
+    if (m_keyAliases.erase(key) != 0u)
+        return GetImageSrv(path, cmdList, usage) != nullptr;
+
+    auto it = m_imagePool.find(key);
     if (it == m_imagePool.end())
     {
-        return GetImageSrv(path, cmdList) != nullptr;
+        return GetImageSrv(path, cmdList, usage) != nullptr;
     }
 
     TextureData& data = it->second;
+    ForgetContent(key);
 
     if (data.Srv && data.Srv->IsInitialize())
     {
-        if (!data.Staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+        if (!data.Staging->Destroy()) LOG_ERROR("KFEImagePool::Reload: Failed to destroy the staging texture of '{}'.", path);
     }
 
     if (data.Staging && data.Staging->IsInitialized())
     {
-        if (!data.Staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+        if (!data.Staging->Destroy()) LOG_ERROR("KFEImagePool::Reload: Failed to destroy the staging texture of '{}'.", path);
     }
 
     data.Srv.reset();
     data.Staging.reset();
+    data.Residency.Reset();
+    ReleasePacked(data);
     data.Name = path;
 
     if (!LoadTextureInternal(path, cmdList, data))
@@ -227,6 +376,11 @@ bool KFEImagePool::Reload(const std::string& path, ID3D12GraphicsCommandList* cm
         return false;
     }
 
+    data.ContentHash = m_bContentDedup ? HashFile(path, usage) : 0u;
+    if (data.ContentHash)
+        m_contentOwners.emplace(data.ContentHash, key);
+
+    TrackResidency(data);
     LOG_SUCCESS("KFEImagePool::Reload: Reloaded texture '{}'.", path);
     return true;
 }
@@ -237,12 +391,12 @@ void KFEImagePool::Clear() noexcept
     {
         if (data.Srv && data.Srv->IsInitialize())
         {
-            if (!data.Staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+            if (!data.Staging->Destroy()) LOG_ERROR("KFEImagePool::Clear: Failed to destroy the staging texture of '{}'.", key);
         }
 
         if (data.Staging && data.Staging->IsInitialized())
         {
-            if (!data.Staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+            if (!data.Staging->Destroy()) LOG_ERROR("KFEImagePool::Clear: Failed to destroy the staging texture of '{}'.", key);
         }
 
         data.Srv.reset();
@@ -250,6 +404,33 @@ void KFEImagePool::Clear() noexcept
     }
 
     m_imagePool.clear();
+    m_keyAliases.clear();
+    m_contentOwners.clear();
+    m_canonicalPaths.clear();
+    m_dedupHits = 0u;
+
+    for (ArrayPage& page : m_arrayPages)
+    {
+        if (page.Srv && page.Srv->IsInitialize())
+        {
+            if (!page.Srv->Destroy()) LOG_ERROR("KFEImagePool::Clear: Failed to free an array SRV.");
+        }
+
+        if (page.Staging && page.Staging->IsInitialized())
+        {
+            if (!page.Staging->Destroy()) LOG_ERROR("KFEImagePool::Clear: Failed to destroy an array page staging texture.");
+        }
+    }
+    m_arrayPages.clear();
+
+    RetireCompleted(UINT64_MAX);
+    m_streamSlots.clear();
+    m_streamStats = {};
+
+    std::lock_guard<std::mutex> lock(m_pageInMutex);
+    m_pageInJobs.clear();
+    m_pageInQueued.clear();
+    m_pagedIn.clear();
 }
 
 _Use_decl_annotations_
@@ -258,6 +439,446 @@ std::size_t KFEImagePool::GetTextureCount() const noexcept
     return m_imagePool.size();
 }
 
+_Use_decl_annotations_
+std::uint32_t KFEImagePool::Prefetch(
+    const std::vector<KFE_IMAGE_REQUEST>& requests,
+    ID3D12GraphicsCommandList* cmdList)
+{
+    if (!m_bInitialized)
+    {
+        LOG_ERROR("KFEImagePool::Prefetch: Image pool is not initialized.");
+        return 0u;
+    }
+
+    if (!cmdList)
+    {
+        LOG_ERROR("KFEImagePool::Prefetch: Command list is null.");
+        return 0u;
+    }
+
+    struct PrefetchJob
+    {
+        std::string   Key;
+        std::string   Path;
+        ETextureUsage Usage = ETextureUsage::Color;
+        std::uint64_t ContentHash = 0u;
+        DecodedImage  Image{};
+        bool          bDecoded = false;
+    };
+
+    std::vector<PrefetchJob> jobs;
+    jobs.reserve(requests.size());
+
+    std::uint32_t resident = 0u;
+    std::unordered_set<std::string> seen;
+
+    //~ Same bytes as an earlier job of this batch: key -> job index
+    std::unordered_map<std::uint64_t, std::size_t>   batchOwners;
+    std::vector<std::pair<std::string, std::size_t>> batchAliases;
+
+    for (const auto& request : requests)
+    {
+        if (request.Path.empty())
+            continue;
+
+        std::string key = ResolveKey(request.Path, request.Usage);
+        if (!seen.insert(key).second)
+            continue;
+
+        auto it = m_imagePool.find(key);
+        if (it != m_imagePool.end() && GetSrvOf(it->second))
+        {
+            ++resident;
+            continue;
+        }
+
+        std::uint64_t hash = 0u;
+        if (const std::string* owner = FindContentOwner(request.Path, request.Usage, hash))
+        {
+            AddAlias(key, *owner);
+            ++resident;
+            continue;
+        }
+
+        if (hash)
+        {
+            const auto [batchOwner, inserted] = batchOwners.emplace(hash, jobs.size());
+            if (!inserted && SameFileBytes(request.Path, jobs[batchOwner->second].Path))
+            {
+                batchAliases.emplace_back(std::move(key), batchOwner->second);
+                continue;
+            }
+        }
+
+        PrefetchJob job{};
+        job.Key = std::move(key);
+        job.Path = request.Path;
+        job.Usage = request.Usage;
+        job.ContentHash = hash;
+        jobs.emplace_back(std::move(job));
+    }
+
+    if (jobs.empty())
+        return resident;
+
+    std::atomic<std::uint32_t> next{ 0u };
+
+    auto Worker = [&]() noexcept
+        {
+            for (;;)
+            {
+                const std::uint32_t index = next.fetch_add(1u, std::memory_order_relaxed);
+                if (index >= jobs.size())
+                    return;
+
+                PrefetchJob& job = jobs[index];
+                job.bDecoded = DecodeImage(job.Path, job.Usage, job.Image);
+            }
+        };
+
+    //~ Decoding is the slow part and needs no device, the calling thread works too
+    const std::uint32_t hardware = (std::max)(1u, std::thread::hardware_concurrency());
+    const std::uint32_t workerCount = (std::min)(hardware, static_cast<std::uint32_t>(jobs.size()));
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(workerCount - 1u);
+
+        for (std::uint32_t i = 1u; i < workerCount; ++i)
+            workers.emplace_back(Worker);
+
+        Worker();
+    }   //~ joined here
+
+    //~ Uploads touch the device, the heaps and the list: one batch on this thread
+    std::uint32_t uploaded = 0u;
+    for (auto& job : jobs)
+    {
+        if (!job.bDecoded)
+            continue;
+
+        auto it = m_imagePool.find(job.Key);
+        if (it == m_imagePool.end())
+        {
+            TextureData data{};
+            data.Name = job.Path;
+            data.Usage = job.Usage;
+            it = m_imagePool.emplace(job.Key, std::move(data)).first;
+        }
+
+        if (!UploadDecoded(job.Path, job.Image, cmdList, it->second))
+        {
+            LOG_ERROR("KFEImagePool::Prefetch: Failed to upload '{}'.", job.Path);
+            m_imagePool.erase(it);
+            continue;
+        }
+
+        job.Image = {};  //~ drop the pixels and the mapping as we go
+        ++uploaded;
+
+        it->second.ContentHash = job.ContentHash;
+        if (job.ContentHash)
+            m_contentOwners.emplace(job.ContentHash, job.Key);
+
+        TrackResidency(it->second);
+    }
+
+    for (const auto& [key, jobIndex] : batchAliases)
+    {
+        if (!m_imagePool.contains(jobs[jobIndex].Key))
+            continue;
+
+        AddAlias(key, jobs[jobIndex].Key);
+        ++resident;
+    }
+
+    LOG_INFO("KFEImagePool::Prefetch: Uploaded {}/{} textures decoded on {} workers",
+        uploaded,
+        static_cast<std::uint32_t>(jobs.size()),
+        workerCount);
+
+    return resident + uploaded;
+}
+
+_Use_decl_annotations_
+EPackedORMState KFEImagePool::RequestPackedORM(const KFE_ORM_SOURCES& sources, std::string& outPath)
+{
+    outPath.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(m_cookMutex);
+
+        const auto [it, bInserted] = m_ormPacks.try_emplace(MakeORMKey(sources));
+        if (!bInserted)
+        {
+            if (it->second.State == EPackedORMState::Ready)
+                outPath = it->second.Path;
+            return it->second.State;
+        }
+
+        m_ormJobs.push_back(sources);
+
+        if (!m_cookWorker.joinable())
+            m_cookWorker = std::jthread([this](std::stop_token stop) { CookWorker(stop); });
+    }
+
+    m_cookCv.notify_one();
+    return EPackedORMState::Pending;
+}
+
+void KFEImagePool::SetTextureCooking(bool enabled, const KFE_TEXTURE_COOK_DESC& desc) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_cookMutex);
+    m_bCookTextures = enabled;
+    m_cookDesc = desc;
+}
+
+void KFEImagePool::SetTexturePacking(const KFE_TEXTURE_PACKING_DESC& desc) noexcept
+{
+    m_packDesc = desc;
+}
+
+KFE_TEXTURE_PACKING_STATS KFEImagePool::GetPackingStats() const noexcept
+{
+    KFE_TEXTURE_PACKING_STATS stats{};
+    stats.ArrayCount = static_cast<std::uint32_t>(m_arrayPages.size());
+
+    for (const ArrayPage& page : m_arrayPages)
+    {
+        for (const std::uint8_t used : page.Used)
+        {
+            if (used) ++stats.PackedTextures;
+            else      ++stats.FreeSlices;
+        }
+    }
+    return stats;
+}
+
+void KFEImagePool::SetContentDedup(bool enabled) noexcept
+{
+    m_bContentDedup = enabled;
+}
+
+KFE_TEXTURE_DEDUP_STATS KFEImagePool::GetDedupStats() const noexcept
+{
+    KFE_TEXTURE_DEDUP_STATS stats{};
+    stats.UniqueTextures = static_cast<std::uint32_t>(m_imagePool.size());
+    stats.DuplicatePaths = static_cast<std::uint32_t>(m_keyAliases.size());
+    stats.DuplicateHits = m_dedupHits;
+
+    for (const auto& [key, ownerKey] : m_keyAliases)
+    {
+        const auto owner = m_imagePool.find(ownerKey);
+        if (owner != m_imagePool.end())
+            stats.BytesSaved += owner->second.ResidentBytes;
+    }
+    return stats;
+}
+
+_Use_decl_annotations_
+std::string KFEImagePool::NormalizePath(const std::string& path)
+{
+    namespace fs = std::filesystem;
+
+    //~ weakly_canonical resolves what exists and keeps the rest lexical
+    std::error_code ec;
+    fs::path normal = fs::weakly_canonical(fs::path(path), ec);
+    if (ec || normal.empty())
+        normal = fs::path(path).lexically_normal();
+
+    std::string out = normal.generic_string();
+
+#if defined(_WIN32)
+    std::transform(out.begin(), out.end(), out.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+#endif
+
+    return out;
+}
+
+void KFEImagePool::SetTextureStreaming(const KFE_TEXTURE_STREAMING_DESC& desc) noexcept
+{
+    m_streamDesc = desc;
+}
+
+KFE_TEXTURE_STREAMING_STATS KFEImagePool::GetStreamingStats() const noexcept
+{
+    return m_streamStats;
+}
+
+_Use_decl_annotations_
+std::uint32_t KFEImagePool::GetStreamHandle(const std::string& path, ETextureUsage usage) const noexcept
+{
+    const auto it = m_imagePool.find(ResolveKey(path, usage));
+    if (it == m_imagePool.end() || !it->second.Stream.IsValid())
+        return KFE_INVALID_INDEX;
+
+    return it->second.StreamHandle;
+}
+
+_Use_decl_annotations_
+void KFEImagePool::ReportTextureUse(std::uint32_t streamHandle, float screenPixels) noexcept
+{
+    if (streamHandle >= m_streamSlots.size())
+        return;
+
+    StreamSlot& slot = m_streamSlots[streamHandle];
+    slot.FramePixels = std::max(slot.FramePixels, screenPixels);
+}
+
+_Use_decl_annotations_
+void KFEImagePool::UpdateStreaming(ID3D12GraphicsCommandList* cmdList, ID3D12Fence* fence, std::uint64_t fenceValue)
+{
+    if (!m_bInitialized || !cmdList || !fence)
+        return;
+
+    RetireCompleted(fence->GetCompletedValue());
+    RecordPackedUploads(cmdList);
+
+    if (!m_streamDesc.bEnabled)
+        return;
+
+    ++m_streamFrame;
+
+    std::vector<KFE_STREAMING_CANDIDATE> candidates;
+    std::vector<TextureData*>            streamed;
+    std::uint64_t                        fixedBytes = 0u;
+    std::uint64_t                        wantedBytes = 0u;
+
+    for (auto& [key, data] : m_imagePool)
+    {
+        if (!data.Stream.IsValid() || data.StreamHandle >= m_streamSlots.size())
+        {
+            fixedBytes += data.ResidentBytes;
+            continue;
+        }
+
+        //~ A finer request replaces the held one at once, a coarser one only after it lingered
+        StreamSlot& slot = m_streamSlots[data.StreamHandle];
+        if (slot.FramePixels > 0.0f)
+            data.Residency.Touch();
+
+        if (slot.FramePixels >= slot.HeldPixels || m_streamFrame - slot.HeldFrame > m_streamDesc.LingerFrames)
+        {
+            slot.HeldPixels = slot.FramePixels;
+            slot.HeldFrame = m_streamFrame;
+        }
+        slot.FramePixels = 0.0f;
+
+        KFE_STREAMING_CANDIDATE candidate{};
+        candidate.MipBytes = data.MipBytes;
+        candidate.InitialMip = data.InitialMip;
+        candidate.TopSize = std::max(data.Stream.Width, data.Stream.Height);
+        candidate.Width = data.Stream.Width;
+        candidate.Height = data.Stream.Height;
+        candidate.bBlockCompressed = KFEBlockCompression::GetBlockBytes(data.Stream.Format) != 0u;
+        candidate.ScreenPixels = slot.HeldPixels;
+        candidate.WantedMip = KFETextureStreaming::ComputeWantedMip(
+            candidate.TopSize,
+            static_cast<std::uint32_t>(data.MipBytes.size()),
+            slot.HeldPixels,
+            m_streamDesc.TexelsPerPixel);
+
+        wantedBytes += KFETextureStreaming::SumMipBytes(data.MipBytes, std::min(candidate.WantedMip, data.InitialMip));
+
+        candidates.push_back(candidate);
+        streamed.push_back(&data);
+    }
+
+    //~ The global budget shrinks with whatever meshes and render targets hold
+    const std::uint64_t budgetBytes = std::min(
+        m_streamDesc.BudgetBytes,
+        KFEResidencyManager::Instance().GetBudgetFor(EResidencyCategory::Texture));
+
+    std::vector<std::uint32_t> targets;
+    KFETextureStreaming::Arbitrate(candidates, budgetBytes, fixedBytes, targets);
+
+    //~ Downgrades first to free memory, then upgrades from the largest on screen
+    std::vector<std::size_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), std::size_t{ 0 });
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+        {
+            const bool downA = targets[a] > streamed[a]->ResidentMip;
+            const bool downB = targets[b] > streamed[b]->ResidentMip;
+            if (downA != downB)
+                return downA;
+            return candidates[a].ScreenPixels > candidates[b].ScreenPixels;
+        });
+
+    std::uint32_t updates = 0u;
+    std::uint32_t pending = 0u;
+    std::uint64_t uploadBytes = 0u;
+
+    for (const std::size_t i : order)
+    {
+        TextureData& data = *streamed[i];
+        const std::uint32_t target = targets[i];
+        if (target == data.ResidentMip)
+            continue;
+
+        ++pending;
+        if (updates >= m_streamDesc.MaxUpdatesPerFrame)
+            continue;
+
+        const std::uint64_t bytes = KFETextureStreaming::SumMipBytes(data.MipBytes, target);
+        if (uploadBytes > 0u && uploadBytes + bytes > m_streamDesc.MaxUploadBytesPerFrame)
+            continue;
+
+        const bool bUpgrade = target < data.ResidentMip;
+        if (bUpgrade)
+        {
+            //~ Finer mips are read from the mapping, fault them in on the worker first
+            bool bPagedIn = false;
+            {
+                std::lock_guard<std::mutex> lock(m_pageInMutex);
+                const auto it = m_pagedIn.find(data.StreamHandle);
+                bPagedIn = it != m_pagedIn.end() && it->second <= target;
+            }
+
+            if (!bPagedIn)
+            {
+                QueuePageIn(data.StreamHandle, data, target);
+                continue;
+            }
+        }
+
+        TextureData fresh{};
+        fresh.Usage = data.Usage;
+        if (!UploadCookedRange(data.Name, data.Stream, target, cmdList, fresh))
+            continue;
+
+        //~ The old view may still be bound by this frame or the last one
+        m_retired.push_back(RetiredTexture{ std::move(data.Staging), std::move(data.Srv), fenceValue });
+
+        data.Staging = std::move(fresh.Staging);
+        data.Srv = std::move(fresh.Srv);
+        data.Width = fresh.Width;
+        data.Height = fresh.Height;
+        data.Mips = fresh.Mips;
+        data.ResidentMip = target;
+        data.ResidentBytes = KFETextureStreaming::SumMipBytes(data.MipBytes, target);
+        data.Residency.Resize(data.ResidentBytes);
+
+        ++m_residencyGeneration;
+        ++updates;
+        --pending;
+        uploadBytes += bytes;
+
+        if (bUpgrade) ++m_streamStats.Upgrades;
+        else          ++m_streamStats.Downgrades;
+    }
+
+    std::uint64_t residentBytes = fixedBytes;
+    for (const TextureData* data : streamed)
+        residentBytes += data->ResidentBytes;
+
+    m_streamStats.BudgetBytes = budgetBytes;
+    m_streamStats.ResidentBytes = residentBytes;
+    m_streamStats.WantedBytes = fixedBytes + wantedBytes;
+    m_streamStats.StreamedTextures = static_cast<std::uint32_t>(streamed.size());
+    m_streamStats.PendingUpdates = pending;
+}
+
 #pragma endregion
 
 #pragma region Internal_Load
@@ -286,23 +907,135 @@ bool KFEImagePool::LoadTextureInternal(
         return false;
     }
 
+    DecodedImage image{};
+    if (!DecodeImage(path, outData.Usage, image))
+        return false;
+
+    return UploadDecoded(path, image, cmdList, outData);
+}
+
+_Use_decl_annotations_
+bool KFEImagePool::DecodeImage(
+    const std::string& path,
+    ETextureUsage usage,
+    DecodedImage& outImage,
+    bool bAllowCooked) noexcept
+{
+    KFE_TEXTURE_COOK_DESC cookDesc{};
+    {
+        std::lock_guard<std::mutex> lock(m_cookMutex);
+        outImage.bCook = m_bCookTextures;
+        cookDesc = m_cookDesc;
+    }
+
+    //~ Cooked file first, the source only when it is missing or stale
+    if (outImage.bCook && bAllowCooked && KFETextureCooker::LoadCooked(path, usage, cookDesc, outImage.Cooked))
+        return true;
+
+    outImage.Cooked = {};
+
     int width = 0;
     int height = 0;
     int comp = 0;
 
-    stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &comp, STBI_rgb_alpha);
+    //~ Decoded from the mapped file, stb_image buffers nothing of its own
+    KFEMappedFile source{};
+    if (!KFEFileSystem::MapForRead(path, source) || source.GetSize() > static_cast<std::uint64_t>(INT_MAX))
+    {
+        LOG_ERROR("KFEImagePool::DecodeImage: Failed to map '{}'.", path);
+        return false;
+    }
+
+    stbi_uc* pixels = stbi_load_from_memory(source.GetData(), static_cast<int>(source.GetSize()),
+        &width, &height, &comp, STBI_rgb_alpha);
     if (!pixels)
     {
-        LOG_ERROR("KFEImagePool::LoadTextureInternal: stb_image failed to load '{}'.", path);
+        LOG_ERROR("KFEImagePool::DecodeImage: stb_image failed to load '{}'.", path);
+        return false;
+    }
+
+    outImage.Pixels = std::shared_ptr<std::uint8_t>(pixels, [](std::uint8_t* p) { stbi_image_free(p); });
+    outImage.Width = static_cast<std::uint32_t>(width);
+    outImage.Height = static_cast<std::uint32_t>(height);
+    return true;
+}
+
+_Use_decl_annotations_
+bool KFEImagePool::UploadDecoded(
+    const std::string& path,
+    const DecodedImage& image,
+    ID3D12GraphicsCommandList* cmdList,
+    TextureData& outData)
+{
+    if (image.Cooked.IsValid())
+    {
+        if (UploadCooked(path, image.Cooked, cmdList, outData))
+            return true;
+
+        //~ Mapped but not uploadable, retry from the source
+        DecodedImage raw{};
+        if (!DecodeImage(path, outData.Usage, raw, false))
+            return false;
+
+        return UploadDecoded(path, raw, cmdList, outData);
+    }
+
+    if (!image.Pixels)
+    {
+        LOG_ERROR("KFEImagePool::UploadDecoded: No pixels decoded for '{}'.", path);
         return false;
     }
 
     const DXGI_FORMAT   format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    const std::uint32_t w = static_cast<std::uint32_t>(width);
-    const std::uint32_t h = static_cast<std::uint32_t>(height);
+    const std::uint32_t w = image.Width;
+    const std::uint32_t h = image.Height;
 
     const std::uint32_t mipLevels = CalcMipLevels(w, h);
 
+    outData.bCooked = false;
+    outData.Stream = {};
+    outData.MipBytes.clear();
+    outData.ResidentMip = 0u;
+    outData.InitialMip = 0u;
+
+    //~ Small ones become a slice of a shared array. Arrays get no UAV mip pass, the
+    //~ same box filter runs here.
+    if (CanPack(w, h))
+    {
+        std::vector<KFE_MIP_LEVEL> levels;
+        if (KFEMipGenerator::GenerateChain(image.Pixels.get(), w, h, KFE_MIP_GEN_DESC{}, levels))
+        {
+            std::vector<KFE_COOKED_MIP> mips;
+            mips.push_back(KFE_COOKED_MIP{ w, h, w * 4u, h, image.Pixels.get() });
+            for (const KFE_MIP_LEVEL& level : levels)
+                mips.push_back(KFE_COOKED_MIP{ level.Width, level.Height, level.Width * 4u, level.Height, level.Pixels.data() });
+
+            if (UploadPacked(path, format, mips, outData))
+            {
+                LOG_SUCCESS("KFEImagePool::UploadDecoded: Loaded texture '{}': {}x{}, {} mips, array slice {}.",
+                    path, w, h, mipLevels, outData.ArraySlice);
+
+                if (image.bCook)
+                    QueueCook(path, outData.Usage);
+                return true;
+            }
+        }
+    }
+
+    //~ Without the compute pipeline the same box filter runs on the CPU and every mip is uploaded
+    const bool bGpuMips = mipLevels <= 1u || InitializeMipGenPipeline();
+
+    std::vector<KFE_MIP_LEVEL> cpuMips;
+    if (!bGpuMips)
+    {
+        LOG_WARNING("KFEImagePool::UploadDecoded: GPU mip generation unavailable, building mips on the CPU for '{}'.", path);
+
+        KFE_MIP_GEN_DESC mipDesc{};
+        mipDesc.ThreadCount = 0u;
+        if (!KFEMipGenerator::GenerateChain(image.Pixels.get(), w, h, mipDesc, cpuMips))
+            cpuMips.clear();
+    }
+
     auto staging = std::make_unique<KFEStagingTexture>();
 
     KFE_STAGING_TEXTURE_CREATE_DESC sdesc{};
@@ -312,45 +1045,199 @@ bool KFEImagePool::LoadTextureInternal(
     sdesc.Format = format;
     sdesc.MipLevels = mipLevels; // texture will have full mip chain
     sdesc.ArraySize = 1u;
+    sdesc.UploadSubresources = cpuMips.empty() ? 1u : 0u;
 
     if (!staging->Initialize(sdesc))
     {
-        LOG_ERROR("KFEImagePool::LoadTextureInternal: Failed to create staging texture for '{}'.", path);
-        stbi_image_free(pixels);
+        LOG_ERROR("KFEImagePool::UploadDecoded: Failed to create staging texture for '{}'.", path);
         return false;
     }
 
     const std::uint32_t srcRowPitch = w * 4u;
-    if (!staging->WritePixels(pixels, srcRowPitch))
+    if (!staging->WritePixels(image.Pixels.get(), srcRowPitch))
     {
-        LOG_ERROR("KFEImagePool::LoadTextureInternal: WritePixels failed for '{}'.", path);
-        if (!staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
-        stbi_image_free(pixels);
+        LOG_ERROR("KFEImagePool::UploadDecoded: WritePixels failed for '{}'.", path);
+        if (!staging->Destroy()) LOG_ERROR("KFEImagePool::UploadDecoded: Failed to destroy the staging texture of '{}'.", path);
         return false;
     }
 
-    stbi_image_free(pixels);
+    for (std::size_t i = 0; i < cpuMips.size(); ++i)
+    {
+        const KFE_MIP_LEVEL& level = cpuMips[i];
+        if (!staging->WriteSubresource(static_cast<std::uint32_t>(i + 1u), level.Pixels.data(), level.Width * 4u))
+        {
+            LOG_ERROR("KFEImagePool::UploadDecoded: WriteSubresource failed for '{}' mip {}.", path, i + 1u);
+            if (!staging->Destroy()) LOG_ERROR("KFEImagePool::UploadDecoded: Failed to destroy the staging texture of '{}'.", path);
+            return false;
+        }
+    }
 
     ID3D12GraphicsCommandList* nativeCmd = cmdList;
     if (!staging->RecordUploadToTexture(nativeCmd))
     {
-        LOG_ERROR("KFEImagePool::LoadTextureInternal: RecordUploadToTexture failed for '{}'.", path);
-        if (!staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+        LOG_ERROR("KFEImagePool::UploadDecoded: RecordUploadToTexture failed for '{}'.", path);
+        if (!staging->Destroy()) LOG_ERROR("KFEImagePool::UploadDecoded: Failed to destroy the staging texture of '{}'.", path);
         return false;
     }
 
     KFETexture* texResource = staging->GetTexture();
     if (!texResource || !texResource->GetNative())
     {
-        LOG_ERROR("KFEImagePool::LoadTextureInternal: Staging texture's default resource is null for '{}'.", path);
-        if (!staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+        LOG_ERROR("KFEImagePool::UploadDecoded: Staging texture's default resource is null for '{}'.", path);
+        if (!staging->Destroy()) LOG_ERROR("KFEImagePool::UploadDecoded: Failed to destroy the staging texture of '{}'.", path);
         return false;
     }
 
     // Generate mipmaps on the GPU
-    if (!GenerateMips(texResource, w, h, cmdList))
+    if (bGpuMips && !GenerateMips(texResource, w, h, cmdList))
+    {
+        LOG_WARNING("KFEImagePool::UploadDecoded: GenerateMips failed for '{}'. Using base level only.", path);
+    }
+
+    if (!CreateSrv(path, staging, format, mipLevels, outData))
+        return false;
+
+    outData.ResidentBytes = CalcChainBytes(w, h);
+
+    LOG_SUCCESS("KFEImagePool::UploadDecoded: Loaded texture '{}': {}x{}, {} mips.",
+        path, w, h, mipLevels);
+
+    if (image.bCook)
+        QueueCook(path, outData.Usage);
+
+    return true;
+}
+
+_Use_decl_annotations_
+bool KFEImagePool::UploadCooked(
+    const std::string& path,
+    const KFE_COOKED_TEXTURE& cooked,
+    ID3D12GraphicsCommandList* cmdList,
+    TextureData& outData)
+{
+    const auto mipLevels = static_cast<std::uint32_t>(cooked.Mips.size());
+
+    if (CanPack(cooked.Width, cooked.Height) && UploadPacked(path, cooked.Format, cooked.Mips, outData))
+    {
+        outData.bCooked = true;
+        outData.Stream = {};
+        outData.MipBytes.clear();
+        outData.ResidentMip = 0u;
+        outData.InitialMip = 0u;
+
+        LOG_SUCCESS("KFEImagePool::UploadCooked: Loaded cooked texture '{}': {}x{}, {} mips, format {}, array slice {}.",
+            path, cooked.Width, cooked.Height, mipLevels, static_cast<int>(cooked.Format), outData.ArraySlice);
+        return true;
+    }
+
+    //~ Large textures start from a coarser mip, the rest streams in once they are seen
+    std::uint32_t firstMip = 0u;
+    if (m_streamDesc.bEnabled)
+    {
+        firstMip = KFETextureStreaming::ComputeInitialMip(
+            cooked.Width, cooked.Height, mipLevels,
+            m_streamDesc.InitialMaxSize,
+            KFEBlockCompression::GetBlockBytes(cooked.Format) != 0u);
+    }
+
+    if (!UploadCookedRange(path, cooked, firstMip, cmdList, outData))
+        return false;
+
+    outData.bCooked = true;
+    outData.MipBytes.clear();
+    for (const KFE_COOKED_MIP& mip : cooked.Mips)
+        outData.MipBytes.push_back(static_cast<std::uint64_t>(mip.RowPitch) * mip.RowCount);
+
+    outData.ResidentMip = firstMip;
+    outData.InitialMip = firstMip;
+    outData.ResidentBytes = KFETextureStreaming::SumMipBytes(outData.MipBytes, firstMip);
+
+    if (firstMip > 0u)
+    {
+        outData.Stream = cooked; //~ shares the mapping
+        RegisterStream(outData);
+    }
+    else
+    {
+        outData.Stream = {};
+        outData.MipBytes.clear();
+    }
+
+    LOG_SUCCESS("KFEImagePool::UploadCooked: Loaded cooked texture '{}': {}x{}, {} mips from mip {}, format {}.",
+        path, cooked.Width, cooked.Height, mipLevels, firstMip, static_cast<int>(cooked.Format));
+    return true;
+}
+
+_Use_decl_annotations_
+bool KFEImagePool::UploadCookedRange(
+    const std::string& path,
+    const KFE_COOKED_TEXTURE& cooked,
+    std::uint32_t firstMip,
+    ID3D12GraphicsCommandList* cmdList,
+    TextureData& outData)
+{
+    if (firstMip >= cooked.Mips.size())
+    {
+        LOG_ERROR("KFEImagePool::UploadCookedRange: Mip {} is out of range for '{}'.", firstMip, path);
+        return false;
+    }
+
+    const auto mipLevels = static_cast<std::uint32_t>(cooked.Mips.size()) - firstMip;
+    const KFE_COOKED_MIP& top = cooked.Mips[firstMip];
+
+    auto staging = std::make_unique<KFEStagingTexture>();
+
+    KFE_STAGING_TEXTURE_CREATE_DESC sdesc{};
+    sdesc.Device = m_pDevice;
+    sdesc.Width = top.Width;
+    sdesc.Height = top.Height;
+    sdesc.Format = cooked.Format;
+    sdesc.MipLevels = mipLevels;
+    sdesc.ArraySize = 1u;
+    sdesc.UploadSubresources = 0u;       // every mip comes from the file
+    sdesc.AllowUnorderedAccess = false;  // not allowed on BC formats, nothing writes it
+
+    if (!staging->Initialize(sdesc))
     {
-        LOG_WARNING("KFEImagePool::LoadTextureInternal: GenerateMips failed for '{}'. Using base level only.", path);
+        LOG_ERROR("KFEImagePool::UploadCookedRange: Failed to create staging texture for '{}'.", path);
+        return false;
+    }
+
+    for (std::uint32_t mip = 0; mip < mipLevels; ++mip)
+    {
+        const KFE_COOKED_MIP& src = cooked.Mips[firstMip + mip];
+        if (!staging->WriteSubresource(mip, src.Data, src.RowPitch))
+        {
+            LOG_ERROR("KFEImagePool::UploadCookedRange: WriteSubresource failed for '{}' mip {}.", path, firstMip + mip);
+            if (!staging->Destroy()) LOG_ERROR("KFEImagePool::UploadCookedRange: Failed to destroy the staging texture of '{}'.", path);
+            return false;
+        }
+    }
+
+    if (!staging->RecordUploadToTexture(cmdList))
+    {
+        LOG_ERROR("KFEImagePool::UploadCookedRange: RecordUploadToTexture failed for '{}'.", path);
+        if (!staging->Destroy()) LOG_ERROR("KFEImagePool::UploadCookedRange: Failed to destroy the staging texture of '{}'.", path);
+        return false;
+    }
+
+    return CreateSrv(path, staging, cooked.Format, mipLevels, outData);
+}
+
+_Use_decl_annotations_
+bool KFEImagePool::CreateSrv(
+    const std::string& path,
+    std::unique_ptr<KFEStagingTexture>& staging,
+    DXGI_FORMAT format,
+    std::uint32_t mipLevels,
+    TextureData& outData)
+{
+    KFETexture* texResource = staging->GetTexture();
+    if (!texResource || !texResource->GetNative())
+    {
+        LOG_ERROR("KFEImagePool::CreateSrv: Staging texture's default resource is null for '{}'.", path);
+        if (!staging->Destroy()) LOG_ERROR("KFEImagePool::CreateSrv: Failed to destroy the staging texture of '{}'.", path);
+        return false;
     }
 
     auto srv = std::make_unique<KFETextureSRV>();
@@ -360,7 +1247,7 @@ bool KFEImagePool::LoadTextureInternal(
     srvDesc.Heap = m_pResourceHeap;
     srvDesc.Texture = texResource;
     srvDesc.Format = format;
-    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY; // the material shaders sample arrays
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.MostDetailedMip = 0u;
     srvDesc.MipLevels = mipLevels; // full chain
@@ -371,23 +1258,482 @@ bool KFEImagePool::LoadTextureInternal(
 
     if (!srv->Initialize(srvDesc))
     {
-        LOG_ERROR("KFEImagePool::LoadTextureInternal: Failed to create SRV for '{}'.", path);
-        if (!staging->Destroy()) LOG_ERROR("HUGE LEAK!!!!!!!!!!!!!! ALREAT!!");
+        LOG_ERROR("KFEImagePool::CreateSrv: Failed to create SRV for '{}'.", path);
+        if (!staging->Destroy()) LOG_ERROR("KFEImagePool::CreateSrv: Failed to destroy the staging texture of '{}'.", path);
         return false;
     }
 
     outData.Name = path;
+    outData.Width = staging->GetWidth();
+    outData.Height = staging->GetHeight();
     outData.Staging = std::move(staging);
     outData.Srv = std::move(srv);
-    outData.Width = w;
-    outData.Height = h;
     outData.Mips = mipLevels;
+    outData.Format = format;
+    outData.ArrayPage = KFE_INVALID_INDEX;
+    outData.ArraySlice = 0u;
+    return true;
+}
+
+#pragma endregion
+
+#pragma region Internal_Dedup
+
+_Use_decl_annotations_
+std::string KFEImagePool::ResolveKey(const std::string& path, ETextureUsage usage) const
+{
+    std::string key = MakePoolKey(CanonicalPath(path), usage);
+
+    if (const auto alias = m_keyAliases.find(key); alias != m_keyAliases.end())
+        return alias->second;
+
+    return key;
+}
+
+_Use_decl_annotations_
+const std::string& KFEImagePool::CanonicalPath(const std::string& path) const
+{
+    auto it = m_canonicalPaths.find(path);
+    if (it == m_canonicalPaths.end())
+        it = m_canonicalPaths.emplace(path, NormalizePath(path)).first;
+
+    return it->second;
+}
+
+_Use_decl_annotations_
+const std::string* KFEImagePool::FindContentOwner(
+    const std::string& path,
+    ETextureUsage usage,
+    std::uint64_t& outHash)
+{
+    outHash = 0u;
+    if (!m_bContentDedup)
+        return nullptr;
+
+    outHash = HashFile(path, usage);
+    if (!outHash)
+        return nullptr;
+
+    const auto owner = m_contentOwners.find(outHash);
+    if (owner == m_contentOwners.end())
+        return nullptr;
+
+    const auto entry = m_imagePool.find(owner->second);
+    if (entry == m_imagePool.end() || !GetSrvOf(entry->second))
+        return nullptr;
+
+    //~ Also catches an owner whose file changed since it was loaded
+    if (!SameFileBytes(path, entry->second.Name))
+        return nullptr;
+
+    return &owner->second;
+}
+
+_Use_decl_annotations_
+void KFEImagePool::AddAlias(const std::string& key, const std::string& ownerKey)
+{
+    m_keyAliases[key] = ownerKey;
+    LOG_INFO("KFEImagePool: '{}' has the same bytes as '{}', sharing its texture.", key, ownerKey);
+}
+
+_Use_decl_annotations_
+void KFEImagePool::ForgetContent(const std::string& ownerKey)
+{
+    std::erase_if(m_contentOwners, [&](const auto& entry) { return entry.second == ownerKey; });
+    std::erase_if(m_keyAliases, [&](const auto& entry) { return entry.second == ownerKey; });
+}
+
+#pragma endregion
+
+#pragma region Internal_Pack
+
+bool KFEImagePool::CanPack(std::uint32_t width, std::uint32_t height) const noexcept
+{
+    return m_packDesc.bEnabled
+        && m_packDesc.SlicesPerArray > 1u
+        && width <= m_packDesc.MaxSize
+        && height <= m_packDesc.MaxSize;
+}
+
+_Use_decl_annotations_
+bool KFEImagePool::UploadPacked(
+    const std::string& path,
+    DXGI_FORMAT format,
+    const std::vector<KFE_COOKED_MIP>& mips,
+    TextureData& outData)
+{
+    if (mips.empty())
+        return false;
+
+    const std::uint32_t width = mips.front().Width;
+    const std::uint32_t height = mips.front().Height;
+    const auto          mipCount = static_cast<std::uint32_t>(mips.size());
+
+    //~ First free slice of a matching array
+    std::uint32_t pageIndex = KFE_INVALID_INDEX;
+    std::uint32_t slice = 0u;
+    for (std::uint32_t p = 0u; p < m_arrayPages.size(); ++p)
+    {
+        const ArrayPage& page = m_arrayPages[p];
+        if (page.Format != format || page.Width != width || page.Height != height || page.Mips != mipCount)
+            continue;
+
+        const auto freeSlice = std::find(page.Used.begin(), page.Used.end(), std::uint8_t{ 0u });
+        if (freeSlice == page.Used.end())
+            continue;
+
+        pageIndex = p;
+        slice = static_cast<std::uint32_t>(freeSlice - page.Used.begin());
+        break;
+    }
+
+    if (pageIndex == KFE_INVALID_INDEX)
+    {
+        const std::uint32_t sliceCount = m_packDesc.SlicesPerArray;
+
+        ArrayPage page{};
+        page.Format = format;
+        page.Width = width;
+        page.Height = height;
+        page.Mips = mipCount;
+        page.Staging = std::make_unique<KFEStagingTexture>();
+
+        KFE_STAGING_TEXTURE_CREATE_DESC sdesc{};
+        sdesc.Device = m_pDevice;
+        sdesc.Width = width;
+        sdesc.Height = height;
+        sdesc.Format = format;
+        sdesc.MipLevels = mipCount;
+        sdesc.ArraySize = sliceCount;
+        sdesc.UploadSubresources = 0u;       // slices are written as textures arrive
+        sdesc.AllowUnorderedAccess = false;
+
+        if (!page.Staging->Initialize(sdesc))
+        {
+            LOG_ERROR("KFEImagePool::UploadPacked: Failed to create a {}x{} array for '{}'.", width, height, path);
+            return false;
+        }
+
+        page.Srv = std::make_unique<KFETextureSRV>();
+
+        KFE_SRV_CREATE_DESC srvDesc{};
+        srvDesc.Device = m_pDevice;
+        srvDesc.Heap = m_pResourceHeap;
+        srvDesc.Texture = page.Staging->GetTexture();
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.MostDetailedMip = 0u;
+        srvDesc.MipLevels = mipCount;
+        srvDesc.FirstArraySlice = 0u;
+        srvDesc.ArraySize = sliceCount;
+        srvDesc.PlaneSlice = 0u;
+        srvDesc.DescriptorIndex = KFE_INVALID_INDEX;
+
+        if (!page.Srv->Initialize(srvDesc))
+        {
+            LOG_ERROR("KFEImagePool::UploadPacked: Failed to create the array SRV for '{}'.", path);
+            if (!page.Staging->Destroy()) LOG_ERROR("KFEImagePool::UploadPacked: Failed to destroy the array page staging texture for '{}'.", path);
+            return false;
+        }
+
+        page.Used.assign(sliceCount, 0u);
+        page.Resident.assign(sliceCount, 0u);
+
+        pageIndex = static_cast<std::uint32_t>(m_arrayPages.size());
+        slice = 0u;
+        m_arrayPages.push_back(std::move(page));
+
+        LOG_INFO("KFEImagePool::UploadPacked: New {}x{} array, {} mips, {} slices, format {}.",
+            width, height, mipCount, sliceCount, static_cast<int>(format));
+    }
+
+    ArrayPage& page = m_arrayPages[pageIndex];
+    const UINT first = CalcSubresourceIndex(0u, slice, 0u, mipCount, static_cast<UINT>(page.Used.size()));
+
+    std::uint64_t bytes = 0u;
+    for (std::uint32_t mip = 0u; mip < mipCount; ++mip)
+    {
+        const KFE_COOKED_MIP& src = mips[mip];
+        if (!page.Staging->WriteSubresource(first + mip, src.Data, src.RowPitch))
+        {
+            LOG_ERROR("KFEImagePool::UploadPacked: WriteSubresource failed for '{}' mip {}.", path, mip);
+            return false;
+        }
+        bytes += static_cast<std::uint64_t>(src.RowPitch) * src.RowCount;
+    }
+
+    if (std::find(page.Pending.begin(), page.Pending.end(), slice) == page.Pending.end())
+        page.Pending.push_back(slice);
+    page.Used[slice] = 1u;
 
-    LOG_SUCCESS("KFEImagePool::LoadTextureInternal: Loaded texture '{}': {}x{}, {} mips.",
-        path, width, height, mipLevels);
+    outData.Name = path;
+    outData.Width = width;
+    outData.Height = height;
+    outData.Mips = mipCount;
+    outData.Format = format;
+    outData.Staging.reset();
+    outData.Srv.reset();
+    outData.ArrayPage = pageIndex;
+    outData.ArraySlice = slice;
+    outData.ResidentBytes = bytes;
     return true;
 }
 
+_Use_decl_annotations_
+void KFEImagePool::RecordPackedUploads(ID3D12GraphicsCommandList* cmdList) noexcept
+{
+    for (ArrayPage& page : m_arrayPages)
+    {
+        if (page.Pending.empty())
+            continue;
+
+        const auto sliceCount = static_cast<UINT>(page.Used.size());
+        for (const std::uint32_t slice : page.Pending)
+        {
+            const UINT first = CalcSubresourceIndex(0u, slice, 0u, page.Mips, sliceCount);
+            if (!page.Staging->RecordUploadRange(cmdList, first, page.Mips, page.Resident[slice] != 0u))
+            {
+                LOG_ERROR("KFEImagePool::RecordPackedUploads: RecordUploadRange failed for slice {} of a {}x{} array.",
+                    slice, page.Width, page.Height);
+                continue;
+            }
+            page.Resident[slice] = 1u;
+        }
+        page.Pending.clear();
+    }
+}
+
+_Use_decl_annotations_
+void KFEImagePool::ReleasePacked(TextureData& data) noexcept
+{
+    if (data.ArrayPage < m_arrayPages.size())
+    {
+        ArrayPage& page = m_arrayPages[data.ArrayPage];
+        if (data.ArraySlice < page.Used.size())
+            page.Used[data.ArraySlice] = 0u;
+    }
+
+    data.ArrayPage = KFE_INVALID_INDEX;
+    data.ArraySlice = 0u;
+}
+
+_Use_decl_annotations_
+KFETextureSRV* KFEImagePool::GetSrvOf(const TextureData& data) const noexcept
+{
+    if (data.ArrayPage < m_arrayPages.size())
+        return m_arrayPages[data.ArrayPage].Srv.get();
+
+    return data.Srv.get();
+}
+
+#pragma endregion
+
+#pragma region Internal_Stream
+
+_Use_decl_annotations_
+void KFEImagePool::RegisterStream(TextureData& data)
+{
+    //~ A reload keeps its handle so holders of it stay valid
+    if (data.StreamHandle >= m_streamSlots.size())
+    {
+        data.StreamHandle = static_cast<std::uint32_t>(m_streamSlots.size());
+        m_streamSlots.emplace_back();
+    }
+    else
+    {
+        m_streamSlots[data.StreamHandle] = StreamSlot{};
+    }
+
+    std::lock_guard<std::mutex> lock(m_pageInMutex);
+    m_pagedIn.erase(data.StreamHandle);
+}
+
+_Use_decl_annotations_
+void KFEImagePool::TrackResidency(TextureData& data)
+{
+    KFE_RESIDENCY_REGISTER_DESC desc{};
+    desc.Name = data.Name;
+    desc.Category = EResidencyCategory::Texture;
+    desc.SizeInBytes = data.ResidentBytes;
+
+    //~ Eviction forgets the on screen size, the next UpdateStreaming drops the texture
+    //~ to its initial mip. Runs in FrameBegin on the render thread, like the streaming.
+    if (data.Stream.IsValid())
+    {
+        TextureData* target = &data;
+        desc.Evict = [this, target]() noexcept -> std::uint64_t
+            {
+                if (target->StreamHandle < m_streamSlots.size())
+                {
+                    StreamSlot& slot = m_streamSlots[target->StreamHandle];
+                    slot.FramePixels = 0.0f;
+                    slot.HeldPixels = 0.0f;
+                    slot.HeldFrame = m_streamFrame;
+                }
+
+                const std::uint64_t initialBytes = KFETextureStreaming::SumMipBytes(target->MipBytes, target->InitialMip);
+                return target->ResidentBytes > initialBytes ? target->ResidentBytes - initialBytes : 0u;
+            };
+    }
+
+    data.Residency = KFEResidencyManager::Instance().Register(std::move(desc));
+}
+
+_Use_decl_annotations_
+void KFEImagePool::RetireCompleted(std::uint64_t completedValue) noexcept
+{
+    std::erase_if(m_retired, [completedValue](RetiredTexture& retired) noexcept
+        {
+            if (retired.FenceValue > completedValue)
+                return false;
+
+            if (retired.Srv && retired.Srv->IsInitialize())
+            {
+                if (!retired.Srv->Destroy()) LOG_ERROR("KFEImagePool::RetireCompleted: Failed to free a streamed SRV.");
+            }
+
+            if (retired.Staging && retired.Staging->IsInitialized())
+            {
+                if (!retired.Staging->Destroy()) LOG_ERROR("KFEImagePool::RetireCompleted: Failed to free a streamed texture.");
+            }
+            return true;
+        });
+}
+
+_Use_decl_annotations_
+void KFEImagePool::QueuePageIn(std::uint32_t handle, const TextureData& data, std::uint32_t targetMip)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pageInMutex);
+
+        const auto queued = m_pageInQueued.find(handle);
+        if (queued != m_pageInQueued.end() && queued->second <= targetMip)
+            return;
+
+        PageInJob job{};
+        job.Handle = handle;
+        job.Mip = targetMip;
+        job.Mips.assign(data.Stream.Mips.begin() + targetMip, data.Stream.Mips.begin() + data.ResidentMip);
+        job.Backing = data.Stream.Backing;
+
+        m_pageInQueued[handle] = targetMip;
+        m_pageInJobs.push_back(std::move(job));
+
+        if (!m_pageInWorker.joinable())
+            m_pageInWorker = std::jthread([this](std::stop_token stop) { PageInWorker(stop); });
+    }
+
+    m_pageInCv.notify_one();
+}
+
+void KFEImagePool::PageInWorker(std::stop_token stop) noexcept
+{
+    for (;;)
+    {
+        PageInJob job{};
+        {
+            std::unique_lock<std::mutex> lock(m_pageInMutex);
+            if (!m_pageInCv.wait(lock, stop, [this]() { return !m_pageInJobs.empty(); }))
+                return;
+
+            job = std::move(m_pageInJobs.front());
+            m_pageInJobs.pop_front();
+        }
+
+        //~ One read per page, so the upload on the render thread copies from memory
+        std::uint8_t sink = 0u;
+        for (const KFE_COOKED_MIP& mip : job.Mips)
+        {
+            const std::size_t bytes = static_cast<std::size_t>(mip.RowPitch) * mip.RowCount;
+            for (std::size_t offset = 0u; offset < bytes; offset += 4096u)
+                sink ^= mip.Data[offset];
+        }
+        volatile std::uint8_t touched = sink;
+        static_cast<void>(touched);
+
+        std::lock_guard<std::mutex> lock(m_pageInMutex);
+
+        const auto queued = m_pageInQueued.find(job.Handle);
+        if (queued != m_pageInQueued.end() && queued->second == job.Mip)
+            m_pageInQueued.erase(queued);
+
+        const auto [it, inserted] = m_pagedIn.try_emplace(job.Handle, job.Mip);
+        if (!inserted)
+            it->second = std::min(it->second, job.Mip);
+    }
+}
+
+#pragma endregion
+
+#pragma region Internal_Cook
+
+void KFEImagePool::QueueCook(const std::string& path, ETextureUsage usage)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cookMutex);
+
+        if (!m_cookQueued.insert(KFETextureCooker::GetCookedPath(path, usage)).second)
+            return;
+
+        m_cookJobs.push_back(CookJob{ path, usage });
+
+        //~ One worker, cooking must not compete with the frame for every core
+        if (!m_cookWorker.joinable())
+            m_cookWorker = std::jthread([this](std::stop_token stop) { CookWorker(stop); });
+    }
+
+    m_cookCv.notify_one();
+}
+
+void KFEImagePool::CookWorker(std::stop_token stop) noexcept
+{
+    for (;;)
+    {
+        CookJob               job{};
+        KFE_TEXTURE_COOK_DESC desc{};
+        KFE_ORM_SOURCES       orm{};
+        bool                  bPackORM = false;
+        {
+            std::unique_lock<std::mutex> lock(m_cookMutex);
+            if (!m_cookCv.wait(lock, stop, [this]() { return !m_ormJobs.empty() || !m_cookJobs.empty(); }))
+                return;
+
+            //~ Packs first, their materials sample three maps until they are done
+            if (!m_ormJobs.empty())
+            {
+                orm = std::move(m_ormJobs.front());
+                m_ormJobs.pop_front();
+                bPackORM = true;
+            }
+            else
+            {
+                job = std::move(m_cookJobs.front());
+                m_cookJobs.pop_front();
+                desc = m_cookDesc;
+            }
+        }
+
+        if (bPackORM)
+        {
+            std::string packed{};
+            const bool bPacked = KFETextureCooker::PackORM(orm, packed);
+
+            std::lock_guard<std::mutex> lock(m_cookMutex);
+            PackedORM& result = m_ormPacks[MakeORMKey(orm)];
+            result.State = bPacked ? EPackedORMState::Ready : EPackedORMState::Failed;
+            result.Path = bPacked ? std::move(packed) : std::string{};
+            continue;
+        }
+
+        if (!KFETextureCooker::CookFile(job.Path, job.Usage, desc))
+            LOG_WARNING("KFEImagePool: Background cook of '{}' failed, the source keeps loading", job.Path);
+
+        std::lock_guard<std::mutex> lock(m_cookMutex);
+        m_cookQueued.erase(KFETextureCooker::GetCookedPath(job.Path, job.Usage));
+    }
+}
+
 #pragma endregion
 
 #pragma region Internal_MipGen
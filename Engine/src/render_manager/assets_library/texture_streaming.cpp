@@ -0,0 +1,346 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : texture_streaming.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/texture/texture_streaming.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <queue>
+
+namespace kfe
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        struct UpgradeEntry
+        {
+            float         Undersample; //~ screen pixels per texel of the current top level
+            std::uint32_t Index;
+
+            bool operator<(const UpgradeEntry& rhs) const noexcept
+            {
+                //~ Lower index wins ties so the result does not depend on heap order
+                if (Undersample != rhs.Undersample)
+                    return Undersample < rhs.Undersample;
+                return Index > rhs.Index;
+            }
+        };
+
+        static float Undersample(const KFE_STREAMING_CANDIDATE& c, std::uint32_t mip) noexcept
+        {
+            const std::uint32_t size = (std::max)(1u, c.TopSize >> mip);
+            return c.ScreenPixels / static_cast<float>(size);
+        }
+
+        //~ Mip 0 of a BC cook is whole blocks, so there always is one for mip > 0
+        static std::uint32_t NextFinerMip(const KFE_STREAMING_CANDIDATE& c, std::uint32_t mip) noexcept
+        {
+            std::uint32_t next = mip - 1u;
+            while (next > 0u && !KFETextureStreaming::IsLoadableMip(c.Width, c.Height, next, c.bBlockCompressed))
+                --next;
+            return next;
+        }
+
+        static std::uint32_t MipCountOf(std::uint32_t w, std::uint32_t h) noexcept
+        {
+            std::uint32_t levels = 1u;
+            while (w > 1u || h > 1u)
+            {
+                w = (std::max)(1u, w >> 1u);
+                h = (std::max)(1u, h >> 1u);
+                ++levels;
+            }
+            return levels;
+        }
+    }
+
+    float KFETextureStreaming::ComputeScreenPixels(
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax,
+        const XMMATRIX& world,
+        const KFE_TEXTURE_STREAMING_VIEW& view) noexcept
+    {
+        const XMVECTOR localMin = XMLoadFloat3(&aabbMin);
+        const XMVECTOR localMax = XMLoadFloat3(&aabbMax);
+
+        const XMVECTOR center = XMVector3TransformCoord(XMVectorScale(XMVectorAdd(localMin, localMax), 0.5f), world);
+
+        const float scale = (std::max)({
+            XMVectorGetX(XMVector3Length(world.r[0])),
+            XMVectorGetX(XMVector3Length(world.r[1])),
+            XMVectorGetX(XMVector3Length(world.r[2])) });
+
+        const float diagonal = XMVectorGetX(XMVector3Length(XMVectorSubtract(localMax, localMin))) * scale;
+        const float radius = diagonal * 0.5f;
+
+        const float distance = XMVectorGetX(XMVector3Length(
+            XMVectorSubtract(center, XMLoadFloat3(&view.CameraPosition))));
+
+        const float tanHalfFov = std::tan(view.FovY * 0.5f);
+        if (diagonal <= 0.0f || tanHalfFov <= 0.0f)
+            return 0.0f;
+
+        if (distance <= radius)
+            return FLT_MAX;
+
+        return (diagonal / (distance * tanHalfFov)) * view.ViewportHeight * 0.5f;
+    }
+
+    std::uint32_t KFETextureStreaming::ComputeWantedMip(
+        std::uint32_t topSize,
+        std::uint32_t mipCount,
+        float screenPixels,
+        float texelsPerPixel) noexcept
+    {
+        if (mipCount == 0u)
+            return 0u;
+
+        const std::uint32_t lastMip = mipCount - 1u;
+        if (!(screenPixels > 0.0f) || !(texelsPerPixel > 0.0f))
+            return lastMip;
+
+        const float neededTexels = screenPixels * texelsPerPixel;
+        if (neededTexels >= static_cast<float>(topSize))
+            return 0u;
+
+        //~ Level m has topSize >> m texels, keep the coarsest one still >= neededTexels
+        const float ratio = static_cast<float>(topSize) / neededTexels;
+        const auto  mip = static_cast<std::uint32_t>(std::floor(std::log2(ratio)));
+        return (std::min)(mip, lastMip);
+    }
+
+    bool KFETextureStreaming::IsLoadableMip(
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t mip,
+        bool bBlockCompressed) noexcept
+    {
+        if (!bBlockCompressed || mip == 0u)
+            return true;
+
+        const std::uint32_t w = (std::max)(1u, width >> mip);
+        const std::uint32_t h = (std::max)(1u, height >> mip);
+        return (w & 3u) == 0u && (h & 3u) == 0u;
+    }
+
+    std::uint32_t KFETextureStreaming::ComputeInitialMip(
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t mipCount,
+        std::uint32_t maxSize,
+        bool bBlockCompressed) noexcept
+    {
+        if (mipCount <= 1u)
+            return 0u;
+
+        maxSize = (std::max)(maxSize, 1u);
+
+        std::uint32_t mip = 0u;
+        while (mip + 1u < mipCount && (std::max)(width >> mip, height >> mip) > maxSize)
+            ++mip;
+
+        while (!IsLoadableMip(width, height, mip, bBlockCompressed))
+            --mip;
+
+        return mip;
+    }
+
+    std::uint64_t KFETextureStreaming::SumMipBytes(std::span<const std::uint64_t> mipBytes, std::uint32_t firstMip) noexcept
+    {
+        std::uint64_t total = 0u;
+        for (std::size_t m = firstMip; m < mipBytes.size(); ++m)
+            total += mipBytes[m];
+        return total;
+    }
+
+    std::uint64_t KFETextureStreaming::Arbitrate(
+        std::span<const KFE_STREAMING_CANDIDATE> candidates,
+        std::uint64_t budgetBytes,
+        std::uint64_t fixedBytes,
+        std::vector<std::uint32_t>& outTargetMips) noexcept
+    {
+        outTargetMips.assign(candidates.size(), 0u);
+
+        std::uint64_t total = fixedBytes;
+        std::priority_queue<UpgradeEntry> upgrades;
+
+        for (std::size_t i = 0; i < candidates.size(); ++i)
+        {
+            const KFE_STREAMING_CANDIDATE& c = candidates[i];
+            const auto mipCount = static_cast<std::uint32_t>(c.MipBytes.size());
+
+            const std::uint32_t initial = mipCount == 0u ? 0u : (std::min)(c.InitialMip, mipCount - 1u);
+            outTargetMips[i] = initial;
+            total += SumMipBytes(c.MipBytes, initial);
+
+            if ((std::min)(c.WantedMip, initial) < initial)
+                upgrades.push(UpgradeEntry{ Undersample(c, initial), static_cast<std::uint32_t>(i) });
+        }
+
+        //~ Initial mips are never dropped, the budget only gates the finer levels
+        while (!upgrades.empty())
+        {
+            const UpgradeEntry top = upgrades.top();
+            upgrades.pop();
+
+            const KFE_STREAMING_CANDIDATE& c = candidates[top.Index];
+            std::uint32_t& target = outTargetMips[top.Index];
+
+            //~ Levels in between that are not whole blocks come along with the next one
+            const std::uint32_t next = NextFinerMip(c, target);
+
+            std::uint64_t cost = 0u;
+            for (std::uint32_t m = next; m < target; ++m)
+                cost += c.MipBytes[m];
+
+            if (total + cost > budgetBytes)
+                continue; //~ a smaller level of another texture may still fit
+
+            total += cost;
+            target = next;
+
+            if (target > c.WantedMip)
+                upgrades.push(UpgradeEntry{ Undersample(c, target), top.Index });
+        }
+
+        return total;
+    }
+
+    bool KFETextureStreaming::RunSelfTest() noexcept
+    {
+        bool ok = true;
+        auto Check = [&ok](bool condition, const char* what) noexcept
+            {
+                if (!condition)
+                {
+                    LOG_ERROR("KFETextureStreaming::RunSelfTest: {}", what);
+                    ok = false;
+                }
+            };
+
+        //~ Wanted mip
+        Check(ComputeWantedMip(2048u, 12u, 2048.0f) == 0u, "full size on screen wants mip 0");
+        Check(ComputeWantedMip(2048u, 12u, 4096.0f) == 0u, "magnified wants mip 0");
+        Check(ComputeWantedMip(2048u, 12u, 512.0f) == 2u, "512 pixels of a 2048 texture wants mip 2");
+        Check(ComputeWantedMip(2048u, 12u, 500.0f) == 2u, "500 pixels keeps the 512 level");
+        Check(ComputeWantedMip(2048u, 12u, 520.0f) == 1u, "520 pixels needs the 1024 level");
+        Check(ComputeWantedMip(2048u, 12u, 512.0f, 2.0f) == 1u, "2 texels per pixel is one level finer");
+        Check(ComputeWantedMip(2048u, 12u, 0.0f) == 11u, "off screen wants the last mip");
+        Check(ComputeWantedMip(2048u, 12u, 0.25f) == 11u, "sub pixel clamps to the last mip");
+        Check(ComputeWantedMip(2048u, 12u, FLT_MAX) == 0u, "camera inside wants mip 0");
+
+        //~ Initial mip
+        Check(ComputeInitialMip(2048u, 2048u, 12u, 256u, true) == 3u, "2048 starts at 256");
+        Check(ComputeInitialMip(2048u, 512u, 12u, 256u, true) == 3u, "largest axis decides");
+        Check(ComputeInitialMip(200u, 200u, 8u, 256u, false) == 0u, "small textures load whole");
+        Check(ComputeInitialMip(1000u, 1000u, MipCountOf(1000u, 1000u), 256u, true) == 1u, "1000 halves to 500 then 250, BC stops at 500");
+        Check(ComputeInitialMip(1000u, 1000u, MipCountOf(1000u, 1000u), 256u, false) == 2u, "uncompressed 1000 starts at 250");
+        Check(ComputeInitialMip(1032u, 1032u, MipCountOf(1032u, 1032u), 256u, true) == 1u, "1032 halves to 516 then 258, BC stops at 516");
+        Check(ComputeInitialMip(1032u, 1032u, MipCountOf(1032u, 1032u), 256u, false) == 3u, "uncompressed 1032 starts at 129");
+
+        //~ Screen size
+        {
+            const XMFLOAT3 mn{ -1.0f, -1.0f, -1.0f };
+            const XMFLOAT3 mx{ 1.0f, 1.0f, 1.0f };
+            KFE_TEXTURE_STREAMING_VIEW view{};
+            view.CameraPosition = XMFLOAT3{ 0.0f, 0.0f, -10.0f };
+
+            const float nearPixels = ComputeScreenPixels(mn, mx, XMMatrixIdentity(), view);
+            view.CameraPosition.z = -20.0f;
+            const float farPixels = ComputeScreenPixels(mn, mx, XMMatrixIdentity(), view);
+            const float scaled = ComputeScreenPixels(mn, mx, XMMatrixScaling(2.0f, 2.0f, 2.0f), view);
+            view.CameraPosition.z = 0.0f;
+            const float inside = ComputeScreenPixels(mn, mx, XMMatrixIdentity(), view);
+
+            Check(nearPixels > 0.0f && std::fabs(nearPixels / farPixels - 2.0f) < 1e-3f, "twice the distance halves the size");
+            Check(std::fabs(scaled / farPixels - 2.0f) < 1e-3f, "twice the scale doubles the size");
+            Check(inside == FLT_MAX, "camera inside the bounds is full size");
+        }
+
+        //~ Arbitration, two 1024 RGBA8 chains (4 MB, 1 MB, 256 KB, ...)
+        std::vector<std::uint64_t> chain;
+        for (std::uint32_t s = 1024u; s > 0u; s >>= 1u)
+            chain.push_back(static_cast<std::uint64_t>(s) * s * 4u);
+
+        KFE_STREAMING_CANDIDATE large{};
+        large.MipBytes = chain;
+        large.InitialMip = 2u;
+        large.WantedMip = 0u;
+        large.TopSize = 1024u;
+        large.ScreenPixels = 1200.0f;
+
+        KFE_STREAMING_CANDIDATE small = large;
+        small.WantedMip = 1u;
+        small.ScreenPixels = 400.0f;
+
+        const std::vector<KFE_STREAMING_CANDIDATE> pair{ large, small };
+        const std::uint64_t initialBytes = 2u * SumMipBytes(chain, 2u);
+        std::vector<std::uint32_t> targets;
+
+        std::uint64_t used = Arbitrate(pair, UINT64_MAX, 0u, targets);
+        Check(targets[0] == 0u && targets[1] == 1u, "an unlimited budget gives every wanted mip");
+        Check(used == SumMipBytes(chain, 0u) + SumMipBytes(chain, 1u), "unlimited total");
+
+        used = Arbitrate(pair, 0u, 0u, targets);
+        Check(targets[0] == 2u && targets[1] == 2u && used == initialBytes, "no budget keeps the initial mips");
+
+        //~ Room for both 512 levels but not the 1024 one
+        used = Arbitrate(pair, initialBytes + 2u * chain[1], 0u, targets);
+        Check(targets[0] == 1u && targets[1] == 1u, "the 1024 level does not fit");
+
+        //~ Room for one 512 level, the larger one on screen gets it
+        used = Arbitrate(pair, initialBytes + chain[1], 0u, targets);
+        Check(targets[0] == 1u && targets[1] == 2u, "priority follows screen coverage");
+        Check(used <= initialBytes + chain[1], "the budget holds");
+
+        used = Arbitrate(pair, initialBytes + chain[1], chain[1], targets);
+        Check(targets[0] == 2u && targets[1] == 2u, "fixed bytes count against the budget");
+
+        //~ A wanted mip coarser than the initial one changes nothing
+        KFE_STREAMING_CANDIDATE tiny = large;
+        tiny.WantedMip = 5u;
+        const std::vector<KFE_STREAMING_CANDIDATE> single{ tiny };
+        Arbitrate(single, UINT64_MAX, 0u, targets);
+        Check(targets[0] == 2u, "initial mips stay resident");
+
+        //~ BC 2052: mips 1 (1026) and 2 (513) are not whole blocks, mip 3 (256) is
+        std::vector<std::uint64_t> odd;
+        for (std::uint32_t s = 2052u; s > 0u; s >>= 1u)
+            odd.push_back(static_cast<std::uint64_t>(s) * s);
+
+        KFE_STREAMING_CANDIDATE bc{};
+        bc.MipBytes = odd;
+        bc.Width = 2052u;
+        bc.Height = 2052u;
+        bc.bBlockCompressed = true;
+        bc.TopSize = 2052u;
+        bc.InitialMip = ComputeInitialMip(2052u, 2052u, MipCountOf(2052u, 2052u), 256u, true);
+        bc.WantedMip = 2u;
+        bc.ScreenPixels = 600.0f;
+        Check(bc.InitialMip == 3u, "BC 2052 starts at 256");
+
+        const std::vector<KFE_STREAMING_CANDIDATE> bcOnly{ bc };
+        Arbitrate(bcOnly, UINT64_MAX, 0u, targets);
+        Check(targets[0] == 0u, "BC upgrades skip levels that are not whole blocks");
+
+        Arbitrate(bcOnly, SumMipBytes(odd, 1u), 0u, targets);
+        Check(targets[0] == 3u, "BC upgrade pays for the skipped levels");
+
+        if (ok)
+            LOG_SUCCESS("KFETextureStreaming::RunSelfTest: All checks passed.");
+
+        return ok;
+    }
+}
@@ -0,0 +1,534 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : vertex_kernels.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/vertex_kernels.h"
+#include "engine/render_manager/assets_library/model/geometry.h"
+#include "engine/utils/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define KFE_VERTEX_KERNELS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define KFE_TARGET_AVX2
+    #else
+        #include <cpuid.h>
+        #define KFE_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define KFE_VERTEX_KERNELS_X86 0
+#endif
+
+namespace kfe
+{
+    using import::Float3;
+    using import::ImportedVertex;
+
+    namespace
+    {
+        //~ ConvertVertices writes each 12 byte field with a 16 byte store, the spill
+        //~ lands on the next field which is written right after
+        static_assert(offsetof(ImportedVertex, Position)   == 0u);
+        static_assert(offsetof(ImportedVertex, Normal)     == 12u);
+        static_assert(offsetof(ImportedVertex, Tangent)    == 24u);
+        static_assert(offsetof(ImportedVertex, Bitangent)  == 36u);
+        static_assert(offsetof(ImportedVertex, UV)         == 48u);
+        static_assert(offsetof(ImportedVertex, HasNormal)  == 64u);
+        static_assert(offsetof(ImportedVertex, HasTangent) == 65u);
+        static_assert(offsetof(ImportedVertex, HasUV)      == 66u);
+        static_assert(import::KFE_MAX_UV_CHANNELS == 2u);
+        static_assert(sizeof(ImportedVertex) == sizeof(KFEMeshVertex));
+
+        //~ Stride 0 sources for missing streams, 4 floats so a full vector load is safe
+        alignas(16) constexpr float kDefaultNormal[4]    = { 0.0f, 1.0f, 0.0f, 0.0f };
+        alignas(16) constexpr float kDefaultTangent[4]   = { 1.0f, 0.0f, 0.0f, 0.0f };
+        alignas(16) constexpr float kDefaultBitangent[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+        alignas(16) constexpr float kDefaultUV[4]        = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        struct Stream
+        {
+            const float* Data;
+            std::size_t  Stride; //~ in floats, 0 for defaults
+        };
+
+        Stream MakeStream(const float* data, const float* fallback) noexcept
+        {
+            return data ? Stream{ data, 3u } : Stream{ fallback, 0u };
+        }
+
+        std::uint32_t PackFlags(const KFE_VERTEX_SOURCE_STREAMS& src) noexcept
+        {
+            const std::uint8_t flags[4] =
+            {
+                static_cast<std::uint8_t>(src.Normals != nullptr),
+                static_cast<std::uint8_t>(src.Tangents != nullptr && src.Bitangents != nullptr),
+                static_cast<std::uint8_t>(src.UV[0] != nullptr),
+                static_cast<std::uint8_t>(src.UV[1] != nullptr)
+            };
+
+            std::uint32_t packed = 0u;
+            std::memcpy(&packed, flags, sizeof(packed));
+            return packed;
+        }
+
+        void ReduceAABBScalar(const float* p, std::size_t count, float mn[3], float mx[3]) noexcept
+        {
+            for (std::size_t i = 0u; i < count; ++i, p += 3)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    mn[c] = (std::min)(mn[c], p[c]);
+                    mx[c] = (std::max)(mx[c], p[c]);
+                }
+            }
+        }
+
+#if KFE_VERTEX_KERNELS_X86
+        bool DetectAVX2() noexcept
+        {
+#if defined(_MSC_VER)
+            int info[4]{};
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx)
+                return false;
+
+            //~ OS saves the YMM state
+            if ((_xgetbv(0) & 0x6u) != 0x6u)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+        //~ Three loads cover 4 positions; lane j of vector k holds component (4k + j) % 3
+        void ReduceAABBSSE(const float* p, std::size_t count, float mn[3], float mx[3]) noexcept
+        {
+            //~ Seed every lane with its own component, the fold below maps lanes back
+            alignas(16) float seedMin[12], seedMax[12];
+            for (int l = 0; l < 12; ++l)
+            {
+                seedMin[l] = mn[l % 3];
+                seedMax[l] = mx[l % 3];
+            }
+
+            __m128 mn0 = _mm_load_ps(seedMin), mn1 = _mm_load_ps(seedMin + 4), mn2 = _mm_load_ps(seedMin + 8);
+            __m128 mx0 = _mm_load_ps(seedMax), mx1 = _mm_load_ps(seedMax + 4), mx2 = _mm_load_ps(seedMax + 8);
+
+            std::size_t i = 0u;
+            for (; i + 4u <= count; i += 4u, p += 12)
+            {
+                const __m128 a = _mm_loadu_ps(p);
+                const __m128 b = _mm_loadu_ps(p + 4);
+                const __m128 c = _mm_loadu_ps(p + 8);
+
+                mn0 = _mm_min_ps(mn0, a); mx0 = _mm_max_ps(mx0, a);
+                mn1 = _mm_min_ps(mn1, b); mx1 = _mm_max_ps(mx1, b);
+                mn2 = _mm_min_ps(mn2, c); mx2 = _mm_max_ps(mx2, c);
+            }
+
+            _mm_store_ps(seedMin, mn0); _mm_store_ps(seedMin + 4, mn1); _mm_store_ps(seedMin + 8, mn2);
+            _mm_store_ps(seedMax, mx0); _mm_store_ps(seedMax + 4, mx1); _mm_store_ps(seedMax + 8, mx2);
+
+            for (int l = 0; l < 12; ++l)
+            {
+                mn[l % 3] = (std::min)(mn[l % 3], seedMin[l]);
+                mx[l % 3] = (std::max)(mx[l % 3], seedMax[l]);
+            }
+
+            ReduceAABBScalar(p, count - i, mn, mx);
+        }
+
+        //~ Same layout trick, 8 positions per three 256 bit loads
+        KFE_TARGET_AVX2
+        void ReduceAABBAVX2(const float* p, std::size_t count, float mn[3], float mx[3]) noexcept
+        {
+            alignas(32) float seedMin[24], seedMax[24];
+            for (int l = 0; l < 24; ++l)
+            {
+                seedMin[l] = mn[l % 3];
+                seedMax[l] = mx[l % 3];
+            }
+
+            __m256 mn0 = _mm256_load_ps(seedMin), mn1 = _mm256_load_ps(seedMin + 8), mn2 = _mm256_load_ps(seedMin + 16);
+            __m256 mx0 = _mm256_load_ps(seedMax), mx1 = _mm256_load_ps(seedMax + 8), mx2 = _mm256_load_ps(seedMax + 16);
+
+            std::size_t i = 0u;
+            for (; i + 8u <= count; i += 8u, p += 24)
+            {
+                const __m256 a = _mm256_loadu_ps(p);
+                const __m256 b = _mm256_loadu_ps(p + 8);
+                const __m256 c = _mm256_loadu_ps(p + 16);
+
+                mn0 = _mm256_min_ps(mn0, a); mx0 = _mm256_max_ps(mx0, a);
+                mn1 = _mm256_min_ps(mn1, b); mx1 = _mm256_max_ps(mx1, b);
+                mn2 = _mm256_min_ps(mn2, c); mx2 = _mm256_max_ps(mx2, c);
+            }
+
+            _mm256_store_ps(seedMin, mn0); _mm256_store_ps(seedMin + 8, mn1); _mm256_store_ps(seedMin + 16, mn2);
+            _mm256_store_ps(seedMax, mx0); _mm256_store_ps(seedMax + 8, mx1); _mm256_store_ps(seedMax + 16, mx2);
+            _mm256_zeroupper();
+
+            for (int l = 0; l < 24; ++l)
+            {
+                mn[l % 3] = (std::min)(mn[l % 3], seedMin[l]);
+                mx[l % 3] = (std::max)(mx[l % 3], seedMax[l]);
+            }
+
+            ReduceAABBScalar(p, count - i, mn, mx);
+        }
+
+        //~ The last element of a 3 float stream can not take a 16 byte load
+        inline __m128 Load3(const float* p) noexcept
+        {
+            return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+        }
+
+        template<bool Tail>
+        inline __m128 LoadElement(const Stream& s, std::size_t i) noexcept
+        {
+            const float* p = s.Data + i * s.Stride;
+            if constexpr (Tail)
+                return s.Stride ? Load3(p) : _mm_load_ps(p);
+            else
+                return _mm_loadu_ps(p);
+        }
+
+        template<bool Tail>
+        inline void ConvertOne(const Stream (&streams)[6],
+                               std::size_t   i,
+                               __m128        center,
+                               __m128        scale,
+                               std::uint32_t flags,
+                               __m128&       mn,
+                               __m128&       mx,
+                               ImportedVertex& out) noexcept
+        {
+            float* dst = &out.Position.x;
+
+            const __m128 pos = _mm_mul_ps(_mm_sub_ps(LoadElement<Tail>(streams[0], i), center), scale);
+            mn = _mm_min_ps(mn, pos);
+            mx = _mm_max_ps(mx, pos);
+
+            //~ Ascending 16 byte stores, each spill is overwritten by the next one
+            _mm_storeu_ps(dst + 0,  pos);
+            _mm_storeu_ps(dst + 3,  LoadElement<Tail>(streams[1], i));
+            _mm_storeu_ps(dst + 6,  LoadElement<Tail>(streams[2], i));
+            _mm_storeu_ps(dst + 9,  LoadElement<Tail>(streams[3], i));
+            _mm_storeu_ps(dst + 12, _mm_movelh_ps(LoadElement<Tail>(streams[4], i),
+                                                  LoadElement<Tail>(streams[5], i)));
+
+            std::memcpy(&out.HasNormal, &flags, sizeof(flags));
+        }
+#endif // KFE_VERTEX_KERNELS_X86
+
+        //~ Reference for the benchmark: the importer, NormalizeSceneToUnitBox and
+        //~ BuildFromImportedMesh loops as they were before the kernels
+        void ScalarReference(const KFE_VERTEX_SOURCE_STREAMS& src,
+                             std::vector<ImportedVertex>&      imported,
+                             std::vector<KFEMeshVertex>&       engine,
+                             Float3&                           outMin,
+                             Float3&                           outMax) noexcept
+        {
+            const std::size_t n = src.VertexCount;
+            Float3 mn{ 1e30f, 1e30f, 1e30f };
+            Float3 mx{ -1e30f, -1e30f, -1e30f };
+
+            for (std::size_t v = 0u; v < n; ++v)
+            {
+                ImportedVertex& outV = imported[v];
+                const float* p = src.Positions + 3u * v;
+                outV.Position = { p[0], p[1], p[2] };
+
+                mn.x = (std::min)(mn.x, p[0]); mn.y = (std::min)(mn.y, p[1]); mn.z = (std::min)(mn.z, p[2]);
+                mx.x = (std::max)(mx.x, p[0]); mx.y = (std::max)(mx.y, p[1]); mx.z = (std::max)(mx.z, p[2]);
+
+                if (src.Normals)
+                {
+                    const float* q = src.Normals + 3u * v;
+                    outV.Normal = { q[0], q[1], q[2] };
+                    outV.HasNormal = true;
+                }
+                else
+                {
+                    outV.HasNormal = false;
+                }
+
+                if (src.Tangents && src.Bitangents)
+                {
+                    const float* t = src.Tangents + 3u * v;
+                    const float* b = src.Bitangents + 3u * v;
+                    outV.Tangent = { t[0], t[1], t[2] };
+                    outV.Bitangent = { b[0], b[1], b[2] };
+                    outV.HasTangent = true;
+                }
+                else
+                {
+                    outV.HasTangent = false;
+                }
+
+                for (std::uint32_t ch = 0u; ch < import::KFE_MAX_UV_CHANNELS; ++ch)
+                {
+                    if (src.UV[ch])
+                    {
+                        const float* uv = src.UV[ch] + 3u * v;
+                        outV.UV[ch] = { uv[0], uv[1] };
+                        outV.HasUV[ch] = true;
+                    }
+                    else
+                    {
+                        outV.HasUV[ch] = false;
+                    }
+                }
+            }
+
+            const Float3 center{ 0.5f * (mn.x + mx.x), 0.5f * (mn.y + mx.y), 0.5f * (mn.z + mx.z) };
+            const float  extent = (std::max)(mx.x - mn.x, (std::max)(mx.y - mn.y, mx.z - mn.z));
+            const float  invScale = extent > 1e-6f ? 1.0f / extent : 1.0f;
+
+            outMin = { 1e30f, 1e30f, 1e30f };
+            outMax = { -1e30f, -1e30f, -1e30f };
+
+            for (auto& v : imported)
+            {
+                auto p = v.Position;
+                p.x = (p.x - center.x) * invScale;
+                p.y = (p.y - center.y) * invScale;
+                p.z = (p.z - center.z) * invScale;
+                v.Position = p;
+
+                outMin.x = (std::min)(outMin.x, p.x); outMin.y = (std::min)(outMin.y, p.y); outMin.z = (std::min)(outMin.z, p.z);
+                outMax.x = (std::max)(outMax.x, p.x); outMax.y = (std::max)(outMax.y, p.y); outMax.z = (std::max)(outMax.z, p.z);
+            }
+
+            for (std::size_t i = 0u; i < n; ++i)
+            {
+                const ImportedVertex& inV = imported[i];
+                KFEMeshVertex& outV = engine[i];
+
+                outV.Position = inV.Position;
+                outV.HasNormal = inV.HasNormal;
+                outV.Normal = inV.HasNormal ? inV.Normal : DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f);
+
+                outV.HasTangent = inV.HasTangent;
+                if (inV.HasTangent)
+                {
+                    outV.Tangent = inV.Tangent;
+                    outV.Bitangent = inV.Bitangent;
+                }
+                else
+                {
+                    outV.Tangent = DirectX::XMFLOAT3(1.0f, 0.0f, 0.0f);
+                    outV.Bitangent = DirectX::XMFLOAT3(0.0f, 0.0f, 1.0f);
+                }
+
+                outV.HasUV0 = inV.HasUV[0];
+                outV.UV0 = inV.HasUV[0] ? inV.UV[0] : DirectX::XMFLOAT2(0.0f, 0.0f);
+                outV.HasUV1 = inV.HasUV[1];
+                outV.UV1 = inV.HasUV[1] ? inV.UV[1] : DirectX::XMFLOAT2(0.0f, 0.0f);
+            }
+        }
+    }
+
+    const char* KFEVertexKernels::GetInstructionSet() noexcept
+    {
+#if KFE_VERTEX_KERNELS_X86
+        static const bool avx2 = DetectAVX2();
+        return avx2 ? "AVX2" : "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void KFEVertexKernels::ReduceAABB(const float* positions,
+                                      std::size_t  count,
+                                      Float3&      inOutMin,
+                                      Float3&      inOutMax) noexcept
+    {
+        if (!positions || count == 0u)
+            return;
+
+        float mn[3] = { inOutMin.x, inOutMin.y, inOutMin.z };
+        float mx[3] = { inOutMax.x, inOutMax.y, inOutMax.z };
+
+#if KFE_VERTEX_KERNELS_X86
+        static const bool avx2 = DetectAVX2();
+        if (avx2)
+            ReduceAABBAVX2(positions, count, mn, mx);
+        else
+            ReduceAABBSSE(positions, count, mn, mx);
+#else
+        ReduceAABBScalar(positions, count, mn, mx);
+#endif
+
+        inOutMin = { mn[0], mn[1], mn[2] };
+        inOutMax = { mx[0], mx[1], mx[2] };
+    }
+
+    void KFEVertexKernels::ConvertVertices(const KFE_VERTEX_SOURCE_STREAMS& src,
+                                           const Float3&                    center,
+                                           float                            scale,
+                                           ImportedVertex*                  out,
+                                           Float3&                          outMin,
+                                           Float3&                          outMax) noexcept
+    {
+        outMin = { 1e30f, 1e30f, 1e30f };
+        outMax = { -1e30f, -1e30f, -1e30f };
+
+        const std::size_t n = src.VertexCount;
+        if (!src.Positions || !out || n == 0u)
+            return;
+
+        const bool hasTangents = src.Tangents && src.Bitangents;
+
+        const Stream streams[6] =
+        {
+            MakeStream(src.Positions, nullptr),
+            MakeStream(src.Normals, kDefaultNormal),
+            MakeStream(hasTangents ? src.Tangents : nullptr, kDefaultTangent),
+            MakeStream(hasTangents ? src.Bitangents : nullptr, kDefaultBitangent),
+            MakeStream(src.UV[0], kDefaultUV),
+            MakeStream(src.UV[1], kDefaultUV)
+        };
+
+        const std::uint32_t flags = PackFlags(src);
+
+#if KFE_VERTEX_KERNELS_X86
+        const __m128 c = _mm_setr_ps(center.x, center.y, center.z, 0.0f);
+        const __m128 s = _mm_set1_ps(scale);
+        __m128 mn = _mm_set1_ps(1e30f);
+        __m128 mx = _mm_set1_ps(-1e30f);
+
+        for (std::size_t i = 0u; i + 1u < n; ++i)
+            ConvertOne<false>(streams, i, c, s, flags, mn, mx, out[i]);
+
+        ConvertOne<true>(streams, n - 1u, c, s, flags, mn, mx, out[n - 1u]);
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, mn);
+        outMin = { lanes[0], lanes[1], lanes[2] };
+        _mm_store_ps(lanes, mx);
+        outMax = { lanes[0], lanes[1], lanes[2] };
+#else
+        for (std::size_t i = 0u; i < n; ++i)
+        {
+            ImportedVertex& v = out[i];
+            const float* p = streams[0].Data + 3u * i;
+            v.Position = { (p[0] - center.x) * scale, (p[1] - center.y) * scale, (p[2] - center.z) * scale };
+
+            outMin = { (std::min)(outMin.x, v.Position.x), (std::min)(outMin.y, v.Position.y), (std::min)(outMin.z, v.Position.z) };
+            outMax = { (std::max)(outMax.x, v.Position.x), (std::max)(outMax.y, v.Position.y), (std::max)(outMax.z, v.Position.z) };
+
+            const float* q = streams[1].Data + streams[1].Stride * i;
+            const float* t = streams[2].Data + streams[2].Stride * i;
+            const float* b = streams[3].Data + streams[3].Stride * i;
+            const float* u0 = streams[4].Data + streams[4].Stride * i;
+            const float* u1 = streams[5].Data + streams[5].Stride * i;
+
+            v.Normal = { q[0], q[1], q[2] };
+            v.Tangent = { t[0], t[1], t[2] };
+            v.Bitangent = { b[0], b[1], b[2] };
+            v.UV[0] = { u0[0], u0[1] };
+            v.UV[1] = { u1[0], u1[1] };
+            std::memcpy(&v.HasNormal, &flags, sizeof(flags));
+        }
+#endif
+    }
+
+    KFE_VERTEX_KERNEL_BENCH_RESULT KFEVertexKernels::RunBenchmark(std::uint32_t vertexCount) noexcept
+    {
+        using Clock = std::chrono::steady_clock;
+
+        KFE_VERTEX_KERNEL_BENCH_RESULT result{};
+        result.VertexCount = vertexCount;
+        result.InstructionSet = GetInstructionSet();
+
+        if (vertexCount == 0u)
+            return result;
+
+        const std::size_t n = vertexCount;
+
+        //~ Assimp style streams, the UV stream keeps its unused z
+        std::vector<float> positions(3u * n), normals(3u * n), tangents(3u * n), bitangents(3u * n), uvs(3u * n);
+
+        std::mt19937 rng(7u);
+        std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
+        for (std::size_t i = 0u; i < 3u * n; ++i)
+        {
+            positions[i]  = dist(rng);
+            normals[i]    = dist(rng) * 0.02f;
+            tangents[i]   = dist(rng) * 0.02f;
+            bitangents[i] = dist(rng) * 0.02f;
+            uvs[i]        = dist(rng) * 0.01f + 0.5f;
+        }
+
+        KFE_VERTEX_SOURCE_STREAMS src{};
+        src.Positions   = positions.data();
+        src.Normals     = normals.data();
+        src.Tangents    = tangents.data();
+        src.Bitangents  = bitangents.data();
+        src.UV[0]       = uvs.data();
+        src.VertexCount = n;
+
+        std::vector<ImportedVertex> importedRef(n), importedFused(n);
+        std::vector<KFEMeshVertex>  engineRef(n), engineFused(n);
+
+        Float3 refMin{}, refMax{};
+        const auto t0 = Clock::now();
+        ScalarReference(src, importedRef, engineRef, refMin, refMax);
+        const auto t1 = Clock::now();
+
+        Float3 mn{ 1e30f, 1e30f, 1e30f };
+        Float3 mx{ -1e30f, -1e30f, -1e30f };
+        ReduceAABB(src.Positions, n, mn, mx);
+
+        const Float3 center{ 0.5f * (mn.x + mx.x), 0.5f * (mn.y + mx.y), 0.5f * (mn.z + mx.z) };
+        const float  extent = (std::max)(mx.x - mn.x, (std::max)(mx.y - mn.y, mx.z - mn.z));
+        const float  scale = extent > 1e-6f ? 1.0f / extent : 1.0f;
+
+        Float3 fusedMin{}, fusedMax{};
+        ConvertVertices(src, center, scale, importedFused.data(), fusedMin, fusedMax);
+        std::memcpy(engineFused.data(), importedFused.data(), n * sizeof(KFEMeshVertex));
+        const auto t2 = Clock::now();
+
+        result.ScalarMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        result.FusedMs  = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        result.Speedup  = result.FusedMs > 0.0 ? result.ScalarMs / result.FusedMs : 0.0;
+
+        //~ Same arithmetic per component, so results must be bit identical
+        result.bMatches =
+            std::memcmp(&refMin, &fusedMin, sizeof(Float3)) == 0 &&
+            std::memcmp(&refMax, &fusedMax, sizeof(Float3)) == 0 &&
+            std::memcmp(engineRef.data(), engineFused.data(), n * sizeof(KFEMeshVertex)) == 0;
+
+        LOG_INFO("KFEVertexKernels::RunBenchmark: {} vertices, scalar {:.2f} ms, fused {} {:.2f} ms, speedup {:.2f}x, match={}",
+            result.VertexCount, result.ScalarMs, result.InstructionSet, result.FusedMs, result.Speedup, result.bMatches);
+
+        return result;
+    }
+}
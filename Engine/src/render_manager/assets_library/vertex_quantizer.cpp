@@ -0,0 +1,278 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ *  -----------------------------------------------------------------------------
+ *  Project   : KnightFox (WMG Warwick - Module 2 WM9M2:Computer Graphics)
+ *  File      : vertex_quantizer.cpp
+ *  -----------------------------------------------------------------------------
+ */
+
+#include "pch.h"
+
+#include "engine/render_manager/assets_library/model/vertex_quantizer.h"
+
+#include <DirectXPackedVector.h>
+
+#include <cmath>
+
+namespace kfe
+{
+    using namespace DirectX;
+    using namespace DirectX::PackedVector;
+
+    namespace
+    {
+        inline constexpr float kSnorm16Max = 32767.0f;
+        inline constexpr float kUnorm16Max = 65535.0f;
+
+        static float SignNotZero(float v) noexcept
+        {
+            return v >= 0.0f ? 1.0f : -1.0f;
+        }
+
+        static float ClampSnorm(float v) noexcept
+        {
+            return (std::max)(-kSnorm16Max, (std::min)(kSnorm16Max, v));
+        }
+
+        static float Dot3(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        static XMFLOAT3 Cross3(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+        {
+            return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        }
+
+        static bool Normalize3(XMFLOAT3& v) noexcept
+        {
+            const float len = std::sqrt(Dot3(v, v));
+            if (len <= 1e-20f)
+                return false;
+
+            v.x /= len; v.y /= len; v.z /= len;
+            return true;
+        }
+
+        //~ atan2 keeps precision for tiny angles where acos(dot) does not
+        static float AngleDegrees(XMFLOAT3 a, XMFLOAT3 b) noexcept
+        {
+            if (!Normalize3(a) || !Normalize3(b))
+                return 0.0f;
+
+            const XMFLOAT3 c = Cross3(a, b);
+            return XMConvertToDegrees(std::atan2(std::sqrt(Dot3(c, c)), Dot3(a, b)));
+        }
+
+        static std::uint16_t QuantizeUnorm(float value, float minValue, float extent) noexcept
+        {
+            if (extent <= 0.0f)
+                return 0u;
+
+            const float t = (std::max)(0.0f, (std::min)(1.0f, (value - minValue) / extent));
+            return static_cast<std::uint16_t>(std::lround(t * kUnorm16Max));
+        }
+
+        static float DequantizeUnorm(std::uint16_t q, float minValue, float extent) noexcept
+        {
+            return minValue + (static_cast<float>(q) / kUnorm16Max) * extent;
+        }
+
+        //~ Matches DXGI SNORM conversion, -32768 maps to -1 like -32767
+        static float SnormToFloat(std::int16_t q) noexcept
+        {
+            return (std::max)(-1.0f, static_cast<float>(q) / kSnorm16Max);
+        }
+    }
+
+    void KFEVertexQuantizer::EncodeOctahedral(const XMFLOAT3& dir, std::int16_t out[2]) noexcept
+    {
+        XMFLOAT3 n = dir;
+        if (!Normalize3(n))
+            n = { 0.0f, 0.0f, 1.0f };
+
+        const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        float px = n.x / l1;
+        float py = n.y / l1;
+
+        if (n.z < 0.0f)
+        {
+            const float ox = px;
+            px = (1.0f - std::fabs(py)) * SignNotZero(ox);
+            py = (1.0f - std::fabs(ox)) * SignNotZero(py);
+        }
+
+        //~ Pick the best of the four surrounding grid points instead of plain rounding
+        const float fx = px * kSnorm16Max;
+        const float fy = py * kSnorm16Max;
+
+        //~ Compare by |cross| since dot products of near parallel vectors all round to 1 in float
+        float bestError = 4.0f;
+        for (int ix = 0; ix < 2; ++ix)
+        {
+            for (int iy = 0; iy < 2; ++iy)
+            {
+                const std::int16_t cand[2] =
+                {
+                    static_cast<std::int16_t>(ClampSnorm(ix ? std::ceil(fx) : std::floor(fx))),
+                    static_cast<std::int16_t>(ClampSnorm(iy ? std::ceil(fy) : std::floor(fy)))
+                };
+
+                const XMFLOAT3 decoded = DecodeOctahedral(cand);
+                const XMFLOAT3 c = Cross3(decoded, n);
+                const float error = Dot3(decoded, n) > 0.0f ? Dot3(c, c) : 4.0f;
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    out[0] = cand[0];
+                    out[1] = cand[1];
+                }
+            }
+        }
+    }
+
+    XMFLOAT3 KFEVertexQuantizer::DecodeOctahedral(const std::int16_t in[2]) noexcept
+    {
+        XMFLOAT3 n{ SnormToFloat(in[0]), SnormToFloat(in[1]), 0.0f };
+        n.z = 1.0f - std::fabs(n.x) - std::fabs(n.y);
+
+        const float t = (std::max)(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+
+        Normalize3(n);
+        return n;
+    }
+
+    KFEMeshVertexCompact KFEVertexQuantizer::Encode(
+        const KFEMeshVertex& v,
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax) noexcept
+    {
+        KFEMeshVertexCompact out{};
+
+        out.Position[0] = QuantizeUnorm(v.Position.x, aabbMin.x, aabbMax.x - aabbMin.x);
+        out.Position[1] = QuantizeUnorm(v.Position.y, aabbMin.y, aabbMax.y - aabbMin.y);
+        out.Position[2] = QuantizeUnorm(v.Position.z, aabbMin.z, aabbMax.z - aabbMin.z);
+
+        EncodeOctahedral(v.Normal, out.Normal);
+
+        //~ Tangent frame: keep T, rebuild B = cross(N, T) * sign in the shader
+        XMFLOAT3 tangent = v.Tangent;
+        if (!Normalize3(tangent))
+            tangent = { 1.0f, 0.0f, 0.0f };
+
+        EncodeOctahedral(tangent, out.Tangent);
+
+        const float handedness = Dot3(Cross3(v.Normal, v.Tangent), v.Bitangent);
+        out.Position[3] = handedness < 0.0f ? 0u : 0xFFFFu;
+
+        out.UV0[0] = XMConvertFloatToHalf(v.UV0.x);
+        out.UV0[1] = XMConvertFloatToHalf(v.UV0.y);
+        out.UV1[0] = XMConvertFloatToHalf(v.UV1.x);
+        out.UV1[1] = XMConvertFloatToHalf(v.UV1.y);
+
+        return out;
+    }
+
+    KFEMeshVertex KFEVertexQuantizer::Decode(
+        const KFEMeshVertexCompact& v,
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax) noexcept
+    {
+        KFEMeshVertex out{};
+
+        out.Position.x = DequantizeUnorm(v.Position[0], aabbMin.x, aabbMax.x - aabbMin.x);
+        out.Position.y = DequantizeUnorm(v.Position[1], aabbMin.y, aabbMax.y - aabbMin.y);
+        out.Position.z = DequantizeUnorm(v.Position[2], aabbMin.z, aabbMax.z - aabbMin.z);
+
+        out.Normal = DecodeOctahedral(v.Normal);
+        out.Tangent = DecodeOctahedral(v.Tangent);
+
+        const float sign = v.Position[3] >= 0x8000u ? 1.0f : -1.0f;
+        const XMFLOAT3 b = Cross3(out.Normal, out.Tangent);
+        out.Bitangent = { b.x * sign, b.y * sign, b.z * sign };
+
+        out.UV0 = { XMConvertHalfToFloat(v.UV0[0]), XMConvertHalfToFloat(v.UV0[1]) };
+        out.UV1 = { XMConvertHalfToFloat(v.UV1[0]), XMConvertHalfToFloat(v.UV1[1]) };
+
+        out.HasNormal = true;
+        out.HasTangent = true;
+        out.HasUV0 = true;
+        out.HasUV1 = true;
+
+        return out;
+    }
+
+    void KFEVertexQuantizer::EncodeAll(
+        std::span<const KFEMeshVertex> src,
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax,
+        std::vector<KFEMeshVertexCompact>& out)
+    {
+        out.resize(src.size());
+
+        for (std::size_t i = 0; i < src.size(); ++i)
+            out[i] = Encode(src[i], aabbMin, aabbMax);
+    }
+
+    KFE_VERTEX_QUANTIZATION_ERROR KFEVertexQuantizer::MeasureRoundTrip(
+        std::span<const KFEMeshVertex> src,
+        const XMFLOAT3& aabbMin,
+        const XMFLOAT3& aabbMax) noexcept
+    {
+        KFE_VERTEX_QUANTIZATION_ERROR result{};
+
+        //~ Half a quantization step per axis, plus float slack
+        const float extent = (std::max)({ aabbMax.x - aabbMin.x, aabbMax.y - aabbMin.y, aabbMax.z - aabbMin.z, 0.0f });
+        const float positionBound = extent / (2.0f * kUnorm16Max) + extent * 1e-6f + 1e-7f;
+
+        for (const KFEMeshVertex& v : src)
+        {
+            const KFEMeshVertex d = Decode(Encode(v, aabbMin, aabbMax), aabbMin, aabbMax);
+
+            result.MaxPositionError = (std::max)({ result.MaxPositionError,
+                std::fabs(d.Position.x - v.Position.x),
+                std::fabs(d.Position.y - v.Position.y),
+                std::fabs(d.Position.z - v.Position.z) });
+
+            if (v.HasNormal)
+                result.MaxNormalDegrees = (std::max)(result.MaxNormalDegrees, AngleDegrees(v.Normal, d.Normal));
+
+            if (v.HasTangent)
+            {
+                result.MaxTangentDegrees = (std::max)(result.MaxTangentDegrees, AngleDegrees(v.Tangent, d.Tangent));
+
+                if (Dot3(v.Bitangent, d.Bitangent) < 0.0f)
+                    result.BitangentSignMatches = false;
+            }
+
+            //~ Half float keeps 11 significant bits
+            const float uvValues[4] = { v.UV0.x, v.UV0.y, v.UV1.x, v.UV1.y };
+            const float uvDecoded[4] = { d.UV0.x, d.UV0.y, d.UV1.x, d.UV1.y };
+
+            for (int c = 0; c < 4; ++c)
+            {
+                const float err = std::fabs(uvDecoded[c] - uvValues[c]);
+                const float bound = std::fabs(uvValues[c]) * (1.0f / 2048.0f) + 6.0e-8f;
+
+                result.MaxUVError = (std::max)(result.MaxUVError, err);
+                if (!(err <= bound))
+                    result.WithinBounds = false;
+            }
+        }
+
+        if (result.MaxPositionError > positionBound ||
+            result.MaxNormalDegrees > kMaxDirectionErrorDegrees ||
+            result.MaxTangentDegrees > kMaxDirectionErrorDegrees ||
+            !result.BitangentSignMatches)
+        {
+            result.WithinBounds = false;
+        }
+
+        return result;
+    }
+}
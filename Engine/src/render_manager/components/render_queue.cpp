@@ -33,6 +33,9 @@
 #include "engine/render_manager/api/queue/copy_queue.h"
 #include "engine/render_manager/api/queue/graphics_queue.h"
 
+//~ Assets
+#include "engine/render_manager/assets_library/model/mesh_cache.h"
+
 //~ Utility
 #include "engine/utils/logger.h"
 #include <unordered_map>
@@ -68,6 +71,8 @@ public:
 private:
 	//~ Scene Objects
 	void Build_SceneObjects();
+	void Poll_SceneObjects ();
+	bool IsStreaming		   (const KID id) const noexcept;
 	void Update_SceneObjects   (float deltaTime);
 	void MainPass_SceneObject  (const KFE_RENDER_QUEUE_MAIN_PASS_DESC& desc) noexcept;
 	void ShadowPass_SceneObject(const KFE_RENDER_QUEUE_SHADOW_PASS_DESC& desc) noexcept;
@@ -97,6 +102,10 @@ private:
 	std::unordered_map<KID, IKFESceneObject*> m_sceneObjects{};
 	std::vector<KID> m_sceneObjectToBuild{};
 
+	//~ Built but their upload has not reached this copy fence value yet,
+	//~ they are neither updated nor drawn until it does
+	std::unordered_map<KID, std::uint64_t> m_streamingObjects{};
+
 	//~ Lights
 	std::unordered_map<KID, IKFELight*> m_lights{};
 };
@@ -217,6 +226,14 @@ bool kfe::KFERenderQueue::Impl::Initialize(const KFE_RENDER_QUEUE_INIT_DESC& des
 _Use_decl_annotations_
 bool kfe::KFERenderQueue::Impl::Destroy() noexcept
 {
+	//~ Uploads still in flight reference these objects
+	if (!m_streamingObjects.empty())
+	{
+		m_pCopyCommandList->Wait();
+		m_streamingObjects.clear();
+	}
+	m_sceneObjectToBuild.clear();
+
 	//~ destroy objects
 	for (auto& [id, scene] : m_sceneObjects)
 	{
@@ -274,12 +291,37 @@ void kfe::KFERenderQueue::Impl::RemoveSceneObject(const KID id) noexcept
 	{
 		m_sceneObjects.erase(id);
 	}
+
+	std::erase(m_sceneObjectToBuild, id);
+
+	//~ The caller destroys it next, its upload must not be in flight
+	if (m_streamingObjects.erase(id) > 0u)
+	{
+		m_pCopyCommandList->Wait();
+	}
 }
 
 void kfe::KFERenderQueue::Impl::Build_SceneObjects()
 {
 	if (m_sceneObjectToBuild.empty()) return;
 
+	//~ Only objects whose imports finished are recorded, the rest wait for a later frame
+	std::vector<KID> ready{};
+	std::erase_if(m_sceneObjectToBuild, [&](const KID id)
+		{
+			auto it = m_sceneObjects.find(id);
+			if (it == m_sceneObjects.end() || !it->second)
+				return true;
+
+			if (!it->second->PrepareBuild())
+				return false;
+
+			ready.push_back(id);
+			return true;
+		});
+
+	if (ready.empty()) return;
+
 	auto* copyQueue = m_pCopyCommandQ->GetNative();
 
 	++m_nCopyFenceValue;
@@ -291,19 +333,22 @@ void kfe::KFERenderQueue::Impl::Build_SceneObjects()
 	if (!m_pCopyCommandList->Reset(resetter))
 	{
 		LOG_ERROR("Failed to reset graphics command list for upload.");
+		m_sceneObjectToBuild.insert(m_sceneObjectToBuild.end(), ready.begin(), ready.end());
+		return;
 	}
 
 	ID3D12GraphicsCommandList* cmdList = m_pCopyCommandList->GetNative();
 	if (!cmdList)
 	{
 		LOG_ERROR("KCommand list is null.");
+		m_sceneObjectToBuild.insert(m_sceneObjectToBuild.end(), ready.begin(), ready.end());
+		return;
 	}
 
 	//~ Build
-	for (auto id : m_sceneObjectToBuild)
+	for (auto id : ready)
 	{
 		auto* obj = m_sceneObjects[id];
-		if (!obj) continue;
 
 		KFE_BUILD_OBJECT_DESC builder{};
 		builder.ComandQueue  = m_pCopyCommandQ.get();
@@ -317,21 +362,77 @@ void kfe::KFERenderQueue::Impl::Build_SceneObjects()
 		if (!obj->Build(builder))
 		{
 			LOG_ERROR("Failed to build {}", obj->GetName());
+			continue;
 		}
+		m_streamingObjects[id] = m_nCopyFenceValue;
 	}
 
 	cmdList->Close();
 	ID3D12CommandList* cmdLists[] = { cmdList };
 	copyQueue->ExecuteCommandLists(1u, cmdLists);
 
+	//~ No wait, Poll_SceneObjects releases the objects once the fence passes
 	HRESULT hr = copyQueue->Signal(m_pFence.Get(), m_nCopyFenceValue);
+	if (FAILED(hr))
+	{
+		//~ The fence never reaches this value, do not hide the objects forever
+		LOG_ERROR("Failed to signal upload fence, HRESULT = 0x{:08X}", static_cast<unsigned>(hr));
+		for (auto id : ready)
+			m_streamingObjects.erase(id);
+		return;
+	}
 
-	m_pCopyCommandList->Wait();
-	m_sceneObjectToBuild.clear();
+	//~ Shared arena pages and pooled textures are read by the main queue, its next
+	//~ submission waits on the GPU for this upload without stalling the CPU
+	auto* mainQueue = m_pGraphicsCommandQ ? m_pGraphicsCommandQ->GetNative() : nullptr;
+	if (mainQueue)
+	{
+		hr = mainQueue->Wait(m_pFence.Get(), m_nCopyFenceValue);
+		if (FAILED(hr))
+		{
+			LOG_ERROR("Failed to make the main queue wait on the upload fence, HRESULT = 0x{:08X}", static_cast<unsigned>(hr));
+			m_pCopyCommandList->Wait();
+		}
+	}
+	else
+	{
+		m_pCopyCommandList->Wait();
+	}
+}
+
+void kfe::KFERenderQueue::Impl::Poll_SceneObjects()
+{
+	//~ Returns allocators whose uploads completed to the pool
+	m_pCopyCommandList->Update();
+
+	//~ Models whose upload finished drop their CPU copies
+	if (auto* meshCache = KFEMeshCache::TryGet())
+		meshCache->TrimUploadedCPU();
+
+	if (m_streamingObjects.empty()) return;
+
+	const std::uint64_t completed = m_pFence->GetCompletedValue();
+	std::erase_if(m_streamingObjects, [&](const auto& kv)
+		{
+			if (kv.second > completed)
+				return false;
+
+			if (auto it = m_sceneObjects.find(kv.first); it != m_sceneObjects.end() && it->second)
+			{
+				LOG_INFO("{} streamed in", it->second->GetName());
+			}
+			return true;
+		});
+}
+
+bool kfe::KFERenderQueue::Impl::IsStreaming(const KID id) const noexcept
+{
+	return m_streamingObjects.contains(id);
 }
 
 void kfe::KFERenderQueue::Impl::Update_SceneObjects(float deltaTime)
 {
+	Poll_SceneObjects ();
 	Build_SceneObjects();
 
 	//~ Update
@@ -339,6 +440,7 @@ void kfe::KFERenderQueue::Impl::Update_SceneObjects(float deltaTime)
 	updatter.CameraPosition		 = m_pCamera->GetPosition();
 	updatter.ZFar				 = m_pCamera->GetFarZ();
 	updatter.ZNear				 = m_pCamera->GetNearZ();
+	updatter.CameraFovY			 = m_pCamera->GetFOV();
 	updatter.OrthographicMatrixT = DirectX::XMMatrixTranspose(m_pCamera->GetOrthographicMatrix());
 	updatter.PerpectiveMatrixT	 = DirectX::XMMatrixTranspose(m_pCamera->GetPerspectiveMatrix());
 	updatter.ViewMatrixT	     = DirectX::XMMatrixTranspose(m_pCamera->GetViewMatrix());
@@ -355,7 +457,7 @@ void kfe::KFERenderQueue::Impl::Update_SceneObjects(float deltaTime)
 
 	for (auto& [id, scene] : m_sceneObjects)
 	{
-		if (!scene || !scene->IsInitialized()) continue;
+		if (!scene || !scene->IsInitialized() || IsStreaming(id)) continue;
 
 		//~ TODO: Add Light Manager on each scene objects and attach lights
 		for (auto& [lid, light] : m_lights)
@@ -377,7 +479,7 @@ void kfe::KFERenderQueue::Impl::MainPass_SceneObject(const KFE_RENDER_QUEUE_MAIN
 
 	for (auto& [id, scene] : m_sceneObjects)
 	{
-		if (!scene) continue;
+		if (!scene || !scene->IsInitialized() || IsStreaming(id)) continue;
 		scene->MainPass(renderInfo);
 	}
 }
@@ -391,7 +493,7 @@ void kfe::KFERenderQueue::Impl::ShadowPass_SceneObject(const KFE_RENDER_QUEUE_SH
 
 	for (auto& [id, scene] : m_sceneObjects)
 	{
-		if (!scene || !scene->IsInitialized()) continue;
+		if (!scene || !scene->IsInitialized() || IsStreaming(id)) continue;
 		scene->ShadowPass(renderInfo);
 	}
 }
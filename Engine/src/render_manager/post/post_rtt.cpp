@@ -10,6 +10,7 @@
 
 #include "engine/render_manager/api/heap/heap_rtv.h"
 #include "engine/render_manager/api/heap/heap_cbv_srv_uav.h"
+#include "engine/render_manager/api/pool/residency_manager.h"
 
 #include "engine/utils/logger.h"
 
@@ -59,6 +60,7 @@ private:
     std::unique_ptr<KFETexture>    m_texture;
     std::unique_ptr<KFETextureRTV> m_rtv;
     std::unique_ptr<KFETextureSRV> m_srv;
+    KFEResidencyHandle             m_residency{};
 
     KFE_RT_DRAW_STATE      m_drawState{ KFE_RT_DRAW_STATE::Unknown };
     D3D12_RESOURCE_STATES  m_state{ D3D12_RESOURCE_STATE_COMMON };
@@ -250,6 +252,12 @@ bool kfe::KFERenderTargetTexture::Impl::Initialize(const KFE_RT_TEXTURE_CREATE_D
         return false;
     }
 
+    KFE_RESIDENCY_REGISTER_DESC residency{};
+    residency.Name = "KFERenderTargetTexture";
+    residency.Category = EResidencyCategory::RenderTarget;
+    residency.SizeInBytes = KFEResidencyManager::QueryAllocationBytes(desc.Device, m_texture->GetNative());
+    m_residency = KFEResidencyManager::Instance().Register(std::move(residency));
+
     m_state = desc.InitialState;
     m_drawState = (desc.InitialState & D3D12_RESOURCE_STATE_RENDER_TARGET)
         ? KFE_RT_DRAW_STATE::RenderTarget
@@ -276,6 +284,7 @@ bool kfe::KFERenderTargetTexture::Impl::Destroy() noexcept
     m_rtv    .reset();
     m_srv    .reset();
     m_texture.reset();
+    m_residency.Reset();
 
     m_device  = nullptr;
     m_rtvHeap = nullptr;
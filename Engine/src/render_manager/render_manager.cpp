@@ -32,6 +32,9 @@
 #include "engine/render_manager/api/commands/copy_list.h"
 #include "engine/render_manager/api/commands/compute_list.h"
 #include "engine/render_manager/api/pool/allocator_pool.h"
+#include "engine/render_manager/api/pool/geometry_arena.h"
+#include "engine/render_manager/api/pool/residency_manager.h"
+#include "engine/render_manager/api/pool/offset_allocator.h"
 
 //~ Test Heaps
 #include "engine/render_manager/api/heap/heap_cbv_srv_uav.h"
@@ -78,6 +81,10 @@
 //~ Render Components
 #include "engine/render_manager/components/render_queue.h"
 #include "engine/render_manager/assets_library/texture_library.h"
+#include "engine/render_manager/assets_library/texture/texture_streaming.h"
+#include "engine/render_manager/assets_library/texture/mip_generator.h"
+#include "engine/render_manager/assets_library/model/vertex_kernels.h"
+#include "engine/render_manager/assets_library/model/tangent_space.h"
 
 //~ pass
 #include "engine/render_manager/shadow/shadow_map.h"
@@ -115,6 +122,13 @@ private:
 	void RenderMainPass  (ID3D12GraphicsCommandList* cmdList);
 	void RenderPostPass  (ID3D12GraphicsCommandList* cmdList);
 
+#if defined(DEBUG) || defined(_DEBUG)
+	//~ Diagnostics
+	void RunSelfTests	  ();
+	void RunBenchmarks	  ();
+	void ImguiDiagnostics ();
+#endif
+
 private:
 	KFEWindows* m_pWindows{ nullptr };
 
@@ -252,6 +266,9 @@ bool kfe::KFERenderManager::Impl::Initialize()
 {
 #if defined(DEBUG) || defined(_DEBUG)
 	//~ Init Imgui
+
+	//~ CPU only checks, logged before anything is created
+	RunSelfTests();
 #endif
 	m_camera.SetPosition({ 0, 10, -10.f });
 
@@ -260,6 +277,10 @@ bool kfe::KFERenderManager::Impl::Initialize()
 		return false;
 	}
 
+	//~ Before anything allocates, every pool registers what it creates
+	KFEResidencyManager::Instance().SetBudgetSource(
+		std::make_unique<KFEAdapterBudgetSource>(m_pAdapter->GetNative()));
+
 	if (!InitializeQueues())
 	{
 		return false;
@@ -485,6 +506,16 @@ void kfe::KFERenderManager::Impl::FrameBegin(float dt)
 		THROW_MSG("Graphics command list is null.");
 	}
 
+	//~ Arena ranges freed from here on wait for this frame to retire, earlier ones come back
+	KFEGeometryArena::Instance().SetFrameFence(m_pFence.Get(), m_nFenceValue);
+	KFEGeometryArena::Instance().Collect();
+
+	//~ Evictions first, the streaming below turns them into smaller textures
+	KFEResidencyManager::Instance().BeginFrame();
+
+	//~ Texture mips requested last frame, recorded ahead of the draws that sample them
+	KFEImagePool::Instance().UpdateStreaming(cmdList, m_pFence.Get(), m_nFenceValue);
+
 	// RenderShadowPass(cmdList);
 	RenderMainPass(cmdList);
 	RenderPostPass(cmdList);
@@ -499,6 +530,7 @@ void kfe::KFERenderManager::Impl::FrameBegin(float dt)
 	}
 
 	m_fullScreenQuad.ImguiView(dt);
+	ImguiDiagnostics();
 #endif
 }
 
@@ -1065,3 +1097,46 @@ void kfe::KFERenderManager::Impl::RenderPostPass(ID3D12GraphicsCommandList* cmdL
 
 	m_fullScreenQuad.Render(pe);
 }
+
+#if defined(DEBUG) || defined(_DEBUG)
+void kfe::KFERenderManager::Impl::RunSelfTests()
+{
+	//~ Both run on private state, nothing the renderer owns is touched
+	const bool residency = KFEResidencyManager::RunSelfTest();
+	const bool streaming = KFETextureStreaming::RunSelfTest();
+
+	if (residency && streaming)
+	{
+		LOG_SUCCESS("RenderManager: Self tests passed.");
+	}
+	else
+	{
+		LOG_WARNING("RenderManager: Self tests failed, see the errors above.");
+	}
+}
+
+void kfe::KFERenderManager::Impl::RunBenchmarks()
+{
+	//~ Each one logs its own timings
+	(void)KFEOffsetAllocator::RunBenchmark();
+	(void)KFEVertexKernels  ::RunBenchmark();
+	(void)KFETangentSpace   ::RunBenchmark();
+	(void)KFEMipGenerator   ::RunBenchmark();
+}
+
+void kfe::KFERenderManager::Impl::ImguiDiagnostics()
+{
+	if (ImGui::Begin("Diagnostics"))
+	{
+		if (ImGui::Button("Run Self Tests"))
+			RunSelfTests();
+
+		ImGui::SameLine();
+
+		//~ Takes a few seconds, the frame stalls until they finish
+		if (ImGui::Button("Run Benchmarks"))
+			RunBenchmarks();
+	}
+	ImGui::End();
+}
+#endif
@@ -28,6 +28,7 @@
 
 #include "engine/render_manager/assets_library/shader_library.h"
 #include "engine/render_manager/assets_library/texture_library.h"
+#include "engine/render_manager/assets_library/texture/texture_streaming.h"
 
 #include "engine/utils/logger.h"
 #include "engine/utils/helpers.h"
@@ -42,6 +43,8 @@
 #include <unordered_map>
 #include <map>
 #include <array>
+#include <algorithm>
+#include <cfloat>
 
 #include "engine/render_manager/api/frame_cb.h"
 #include "engine/render_manager/shadow/shadow_map.h"
@@ -157,10 +160,14 @@ private:
         KFETextureSRV* TextureSrv;
         std::uint32_t  ResourceHandle;
         std::uint32_t  ReservedSlot;
+        std::uint32_t  StreamHandle{ KFE_INVALID_INDEX };
+        std::uint32_t  ArraySlice{ 0u };
         bool           Dirty{ false };
     };
     std::array<SrvData, static_cast<std::size_t>(EModelTextureSlot::Count)> m_srvs;
     std::uint32_t m_baseSrvIndex{ KFE_INVALID_INDEX };
+    std::uint64_t m_textureGeneration{ 0u };
+    float         m_screenPixels{ FLT_MAX }; //~ projected size from the last update, drives mip streaming
     std::uint32_t m_frameCounts{ 3u };
 };
 
@@ -245,6 +252,17 @@ void kfe::KEFCubeSceneObject::Impl::Update(const KFE_UPDATE_OBJECT_DESC& desc)
 {
     m_nTimeLived += desc.DeltaTime;
     UpdateConstantBuffer(desc);
+
+    KFE_TEXTURE_STREAMING_VIEW view{};
+    view.CameraPosition = desc.CameraPosition;
+    view.FovY = desc.CameraFovY;
+    view.ViewportHeight = desc.Resolution.y;
+
+    m_screenPixels = KFETextureStreaming::ComputeScreenPixels(
+        DirectX::XMFLOAT3{ -0.5f, -0.5f, -0.5f },
+        DirectX::XMFLOAT3{ 0.5f, 0.5f, 0.5f },
+        m_pObject->GetWorldMatrix(),
+        view);
 }
 
 _Use_decl_annotations_
@@ -313,6 +331,7 @@ bool kfe::KEFCubeSceneObject::Impl::Destroy()
 
             data.TextureSrv = nullptr;
             data.ResourceHandle = KFE_INVALID_INDEX;
+            data.StreamHandle = KFE_INVALID_INDEX;
         }
 
     }
@@ -331,11 +350,38 @@ void kfe::KEFCubeSceneObject::Impl::Render(_In_ const KFE_RENDER_OBJECT_DESC& de
 {
     //BindShadowMapSRV(m_pResourceHeap, desc.ShadowMap);
 
+    //~ Streamed textures get a new SRV whenever their resident mips change
+    auto& pool = KFEImagePool::Instance();
+    if (m_textureGeneration != pool.GetResidencyGeneration())
+    {
+        m_textureGeneration = pool.GetResidencyGeneration();
+
+        const bool bStreamed = std::any_of(m_srvs.begin(), m_srvs.end(),
+            [](const SrvData& d) { return d.StreamHandle != KFE_INVALID_INDEX; });
+
+        for (std::size_t i = 0; bStreamed && i < m_srvs.size(); ++i)
+        {
+            auto& data = m_srvs[i];
+            if (i == static_cast<std::size_t>(EModelTextureSlot::ShadowMap) || data.ReservedSlot == KFE_INVALID_INDEX)
+                continue;
+
+            data.ResourceHandle = KFE_INVALID_INDEX;
+            data.Dirty = true;
+            m_bTextureDirty = true;
+        }
+    }
+
     if (m_bTextureDirty)
     {
         BindTextureFromPath(desc.CommandList);
     }
 
+    for (const auto& data : m_srvs)
+    {
+        if (data.StreamHandle != KFE_INVALID_INDEX)
+            pool.ReportTextureUse(data.StreamHandle, m_screenPixels);
+    }
+
     if (m_bDirtyGeometry)
     {
         KFE_BUILD_OBJECT_DESC builder{};
@@ -592,6 +638,26 @@ bool kfe::KEFCubeSceneObject::Impl::BindTextureFromPath(ID3D12GraphicsCommandLis
     //~ Loop all defined texture slots
     const std::size_t count = static_cast<std::size_t>(EModelTextureSlot::Count);
 
+    //~ Decode all dirty slots together, the loop below then only binds
+    {
+        std::vector<KFE_IMAGE_REQUEST> requests;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& data = m_srvs[i];
+            if (i == static_cast<std::size_t>(EModelTextureSlot::ShadowMap) || !data.Dirty)
+                continue;
+
+            if (data.ReservedSlot == KFE_INVALID_INDEX || data.TexturePath.empty())
+                continue;
+
+            if (kfe_helpers::IsFile(data.TexturePath))
+                requests.push_back({ data.TexturePath, GetTextureUsage(static_cast<EModelTextureSlot>(i)) });
+        }
+
+        if (requests.size() > 1u)
+            (void)pool.Prefetch(requests, cmdList);
+    }
+
     // Track first valid texture so we can alias others to it
     std::size_t      firstValidIndex = static_cast<std::size_t>(-1);
     std::uint32_t    firstValidResource = KFE_INVALID_INDEX;
@@ -606,6 +672,8 @@ bool kfe::KEFCubeSceneObject::Impl::BindTextureFromPath(ID3D12GraphicsCommandLis
         if (!data.Dirty)
             continue;
 
+        data.StreamHandle = KFE_INVALID_INDEX;
+
         //~ no reserved descriptor slot, means Build() didn't allocate
         if (data.ReservedSlot == KFE_INVALID_INDEX)
         {
@@ -634,7 +702,8 @@ bool kfe::KEFCubeSceneObject::Impl::BindTextureFromPath(ID3D12GraphicsCommandLis
         }
 
         //~ Fetch texture SRV from the image pool
-        KFETextureSRV* srv = pool.GetImageSrv(data.TexturePath, cmdList);
+        KFETextureSRV* srv = pool.GetImageSrv(data.TexturePath, cmdList,
+            GetTextureUsage(static_cast<EModelTextureSlot>(i)));
         if (!srv)
         {
             LOG_ERROR("Failed to load SRV for '{}'", data.TexturePath);
@@ -646,6 +715,10 @@ bool kfe::KEFCubeSceneObject::Impl::BindTextureFromPath(ID3D12GraphicsCommandLis
 
         data.TextureSrv = srv;
         data.ResourceHandle = srv->GetDescriptorIndex();
+        data.StreamHandle = pool.GetStreamHandle(data.TexturePath,
+            GetTextureUsage(static_cast<EModelTextureSlot>(i)));
+        data.ArraySlice = pool.GetArraySlice(data.TexturePath,
+            GetTextureUsage(static_cast<EModelTextureSlot>(i)));
 
         //~ Copy SRV into our contiguous block
         const D3D12_CPU_DESCRIPTOR_HANDLE src =
@@ -702,6 +775,7 @@ bool kfe::KEFCubeSceneObject::Impl::BindTextureFromPath(ID3D12GraphicsCommandLis
 
             data.ResourceHandle = firstValidResource;
             data.TextureSrv = m_srvs[firstValidIndex].TextureSrv;
+            data.ArraySlice = m_srvs[firstValidIndex].ArraySlice;
 
             LOG_WARNING(
                 "Cube SRV slot {} had no valid texture; aliased to slot {} (descriptor {}).",
@@ -746,6 +820,10 @@ void kfe::KEFCubeSceneObject::Impl::UpdateConstantBuffer(const KFE_UPDATE_OBJECT
     enforceAttachment(EModelTextureSlot::Height,
         m_metaInformation.Height.IsTextureAttached);
 
+    //~ Bound array slices
+    for (std::size_t i = 0; i < m_srvs.size(); ++i)
+        m_metaInformation.ArraySlice[i] = static_cast<float>(m_srvs[i].ArraySlice);
+
     //~ Copy meta buffer to GPU
     if (m_metaFrameCB.IsInitialized())
     {
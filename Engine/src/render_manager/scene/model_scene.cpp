@@ -28,6 +28,7 @@
 
 #include "engine/render_manager/assets_library/shader_library.h"
 #include "engine/render_manager/assets_library/texture_library.h"
+#include "engine/render_manager/assets_library/texture/texture_streaming.h"
 
 #include "engine/utils/logger.h"
 #include "engine/utils/helpers.h"
@@ -39,6 +40,8 @@
 #include "engine/render_manager/assets_library/model/geometry.h"
 #include "engine/render_manager/assets_library/model/gpu_mesh.h"
 #include "engine/render_manager/assets_library/model/mesh_cache.h"
+#include "engine/render_manager/assets_library/model/meshlet.h"
+#include "engine/render_manager/assets_library/model/mesh_lod.h"
 #include "engine/render_manager/assets_library/model/model.h"
 #include <d3d12.h>
 #include <vector>
@@ -47,6 +50,7 @@
 #include <map>
 #include <unordered_set>
 #include <array>
+#include <cfloat>
 
 #include "engine/render_manager/api/frame_cb.h"
 #include "engine/render_manager/shadow/shadow_map.h"
@@ -61,9 +65,13 @@ static void UpdateMetaCB(_Inout_ kfe::KFEModelSubmesh& sm) noexcept
         return;
 
     *dst = sm.m_textureMetaInformation;
-
+    sm.WritePackedORM(*dst);
+    sm.WriteArraySlices(*dst);
 }
 
+//~ Meshes with fewer meshlets are cheaper to draw whole than to cull
+static constexpr std::size_t kMinMeshletsForCulling = 8u;
+
 #pragma region Impl_Definition
 
 class kfe::KFEMeshSceneObject::Impl
@@ -76,6 +84,7 @@ public:
     ~Impl() = default;
 
     void Update (const KFE_UPDATE_OBJECT_DESC& desc);
+    bool PrepareBuild() noexcept;
     bool Build  (_In_ const KFE_BUILD_OBJECT_DESC& desc);
     bool Destroy();
     void Render (_In_ const KFE_RENDER_OBJECT_DESC& desc);
@@ -138,6 +147,7 @@ private:
     //~ Model
     KFEModel    m_mesh     {};
     std::string m_modelPath{ "assets/defaults/default_3d.obj" };
+    EMeshVertexFormat m_vertexFormat{ EMeshVertexFormat::Full };
     std::unordered_map<std::uint32_t, KFE_COMMON_CB_GPU>                   m_cbData{};
     std::unordered_map<std::uint32_t, DirectX::XMFLOAT4X4>                 m_cbTransLazy{};
     std::unordered_map<std::uint32_t, ModelTextureMetaInformation>         m_cbMetaLazy{};
@@ -150,6 +160,17 @@ private:
     std::unordered_map<std::uint32_t, std::string> m_pendingTexturePath;
     std::unordered_set<std::uint32_t>              m_pendingTextureDirty;
     std::uint32_t m_frameCounts{ 3u };
+
+    //~ Cluster culling and LOD selection, camera cached from Update
+    DirectX::XMFLOAT4X4         m_viewProj{};
+    DirectX::XMFLOAT3           m_cameraPosWS{};
+    float                       m_cameraFovY{ DirectX::XM_PIDIV4 };
+    float                       m_viewportHeight{ 0.0f };
+    bool                        m_bHasCamera{ false };
+    std::vector<KFE_DRAW_RANGE> m_drawRanges;
+
+    //~ LOD
+    float                       m_lodPixelError{ 1.0f };
 };
 
 #pragma endregion
@@ -188,6 +209,11 @@ void kfe::KFEMeshSceneObject::ChildUpdate(const KFE_UPDATE_OBJECT_DESC& desc)
     m_impl->Update(desc);
 }
 
+bool kfe::KFEMeshSceneObject::ChildPrepareBuild()
+{
+    return m_impl->PrepareBuild();
+}
+
 _Use_decl_annotations_
 bool kfe::KFEMeshSceneObject::ChildBuild(const KFE_BUILD_OBJECT_DESC& desc)
 {
@@ -247,6 +273,26 @@ void kfe::KFEMeshSceneObject::Impl::Update(const KFE_UPDATE_OBJECT_DESC& desc)
 {
     m_nTimeLived += desc.DeltaTime;
     UpdateSubmeshConstantBuffers(desc);
+
+    DirectX::XMStoreFloat4x4(&m_viewProj,
+        DirectX::XMMatrixTranspose(desc.ViewMatrixT) * DirectX::XMMatrixTranspose(desc.PerpectiveMatrixT));
+    m_cameraPosWS    = desc.CameraPosition;
+    m_cameraFovY     = desc.CameraFovY;
+    m_viewportHeight = desc.Resolution.y;
+    m_bHasCamera     = true;
+}
+
+bool kfe::KFEMeshSceneObject::Impl::PrepareBuild() noexcept
+{
+    //~ Missing files fall through, BuildGeometry reports them
+    if (m_modelPath.empty() || !kfe_helpers::IsFile(m_modelPath))
+        return true;
+
+    const EMeshVertexFormat format = m_pObject->m_shaderInfo.CompactVertices
+        ? EMeshVertexFormat::Compact
+        : EMeshVertexFormat::Full;
+
+    return KFEMeshCache::Instance().RequestCPU(m_modelPath, format);
 }
 
 _Use_decl_annotations_
@@ -285,13 +331,29 @@ bool kfe::KFEMeshSceneObject::Impl::Destroy()
 
 void kfe::KFEMeshSceneObject::Impl::Render(_In_ const KFE_RENDER_OBJECT_DESC& desc)
 {
-    if (m_bModelDirty)
+    //~ Vertex format follows the pipeline input layout
+    const EMeshVertexFormat wantedFormat = m_pObject->m_shaderInfo.CompactVertices
+        ? EMeshVertexFormat::Compact
+        : EMeshVertexFormat::Full;
+
+    if (m_bBuild && wantedFormat != m_vertexFormat)
+        m_bModelDirty = true;
+
+    //~ Keep drawing the current model until the new one is imported
+    if (m_bModelDirty && !PrepareBuild())
+    {
+        if (!m_bBuild || !m_mesh.IsValid())
+            return;
+    }
+    else if (m_bModelDirty)
     {
         if (m_modelPath.empty()) return;
         KFE_BUILD_OBJECT_DESC builder{};
         builder.Device = m_pDevice;
         builder.CommandList = desc.CommandList;
         builder.ResourceHeap = m_pResourceHeap;
+        builder.Fence = desc.Fence;
+        builder.FenceValue = desc.FenceValue;
         if (!BuildGeometry(builder))
         {
             LOG_ERROR("Failed to rebuild model.");
@@ -312,9 +374,21 @@ void kfe::KFEMeshSceneObject::Impl::Render(_In_ const KFE_RENDER_OBJECT_DESC& de
     if (m_pResourceHeap)
     {
         auto& subs = m_mesh.GetSubmeshesMutable();
+
+        //~ Decode every pending texture of the model at once instead of slot by slot
+        std::vector<KFE_IMAGE_REQUEST> requests;
+        for (auto& sm : subs)
+        {
+            sm.ResolveORMPacking();
+            sm.CollectTextureRequests(requests);
+        }
+
+        if (!requests.empty())
+            (void)KFEImagePool::Instance().Prefetch(requests, desc.CommandList);
+
         for (auto& sm : subs)
         {
-            sm.BindTextureFromPath(desc.CommandList, m_pDevice, m_pResourceHeap);
+            sm.BindTextureFromPath(desc.CommandList, m_pDevice, m_pResourceHeap, desc.Fence, desc.FenceValue);
         }
     }
     else 
@@ -363,7 +437,11 @@ bool kfe::KFEMeshSceneObject::Impl::BuildGeometry(const KFE_BUILD_OBJECT_DESC& d
     }
     m_mesh.Reset();
 
-    if (!m_mesh.Initialize(m_modelPath, desc.Device, desc.CommandList, desc.ResourceHeap))
+    m_vertexFormat = m_pObject->m_shaderInfo.CompactVertices
+        ? EMeshVertexFormat::Compact
+        : EMeshVertexFormat::Full;
+
+    if (!m_mesh.Initialize(m_modelPath, desc.Device, desc.CommandList, desc.ResourceHeap, m_vertexFormat, desc.Fence, desc.FenceValue))
     {
         LOG_ERROR("Failed to initialize model from '{}'", m_modelPath);
         return false;
@@ -970,25 +1048,34 @@ void kfe::KFEMeshSceneObject::Impl::RenderNodeRecursive(
             continue;
 
         auto& sm = const_cast<KFEModelSubmesh&>(sub);
+
+        XMMATRIX cachedLocal = XMMatrixIdentity();
+
+        auto it = m_cbData.find(meshIndex);
+        if (it != m_cbData.end())
+        {
+            const XMMATRIX cachedLocalT = XMLoadFloat4x4(&it->second.WorldT);
+            cachedLocal = XMMatrixTranspose(cachedLocalT);
+        }
+
+        const XMMATRIX finalWorld = cachedLocal * nodeWorld;
+
         // Per submesh b0
         if (sm.ConstantBuffer.IsInitialized())
         {
             sm.ConstantBuffer.Step();
-            XMMATRIX cachedLocal = XMMatrixIdentity();
-
-            auto it = m_cbData.find(meshIndex);
-            if (it != m_cbData.end())
-            {
-                const XMMATRIX cachedLocalT = XMLoadFloat4x4(&it->second.WorldT);
-                cachedLocal = XMMatrixTranspose(cachedLocalT);
-            }
-
-            const XMMATRIX finalWorld = cachedLocal * nodeWorld;
 
             if (auto* cv = static_cast<KFE_COMMON_CB_GPU*>(sm.ConstantBuffer.GetMappedData()))
             {
-                // Store transposed for GPU
-                XMStoreFloat4x4(&cv->WorldT, XMMatrixTranspose(finalWorld));
+                // Store transposed for GPU, compact positions are dequantized by the world matrix
+                if (gpuMesh.GetVertexFormat() == EMeshVertexFormat::Compact)
+                {
+                    XMStoreFloat4x4(&cv->WorldT, XMMatrixTranspose(gpuMesh.GetPositionDequantize() * finalWorld));
+                }
+                else
+                {
+                    XMStoreFloat4x4(&cv->WorldT, XMMatrixTranspose(finalWorld));
+                }
 
                 // Inverse transpose for normals
                 const XMMATRIX Winv = XMMatrixInverse(nullptr, finalWorld);
@@ -1004,7 +1091,7 @@ void kfe::KFEMeshSceneObject::Impl::RenderNodeRecursive(
         }
 
         //SRV table update
-        sm.BindTextureFromPath(cmdList, m_pDevice, m_pResourceHeap);
+        sm.BindTextureFromPath(cmdList, m_pDevice, m_pResourceHeap, desc.Fence, desc.FenceValue);
 
         if (sm.GetBaseSrvIndex() != KFE_INVALID_INDEX)
         {
@@ -1030,12 +1117,69 @@ void kfe::KFEMeshSceneObject::Impl::RenderNodeRecursive(
         cmdList->IASetVertexBuffers(0u, 1u, &vb);
         cmdList->IASetIndexBuffer(&ib);
 
-        cmdList->DrawIndexedInstanced(
-            gpuMesh.GetIndexCount(),
-            1u,
-            0u,
-            0u,
-            0u);
+        // Screen space error picks the level, every level shares the vertex buffer
+        const auto lods = gpuMesh.GetLods();
+        std::uint32_t lodIndex = 0u;
+        if (m_bHasCamera)
+        {
+            KFE_MESH_LOD_SELECT_DESC select{};
+            select.CameraPosition = m_cameraPosWS;
+            select.FovY = m_cameraFovY;
+            select.ViewportHeight = m_viewportHeight;
+            select.MaxPixelError = m_lodPixelError;
+
+            lodIndex = KFEMeshSimplifier::SelectLod(
+                lods, gpuMesh.GetAABBMin(), gpuMesh.GetAABBMax(), finalWorld, select);
+        }
+
+        // The same projected size asks for texture mips, full size until a camera is known
+        float screenPixels = FLT_MAX;
+        if (m_bHasCamera)
+        {
+            KFE_TEXTURE_STREAMING_VIEW view{};
+            view.CameraPosition = m_cameraPosWS;
+            view.FovY = m_cameraFovY;
+            view.ViewportHeight = m_viewportHeight;
+
+            screenPixels = KFETextureStreaming::ComputeScreenPixels(
+                gpuMesh.GetAABBMin(), gpuMesh.GetAABBMax(), finalWorld, view);
+        }
+        sm.ReportTextureUse(screenPixels);
+
+        // Cluster cull against the camera cached in Update, meshlets live in mesh space and cover LOD0
+        const auto meshlets = gpuMesh.GetMeshlets();
+        if (m_bHasCamera && lodIndex == 0u && meshlets.size() >= kMinMeshletsForCulling)
+        {
+            KFE_CLUSTER_CULL_DESC cull{};
+            XMStoreFloat4x4(&cull.MeshToClip, finalWorld * XMLoadFloat4x4(&m_viewProj));
+            XMStoreFloat3(&cull.CameraPosition,
+                XMVector3TransformCoord(XMLoadFloat3(&m_cameraPosWS), XMMatrixInverse(nullptr, finalWorld)));
+
+            // Cone test assumes the rasterizer drops back faces and the transform keeps winding
+            cull.BackfaceCull = m_pObject->Draw.CullMode == ECullMode::Back &&
+                XMVectorGetX(XMMatrixDeterminant(finalWorld)) > 0.0f;
+
+            KFEClusterCuller::Cull(meshlets, cull, m_drawRanges);
+
+            for (const KFE_DRAW_RANGE& range : m_drawRanges)
+            {
+                cmdList->DrawIndexedInstanced(
+                    range.IndexCount,
+                    1u,
+                    range.IndexOffset,
+                    0u,
+                    0u);
+            }
+        }
+        else if (lodIndex < lods.size())
+        {
+            cmdList->DrawIndexedInstanced(
+                lods[lodIndex].IndexCount,
+                1u,
+                lods[lodIndex].IndexOffset,
+                0u,
+                0u);
+        }
     }
 
     for (const auto& child : node.Children)
@@ -1677,6 +1821,27 @@ void kfe::KFEMeshSceneObject::Impl::ImguiViewHeader(float deltaTime)
 
     EditModelPath("Model Path");
 
+    ImGui::SeparatorText("Level of Detail");
+    ImGui::SliderFloat("Max Pixel Error", &m_lodPixelError, 0.25f, 16.0f, "%.2f px");
+
+    if (const KFE_MESH_CACHE_SHARE* share = m_mesh.GetCacheShare(); share && share->Entry)
+    {
+        const auto& meshesGPU = share->Entry->MeshesGPU;
+        for (std::size_t i = 0; i < meshesGPU.size(); ++i)
+        {
+            if (!meshesGPU[i])
+                continue;
+
+            const auto lods = meshesGPU[i]->GetLods();
+            ImGui::Text("%s", meshesGPU[i]->GetName().c_str());
+            for (std::size_t l = 0; l < lods.size(); ++l)
+            {
+                ImGui::BulletText("LOD%zu: %u tris, error %.5f",
+                    l, lods[l].IndexCount / 3u, lods[l].Error);
+            }
+        }
+    }
+
     if (m_bModelDirty)
         ImGui::TextColored(ImVec4(1, 1, 0, 1), "Pending: model reload");
 }
@@ -55,6 +55,11 @@ void kfe::IKFESceneObject::Update(const KFE_UPDATE_OBJECT_DESC& desc)
     ChildUpdate(desc);
 }
 
+bool kfe::IKFESceneObject::PrepareBuild()
+{
+    return ChildPrepareBuild();
+}
+
 _Use_decl_annotations_
 bool kfe::IKFESceneObject::Build(_In_ const KFE_BUILD_OBJECT_DESC& desc)
 {
@@ -503,9 +508,15 @@ bool kfe::IKFESceneObject::InitMainPipeline(KFEDevice* device)
         return false;
     }
 
-    if (m_shaderInfo.VertexShader.empty())
+    //~ Keep the default vertex shader in step with the vertex format
+    static constexpr const char* kDefaultVS        = "shaders/model/vertex_shader.hlsl";
+    static constexpr const char* kDefaultCompactVS = "shaders/model/vertex_shader_compact.hlsl";
+
+    if (m_shaderInfo.VertexShader.empty() ||
+        m_shaderInfo.VertexShader == kDefaultVS ||
+        m_shaderInfo.VertexShader == kDefaultCompactVS)
     {
-        m_shaderInfo.VertexShader = "shaders/model/vertex_shader.hlsl";
+        m_shaderInfo.VertexShader = m_shaderInfo.CompactVertices ? kDefaultCompactVS : kDefaultVS;
     }
 
     if (m_shaderInfo.PixelShader.empty())
@@ -552,7 +563,8 @@ bool kfe::IKFESceneObject::InitMainPipeline(KFEDevice* device)
     }
 
     //~ Input layout
-    const auto layout = KFEMeshGeometry::GetInputLayout();
+    const auto layout = KFEMeshGeometry::GetInputLayout(
+        m_shaderInfo.CompactVertices ? EMeshVertexFormat::Compact : EMeshVertexFormat::Full);
     if (layout.empty())
     {
         LOG_ERROR("InitMainPipeline: Input layout is empty.");
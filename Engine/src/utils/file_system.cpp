@@ -15,6 +15,13 @@
 #include "engine/system/exception/win_exception.h"
 #include "engine/utils/logger.h"
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #pragma region Impl_Declaration
 class KFEFileSystem::Impl
 {
@@ -268,3 +275,210 @@ bool KFEFileSystem::Impl::IsOpen() const
 }
 
 #pragma endregion
+
+#pragma region MappedFile_Impl_Declaration
+
+class KFEMappedFile::Impl
+{
+public:
+	 Impl() = default;
+	~Impl() { Close(); }
+
+	NODISCARD bool Open(_In_ const std::string& path);
+	void Close();
+
+	NODISCARD bool                IsOpen () const { return m_pView != nullptr; }
+	NODISCARD const std::uint8_t* GetData() const { return m_pView; }
+	NODISCARD std::uint64_t       GetSize() const { return m_nSize; }
+
+private:
+#if defined(_WIN32)
+	HANDLE              m_fileHandle   { INVALID_HANDLE_VALUE };
+	HANDLE              m_mappingHandle{ nullptr };
+#else
+	int                 m_fileDescriptor{ -1 };
+#endif
+	const std::uint8_t* m_pView        { nullptr };
+	std::uint64_t       m_nSize        { 0u };
+};
+
+#pragma endregion
+
+#pragma region MappedFile_Implementation
+
+KFEMappedFile::KFEMappedFile()
+	: m_impl(std::make_unique<KFEMappedFile::Impl>())
+{}
+
+KFEMappedFile::~KFEMappedFile() = default;
+
+KFEMappedFile::KFEMappedFile(KFEMappedFile&&) = default;
+KFEMappedFile& KFEMappedFile::operator=(KFEMappedFile&&) = default;
+
+_Use_decl_annotations_
+bool KFEMappedFile::Open(const std::string& path)
+{
+	//~ Moved from, open gives it a fresh state
+	if (!m_impl)
+		m_impl = std::make_unique<KFEMappedFile::Impl>();
+
+	return m_impl->Open(path);
+}
+
+void KFEMappedFile::Close()
+{
+	if (!m_impl) return;
+	m_impl->Close();
+}
+
+bool KFEMappedFile::IsOpen() const
+{
+	return m_impl && m_impl->IsOpen();
+}
+
+const std::uint8_t* KFEMappedFile::GetData() const
+{
+	return m_impl ? m_impl->GetData() : nullptr;
+}
+
+std::uint64_t KFEMappedFile::GetSize() const
+{
+	return m_impl ? m_impl->GetSize() : 0u;
+}
+
+std::string_view KFEMappedFile::GetText() const
+{
+	if (!IsOpen()) return {};
+	return { reinterpret_cast<const char*>(GetData()), static_cast<std::size_t>(GetSize()) };
+}
+
+_Use_decl_annotations_
+bool KFEFileSystem::MapForRead(const std::string& path, KFEMappedFile& outView)
+{
+	return outView.Open(path);
+}
+
+#if defined(_WIN32)
+
+_Use_decl_annotations_
+bool KFEMappedFile::Impl::Open(const std::string& path)
+{
+	Close();
+
+	std::wstring w_path = std::wstring(path.begin(), path.end());
+	m_fileHandle = CreateFile(
+		w_path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr
+	);
+
+	if (m_fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size{};
+	if (!::GetFileSizeEx(m_fileHandle, &size) || size.QuadPart <= 0)
+	{
+		//~ zero sized files cannot be mapped
+		Close();
+		return false;
+	}
+
+	m_mappingHandle = CreateFileMapping(m_fileHandle, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+	if (!m_mappingHandle)
+	{
+		Close();
+		return false;
+	}
+
+	m_pView = static_cast<const std::uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0u, 0u, 0u));
+	if (!m_pView)
+	{
+		Close();
+		return false;
+	}
+
+	m_nSize = static_cast<std::uint64_t>(size.QuadPart);
+	return true;
+}
+
+void KFEMappedFile::Impl::Close()
+{
+	if (m_pView)
+	{
+		UnmapViewOfFile(m_pView);
+		m_pView = nullptr;
+	}
+
+	if (m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+	}
+
+	if (m_fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = INVALID_HANDLE_VALUE;
+	}
+
+	m_nSize = 0u;
+}
+
+#else
+
+_Use_decl_annotations_
+bool KFEMappedFile::Impl::Open(const std::string& path)
+{
+	Close();
+
+	m_fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (m_fileDescriptor < 0)
+		return false;
+
+	struct stat info{};
+	if (::fstat(m_fileDescriptor, &info) != 0 || info.st_size <= 0)
+	{
+		//~ zero sized files cannot be mapped
+		Close();
+		return false;
+	}
+
+	void* view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if (view == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	//~ Loaders read front to back
+	(void)::madvise(view, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+	m_pView = static_cast<const std::uint8_t*>(view);
+	m_nSize = static_cast<std::uint64_t>(info.st_size);
+	return true;
+}
+
+void KFEMappedFile::Impl::Close()
+{
+	if (m_pView)
+	{
+		::munmap(const_cast<std::uint8_t*>(m_pView), static_cast<std::size_t>(m_nSize));
+		m_pView = nullptr;
+	}
+
+	if (m_fileDescriptor >= 0)
+	{
+		::close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+
+	m_nSize = 0u;
+}
+
+#endif
+
+#pragma endregion
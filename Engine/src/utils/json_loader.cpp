@@ -32,32 +32,27 @@ void JsonLoader::Load(const std::string& filePath)
 {
     Clear();
 
-    if (!m_fileSystem.OpenForRead(filePath))
+    //~ Parsed straight from the mapped view, no copy of the file
+    KFEMappedFile view{};
+    if (!KFEFileSystem::MapForRead(filePath, view))
     {
-        LOG_ERROR("JsonLoader::Load - Failed to open file for read: {}", filePath);
-        return;
-    }
+        if (!m_fileSystem.OpenForRead(filePath))
+        {
+            LOG_ERROR("JsonLoader::Load - Failed to open file for read: {}", filePath);
+            return;
+        }
 
-    const std::uint64_t fileSize = m_fileSystem.GetFileSize();
-    if (fileSize == 0ULL)
-    {
-        LOG_WARNING("JsonLoader::Load - File is empty: {}", filePath);
+        const bool bEmpty = m_fileSystem.GetFileSize() == 0ULL;
         m_fileSystem.Close();
-        return;
-    }
 
-    std::string content(fileSize, '\0');
-    if (!m_fileSystem.ReadBytes(content.data(), fileSize))
-    {
-        LOG_ERROR("JsonLoader::Load - Failed to read bytes from file: {}", filePath);
-        m_fileSystem.Close();
+        if (bEmpty)
+            LOG_WARNING("JsonLoader::Load - File is empty: {}", filePath);
+        else
+            LOG_ERROR("JsonLoader::Load - Failed to map file: {}", filePath);
         return;
     }
 
-    m_fileSystem.Close();
-
-    std::istringstream iss(content);
-    FromStream(iss);
+    FromString(view.GetText());
 }
 
 void JsonLoader::Save(const std::string& filepath)
@@ -123,32 +118,28 @@ std::string JsonLoader::ToFormattedString(int indent) const
 }
 
 void JsonLoader::FromStream(std::istream& input)
+{
+    const std::string content{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+    FromString(content);
+}
+
+void JsonLoader::FromString(std::string_view input)
 {
     Clear();
 
     SkipWhitespace(input);
 
-    if (input.peek() == '{')
+    if (Peek(input) == '{')
     {
         ParseObject(input);
     }
-    else if (input.peek() == '"')
+    else if (Peek(input) == '"')
     {
         m_value = ReadQuotedString(input);
     }
     else
     {
-        std::string token;
-        while (input.good())
-        {
-            char c = static_cast<char>(input.peek());
-            if (std::isspace(static_cast<unsigned char>(c)) || c == ',' || c == '}' || c == EOF)
-                break;
-
-            input.get(c);
-            token.push_back(c);
-        }
-        m_value = token;
+        m_value = ReadToken(input);
     }
 }
 
@@ -255,33 +246,40 @@ void JsonLoader::Serialize(std::ostream& output, int indent) const
     }
 }
 
-void JsonLoader::SkipWhitespace(std::istream& input)
+void JsonLoader::SkipWhitespace(std::string_view& input)
 {
-    while (input.good() && std::isspace(static_cast<unsigned char>(input.peek())))
+    while (!input.empty() && std::isspace(static_cast<unsigned char>(input.front())))
     {
-        input.get();
+        input.remove_prefix(1u);
     }
 }
 
-bool JsonLoader::ConsumeChar(std::istream& input, char expected)
+bool JsonLoader::ConsumeChar(std::string_view& input, char expected)
 {
-    if (!input.good())
+    if (input.empty())
         return false;
 
-    const int c = input.get();
+    const char c = input.front();
+    input.remove_prefix(1u);
+
     if (c != expected)
     {
         LOG_ERROR(
             "JsonLoader::ConsumeChar - Expected '{}' but got '{}'",
             expected,
-            static_cast<char>(c)
+            c
         );
         return false;
     }
     return true;
 }
 
-std::string JsonLoader::ReadQuotedString(std::istream& input)
+int JsonLoader::Peek(std::string_view input)
+{
+    return input.empty() ? EOF : static_cast<unsigned char>(input.front());
+}
+
+std::string JsonLoader::ReadQuotedString(std::string_view& input)
 {
     SkipWhitespace(input);
 
@@ -291,45 +289,67 @@ std::string JsonLoader::ReadQuotedString(std::istream& input)
     }
 
     std::string result;
-    while (input.good())
+    while (!input.empty())
     {
-        char c = static_cast<char>(input.get());
-        if (c == '"')
+        //~ Runs without escapes are appended in one go
+        const std::size_t run = input.find_first_of("\"\\");
+        if (run == std::string_view::npos)
         {
+            result.append(input);
+            input = {};
             break;
         }
 
-        if (c == '\\')
-        {
-            if (!input.good())
-                break;
+        result.append(input.substr(0u, run));
+        const char c = input[run];
+        input.remove_prefix(run + 1u);
 
-            char esc = static_cast<char>(input.get());
-            switch (esc)
-            {
-            case '"':  result.push_back('"');  break;
-            case '\\': result.push_back('\\'); break;
-            case '/':  result.push_back('/');  break;
-            case 'b':  result.push_back('\b'); break;
-            case 'f':  result.push_back('\f'); break;
-            case 'n':  result.push_back('\n'); break;
-            case 'r':  result.push_back('\r'); break;
-            case 't':  result.push_back('\t'); break;
-            default:
-                // Unknown escape, keep as-is
-                result.push_back(esc);
-                break;
-            }
+        if (c == '"')
+        {
+            break;
         }
-        else
+
+        if (input.empty())
+            break;
+
+        const char esc = input.front();
+        input.remove_prefix(1u);
+        switch (esc)
         {
-            result.push_back(c);
+        case '"':  result.push_back('"');  break;
+        case '\\': result.push_back('\\'); break;
+        case '/':  result.push_back('/');  break;
+        case 'b':  result.push_back('\b'); break;
+        case 'f':  result.push_back('\f'); break;
+        case 'n':  result.push_back('\n'); break;
+        case 'r':  result.push_back('\r'); break;
+        case 't':  result.push_back('\t'); break;
+        default:
+            // Unknown escape, keep as-is
+            result.push_back(esc);
+            break;
         }
     }
 
     return result;
 }
 
+std::string JsonLoader::ReadToken(std::string_view& input)
+{
+    std::size_t length = 0u;
+    while (length < input.size())
+    {
+        const char c = input[length];
+        if (std::isspace(static_cast<unsigned char>(c)) || c == ',' || c == '}')
+            break;
+        ++length;
+    }
+
+    std::string token{ input.substr(0u, length) };
+    input.remove_prefix(length);
+    return token;
+}
+
 std::string JsonLoader::EscapeString(const std::string& s)
 {
     std::string escaped;
@@ -355,7 +375,7 @@ std::string JsonLoader::EscapeString(const std::string& s)
     return escaped;
 }
 
-void JsonLoader::ParseObject(std::istream& input)
+void JsonLoader::ParseObject(std::string_view& input)
 {
     SkipWhitespace(input);
 
@@ -366,14 +386,14 @@ void JsonLoader::ParseObject(std::istream& input)
     {
         SkipWhitespace(input);
 
-        if (input.peek() == '}')
+        if (Peek(input) == '}')
         {
-            input.get();
+            input.remove_prefix(1u);
             break;
         }
 
         std::string key = ReadQuotedString(input);
-        if (key.empty() && !input.good())
+        if (key.empty() && input.empty())
         {
             LOG_ERROR("JsonLoader::ParseObject - Failed to read key");
             return;
@@ -390,37 +410,26 @@ void JsonLoader::ParseObject(std::istream& input)
 
         JsonLoader child;
 
-        if (input.peek() == '{')
+        if (Peek(input) == '{')
         {
             child.ParseObject(input);
         }
-        else if (input.peek() == '"')
+        else if (Peek(input) == '"')
         {
             child.m_value = ReadQuotedString(input);
         }
         else
         {
-            std::string token;
-            while (input.good())
-            {
-                char c = static_cast<char>(input.peek());
-                if (std::isspace(static_cast<unsigned char>(c)) ||
-                    c == ',' || c == '}' || c == EOF)
-                    break;
-
-                input.get(c);
-                token.push_back(c);
-            }
-            child.m_value = token;
+            child.m_value = ReadToken(input);
         }
 
         m_children.emplace(std::move(key), std::move(child));
 
         SkipWhitespace(input);
-        const int next = input.peek();
+        const int next = Peek(input);
         if (next == ',')
         {
-            input.get();
+            input.remove_prefix(1u);
             continue;
         }
         else if (next == '}')
@@ -429,7 +438,7 @@ void JsonLoader::ParseObject(std::istream& input)
         }
         else
         {
-            if (input.good())
+            if (next != EOF)
             {
                 LOG_WARNING(
                     "JsonLoader::ParseObject - Unexpected character '{}' while parsing object",